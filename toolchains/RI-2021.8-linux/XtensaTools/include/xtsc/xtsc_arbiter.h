@@ -20,6 +20,7 @@
 #include <xtsc/xtsc_response.h>
 #include <xtsc/xtsc_parms.h>
 #include <xtsc/xtsc_address_range_entry.h>
+#include <xtsc/xtsc_slab_allocator.h>
 #include <vector>
 #include <deque>
 
@@ -857,6 +858,25 @@ public:
   virtual bool arbitrate_policy(xtsc::u32& port_num);
 
 
+  /// Mark port_num as having a request in m_request_deques
+  void set_request_pending(xtsc::u32 port_num) {
+    m_pending_requests[port_num >> 6] |= (1ULL << (port_num & 63));
+  }
+
+
+  /// Mark port_num as having no requests in m_request_deques
+  void clear_request_pending(xtsc::u32 port_num) {
+    m_pending_requests[port_num >> 6] &= ~(1ULL << (port_num & 63));
+  }
+
+
+  /**
+   * Return the first port after port_num (wrapping around) which has a request pending
+   * according to m_pending_requests, or m_num_masters if no port has a request pending.
+   */
+  xtsc::u32 next_pending_port(xtsc::u32 port_num) const;
+
+
   /**
    * This method can be used to control the sending of randomly generated RSP_NACC
    * responses (for example, to test the upstream memory interface master device's
@@ -1317,19 +1337,19 @@ protected:
    */
   void add_route_id_bits(xtsc::xtsc_request& request, xtsc::u32 port_num);
 
-  /// Get a new request_info (from the pool)
+  /// Get a new request_info (from m_allocator)
   request_info *new_request_info(xtsc::u32 port_num, const xtsc::xtsc_request& request);
 
-  /// Copy a new request_info (using the pool)
+  /// Copy a new request_info (using m_allocator)
   request_info *copy_request_info(const request_info& info);
 
   /// Delete an request_info (return it to the pool)
   void delete_request_info(request_info*& p_request_info);
 
-  /// Get a new response_info (from the pool)
+  /// Get a new response_info (from m_allocator)
   response_info *new_response_info(const xtsc::xtsc_response& response);
 
-  /// Get a new response_info (from the pool)
+  /// Get a new response_info (from m_allocator)
   response_info *new_response_info(const xtsc::xtsc_request& request);
 
   /// Delete an response_info (return it to the pool)
@@ -1338,7 +1358,7 @@ protected:
   /// Apply address translation if applicable
   xtsc::xtsc_address translate(xtsc::u32 port_num, xtsc::xtsc_address address8);
 
-  /// Get a new req_rsp_info (from the pool)
+  /// Get a new req_rsp_info (from m_allocator)
   req_rsp_info *new_req_rsp_info(request_info *first_request_info);
 
   /// Delete an req_rsp_info (return it to the pool)
@@ -1357,6 +1377,7 @@ protected:
 
   std::deque<request_info*>             **m_request_deques;             ///<  Buffer requests from multiple masters in peekable deque's
   sc_core::sc_fifo<int>                 **m_request_fifos;              ///<  Use sc_fifo to ensure determinancy
+  std::vector<xtsc::u64>                  m_pending_requests;           ///<  Bit N set when port N has requests in m_request_deques
   sc_core::sc_fifo<response_info*>        m_response_fifo;              ///<  Buffer responses from single slave
   sc_core::sc_fifo<request_info*>        *m_phase_delay_fifo;           ///<  Buffer requests being delayed to align their phase
   request_info                           *m_p_apb_request_info;         ///<  Active APB request
@@ -1444,9 +1465,7 @@ protected:
   sc_core::sc_event                       m_align_request_phase_thread_event;
                                                                         ///<  To notify align_request_phase_thread
 
-  std::vector<req_rsp_info*>              m_req_rsp_info_pool;          ///<  Maintain a pool of req_rsp_info to improve performance
-  std::vector<request_info*>              m_request_pool;               ///<  Maintain a pool of requests to improve performance
-  std::vector<response_info*>             m_response_pool;              ///<  Maintain a pool of responses to improve performance
+  xtsc_allocator_client                   m_allocator;                  ///<  For request_info, response_info, and req_rsp_info
 
   std::vector<std::vector<xtsc::xtsc_address_range_entry*>*>
                                           m_translation_tables;         ///<  One table of address translations for each master
@@ -16,6 +16,8 @@
 
 
 #include <xtsc/xtsc_memory.h>
+#include <map>
+#include <set>
 
 
 namespace xtsc_component {
@@ -52,11 +54,26 @@ namespace xtsc_component {
 
    "replacement_policy"  char*  This parameter defines the strategy for selecting a
                                 line to replace. Valid values are RANDOM for random,
-                                RR for round-robin, and LRU for least-recently used
-                                replacement policies. Note: RANDOM policy is generally
-                                used for internal tests only.
+                                RR for round-robin, LRU for least-recently used, and
+                                PLRU for tree pseudo-LRU replacement policies.  The
+                                LRU policy updates a counter for every line in the
+                                set on each access while the PLRU policy only updates
+                                log2("num_ways") bits, so PLRU is recommended for
+                                highly-associative and fully-associative caches.
+                                PLRU requires the number of ways to be a power of 2.
+                                Note: RANDOM policy is generally used for internal
+                                tests only.
                                 Default = RR.
 
+   "tag_index_ways"      u32    If the number of ways in each set is greater than or
+                                equal to this parameter, a tag-to-way index is kept
+                                for each set so that hits and free lines are found
+                                without scanning every line in the set.  This
+                                speeds up highly-associative and fully-associative
+                                caches at the cost of some host memory per line.
+                                A value of 0 disables the index.
+                                Default = 16.
+
    "read_allocate"       bool   If true, the cache line is allocated on a read miss.
                                 Default = true.
 
@@ -167,6 +184,7 @@ public:
     add("profile_cache",       false);
     add("use_pif_attribute",   false);
     add("bypass_delay",        1);
+    add("tag_index_ways",      16);
 
     // Modify xtsc_memory_parm
     set("use_raw_access",      false);
@@ -215,7 +233,8 @@ public:
   typedef enum replacement_policy_t {
     REPL_RANDOM   = 0,
     REPL_RR       = 1,
-    REPL_LRU      = 2
+    REPL_LRU      = 2,
+    REPL_PLRU     = 3
   } replacement_policy_t;
 
   // SystemC needs this.
@@ -459,6 +478,9 @@ protected:
   /// Return the replaced way number based on the LRU policy
   xtsc::u32 find_replace_lru(xtsc::u32 set_num);
 
+  /// Return the replaced way number based on the tree pseudo-LRU policy
+  xtsc::u32 find_replace_plru(xtsc::u32 set_num);
+
   /// Return the replaced way number based on the Random policy
   xtsc::u32 find_replace_random(xtsc::u32 set_num);
 
@@ -478,7 +500,10 @@ protected:
   void clear_dirty(xtsc::u32 set_num, xtsc::u32 way_num) { m_lines[set_num][way_num].dirty = false; }
 
   /// Clear a cache line's valid bit
-  void clear_valid(xtsc::u32 set_num, xtsc::u32 way_num) { m_lines[set_num][way_num].valid = false; }
+  void clear_valid(xtsc::u32 set_num, xtsc::u32 way_num) {
+    if (m_tag_index && m_lines[set_num][way_num].valid) unindex_line(set_num, way_num);
+    m_lines[set_num][way_num].valid = false;
+  }
 
   /// Return the tag of the address
   xtsc::xtsc_address get_tag(xtsc::xtsc_address address) const { return address >> m_tag_shift; }
@@ -514,13 +539,26 @@ protected:
   bool is_write_back(xtsc::u32 pif_attribute) const { return (pif_attribute & WRITE_BACK); }
 
   /// Set a cache line's tag bits
-  void set_tag(xtsc::xtsc_address tag, xtsc::u32 set_num, xtsc::u32 way_num) { m_lines[set_num][way_num].tag = tag; }
+  void set_tag(xtsc::xtsc_address tag, xtsc::u32 set_num, xtsc::u32 way_num) {
+    if (m_tag_index && m_lines[set_num][way_num].valid) unindex_line(set_num, way_num);
+    m_lines[set_num][way_num].tag = tag;
+    if (m_tag_index && m_lines[set_num][way_num].valid) index_line(set_num, way_num);
+  }
 
   /// Set a cache line's dirty bit
   void set_dirty(xtsc::u32 set_num, xtsc::u32 way_num) { m_lines[set_num][way_num].dirty = true; }
 
   /// Set a cache line's valid bit
-  void set_valid(xtsc::u32 set_num, xtsc::u32 way_num) { m_lines[set_num][way_num].valid = true; }
+  void set_valid(xtsc::u32 set_num, xtsc::u32 way_num) {
+    if (m_tag_index && !m_lines[set_num][way_num].valid) index_line(set_num, way_num);
+    m_lines[set_num][way_num].valid = true;
+  }
+
+  /// Add a line which is becoming valid to m_tag_index and remove it from m_invalid_ways
+  void index_line(xtsc::u32 set_num, xtsc::u32 way_num);
+
+  /// Remove a line which is becoming invalid from m_tag_index and add it to m_invalid_ways
+  void unindex_line(xtsc::u32 set_num, xtsc::u32 way_num);
 
   /// Update the LRF bit of a cache line
   void update_lrf(xtsc::u32 set_num, xtsc::u32 way_num) { m_lines[set_num][way_num].lrf = !m_lines[set_num][way_num].lrf; }
@@ -528,6 +566,17 @@ protected:
   /// Update the LRU bits of a cache line
   void update_lru(xtsc::u32 set_num, xtsc::u32 ref);
 
+  /// Update the tree pseudo-LRU bits of a set so they point away from the specified way
+  void update_plru(xtsc::u32 set_num, xtsc::u32 way_num);
+
+  /// Update the LRU or PLRU state (if either is selected) when a line is accessed or allocated
+  void touch_line(xtsc::u32 set_num, xtsc::u32 way_num) {
+    if (m_lru_selected)
+      update_lru(set_num, m_lru[set_num][way_num]);
+    else if (m_plru_selected)
+      update_plru(set_num, way_num);
+  }
+
   /* External memory PIF interface implementation */
   xtsc_respond_if_impl          m_respond_impl;                         ///< m_respond_export binds to this
   xtsc::xtsc_request            m_request;                              ///< For sending system memory requests
@@ -554,16 +603,23 @@ protected:
   bool                          m_profile_cache;                        ///< See "profile_cache"
   bool                          m_use_pif_attribute;                    ///< See "use_pif_attribute"
   sc_core::sc_time              m_bypass_delay;                         ///< See "bypass_delay"
+  xtsc::u32                     m_tag_index_ways;                       ///< See "tag_index_ways"
 
   struct line_info            **m_lines;                                ///< Cache lines, includes the address tag and status bits
   xtsc::u32                   **m_lru;                                  ///< Least-recently used (LRU) counters
   bool                          m_lru_selected;                         ///< Indicates if LRU policy is selected
+  xtsc::u8                    **m_plru;                                 ///< Tree pseudo-LRU bits, m_num_ways-1 nodes per set
+  bool                          m_plru_selected;                        ///< Indicates if PLRU policy is selected
+  std::map<xtsc::xtsc_address, xtsc::u32>
+                               *m_tag_index;                            ///< Per set: tag to way of each valid line (NULL if not indexed)
+  std::set<xtsc::u32>          *m_invalid_ways;                         ///< Per set: ways of the invalid lines (NULL if not indexed)
   xtsc::u32                     m_access_byte_width;                    ///< A copy of "byte_width"
   xtsc::u32                     m_num_lines;                            ///< Total number of cache lines
   xtsc::u32                     m_num_sets;                             ///< Total number of cache sets
   xtsc::u32                     m_line_access_ratio;                    ///< The number of access words in a cache line
   xtsc::u32                     m_set_byte_size;                        ///< Total number of bytes in a set
   xtsc::u32                     m_num_sets_log2;                        ///< Log2 of m_num_sets
+  xtsc::u32                     m_num_ways_log2;                        ///< Log2 of m_num_ways (used by PLRU)
   xtsc::u32                     m_line_byte_width_log2;                 ///< Log2 of m_line_byte_width
   xtsc::u32                     m_tag_shift;                            ///< Shift value to calculate address tag
   xtsc::u32                     m_set_shift;                            ///< Shift value to calculate set index
@@ -20,6 +20,8 @@
 #include <vector>
 #include <map>
 #include <deque>
+#include <sstream>
+#include <iomanip>
 
 
 
@@ -290,12 +292,12 @@ class xtsc_lookup_driver;
                                 first function should return the lookup data as a Lua
                                 whole number or a Lua string which can be converted to a
                                 whole number.  The second function should return the
-                                delay as a Lua whole number.  The values returned by the
-                                Lua functions are not cached by the model, instead, the
-                                functions are called each time a lookup is performed.
-                                This provides a dynamic lookup capability.  If
-                                lua_function is specified then the "default_data"
-                                parameter is not used.
+                                delay as a Lua whole number.  Unless "cache_lua_results"
+                                is true, the values returned by the Lua functions are
+                                not cached by the model, instead, the functions are
+                                called each time a lookup is performed.  This provides a
+                                dynamic lookup capability.  If lua_function is specified
+                                then the "default_data" parameter is not used.
 
                                 Here is an example "lookup_table" file using both line
                                 formats and including the required Lua snippet:
@@ -308,6 +310,14 @@ class xtsc_lookup_driver;
                                   0 1   // floor(e^0) = 1
                                   1 2   // floor(e^1) = 2
 
+   "cache_lua_results"  bool    If true, the values returned by the Lua functions named
+                                on the lua_function line of the "lookup_table" file are
+                                memoized per lookup address so that each function is
+                                only called once for any given address.  This should
+                                only be used if the Lua functions are pure.  The cache
+                                is cleared when the lookup is reset.
+                                Default = false.
+
    "default_data"       char*   C-string containing the default data.  If "ram" is
                                 false, this value will be returned for any lookup
                                 address not specified (explicitly or implicitly) in
@@ -457,6 +467,7 @@ public:
     add("latency",              1);
     add("delay",                0);
     add("lookup_table",         lookup_table);
+    add("cache_lua_results",    false);
     add("default_data",         default_data);
     add("clock_period",         0xFFFFFFFF);
     add("posedge_offset",       0xFFFFFFFF);
@@ -808,6 +819,131 @@ protected:
 
 
 
+  /**
+   * Table of values indexed by a lookup (or RAM) address.
+   *
+   * Addresses of up to m_dense_address_bits bits index a dense array, addresses of up to
+   * 64 bits are keyed by their integer value, and wider addresses are keyed by their hex
+   * string (formatted as "0x" followed by one digit per nibble of the address width).
+   */
+  template <typename T>
+  class address_table {
+  public:
+
+    /// Constructor
+    address_table() : m_address_bits(0), m_integer(false), m_dense(false) {}
+
+    /// Set the address bit width and remove all entries
+    void configure(xtsc::u32 address_bits) {
+      m_address_bits = address_bits;
+      m_integer      = (address_bits <= 64);
+      m_dense        = (address_bits <= m_dense_address_bits);
+      clear();
+    }
+
+    /// Remove all entries
+    void clear() {
+      m_integer_map.clear();
+      m_string_map.clear();
+      if (m_dense) {
+        m_dense_values .assign(1U << m_address_bits, T());
+        m_dense_present.assign(1U << m_address_bits, false);
+      }
+    }
+
+    /// Return a pointer to the value at address or NULL if there is none
+    T *find(const sc_dt::sc_unsigned& address) {
+      if (m_integer) return find(address.to_uint64());
+      typename std::map<std::string, T>::iterator i = m_string_map.find(to_string(address));
+      return (i == m_string_map.end()) ? NULL : &i->second;
+    }
+
+    /// Return a pointer to the value at address (a hex string as accepted by peek/poke) or NULL if there is none
+    T *find(const std::string& address) {
+      if (!m_integer) {
+        typename std::map<std::string, T>::iterator i = m_string_map.find(address);
+        return (i == m_string_map.end()) ? NULL : &i->second;
+      }
+      return find(xtsc::xtsc_strtou64(address));
+    }
+
+    /// Set the value at address, return a reference to the stored value
+    T& insert(const sc_dt::sc_unsigned& address, const T& value) {
+      if (!m_integer) return (m_string_map[to_string(address)] = value);
+      return insert(address.to_uint64(), value);
+    }
+
+    /// Set the value at address (a hex string as accepted by peek/poke), return a reference to the stored value
+    T& insert(const std::string& address, const T& value) {
+      if (!m_integer) return (m_string_map[address] = value);
+      return insert(xtsc::xtsc_strtou64(address), value);
+    }
+
+    /// Append all entries in address order with the address formatted as a hex string
+    void get_entries(std::vector<std::pair<std::string, T> >& entries) const {
+      if (m_dense) {
+        for (xtsc::u32 i = 0; i < m_dense_values.size(); ++i) {
+          if (m_dense_present[i]) entries.push_back(std::make_pair(to_string(i), m_dense_values[i]));
+        }
+      }
+      for (typename std::map<xtsc::u64, T>::const_iterator i = m_integer_map.begin(); i != m_integer_map.end(); ++i) {
+        entries.push_back(std::make_pair(to_string(i->first), i->second));
+      }
+      for (typename std::map<std::string, T>::const_iterator i = m_string_map.begin(); i != m_string_map.end(); ++i) {
+        entries.push_back(*i);
+      }
+    }
+
+  private:
+
+    /// Return a pointer to the value at integer address key or NULL if there is none
+    T *find(xtsc::u64 key) {
+      if (m_dense && (key < m_dense_values.size())) {
+        return m_dense_present[key] ? &m_dense_values[key] : NULL;
+      }
+      typename std::map<xtsc::u64, T>::iterator i = m_integer_map.find(key);
+      return (i == m_integer_map.end()) ? NULL : &i->second;
+    }
+
+    /// Set the value at integer address key (keys beyond the dense array only come from peek/poke)
+    T& insert(xtsc::u64 key, const T& value) {
+      if (m_dense && (key < m_dense_values.size())) {
+        m_dense_present[key] = true;
+        return (m_dense_values[key] = value);
+      }
+      return (m_integer_map[key] = value);
+    }
+
+    /// Format an integer address as a hex string
+    std::string to_string(xtsc::u64 key) const {
+      std::ostringstream oss;
+      oss << "0x" << std::hex << std::setfill('0') << std::setw((m_address_bits + 3) / 4) << key;
+      return oss.str();
+    }
+
+    /// Format an sc_unsigned address as a hex string
+    std::string to_string(const sc_dt::sc_unsigned& address) const {
+      if ((xtsc::u32) address.length() != m_address_bits) {
+        sc_dt::sc_unsigned resized(m_address_bits);
+        resized = address;
+        return to_string(resized);
+      }
+      return "0x" + address.to_string(sc_dt::SC_HEX).substr(m_address_bits%4 ? 2 : 3);
+    }
+
+    xtsc::u32                           m_address_bits;         ///<  Address bit width
+    bool                                m_integer;              ///<  True if addresses are keyed by integer value
+    bool                                m_dense;                ///<  True if addresses index m_dense_values
+    std::vector<T>                      m_dense_values;         ///<  Values indexed by address (if m_dense)
+    std::vector<bool>                   m_dense_present;        ///<  True for each address in m_dense_values that has a value
+    std::map<xtsc::u64, T>              m_integer_map;          ///<  Values keyed by address (if m_integer and not in m_dense_values)
+    std::map<std::string, T>            m_string_map;           ///<  Values keyed by hex address string (if not m_integer)
+  };
+
+
+  /// Addresses of up to this many bits are stored in a dense array by address_table
+  static const xtsc::u32                m_dense_address_bits    = 16;
+
   xtsc_lookup_if_impl                   m_lookup_impl;          ///<  m_lookup binds to this
 
   xtsc_lookup_parms                     m_lookup_parms;         ///< Copy of xtsc_lookup_parms
@@ -839,14 +975,16 @@ protected:
   std::string                           m_lua_data_function;    ///<  From <LuaDataFunction>  in lua_function line of "lookup_table" file
   std::string                           m_lua_delay_function;   ///<  From <LuaDelayFunction> in lua_function line of "lookup_table" file
   bool                                  m_lua_function;         ///<  True if there was a lua_function line in "lookup_table" file
+  bool                                  m_cache_lua_results;    ///<  From "cache_lua_results" parameter
+  address_table<sc_dt::sc_unsigned*>    m_lua_data_cache;       ///<  Memoized <LuaDataFunction> results
+  address_table<xtsc::u32>              m_lua_delay_cache;      ///<  Memoized <LuaDelayFunction> results
   bool                                  m_file_logged;          ///<  True if contents of m_file have been logged
   xtsc::xtsc_script_file               *m_file;                 ///<  The lookup_file
   std::string                           m_line;                 ///<  Current line from m_file
   xtsc::u32                             m_line_count;           ///<  Current line number from m_file
   std::vector<std::string>              m_words;                ///<  Current line tokenized into words
-  std::map<std::string, sc_dt::sc_unsigned*>
-                                        m_data_map;             ///<  The lookup table
-  std::map<std::string, xtsc::u32>      m_delay_map;            ///<  Delay associated with each address
+  address_table<sc_dt::sc_unsigned*>    m_data_map;             ///<  The lookup table
+  address_table<xtsc::u32>              m_delay_map;            ///<  Delay associated with each address
   sc_dt::sc_unsigned                    m_data;                 ///<  Current request data
   sc_dt::sc_unsigned                    m_data_temp;            ///<  To hold data temporarily
   sc_dt::sc_unsigned                    m_old_data;             ///<  Data previously at current request address
@@ -18,6 +18,8 @@
 #include <xtsc/xtsc_response.h>
 #include <xtsc/xtsc_parms.h>
 #include <xtsc/xtsc_memory_b.h>
+#include <xtsc/xtsc_memory_checkpoint.h>
+#include <xtsc/xtsc_slab_allocator.h>
 #include <cstring>
 #include <vector>
 #include <list>
@@ -313,6 +315,42 @@ class xtsc_router;
                                                     // The byte at offset 0x1002 is 52
                              
 
+   "elf_file"             char* If not NULL or empty, this names an ELF file (32 or 64
+                                bit, little or big endian) whose PT_LOAD segments are
+                                loaded into this memory after "initial_value_file" is
+                                processed.  Each segment is loaded at its physical
+                                address (p_paddr).  Any part of a segment which falls
+                                outside this memory is ignored, so the same ELF file can
+                                be given to every memory of a system.  The bytes between
+                                p_filesz and p_memsz are set to zero.
+                                Note: "elf_file" should not be set when
+                                "host_shared_memory" is true.
+                                Default = NULL.
+
+   "binary_file"          char* If not NULL or empty, this names a file whose raw bytes
+                                are loaded into this memory, starting at
+                                "binary_file_offset", after "initial_value_file" and
+                                "elf_file" are processed.  Bytes which would fall past
+                                the end of this memory are ignored.
+                                Note: "binary_file" should not be set when
+                                "host_shared_memory" is true.
+                                Default = NULL.
+
+   "binary_file_offset"   u64   The offset from "start_byte_address" at which the first
+                                byte of "binary_file" is loaded.
+                                Default = 0.
+
+                                Note: "elf_file" and "binary_file" are mapped into the
+                                host address space using mmap() (on Linux) and copied 
+                                page-by-page directly into memory storage instead of
+                                being parsed.  If "mmap_storage" is true and
+                                "mmap_huge_pages" is 0, then the whole host pages of
+                                the file are mapped copy-on-write straight into the
+                                backing store so they are shared with the host page
+                                cache until they are written.  The number of bytes
+                                loaded and the load throughput are reported in the
+                                construction log.
+
    "memory_fill_byte"     u32   The low byte specifies the value used to initialize 
                                 memory contents at address locations not initialize
                                 from "initial_value_file".
@@ -330,6 +368,35 @@ class xtsc_router;
                                 "lua_script_file_eoe" in xtsc:xtsc_initialize_parms.
                                 Default = false.
 
+   "mmap_storage"         bool  If true, the backing store for the whole memory is
+                                reserved up front with a single anonymous mmap() call
+                                using MAP_NORESERVE (so host memory is only committed
+                                for pages which are actually touched) and every page of
+                                the xtsc::xtsc_memory_b page table is pointed into it.
+                                Address translation then becomes a single add, peek and
+                                poke are a single memcpy, and raw fast access is granted
+                                on the whole memory (in 2GB blocks if the memory is
+                                larger than that) instead of on one page at a time.
+                                This is intended for multi-GB memories.  A non-zero
+                                "memory_fill_byte" is supported but causes the whole
+                                memory to be written (and so committed) on each hard
+                                reset.  This parameter is not supported on MS Windows
+                                and cannot be true when "host_shared_memory" is true.
+                                Default = false.
+
+   "mmap_huge_pages"      u32   When "mmap_storage" is true, this parameter specifies
+                                whether host huge pages should be used for the backing
+                                store:
+                                  0 => Use normal host pages.
+                                  1 => Use transparent huge pages (madvise() with
+                                       MADV_HUGEPAGE).  This is only a hint to the OS.
+                                  2 => Use explicit huge pages (mmap() with
+                                       MAP_HUGETLB).  The host must have enough huge
+                                       pages reserved (for example, by writing to
+                                       /proc/sys/vm/nr_hugepages).
+                                This parameter is ignored if "mmap_storage" is false.
+                                Default = 0.
+
    "interval_size"        u64   The number of cycles of this instance's clock period
                                 that are used to determine the duration of an interval
                                 while computing the statistical summary for this 
@@ -941,8 +1008,13 @@ public:
     add("secure_address_range", secure_address_range);
     add("page_byte_size",       1024*16);
     add("initial_value_file",   (char*)NULL);
+    add("elf_file",             (char*)NULL);
+    add("binary_file",          (char*)NULL);
+    add("binary_file_offset",   (xtsc::u64)0);
     add("memory_fill_byte",     0);
     add("host_shared_memory",   false);
+    add("mmap_storage",         false);
+    add("mmap_huge_pages",      0);
     add("interval_size",        (xtsc::u64)1000000);
     add("host_mutex",           false);
     add("shared_memory_name",   (char*)NULL);
@@ -1103,14 +1175,27 @@ public:
    * Non-hardware reads (for example, reads by the debugger).
    * @see xtsc::xtsc_request_if::nb_peek
    */
-  virtual void peek(xtsc::xtsc_address address8, xtsc::u32 size8, xtsc::u8 *buffer) { m_p_memory->peek(address8, size8, buffer); }
+  virtual void peek(xtsc::xtsc_address address8, xtsc::u32 size8, xtsc::u8 *buffer) {
+    if (m_mmap_base && (address8 >= m_start_address8) && (address8 <= m_end_address8) && (size8 <= m_end_address8 - address8 + 1)) {
+      memcpy(buffer, m_mmap_base + (address8 - m_start_address8), size8);
+      return;
+    }
+    m_p_memory->peek(address8, size8, buffer);
+  }
 
 
   /**
    * Non-hardware writes (for example, writes from the debugger).
    * @see xtsc::xtsc_request_if::nb_poke
    */
-  virtual void poke(xtsc::xtsc_address address8, xtsc::u32 size8, const xtsc::u8 *buffer) { m_p_memory->poke(address8, size8, buffer); }
+  virtual void poke(xtsc::xtsc_address address8, xtsc::u32 size8, const xtsc::u8 *buffer) {
+    if (m_p_checkpoint) { m_p_checkpoint->before_write(address8, size8); }
+    if (m_mmap_base && (address8 >= m_start_address8) && (address8 <= m_end_address8) && (size8 <= m_end_address8 - address8 + 1)) {
+      memcpy(m_mmap_base + (address8 - m_start_address8), buffer, size8);
+      return;
+    }
+    m_p_memory->poke(address8, size8, buffer);
+  }
 
 
   /**
@@ -1192,6 +1277,37 @@ public:
   void reset(bool hard_reset = false);
 
 
+  /**
+   * Save a copy-on-write checkpoint of the memory contents (any previous checkpoint is
+   * discarded).  No memory contents are copied by this call; instead, each page is
+   * copied the first time it is about to be modified afterwards.  While a checkpoint is
+   * active, a "use_raw_access" request for TurboXim fast access is granted callback
+   * access instead so that writes can be seen, and any pages that were granted raw
+   * access before this call are copied immediately.  A hard reset while a checkpoint
+   * is active copies every allocated page.
+   *
+   * Note: Only the memory contents are checkpointed (not, for example, exclusive
+   * monitors, pending requests, or statistics).
+   *
+   * @see xtsc_memory_checkpoint
+   */
+  void checkpoint_save();
+
+
+  /**
+   * Restore the memory contents to what they were when checkpoint_save() was called.
+   * The cost is proportional to the number of pages modified since then.  The
+   * checkpoint remains active so it can be restored again.
+   *
+   * @returns the number of pages restored.
+   */
+  xtsc::u32 checkpoint_restore();
+
+
+  /// Discard the checkpoint (if any)
+  void checkpoint_discard();
+
+
   /**
    * Set whether or not exlusive access requests are supported.
    *
@@ -1204,7 +1320,7 @@ public:
   /**
    * Top level Function to display statistical summary for a simulation
    */
-  void summary(std::ostream& os);
+  virtual void summary(std::ostream& os);
 
 
   /**
@@ -1264,6 +1380,11 @@ public:
           Call xtsc_memory::change_clock_period(<ClockPeriodFactor>).  Return previous
           <ClockPeriodFactor> for this device.
 
+        checkpoint save|restore|discard
+          Call xtsc_memory::checkpoint_save(), xtsc_memory::checkpoint_restore(), or
+          xtsc_memory::checkpoint_discard().  For restore, return the number of pages
+          restored.
+
         dump <StartAddress> <NumBytes>
           Dump <NumBytes> of memory starting at <StartAddress> (includes header and
           printable ASCII column).
@@ -1843,6 +1964,10 @@ protected:
   void check_exclusive_monitors_against_write(xtsc::xtsc_request &request, xtsc::xtsc_address address8, xtsc::u32 size8);
 
 
+  /// Add (if add is true) or remove the specified exclusive monitor from m_exclusive_granule_map
+  void index_exclusive_monitor(xtsc::u64 tran_id, xtsc::xtsc_address monitor_beg, xtsc::xtsc_address monitor_end, bool add);
+
+
   /// Return the exact request type of this request
   request_type_t get_request_type(const xtsc::xtsc_request& request, xtsc::u32 port_num);
 
@@ -1919,14 +2044,22 @@ protected:
   void send_response(xtsc::u32 port_num, bool log_data_binary);
 
 
-  /// Get a new request_info (from the pool)
+  /// Get a new request_info (from m_request_info_allocator)
   request_info *new_request_info(const xtsc::xtsc_request& request, xtsc::xtsc_response::status_t status, bool list);
 
 
-  /// Delete an request_info (return it to the pool)
+  /// Delete an request_info (return it to m_request_info_allocator)
   void delete_request_info(request_info*& p_request_info);
 
 
+  /// Get a new xtsc_response (from m_response_allocator)
+  xtsc::xtsc_response *new_response(const xtsc::xtsc_request& request);
+
+
+  /// Delete an xtsc_response (return it to m_response_allocator)
+  void delete_response(xtsc::xtsc_response*& p_response);
+
+
   /// Get the object to use for fast access implemented through CALLBACKS
   xtsc::xtsc_fast_access_if *get_fast_access_object() const;
 
@@ -1977,10 +2110,61 @@ protected:
    * @see xtsc::xtsc_memory_b::load_initial_values
    */
   void load_initial_values() {
-    m_p_memory->load_initial_values();
+    if (m_mmap_base) {
+      load_initial_values_into_mmap_storage();
+    }
+    else {
+      m_p_memory->load_initial_values();
+    }
+    load_image_files();
   }
 
 
+  /**
+   * Load "elf_file" and "binary_file" (if any) and update m_image_bytes_loaded and
+   * m_image_load_seconds.
+   */
+  void load_image_files();
+
+
+  /**
+   * Load the bytes of one file image.
+   *
+   * @param file_name           The name of the file (used in exception messages).
+   *
+   * @param is_elf              True if file_name is an ELF file, false if it is a raw
+   *                            binary to be loaded at "binary_file_offset".
+   *
+   * @returns the number of bytes written into this memory.
+   */
+  xtsc::u64 load_image_file(const std::string& file_name, bool is_elf);
+
+
+  /**
+   * Write size8 bytes starting at address8 (which must all be within this memory) from
+   * p_data or, if p_data is NULL, write zeroes.  If fd is not negative and "mmap_storage"
+   * is active without huge pages, then any whole host pages are mapped copy-on-write
+   * from fd starting at file_offset instead of being copied.
+   */
+  void load_image_bytes(xtsc::xtsc_address address8, const xtsc::u8 *p_data, xtsc::u64 size8, int fd, xtsc::u64 file_offset);
+
+
+  /// Reserve the "mmap_storage" backing store and point every page of the page table into it
+  void create_mmap_storage(xtsc::u32 mmap_huge_pages);
+
+
+  /// Release the "mmap_storage" backing store and give the page table back to xtsc::xtsc_memory_b
+  void destroy_mmap_storage();
+
+
+  /**
+   * Implementation of load_initial_values() when "mmap_storage" is true.  The backing
+   * store is returned to the OS (so it reads as zero) and refilled, and any pages
+   * loaded by xtsc::xtsc_memory_b from "initial_value_file" are copied into it.
+   */
+  void load_initial_values_into_mmap_storage();
+
+
   /// Get the page of memory containing address8 (allocate as needed). 
   xtsc::u32 get_page(xtsc::xtsc_address address8) {
     return m_p_memory->get_page(address8);
@@ -2007,6 +2191,7 @@ protected:
 
   /// Helper method to write a u8 value (allocate as needed).
   virtual void write_u8(xtsc::xtsc_address address8, xtsc::u8 value) {
+    if (m_p_checkpoint) { m_p_checkpoint->before_write(address8, 1); }
     m_p_memory->write_u8(address8, value);
   }
 
@@ -2019,6 +2204,7 @@ protected:
 
   /// Helper method to write a u32 value (allocate as needed).
   virtual void write_u32(xtsc::xtsc_address address8, xtsc::u32 value, bool big_endian = false) {
+    if (m_p_checkpoint) { m_p_checkpoint->before_write(address8, 4); }
     m_p_memory->write_u32(address8, value, false);
   }
 
@@ -2090,6 +2276,10 @@ protected:
   std::string                           m_exclusive_line;               ///< "exclusive_script_file": Current line
   std::vector<std::string>              m_exclusive_words;              ///< "exclusive_script_file": words from current line 
   std::map<xtsc::u64, address_range>    m_exclusive_monitor_map;        ///< Map transaction ID to exclusive monitor address range
+  std::map<xtsc::xtsc_address, std::vector<xtsc::u64> >
+                                        m_exclusive_granule_map;        ///< Map 128-byte granule number to IDs of monitors overlapping it
+  xtsc::u64                             m_exclusive_monitor_hits;       ///< Writes which cleared at least one exclusive monitor
+  xtsc::u64                             m_exclusive_monitor_misses;     ///< Writes checked against exclusive monitors which cleared none
   statistics                          **m_statistics;                   ///< Capture profiling statistics on each port
   bool                                  m_summary;                      ///< See "summary" parameter, method, and command
   bool                                  m_support_exclusive;            ///< See "support_exclusive" parameter, method, and command
@@ -2117,11 +2307,26 @@ protected:
   bool                                  m_is_shared;                    ///< See IS_SHARED under "script_file" parameter
   bool                                  m_pass_dirty;                   ///< See PASS_DIRTY under "script_file" parameter
 
-  std::vector<request_info*>            m_request_pool;                 ///< Pool of requests
+  xtsc_allocator_client                 m_request_info_allocator;       ///< For request_info objects
+  xtsc_allocator_client                 m_response_allocator;           ///< For xtsc_response objects
+  xtsc_allocator_client                 m_user_data_allocator;          ///< For the buffer of USER_DATA script commands
 
   bool                                  m_host_shared_memory;           ///< See "host_shared_memory" parameter
   xtsc::u64                             m_interval_size;                ///< See "interval_size" parameter
   bool                                  m_host_mutex;                   ///< See "host_mutex" parameter
+  bool                                  m_mmap_storage;                 ///< See "mmap_storage" parameter
+  xtsc::u8                             *m_mmap_base;                    ///< Start of the "mmap_storage" backing store (or NULL)
+  xtsc::u64                             m_mmap_size8;                   ///< Byte size of the "mmap_storage" mapping
+  std::vector<xtsc::u8*>                m_mmap_owned_pages;             ///< Pages allocated by xtsc::xtsc_memory_b when "mmap_storage" is true
+  xtsc::u32                             m_mmap_huge_pages;              ///< See "mmap_huge_pages" parameter
+  std::string                           m_elf_file;                     ///< See "elf_file" parameter
+  std::string                           m_binary_file;                  ///< See "binary_file" parameter
+  xtsc::u64                             m_binary_file_offset;           ///< See "binary_file_offset" parameter
+  xtsc::u64                             m_image_bytes_loaded;           ///< Bytes written by the last load_image_files() call
+  double                                m_image_load_seconds;           ///< Host seconds taken by the last load_image_files() call
+  xtsc_memory_checkpoint               *m_p_checkpoint;                 ///< Created by the first checkpoint_save() call
+  std::map<xtsc::xtsc_address, xtsc::xtsc_address>
+                                        m_raw_access_blocks;            ///< Blocks granted TurboXim raw access (start => end address)
 
   bool                                  m_use_fast_access;              ///< For turboxim.  See "use_fast_access".
   std::vector<xtsc::u64>                m_deny_fast_access;             ///< For turboxim.  See "deny_fast_access".
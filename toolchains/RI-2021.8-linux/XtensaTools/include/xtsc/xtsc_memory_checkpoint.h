@@ -0,0 +1,133 @@
+#ifndef _XTSC_MEMORY_CHECKPOINT_H_
+#define _XTSC_MEMORY_CHECKPOINT_H_
+
+// Copyright (c) 2005-2018 by Cadence Design Systems, Inc.  ALL RIGHTS RESERVED.
+// These coded instructions, statements, and computer programs are the
+// copyrighted works and confidential proprietary information of Cadence Design Systems, Inc.
+// They may not be modified, copied, reproduced, distributed, or disclosed to
+// third parties in any manner, medium, or form, in whole or in part, without
+// the prior written consent of Cadence Design Systems, Inc.
+
+/**
+ * @file
+ */
+
+
+#include <xtsc/xtsc.h>
+#include <xtsc/xtsc_memory_b.h>
+#include <vector>
+
+
+
+namespace xtsc_component {
+
+
+/**
+ * A copy-on-write checkpoint of the contents of an xtsc::xtsc_memory_b.
+ *
+ * Calling save() does not copy any memory contents.  Instead, the contents of a page
+ * are copied into the checkpoint the first time the page is about to be modified after
+ * save() is called.  Calling restore() copies back just those pages, so its cost is
+ * proportional to the number of pages touched since save() was called instead of to
+ * the size of the memory.  A checkpoint can be restored any number of times.
+ *
+ * This class relies on its owner to call before_write() or before_write_page() on each
+ * of its write paths.  Writes which bypass the owner (for example, through TurboXim raw
+ * access or TLM2 DMI pointers) cannot be seen, so the owner must call preserve_range()
+ * for any range previously granted such write access when save() is called and must not
+ * grant such write access while is_active() returns true.
+ *
+ * Note: Checkpoints are not supported when the memory is using host OS shared memory.
+ *
+ * @see xtsc_memory
+ * @see xtsc_memory_tlm2
+ */
+class XTSC_COMP_API xtsc_memory_checkpoint {
+public:
+
+
+  /**
+   * Constructor for an xtsc_memory_checkpoint.
+   *
+   * @param     memory          The memory whose contents are to be checkpointed.
+   */
+  xtsc_memory_checkpoint(xtsc::xtsc_memory_b& memory);
+
+
+  /// Destructor.
+  ~xtsc_memory_checkpoint();
+
+
+  /**
+   * Start a new checkpoint of the current memory contents (any previous checkpoint is
+   * discarded).
+   */
+  void save();
+
+
+  /**
+   * Restore the memory contents to what they were when save() was called.  The
+   * checkpoint remains active.
+   *
+   * @returns the number of pages restored.
+   */
+  xtsc::u32 restore();
+
+
+  /// Discard the checkpoint (if any) and release the saved pages
+  void discard();
+
+
+  /// Return true if save() has been called and discard() has not been called since
+  bool is_active() const { return m_active; }
+
+
+  /// Call before modifying the bytes [address8, address8+size8-1] of the memory (out-of-range calls are ignored)
+  void before_write(xtsc::xtsc_address address8, xtsc::u32 size8) {
+    if (m_active && size8 && (address8 >= m_memory.m_start_address8) && (address8 + size8 - 1 <= m_memory.m_end_address8)) {
+      xtsc::u32 first = m_memory.get_page_id(address8);
+      xtsc::u32 last  = m_memory.get_page_id(address8 + size8 - 1);
+      for (xtsc::u32 page = first; page <= last; ++page) {
+        before_write_page(page);
+      }
+    }
+  }
+
+
+  /// Call before modifying the specified page of the memory (as returned by xtsc::xtsc_memory_b::get_page())
+  void before_write_page(xtsc::u32 page) {
+    if (m_active && !m_saved_pages[page]) {
+      preserve(page);
+    }
+  }
+
+
+  /// Preserve all pages overlapping the address range [low_address8, high_address8]
+  void preserve_range(xtsc::xtsc_address low_address8, xtsc::xtsc_address high_address8);
+
+
+  /// Preserve all currently allocated pages (for example, before reloading initial values)
+  void preserve_all();
+
+
+  /// Get the number of pages currently held by the checkpoint
+  xtsc::u32 get_num_saved_pages() const { return (xtsc::u32) m_saved_page_list.size(); }
+
+
+private:
+
+  /// Copy the current contents of the specified page into the checkpoint
+  void preserve(xtsc::u32 page);
+
+  xtsc::xtsc_memory_b&                  m_memory;                       ///< The memory being checkpointed
+  bool                                  m_active;                       ///< True between save() and discard()
+  std::vector<xtsc::u8*>                m_saved_pages;                  ///< Indexed by page number, NULL if not yet preserved
+  std::vector<xtsc::u32>                m_saved_page_list;              ///< The page numbers whose m_saved_pages entry is not NULL
+};
+
+
+
+}  // namespace xtsc_component
+
+
+#endif  // _XTSC_MEMORY_CHECKPOINT_H_
@@ -0,0 +1,322 @@
+#ifndef _XTSC_PARALLEL_BARRIER_H_
+#define _XTSC_PARALLEL_BARRIER_H_
+
+// Copyright (c) 2005-2018 by Cadence Design Systems, Inc.  ALL RIGHTS RESERVED.
+// These coded instructions, statements, and computer programs are the
+// copyrighted works and confidential proprietary information of Cadence Design Systems, Inc.
+// They may not be modified, copied, reproduced, distributed, or disclosed to
+// third parties in any manner, medium, or form, in whole or in part, without
+// the prior written consent of Cadence Design Systems, Inc.
+
+/**
+ * @file
+ */
+
+
+#include <xtsc/xtsc.h>
+#include <xtsc/xtsc_parms.h>
+#include <vector>
+
+
+
+namespace xtsc_component {
+
+
+class xtsc_queue;
+class xtsc_wire;
+
+
+/**
+ * Constructor parameters for a xtsc_parallel_barrier object.
+ *
+ *  \verbatim
+   Name                 Type    Description
+   ------------------   ----    --------------------------------------------------------
+
+   "num_processes"      u32     The number of OS processes taking part in the parallel
+                                simulation.  Each process must have exactly one
+                                xtsc_parallel_barrier constructed with the same
+                                "num_processes", "lookahead", "clock_period", and
+                                "shared_memory_name".
+                                Default = 2.
+
+   "process_index"      u32     The index of this process (from 0 to "num_processes"-1).
+                                Each process must use a different index.
+                                Default = 0.
+
+   "lookahead"          u32     The length of each synchronization window expressed in
+                                terms of this device's clock period.  No process
+                                simulates past the end of a window until all processes
+                                have reached the end of that window.  A queue push or
+                                pop or a wire write made in one process during a window
+                                becomes visible to the other processes at the end of
+                                that window, that is, between 0 and "lookahead" clock
+                                periods later.  So to be conservative, every channel
+                                added with add_channel() must model a latency of at
+                                least "lookahead" clock periods between the cores it
+                                connects, and "lookahead" must not exceed the smallest
+                                such latency.  Memory writes through an xtsc_memory
+                                with "host_shared_memory" true are not delayed, so
+                                cores in different processes should not communicate
+                                through shared xtsc_memory within a window.
+                                Default = 1000.
+
+   "clock_period"       u32     This is the length of this device's clock period
+                                expressed in terms of the SystemC time resolution
+                                (from sc_get_time_resolution()).  A value of
+                                0xFFFFFFFF means to use the XTSC system clock
+                                period (from xtsc_get_system_clock_period()).
+                                Default = 0xFFFFFFFF (i.e. use the system clock
+                                period).
+
+   "shared_memory_name" char*   The name of the host OS shared memory used to publish
+                                each process's progress.  If this parameter is left at
+                                its default setting of NULL, then the shared memory name
+                                will be formed by concatenating the user name, a period,
+                                and the module instance hierarchical name (so all
+                                processes must use the same instance name).
+                                Default = NULL (use default shared memory name)
+
+   "session_id"         u32     An identifier of this simulation run.  All processes of
+                                a run must use the same "session_id" and it should differ
+                                from the one used by the previous run with the same
+                                "shared_memory_name" (for example, the launcher could
+                                pass its own OS process ID to each process).  A process
+                                ignores the slot of another process until that slot
+                                carries this "session_id", so a barrier shared memory
+                                left over from an earlier run cannot release a barrier
+                                early.
+                                Default = 0.
+
+   "spin_count"         u32     The number of times the shared memory is polled while
+                                waiting at a barrier before the host CPU is yielded to
+                                other OS processes (the polling then continues).
+                                Default = 1000.
+
+    \endverbatim
+ *
+ * @see xtsc_parallel_barrier
+ * @see xtsc::xtsc_parms
+ */
+class XTSC_COMP_API xtsc_parallel_barrier_parms : public xtsc::xtsc_parms {
+public:
+
+  /**
+   * Constructor for an xtsc_parallel_barrier_parms object.
+   *
+   * @param     num_processes   See the "num_processes" parameter.
+   *
+   * @param     process_index   See the "process_index" parameter.
+   *
+   * @param     lookahead       See the "lookahead" parameter.
+   */
+  xtsc_parallel_barrier_parms(xtsc::u32 num_processes = 2, xtsc::u32 process_index = 0, xtsc::u32 lookahead = 1000) {
+    add("num_processes",        num_processes);
+    add("process_index",        process_index);
+    add("lookahead",            lookahead);
+    add("clock_period",         0xFFFFFFFF);
+    add("shared_memory_name",   (char*)NULL);
+    add("session_id",           0);
+    add("spin_count",           1000);
+  }
+
+
+  /// Return what kind of xtsc_parms this is (our C++ type)
+  virtual const char* kind() const { return "xtsc_parallel_barrier_parms"; }
+
+};
+
+
+
+/**
+ * A conservative time barrier for splitting one simulation into multiple OS processes.
+ *
+ * xtsc_memory, xtsc_queue, and xtsc_wire can be configured to use host OS shared memory
+ * (see their "host_shared_memory" parameter) so that, for example, a system with many
+ * cores can be partitioned into several OS processes which each simulate a subset of
+ * the cores on their own host processor core.  The shared memory only provides the
+ * storage, however, so nothing keeps the SystemC simulation times of the processes
+ * together.  This module does that.
+ *
+ * Simulation time is divided into windows of "lookahead" clock periods.  At the start
+ * of each window, this module calls xtsc::xtsc_set_relaxed_simulation_barrier() so that
+ * cores running in fast functional mode (TurboXim) do not run ahead past the end of the
+ * window.  At the end of each window, this module publishes its arrival in its slot
+ * of the barrier shared memory and then waits (without letting SystemC time advance)
+ * until every other process has arrived.  It then calls sync_host_shared_memory() on
+ * each channel added with add_channel() and waits a second time, until every other
+ * process has done the same, before starting the next window.  The second wait keeps a
+ * fast process from pushing, popping, or writing in the next window while a slow
+ * process is still taking its snapshot of the previous one, so what each channel sees
+ * at the end of a window does not depend on host scheduling.  Each slot is in its own
+ * cache line and is only written by its own process, so no locks are needed.  Each slot also carries the "session_id" of the process which owns it, so
+ * slots left over from an earlier run are ignored.  A process that finishes its simulation marks its slot as done so that the
+ * others are not blocked by it.
+ *
+ * Pushes, pops, and writes done by another process do not notify the SystemC events
+ * of the xtsc_queue and xtsc_wire objects in this process.  Use the add_channel()
+ * methods to have this module call their sync_host_shared_memory() method after each
+ * barrier.  add_channel() also tells the channel to hide pushes, pops, and writes done
+ * by other processes until that call, so each one reaches this process at the end of
+ * the window in which it was made (see the "lookahead" parameter for the channel
+ * latency this requires).
+ *
+ * Here is an example of the code in sc_main.cpp of process 1 of a 4-process simulation:
+ * \verbatim
+    xtsc_parallel_barrier_parms barrier_parms(4, 1, 500);
+    xtsc_parallel_barrier barrier("barrier", barrier_parms);
+    barrier.add_channel(core0_to_core4);        // xtsc_queue with "host_shared_memory" true
+    barrier.add_channel(core4_status);          // xtsc_wire  with "host_shared_memory" true
+   \endverbatim
+ *
+ * Note:  If "session_id" is left the same from one run to the next, the barrier shared
+ *        memory must be removed between runs (for example, by setting the
+ *        "unlink_host_shared_memory" parameter of xtsc::xtsc_initialize_parms).  A stale
+ *        slot belonging to this process with the same "session_id" is detected at
+ *        construction time.
+ *
+ * @see xtsc_parallel_barrier_parms
+ * @see xtsc_queue::sync_host_shared_memory()
+ * @see xtsc_wire::sync_host_shared_memory()
+ * @see xtsc::xtsc_set_relaxed_simulation_barrier()
+ */
+class XTSC_COMP_API xtsc_parallel_barrier :
+  public sc_core::sc_module,
+  public xtsc::xtsc_module,
+  public xtsc::xtsc_command_handler_interface
+{
+public:
+
+  SC_HAS_PROCESS(xtsc_parallel_barrier);
+
+
+  /// Our C++ type (SystemC uses this)
+  virtual const char* kind() const { return "xtsc_parallel_barrier"; }
+
+
+  /**
+   * Constructor for an xtsc_parallel_barrier.
+   *
+   * @param     module_name     Name of the xtsc_parallel_barrier sc_module.
+   *
+   * @param     barrier_parms   The remaining parameters for construction.
+   *
+   * @see xtsc_parallel_barrier_parms
+   */
+  xtsc_parallel_barrier(sc_core::sc_module_name module_name, const xtsc_parallel_barrier_parms& barrier_parms);
+
+
+  /// Destructor.
+  ~xtsc_parallel_barrier();
+
+
+  /// For xtsc_connection_interface (this module has no ports)
+  virtual xtsc::u32 get_bit_width(const std::string& port_name, xtsc::u32 interface_num = 0) const;
+
+
+  /// For xtsc_connection_interface (this module has no ports)
+  virtual sc_core::sc_object *get_port(const std::string& port_name);
+
+
+  /**
+   * Reset the xtsc_parallel_barrier.
+   *
+   * The window count cannot be rewound without the cooperation of the other processes,
+   * so this method only resets the statistics.
+   */
+  void reset(bool hard_reset = false);
+
+
+  /**
+   * Have sync_host_shared_memory() called on queue after each barrier and call its
+   * enable_barrier_sync() method.
+   *
+   * @param     queue           An xtsc_queue with "host_shared_memory" true whose
+   *                            producer or consumer is in another process.
+   */
+  void add_channel(xtsc_queue& queue);
+
+
+  /**
+   * Have sync_host_shared_memory() called on wire after each barrier and call its
+   * enable_barrier_sync() method.
+   *
+   * @param     wire            An xtsc_wire with "host_shared_memory" true whose writer
+   *                            or readers are in another process.
+   */
+  void add_channel(xtsc_wire& wire);
+
+
+  /// Return the number of windows completed by this process
+  xtsc::u64 get_num_windows() const { return m_window; }
+
+
+  /**
+   * Implementation of the xtsc::xtsc_command_handler_interface.
+   *
+   * This implementation supports the following commands:
+   *  \verbatim
+        status
+          Return this process's window count and the barrier phase published by each
+          process (twice the window count after the channels have been synced and one
+          less than that while waiting for the other processes to arrive).
+
+        reset
+          Call xtsc_parallel_barrier::reset().
+      \endverbatim
+   */
+  void execute(const std::string&               cmd_line,
+               const std::vector<std::string>&  words,
+               const std::vector<std::string>&  words_lc,
+               std::ostream&                    result);
+
+
+protected:
+
+  /// SystemC callback: publish that this process is done
+  void end_of_simulation();
+
+
+  /// Run a window, wait at the barrier, sync the channels, and wait again (forever)
+  void barrier_thread();
+
+
+  /// Publish phase and wait until all other processes have published it (or are done)
+  void arrive_and_wait(xtsc::u64 phase);
+
+
+  /// Return a pointer to the slot of the specified process (word 0 is its session ID, word 1 is its phase number)
+  xtsc::u64 *get_slot(xtsc::u32 process_index) const { return (xtsc::u64*) &m_p_shmem[process_index * SLOT_SIZE]; }
+
+
+  /// Return the phase number published by the specified process (0 if its slot is not from our session)
+  xtsc::u64 get_published_phase(xtsc::u32 process_index) const;
+
+
+  static const xtsc::u64 DONE = 0xFFFFFFFFFFFFFFFFull;      ///< Slot value of a process which has finished simulating
+  static const xtsc::u32 SLOT_SIZE = 64;                    ///< Bytes per slot (one host cache line)
+
+  log4xtensa::TextLogger&               m_text;                 ///< Text logger
+  xtsc::u32                             m_num_processes;        ///< See "num_processes" parameter
+  xtsc::u32                             m_process_index;        ///< See "process_index" parameter
+  xtsc::u32                             m_lookahead;            ///< See "lookahead" parameter
+  xtsc::u32                             m_session_id;           ///< See "session_id" parameter
+  xtsc::u32                             m_spin_count;           ///< See "spin_count" parameter
+  sc_core::sc_time                      m_clock_period;         ///< This device's clock period
+  sc_core::sc_time                      m_lookahead_time;       ///< m_lookahead * m_clock_period
+  std::string                           m_shmem_name;           ///< Shared Memory: name
+  xtsc::u8                             *m_p_shmem;              ///< Shared Memory: one slot per process
+  xtsc::u32                             m_shmem_total_size;     ///< Shared Memory: number of bytes in shared memory
+  xtsc::u64                             m_window;               ///< Number of windows completed by this process
+  xtsc::u64                             m_num_yields;           ///< Number of times the host CPU was yielded at a barrier
+  xtsc::u64                             m_num_channel_updates;  ///< Number of sync_host_shared_memory() calls which returned true
+  std::vector<xtsc_queue*>              m_queues;               ///< See add_channel(xtsc_queue&)
+  std::vector<xtsc_wire*>               m_wires;                ///< See add_channel(xtsc_wire&)
+};
+
+
+
+}  // namespace xtsc_component
+
+
+#endif  // _XTSC_PARALLEL_BARRIER_H_
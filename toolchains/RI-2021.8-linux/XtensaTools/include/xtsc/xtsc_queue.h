@@ -18,6 +18,7 @@
 #include <xtsc/xtsc_queue_push_if.h>
 #include <xtsc/xtsc_queue_pop_if.h>
 #include <vector>
+#include <set>
 
 
 
@@ -102,9 +103,9 @@ class xtsc_queue_consumer;
                                 construction time as host OS shared memory using
                                 shm_open() on Linux and CreateFileMapping() on
                                 MS Windows.  If this parameter is set true, then
-                                neither "pop_file" nor "push_file" may be used and
-                                neither "num_consumers" nor "num_producers" may
-                                exceed 1.
+                                neither "pop_file" nor "push_file" may be used and,
+                                unless "shared_memory_mpmc" is true, neither
+                                "num_consumers" nor "num_producers" may exceed 1.
                                 Default = false.
 
    "shared_memory_name"   char* The name of the host OS shared memory.  If this
@@ -115,6 +116,37 @@ class xtsc_queue_consumer;
                                 "host_shared_memory" is true.
                                 Default = NULL (use default shared memory name)
 
+   "shared_memory_mpmc" bool    If false, the host OS shared memory holds a single-
+                                producer/single-consumer ring:  "depth"+1 rows (each a
+                                64-bit ticket followed by the element data extended to a
+                                64-bit boundary) followed by the 32-bit read and write
+                                row indices.  If true, the host OS shared memory holds a
+                                lock-free multi-producer/multi-consumer ring which any
+                                number of producers and consumers (in this process via
+                                "num_producers" and "num_consumers", in other XTSC
+                                processes, or in non-XTSC host programs) can push to
+                                and pop from without locks:
+                                  Byte 0:    64-bit enqueue position (own cache line)
+                                  Byte 64:   64-bit dequeue position (own cache line)
+                                  Byte 128:  "depth" cells, each padded to a multiple
+                                             of 64 bytes and holding a 64-bit sequence
+                                             number, a 64-bit ticket (from
+                                             xtsc_create_queue_ticket()), and the
+                                             element data extended to a 64-bit
+                                             boundary.
+                                To push, a producer claims position P by atomically
+                                incrementing the enqueue position when cell P%"depth" has
+                                sequence number P, writes the ticket and data, and then
+                                stores P+1 to the sequence number (release).  To pop, a
+                                consumer claims position P by atomically incrementing
+                                the dequeue position when cell P%"depth" has sequence
+                                number P+1, reads the ticket and data, and then stores
+                                P+"depth" to the sequence number (release).  Sequence
+                                numbers are stored minus the cell index so that an
+                                all-zero shared memory is an empty queue.  This
+                                parameter is only used if "host_shared_memory" is true.
+                                Default = false.
+
    Note:  To cause xtsc_queue to function as a normal queue, set both "push_file"
           and "pop_file" parameter values to null (the default) or empty and 
           bind to both the xtsc_queue::m_producer and xtsc_queue::m_consumer ports.
@@ -141,7 +173,13 @@ class xtsc_queue_consumer;
           To use host OS shared memory for the queue, set "host_shared_memory" to true,
           do not set "pop_file" or "push_file", set "num_consumers" and "num_producers"
           to either 0 or 1, and ensure at most one process on the workstation writes to
-          the queue and at most one process reads from the queue.
+          the queue and at most one process reads from the queue (or set
+          "shared_memory_mpmc" to true to allow any number of each).  When the producer and
+          consumer are in different simulation processes, use xtsc_parallel_barrier to
+          keep the processes' simulation times together, to notify the queue events
+          when the other process pushes or pops, and to hold each such push or pop back
+          until the end of the barrier window in which it was made (so the queue must
+          model a latency of at least the barrier "lookahead").
 
    \endverbatim
  *
@@ -234,6 +272,7 @@ public:
     add("wraparound",           wraparound);
     add("host_shared_memory",   false);
     add("shared_memory_name",   (char*)NULL);
+    add("shared_memory_mpmc",   false);
   }
 
 
@@ -450,6 +489,10 @@ public:
   void drain_fifo_method();
 
 
+  /// To refill the fifo from the checkpoint once the space drained by checkpoint_restore() is free
+  void checkpoint_restore_method();
+
+
   /**
    * Dump the contents of the xtsc_queue.
    */
@@ -495,6 +538,79 @@ public:
   void poke(xtsc::u32 nth, const sc_dt::sc_unsigned& value);
 
 
+  /**
+   * Save a checkpoint of the queue contents (the elements, their tickets, and the most
+   * recent push and pop tickets).  Any previous checkpoint is discarded.  An exception
+   * is thrown if "push_file" or "pop_file" was specified, if "host_shared_memory" is
+   * true (the other process may be pushing or popping at any time), or if a
+   * checkpoint_restore() is still pending.
+   *
+   * Note: When there are multiple producers or consumers, elements which are in a skid
+   * or jerk buffer (that is, in transit for one delta cycle) are not included.
+   */
+  void checkpoint_save();
+
+
+  /**
+   * Restore the queue contents saved by checkpoint_save().  The checkpoint remains
+   * so it can be restored again.
+   *
+   * Note: The queue is emptied immediately but the saved elements cannot be put back
+   * into it until the space is freed (an sc_fifo does not free the space of elements
+   * read in the current delta cycle until its update phase).  Until the saved elements
+   * are back, which takes one or two delta cycles, every push and pop is refused (as
+   * if the queue were full and empty) and the no-longer-empty and no-longer-full
+   * events are notified when the restore completes.  Elements pushed in the same delta
+   * cycle before this call are discarded along with the rest of the queue contents.
+   *
+   * @returns the number of elements in the queue once the restore completes.
+   */
+  xtsc::u32 checkpoint_restore();
+
+
+  /// Discard the checkpoint (if any)
+  void checkpoint_discard();
+
+
+  /**
+   * When "host_shared_memory" is true, the producer and the consumer of this queue may
+   * be in different OS processes.  Pushes and pops done by the other process do not
+   * notify the events of this queue, so this method compares the host shared memory
+   * read and write indices (or, when "shared_memory_mpmc" is true, the dequeue and
+   * enqueue positions) against the values seen on the previous call and notifies the
+   * no-longer-empty and no-longer-full events accordingly.
+   *
+   * This method is typically called by xtsc_parallel_barrier after each barrier.
+   *
+   * @returns true if the other process pushed or popped since the previous call.  If
+   *          "host_shared_memory" is false, this method does nothing and returns false.
+   *
+   * @see xtsc_parallel_barrier
+   * @see enable_barrier_sync()
+   */
+  bool sync_host_shared_memory();
+
+
+  /**
+   * Make pushes and pops done by other processes visible to the producers and consumers
+   * of this queue only when sync_host_shared_memory() is called, instead of as soon as
+   * they reach host shared memory.  Until then, a consumer cannot pop an element pushed
+   * by another process and a producer cannot reuse a row freed by a pop in another
+   * process.  Pushes and pops done by this process are still visible at once.  This
+   * makes the delay through the queue between processes independent of how the host
+   * schedules them.
+   *
+   * When "shared_memory_mpmc" is true, this only orders pushes before the pops which
+   * remove them.  Producers in different processes still compete for the enqueue
+   * position (and consumers for the dequeue position) in host order.
+   *
+   * This method is called by xtsc_parallel_barrier::add_channel().
+   *
+   * @see xtsc_parallel_barrier
+   */
+  void enable_barrier_sync() { m_shmem_barrier_sync = true; }
+
+
   /// Implementation of the xtsc::xtsc_command_handler_interface.
   virtual void man(std::ostream& os);
 
@@ -510,6 +626,11 @@ public:
         can_push [<PushPort>]
           Return nb_can_push() for the specified <PushPort> (default 0).
 
+        checkpoint save|restore|discard
+          Call xtsc_queue::checkpoint_save(), xtsc_queue::checkpoint_restore(), or
+          xtsc_queue::checkpoint_discard().  For restore, return the number of elements
+          in the queue.
+
         dump
           Return the os buffer from calling xtsc_queue::dump(os).
 
@@ -635,6 +756,38 @@ private:
   /// Return the index of the nth element from the front or throw if there is none.
   xtsc::u32 get_index_of_nth_from_front(xtsc::u32 nth, const char *function);
 
+  /// Return a pointer to host shared memory row index (a u64 ticket followed by the element data)
+  xtsc::u8 *shmem_row(xtsc::u32 index) {
+    return &m_p_shmem[m_shmem_rows_offset + index * m_shmem_bytes_per_row + (m_shmem_mpmc ? 8 : 0)];
+  }
+
+  /// Return a pointer to the sequence number of host shared memory cell index ("shared_memory_mpmc" only)
+  xtsc::u64 *shmem_sequence(xtsc::u32 index) { return (xtsc::u64*) &m_p_shmem[m_shmem_rows_offset + index * m_shmem_bytes_per_row]; }
+
+  /// Return the number of elements in the "shared_memory_mpmc" ring (pushes and pops in flight are counted)
+  xtsc::u32 shmem_mpmc_count();
+
+  /// Push to the "shared_memory_mpmc" ring.  Return false if it is full.
+  bool shmem_mpmc_push(const sc_dt::sc_unsigned& element, xtsc::u64& ticket);
+
+  /// Pop (or, if peek is true, just copy) the front of the "shared_memory_mpmc" ring.  Return false if it is empty.
+  bool shmem_mpmc_pop(sc_dt::sc_unsigned& element, xtsc::u64& ticket, bool peek);
+
+  /// Return the number of elements consumers in this process may pop from the "shared_memory_mpmc" ring
+  xtsc::u32 shmem_mpmc_num_available();
+
+  /// Return the number of cells producers in this process may push to in the "shared_memory_mpmc" ring
+  xtsc::u32 shmem_mpmc_num_free();
+
+  /// Return the first position at or after pos which is not visible given a barrier snapshot and this process's own positions
+  static xtsc::u64 shmem_visible_end(xtsc::u64 pos, xtsc::u64 snapshot, const std::set<xtsc::u64>& own);
+
+  /// Return widx as producers and consumers in this process may see it (see enable_barrier_sync())
+  xtsc::u32 shmem_visible_widx();
+
+  /// Return ridx as producers and consumers in this process may see it (see enable_barrier_sync())
+  xtsc::u32 shmem_visible_ridx();
+
   /// Get the xtsc_queue_push_if associated with port
   xtsc::xtsc_queue_push_if& get_queue_push_interface(xtsc::u32 port);
 
@@ -647,6 +800,21 @@ private:
   /// Set m_has_pop_file_element and m_pop_file_element
   void get_next_pop_file_element();
 
+  /// Return a pointer to the packed words of element storage slot index
+  xtsc::u64 *element_words(xtsc::u32 index) { return &m_element_words[index * m_words_per_element]; }
+
+  /// Pack element into m_words_per_element words (least-significant word first)
+  void pack_element(const sc_dt::sc_unsigned& element, xtsc::u64 *p_words);
+
+  /// Unpack m_words_per_element words (least-significant word first) into element
+  void unpack_element(const xtsc::u64 *p_words, sc_dt::sc_unsigned& element);
+
+  /// Copy the m_words_per_element words of one element
+  void copy_element(xtsc::u64 *p_dst, const xtsc::u64 *p_src) const;
+
+  /// Return the packed element formatted as a hex string (for logging)
+  std::string element_to_string(const xtsc::u64 *p_words);
+
 
   /// Implementation of xtsc_queue_push_if for single producer.
   class xtsc_queue_push_if_impl : public xtsc::xtsc_queue_push_if, public sc_core::sc_object {
@@ -817,7 +985,7 @@ private:
   };
 
 
-  // We use an sc_fifo, m_fifo, in addition to the m_element_ptrs table because the
+  // We use an sc_fifo, m_fifo, in addition to the m_element_words table because the
   // sc_fifo uses evaluate-update semantics to ensure determinacy.
 
 
@@ -831,25 +999,27 @@ private:
   xtsc::u32                             m_num_consumers;           ///<  From "num_consumers" parameter
   bool                                  m_multi_client;            ///<  true if either m_num_producers or m_num_consumers exceeds 1
   xtsc::u32                             m_depth;                   ///<  Capacity - number of elements
-  sc_core::sc_fifo<int>                 m_fifo;                    ///<  Indexes into m_element_ptrs (to ensure determinacy)
+  sc_core::sc_fifo<int>                 m_fifo;                    ///<  Indexes into m_element_words (to ensure determinacy)
   bool                                  m_use_fifo;                ///<  True if using sc_fifo, false if using a file of host shared memory
-  sc_dt::sc_unsigned                  **m_element_ptrs;            ///<  To store the elements
+  std::vector<xtsc::u64>                m_element_words;           ///<  To store the elements, m_words_per_element packed words each
   xtsc::u64                            *m_tickets;                 ///<  To store the ticket associated with each element
   xtsc::u32                             m_skid_index;              ///<  Move from skid buffer to m_fifo in fair, round-robin fashion
-  sc_core::sc_fifo<int>               **m_skid_fifos;              ///<  A entry in m_skid_fifos[N] says that m_skid_buffers[N] is valid
-  sc_dt::sc_unsigned                  **m_skid_buffers;            ///<  Skid buffers to store the elements
+  sc_core::sc_fifo<int>               **m_skid_fifos;              ///<  A entry in m_skid_fifos[N] says that skid buffer N is valid
+  std::vector<xtsc::u64>                m_skid_words;              ///<  Skid buffers to store the elements, m_words_per_element packed words each
   xtsc::u64                            *m_skid_tickets;            ///<  To store the queue tickets associated with the skid buffers
   xtsc::u32                             m_jerk_index;              ///<  Move from m_fifo to jerk buffer in fair, round-robin fashion
-  sc_core::sc_fifo<int>               **m_jerk_fifos;              ///<  A entry in m_jerk_fifos[N] says that m_jerk_buffers[N] is valid
-  sc_dt::sc_unsigned                  **m_jerk_buffers;            ///<  Jerk buffers to store the elements
+  sc_core::sc_fifo<int>               **m_jerk_fifos;              ///<  A entry in m_jerk_fifos[N] says that jerk buffer N is valid
+  std::vector<xtsc::u64>                m_jerk_words;              ///<  Jerk buffers to store the elements, m_words_per_element packed words each
   xtsc::u64                            *m_jerk_tickets;            ///<  To store the queue tickets associated with the jerk buffers
   xtsc::u64                             m_pop_ticket;              ///<  Save ticket of last popped value
   xtsc::u64                             m_push_ticket;             ///<  Save ticket of last pushed value
   sc_dt::sc_unsigned                    m_dummy;                   ///<  For logging failed pushes and pops
   xtsc::u32                             m_width1;                  ///<  Bit width of each element
   xtsc::u32                             m_width8;                  ///<  Byte width of each element
+  xtsc::u32                             m_words_per_element;       ///<  Number of u64 words used to store each element
   sc_dt::sc_unsigned                    m_value;                   ///<  For temporary use within a method
-  xtsc::u32                             m_next;                    ///<  Next slot in m_element_ptrs[] and m_tickets[]
+  sc_dt::sc_unsigned                    m_element_temp;            ///<  For packing/unpacking elements whose width is not m_width1
+  xtsc::u32                             m_next;                    ///<  Next slot in m_element_words[] and m_tickets[]
   log4xtensa::TextLogger&               m_text;                    ///<  Text logger
   log4xtensa::BinaryLogger&             m_binary;                  ///<  Binary logger
   bool                                  m_log_data_binary;         ///<  True if transaction data should be logged by m_binary
@@ -864,6 +1034,7 @@ private:
   std::vector<std::string>              m_words;                   ///<  The tokenized words of the current line from m_pop_file
   std::string                           m_line;                    ///<  The current line from m_pop_file
   sc_core::sc_event                     m_drain_fifo_event;        ///<  To drain the fifos after a reset
+  sc_core::sc_event                     m_checkpoint_restore_event;///<  To refill m_fifo after checkpoint_restore()
   sc_core::sc_event                     m_push_pop_event;          ///<  multi-client: notify delta_cycle_method(); else each peek/poke
   sc_core::sc_event                     m_nonempty_event;          ///<  The no-longer-empty event
   sc_core::sc_event                     m_nonfull_event;           ///<  The no-longer-full event
@@ -880,6 +1051,23 @@ private:
   xtsc::u32                             m_shmem_total_size;        ///<  Shared Memory: number of bytes in all rows plus read/write indices
   xtsc::u32                            *m_p_shmem_ridx;            ///<  Shared Memory: pointer to ridx (ridx = Read row InDeX)
   xtsc::u32                            *m_p_shmem_widx;            ///<  Shared Memory: pointer to widx (widx = Write row InDeX)
+  bool                                  m_shmem_mpmc;              ///<  See "shared_memory_mpmc" parameter
+  xtsc::u32                             m_shmem_rows_offset;       ///<  Shared Memory: byte offset of row 0 (128 if m_shmem_mpmc, else 0)
+  xtsc::u64                            *m_p_shmem_enqueue_pos;     ///<  Shared Memory: pointer to the enqueue position (if m_shmem_mpmc)
+  xtsc::u64                            *m_p_shmem_dequeue_pos;     ///<  Shared Memory: pointer to the dequeue position (if m_shmem_mpmc)
+  xtsc::u32                             m_shmem_sync_ridx;         ///<  Shared Memory: ridx seen by sync_host_shared_memory()
+  xtsc::u32                             m_shmem_sync_widx;         ///<  Shared Memory: widx seen by sync_host_shared_memory()
+  bool                                  m_shmem_barrier_sync;      ///<  Shared Memory: See enable_barrier_sync()
+  xtsc::u64                             m_shmem_sync_enqueue_pos;  ///<  Shared Memory: enqueue position seen by sync_host_shared_memory()
+  xtsc::u64                             m_shmem_sync_dequeue_pos;  ///<  Shared Memory: dequeue position seen by sync_host_shared_memory()
+  std::set<xtsc::u64>                   m_shmem_own_pushes;        ///<  Shared Memory: positions pushed by this process since then
+  std::set<xtsc::u64>                   m_shmem_own_pops;          ///<  Shared Memory: positions popped by this process since then
+  bool                                  m_checkpoint_saved;        ///<  True if checkpoint_save() has been called
+  bool                                  m_checkpoint_restore_pending; ///< True from checkpoint_restore() until m_fifo is refilled
+  std::vector<xtsc::u8>                 m_checkpoint_data;         ///<  Checkpoint: element bytes
+  std::vector<xtsc::u64>                m_checkpoint_tickets;      ///<  Checkpoint: ticket of each element
+  xtsc::u64                             m_checkpoint_pop_ticket;   ///<  Checkpoint: m_pop_ticket
+  xtsc::u64                             m_checkpoint_push_ticket;  ///<  Checkpoint: m_push_ticket
 
 };
 
@@ -21,9 +21,11 @@
 #include <xtsc/xtsc_response.h>
 #include <xtsc/xtsc_address_range_entry.h>
 #include <xtsc/xtsc_fast_access.h>
+#include <xtsc/xtsc_slab_allocator.h>
 #include <vector>
 #include <cstring>
 #include <map>
+#include <set>
 
 
 
@@ -158,6 +160,10 @@ class xtsc_tlm22xttlm_transactor;
                                 9.  Address ranges cannot overlap.
                                 10. Comments, extra whitespace, and blank lines are
                                     ignored.   See xtsc_script_file.
+                                11. After the file is read, the table is compiled into
+                                    a sorted list of disjoint address segments which
+                                    is binary searched, so routing time grows only
+                                    logarithmically with the number of lines.
 
                                 The "routing_table" file may also contain a lua_function
                                 line to specify a Lua function that is to be called by
@@ -174,7 +180,8 @@ class xtsc_tlm22xttlm_transactor;
                                 giving the address.  The first function should return a
                                 Lua number giving the port as a whole number.  The
                                 second function should return a Lua number giving the
-                                new translated address as a whole number.  The values
+                                new translated address as a whole number.  Unless the
+                                "lua_cache_page_size" parameter is set, the values
                                 returned by the Lua functions are not cached by the
                                 model, instead, the functions are called each time a
                                 routing is performed.  This provides a dynamic routing
@@ -216,6 +223,21 @@ class xtsc_tlm22xttlm_transactor;
 
                                 Default = NULL.
 
+   "lua_cache_page_size" u32    If non-zero, the results of the Lua functions named on
+                                the lua_function line of the "routing_table" file are
+                                memoized on pages of this many bytes.  The functions
+                                are called once with the lowest address of a page and
+                                the returned port and address translation (expressed
+                                as a delta from that lowest address) are then applied
+                                to every address in that page without calling Lua
+                                again.  This should only be used if the Lua functions
+                                are pure and if the port is constant and the address
+                                translation is linear over each page.  The cache is
+                                cleared when the router is reset.  If non-zero, this
+                                parameter must be a power of 2.
+                                Default = 0 (the Lua functions are called for every
+                                routing).
+
    "default_delta"       u64    The amount to be added to the address of each 
                                 xtsc::xtsc_request that is sent out that does not
                                 have <NewBaseAddr> specified for it in the routing
@@ -653,6 +675,7 @@ public:
     add("use_block_requests",            false);
     add("default_routing",               default_routing);
     add("routing_table",                 routing_table);
+    add("lua_cache_page_size",           0);
     add("default_port_num",              default_port_num);
     add("default_delta",                 0ULL);
     add("address_routing_bits",          empty);
@@ -866,6 +889,9 @@ public:
         reset
           Call xtsc_router::reset().
 
+        revoke_fast_access
+          Call xtsc_router::revoke_fast_access().
+
         watchfilter_add <FilterName> <EventName>
           Calls xtsc_router::watchfilter_add(<FilterName>, <Event>) and returns the
           watchfilter number.  <EventName> can be a hyphen (-) to mean the last event
@@ -1079,6 +1105,18 @@ public:
   void dump_profile_results(std::ostream& os = std::cout);
 
 
+  /**
+   * Revoke all fast access (DMI) previously granted through this router.
+   *
+   * Each upstream master which supplied an xtsc_fast_access_revocation_if with its
+   * fast access request (for example, xtsc_core or xtsc_tlm22xttlm_transactor) has
+   * its revoke_fast_access() method called so that it will re-request fast access,
+   * and pick up the current routing, on its next access.  This method is called
+   * automatically by reset() and whenever the routing table is re-compiled.
+   */
+  void revoke_fast_access();
+
+
   // SystemC calls this method at the end of simulation
   void end_of_simulation();  
 
@@ -1260,6 +1298,40 @@ protected:
   };
 
 
+  /**
+   * A segment of the compiled routing table.  The segments in m_routing_segments are
+   * sorted, disjoint, and together cover the whole address space.  Each one records the
+   * first entry of m_routing_table (in file order) which contains all of its addresses
+   * so that a single binary search gives the same result as a linear walk of
+   * m_routing_table.
+   */
+  class routing_segment {
+  public:
+    /// Constructor
+    routing_segment(xtsc::xtsc_address start_address8, xtsc::xtsc_address end_address8, xtsc::u32 entry_index) :
+      m_start_address8  (start_address8),
+      m_end_address8    (end_address8),
+      m_entry_index     (entry_index)
+    {}
+    xtsc::xtsc_address  m_start_address8;       ///< The lowest byte address in the segment
+    xtsc::xtsc_address  m_end_address8;         ///< The highest byte address in the segment
+    xtsc::u32           m_entry_index;          ///< Index into m_routing_table or NO_ROUTING_ENTRY
+  };
+
+
+  /// Memoized Lua routing result for one page (see "lua_cache_page_size")
+  class lua_cache_entry {
+  public:
+    /// Constructor
+    lua_cache_entry(xtsc::u32 port_num, xtsc::xtsc_address delta) :
+      m_port_num        (port_num),
+      m_delta           (delta)
+    {}
+    xtsc::u32           m_port_num;             ///< Port returned by <LuaPortFunction>
+    xtsc::xtsc_address  m_delta;                ///< Address translation from <LuaAddrFunction> (0 if none)
+  };
+
+
   /// Information about each watchfilter
   class watchfilter_info {
   public:
@@ -1294,6 +1366,19 @@ protected:
    */
   virtual xtsc::u32 get_port_and_apply_address_translation(xtsc::xtsc_address& address8);
 
+  /**
+   * Build m_routing_segments from m_routing_table.  This is done once after the
+   * "routing_table" file is parsed and again if m_routing_table is later changed in size
+   * (for example, by a sub-class).
+   */
+  void compile_routing_table();
+
+  /// Return the index into m_routing_segments of the segment containing address8
+  xtsc::u32 find_routing_segment(xtsc::xtsc_address address8);
+
+  /// Call the Lua functions from the lua_function line to get the port and translate address8
+  xtsc::u32 evaluate_lua_routing(xtsc::xtsc_address& address8);
+
   /**
    * Get the port based on the transaction type.
    *
@@ -1323,25 +1408,25 @@ protected:
   /// PWC: Handle responses from multiple slaves at the correct time
   void response_arbiter_pwc_thread(void);
 
-  /// Get a new request_info (from the pool)
+  /// Get a new request_info (from m_allocator)
   request_info *new_request_info(const xtsc::xtsc_request& request);
 
-  /// Copy a new request_info (using the pool)
+  /// Copy a new request_info (using m_allocator)
   request_info *new_request_info(const request_info& info);
 
   /// Delete an request_info (return it to the pool)
   void delete_request_info(request_info*& p_request_info);
 
-  /// Get a new response_info (from the pool)
+  /// Get a new response_info (from m_allocator)
   response_info *new_response_info(const xtsc::xtsc_response& response);
 
-  /// Get a new response_info (from the pool)
+  /// Get a new response_info (from m_allocator)
   response_info *new_response_info(const xtsc::xtsc_request& request);
 
   /// Delete an response_info (return it to the pool)
   void delete_response_info(response_info*& p_response_info);
 
-  /// Get a new req_rsp_info (from the pool)
+  /// Get a new req_rsp_info (from m_allocator)
   req_rsp_info *new_req_rsp_info(request_info *first_request_info);
 
   /// Delete an req_rsp_info (return it to the pool)
@@ -1439,10 +1524,19 @@ protected:
 
   std::vector<xtsc::xtsc_address_range_entry>
                                           m_routing_table;              ///<  The routing table
+  std::vector<routing_segment>            m_routing_segments;           ///<  Compiled m_routing_table (see compile_routing_table)
+  xtsc::u32                               m_num_compiled_entries;       ///<  Size of m_routing_table when m_routing_segments was built
+  xtsc::u32                               m_last_routing_segment;       ///<  Index of most recently found routing segment
 
   std::string                             m_lua_port_function;          ///<  From <LuaPortFunction> in lua_function line of "routing_table" file
   std::string                             m_lua_addr_function;          ///<  From <LuaAddrFunction> in lua_function line of "routing_table" file
   bool                                    m_lua_function;               ///<  True if there was a lua_function line in "routing_table" file
+  xtsc::u32                               m_lua_cache_page_size;        ///<  From "lua_cache_page_size" parameter
+  xtsc::xtsc_address                      m_lua_cache_page_mask;        ///<  Mask to get the lowest address of a Lua cache page
+  std::map<xtsc::xtsc_address, lua_cache_entry>
+                                          m_lua_cache;                  ///<  Memoized Lua routing results keyed by page address
+  std::set<xtsc::xtsc_fast_access_revocation_if*>
+                                          m_revocation_set;             ///<  Masters granted fast access through this router
 
   std::vector<xtsc::u32>                  m_route_by_priority;          ///<  See "route_by_priority" in xtsc_arbiter_parms
   xtsc::u32                               m_priority_port_map[16];      ///<  Map up to 4-bits of priority to port number
@@ -1460,9 +1554,7 @@ protected:
   sc_core::sc_event                       m_waiting_reads_thread_event; ///<  To notify waiting_reads_thread when a read is waiting
   sc_core::sc_event                       m_outstanding_write_event;    ///<  Notified on the completion of an outstanding write
 
-  std::vector<req_rsp_info*>              m_req_rsp_info_pool;          ///<  Maintain a pool of req_rsp_info to improve performance
-  std::vector<request_info*>              m_request_pool;               ///<  Maintain a pool of requests to improve performance
-  std::vector<response_info*>             m_response_pool;              ///<  Maintain a pool of responses to improve performance
+  xtsc_allocator_client                   m_allocator;                  ///<  For request_info, response_info, and req_rsp_info
 
   std::string                             m_file_name;                  ///<  Routing table file name from "routing_table"
   xtsc::xtsc_script_file                 *m_file;                       ///<  Pointer to routing table file
@@ -1512,6 +1604,9 @@ protected:
    */
   static const xtsc::u32                  ADDRESS_ERROR   = 0xFFFFFFFE;
 
+  /// Entry index of a routing_segment not covered by any m_routing_table entry
+  static const xtsc::u32                  NO_ROUTING_ENTRY = 0xFFFFFFFF;
+
   // Convert and return the word at m_words[index] as a u32
   xtsc::u32 get_u32(xtsc::u32 index);
 
@@ -18,6 +18,7 @@
 #include <xtsc/xtsc_respond_if.h>
 #include <xtsc/xtsc_response.h>
 #include <xtsc/xtsc_fast_access.h>
+#include <xtsc/xtsc_slab_allocator.h>
 #include <string>
 #include <vector>
 #include <deque>
@@ -244,13 +245,7 @@ public:
       m_cont            (cont),
       m_delay           (delay)
     {}
-    ~response_info() {
-      if (m_p_response) {
-        delete m_p_response;
-        m_p_response = 0;
-      }
-    }
-    xtsc::xtsc_response        *m_p_response;           ///<  The xtsc_response to respond with
+    xtsc::xtsc_response        *m_p_response;           ///<  The xtsc_response to respond with (freed by delete_response_info())
     bool                        m_respond_now;          ///<  The response line had delay of "now"
     bool                        m_cont;                 ///<  The response line had CONT
     sc_core::sc_time            m_delay;                ///<  How long to delay
@@ -437,6 +432,7 @@ protected:
   sc_core::sc_time                      m_repeat_delay_time;            ///<  How long to wait between repeated responses
   sc_core::sc_time                      m_clock_period;                 ///<  This modules clock period
   xtsc::u32                             m_transfer_num;                 ///<  For xtsc_response::set_transfer_number()
+  xtsc_allocator_client                 m_allocator;                    ///<  For response_info and xtsc_response objects
   log4xtensa::TextLogger&               m_text;                         ///<  Text logger
 
   std::vector<sc_core::sc_process_handle>
@@ -28,6 +28,7 @@
 #include <xtsc/xtsc_respond_if.h>
 #include <xtsc/xtsc_response.h>
 #include <xtsc/xtsc_fast_access.h>
+#include <xtsc/xtsc_slab_allocator.h>
 #include <deque>
 #include <vector>
 #include <list>
@@ -155,7 +156,10 @@ class xtsc_xttlm2tlm2_transactor;
                                 to support DMI.  If false, no attempt will be made to
                                 support DMI.  Even if this parameter is true, DMI can
                                 not be supported if the downstream memory does not
-                                support raw fast access.
+                                support raw fast access.  If a downstream component
+                                (for example, xtsc_xttlm2tlm2_transactor or xtsc_router)
+                                later revokes the fast access, this transactor calls
+                                invalidate_direct_mem_ptr() on the upstream initiator.
                                 Default = true.
 
    "allow_transport_dbg" bool   If true, this transactor will translate transport_dbg
@@ -540,11 +544,11 @@ private:
   void delete_transaction_info(transaction_info*& p_transaction_info);
 
 
-  /// Get a new xtsc_request (from the pool) 
+  /// Get a new xtsc_request (from m_allocator)
   xtsc::xtsc_request *new_request();
 
 
-  /// Delete an xtsc_request (return it to the pool)
+  /// Delete an xtsc_request (return it to m_allocator)
   void delete_request(xtsc::xtsc_request*& p_request);
 
 
@@ -585,8 +589,15 @@ private:
   };
 
 
-  /// Implementation of tlm_fw_transport_if<>
-  class tlm_fw_transport_if_impl : public tlm::tlm_fw_transport_if<>, public sc_core::sc_object {
+  /**
+   * Implementation of tlm_fw_transport_if<>.  Also implements xtsc_fast_access_revocation_if so that
+   * a downstream revocation of fast access granted by get_direct_mem_ptr() is passed back upstream as
+   * a call to invalidate_direct_mem_ptr().
+   */
+  class tlm_fw_transport_if_impl : public tlm::tlm_fw_transport_if<>,
+                                   public xtsc::xtsc_fast_access_revocation_if,
+                                   public sc_core::sc_object
+  {
   public:
 
     /**
@@ -609,6 +620,10 @@ private:
     virtual xtsc::u32           transport_dbg      (tlm::tlm_generic_payload& trans);
 
 
+    /// From xtsc_fast_access_revocation_if: invalidate all DMI granted on this port
+    virtual void                revoke_fast_access ();
+
+
     /// Return true if a port has bound to this implementation
     bool is_connected() { return (m_p_port != 0); }
 
@@ -705,9 +720,8 @@ private:
                 transaction_info*>             *m_trans_to_info_map;            ///<  Map tlm2 gp to transaction_info structure
   std::deque<transaction_info*>               **m_pending_transaction_deque;    ///<  Hold pending transaction_info objects 
   std::vector<transaction_info*>                m_transaction_info_pool;        ///<  Maintain a pool to improve performance
-  std::vector<xtsc::xtsc_request*>              m_request_pool;                 ///<  Maintain a pool of requests to improve performance
   xtsc::u32                                     m_transaction_info_count;       ///<  Count number of constructed transaction_info objects
-  xtsc::u32                                     m_request_count;                ///<  Count number of constructed xtsc_request objects
+  xtsc_allocator_client                         m_allocator;                    ///<  For xtsc_request and transaction_info objects
   std::vector<sc_core::sc_process_handle>       m_process_handles;              ///<  For reset 
   log4xtensa::TextLogger&                       m_text;                         ///<  Text logger
 
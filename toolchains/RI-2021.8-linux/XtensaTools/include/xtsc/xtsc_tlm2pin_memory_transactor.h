@@ -26,6 +26,7 @@
 #include <xtsc/xtsc_module_pin_base.h>
 #include <xtsc/xtsc_memory_b.h>
 #include <xtsc/xtsc_core.h>
+#include <xtsc/xtsc_slab_allocator.h>
 
 
 
@@ -394,6 +395,16 @@ DSO_EXPORT void poke(u32 address8, u32 size8, const u8 *buffer, const char *dso_
    "vcd_handle"         void*   Pointer to SystemC VCD object (sc_trace_file *) or 0 if
                                 tracing is not desired.
 
+   "activity_driven"    bool    If true, threads which would otherwise wake up once
+                                each clock period while waiting on another party (for
+                                example, waiting for PREADY on APB) instead wait for
+                                the relevant signal to rise and then re-sync to the
+                                sample phase (see "sample_phase").  Pins are sampled in
+                                the same clock cycles as when this parameter is false,
+                                but far fewer SystemC context switches occur when the
+                                downstream slave is slow to respond.
+                                Default = false.
+
    "request_fifo_depth" u32     The request fifo depth.  
                                 Default = 1.
                                 Minimum = 1.
@@ -699,6 +710,7 @@ public:
     add("has_xfer_en",               false);
     add("read_delay",                0);
     add("vcd_handle",                (void*)NULL);
+    add("activity_driven",           false);
     add("request_fifo_depth",        1);
     add("cbox",                      false);
     add("banked",                    false);
@@ -1125,6 +1137,10 @@ protected:
   void apb_drive_zeroes(xtsc::u32 port);
 
 
+  /// Wait until the next sample phase (a full clock period if already at the sample phase)
+  void sync_to_sample_phase(void);
+
+
   /// Handle local memory requests
   void lcl_request_thread(void);
 
@@ -1165,7 +1181,7 @@ protected:
   void send_unchecked_response(xtsc::xtsc_response*& p_response, xtsc::u32 port);
 
 
-  /// Get a new response_info (from the pool)
+  /// Get a new response_info (from m_allocator)
   response_info *new_response_info(xtsc::xtsc_response *p_response,
                                    xtsc::u32            bus_addr_bits,
                                    xtsc::u32            size,
@@ -1176,7 +1192,7 @@ protected:
                                    burst_t              burst           = xtsc::xtsc_request::NON_AXI);
 
 
-  /// Get a new response_info (from the pool) and initialize it by copying
+  /// Get a new response_info (from m_allocator) and initialize it by copying
   response_info *new_response_info(const response_info& info);
 
 
@@ -1184,7 +1200,7 @@ protected:
   void delete_response_info(response_info*& p_response_info);
 
 
-  /// Get a new xtsc_request (from the pool) that is a copy of the specified request
+  /// Get a new xtsc_request (from m_allocator) that is a copy of the specified request
   xtsc::xtsc_request *new_request(const xtsc::xtsc_request& request);
 
 
@@ -1420,6 +1436,7 @@ protected:
   bool                          m_has_lock;                     ///< True if memory interface has a lock pin 
                                                                 ///<  (DRAM0|DRAM0BS|DRAM0RW|DRAM1|DRAM1BS|DRAM1RW only)
   bool                          m_has_xfer_en;                  ///< True if memory interface has Xfer enable pin 
+  bool                          m_activity_driven;              ///< See "activity_driven" parameter
                                                                 ///<  (NA PIF|IDMA0|AXI|IDMA|APB|DROM0|XLMI0)
   sc_core::sc_event            *m_write_response_event;         ///< Event used to notify pif_response_thread (per mem port)
   sc_core::sc_event            *m_request_event;                ///< Event used to notify request_thread (per mem port)
@@ -1445,8 +1462,7 @@ protected:
   req_cntl                      m_req_cntl;                     ///< Value for POReqCntrl
   bool_fifo                   **m_resp_rdy_fifo;                ///< sc_fifo to keep track of PORespRdy|xREADY pin (per mem port)
   sc_core::sc_event            *m_drive_resp_rdy_event;         ///< Notify when PORespRdy|xREADY should be driven (per mem port)
-  std::vector<xtsc_request*>    m_request_pool;                 ///< Maintain a pool of requests to improve performance
-  std::vector<response_info*>   m_response_pool;                ///< Maintain a pool of responses to improve performance
+  xtsc_allocator_client         m_allocator;                    ///< For xtsc_request, xtsc_response, and response_info objects
   std::deque<response_info*>   *m_busy_write_rsp_deque;         ///< pending responses: check busy and/or send write rsp (per mem port)
   std::deque<response_info*>   *m_7stage_write_rsp_deque;       ///< pending responses: send write rsp (per mem port)  7 stage only
   std::deque<response_info*>   *m_read_data_rsp_deque;          ///< deque of pending read responses (per mem port)
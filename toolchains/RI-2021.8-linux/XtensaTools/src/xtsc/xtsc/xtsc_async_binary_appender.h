@@ -0,0 +1,190 @@
+#ifndef _XTSC_ASYNC_BINARY_APPENDER_H_
+#define _XTSC_ASYNC_BINARY_APPENDER_H_
+
+// Copyright (c) 2005-2018 by Cadence Design Systems Inc.  ALL RIGHTS RESERVED.
+// These coded instructions, statements, and computer programs are the
+// copyrighted works and confidential proprietary information of Cadence Design Systems Inc.
+// They may not be modified, copied, reproduced, distributed, or disclosed to
+// third parties in any manner, medium, or form, in whole or in part, without
+// the prior written consent of Cadence Design Systems Inc.
+
+/**
+ * @file
+ */
+
+
+#include <xtsc/xtsc.h>
+#include <log4xtensa/appender.h>
+#include <log4xtensa/helpers/property.h>
+#include <atomic>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+
+namespace xtsc_component {
+
+
+/**
+ * A log4xtensa appender which moves binary logging file I/O off the simulation thread.
+ *
+ * Each event passed to this appender (for example, by xtsc::xtsc_log_memory_request_event
+ * or xtsc::xtsc_log_memory_response_event) is copied into a fixed-size slot of a
+ * single-producer, single-consumer lock-free ring.  A background host thread drains the
+ * ring and writes the records to the file using large buffered writes.  The bytes of
+ * each record are written exactly as the BinaryLogger formatted them (the event's
+ * message); no layout is applied.
+ *
+ * When the ring is full, the appender does not block the simulation thread (unless
+ * "Backpressure" is true).  Instead the event is dropped and counted.  The drop,
+ * backpressure, and oversize counters can be obtained with the get methods of this
+ * class or dumped for all instances using dump_all_statistics().
+ *
+ * Because there is a single producer slot index per ring, an appender instance must
+ * only be attached to loggers which are used by one thread (the SystemC simulation
+ * thread).
+ *
+ * To use this appender from a binary logging configuration file, call
+ * xtsc_register_async_binary_appender() before xtsc_initialize() and then name the
+ * appender type "xtsc_component::xtsc_async_binary_appender".  For example:
+ *  \verbatim
+   log4xtensa.rootLogger=INFO, bin
+   log4xtensa.appender.bin=xtsc_component::xtsc_async_binary_appender
+   log4xtensa.appender.bin.File=xtsc.bin
+   log4xtensa.appender.bin.RingRecords=65536
+   log4xtensa.appender.bin.RecordBytes=256
+   log4xtensa.appender.bin.WriteBytes=1048576
+   log4xtensa.appender.bin.Backpressure=false
+    \endverbatim
+ *
+ *  \verbatim
+   Property        Description
+   --------------  -------------------------------------------------------------------
+   File            The name of the output file.  Required.
+
+   RingRecords     The number of slots in the ring.  Rounded up to a power of 2.
+                   Must not exceed 2147483648 (0x80000000).
+                   Default = 65536.
+
+   RecordBytes     The maximum size in bytes of one event.  Larger events are
+                   dropped and counted as oversize.
+                   Default = 256.
+
+   WriteBytes      The number of bytes the background thread buffers before each
+                   write to the file.
+                   Default = 1048576.
+
+   Backpressure    If false, events arriving when the ring is full are dropped and
+                   counted.  If true, the simulation thread waits for a free slot
+                   and the wait is counted.
+                   Default = false.
+    \endverbatim
+ */
+class XTSC_COMP_API xtsc_async_binary_appender : public log4xtensa::Appender {
+public:
+
+  /// Constructor used by the log4xtensa PropertyConfigurator
+  xtsc_async_binary_appender(const log4xtensa::helpers::Properties& properties);
+
+
+  /**
+   * Constructor for programmatic use.
+   *
+   * @param     file_name       The name of the output file.
+   * @param     ring_records    See "RingRecords".
+   * @param     record_bytes    See "RecordBytes".
+   * @param     write_bytes     See "WriteBytes".
+   * @param     backpressure    See "Backpressure".
+   */
+  xtsc_async_binary_appender(const std::string&         file_name,
+                             xtsc::u32                  ring_records    = 65536,
+                             xtsc::u32                  record_bytes    = 256,
+                             xtsc::u32                  write_bytes     = 1024*1024,
+                             bool                       backpressure    = false);
+
+
+  /// Destructor.  Drains the ring and closes the file.
+  virtual ~xtsc_async_binary_appender();
+
+
+  /// Drain the ring, stop the background thread, and close the file
+  virtual void close();
+
+
+  /// Return the number of events written to the file (or still in the ring)
+  xtsc::u64 get_num_records() const { return m_num_records; }
+
+
+  /// Return the number of events dropped because the ring was full
+  xtsc::u64 get_num_dropped() const { return m_num_dropped; }
+
+
+  /// Return the number of events which had to wait for a free slot ("Backpressure" true)
+  xtsc::u64 get_num_backpressure() const { return m_num_backpressure; }
+
+
+  /// Return the number of events dropped because they exceeded "RecordBytes"
+  xtsc::u64 get_num_oversize() const { return m_num_oversize; }
+
+
+  /// Dump the counters of this appender
+  void dump_statistics(std::ostream& os = std::cout) const;
+
+
+  /// Dump the counters of all xtsc_async_binary_appender instances
+  static void dump_all_statistics(std::ostream& os = std::cout);
+
+
+protected:
+
+  /// Copy the event into the ring
+  virtual void append(const log4xtensa::spi::InternalLoggingEvent& event);
+
+
+private:
+
+  /// Common constructor code
+  void init();
+
+  /// Body of the background thread
+  void drain();
+
+  /// Write the slot at index to m_buffer (and the buffer to the file when full)
+  void write_slot(xtsc::u32 index);
+
+  std::string                           m_file_name;            ///<  See "File"
+  xtsc::u32                             m_ring_records;         ///<  See "RingRecords" (a power of 2)
+  xtsc::u32                             m_record_bytes;         ///<  See "RecordBytes"
+  xtsc::u32                             m_write_bytes;          ///<  See "WriteBytes"
+  bool                                  m_backpressure;         ///<  See "Backpressure"
+  std::vector<xtsc::u8>                 m_ring;                 ///<  m_ring_records slots of 4 byte length + m_record_bytes
+  std::vector<char>                     m_buffer;               ///<  Bytes waiting to be written to the file
+  std::ofstream                         m_file;                 ///<  The output file
+  std::atomic<xtsc::u64>                m_head;                 ///<  Next slot to be filled (written only by the simulation thread)
+  std::atomic<xtsc::u64>                m_tail;                 ///<  Next slot to be drained (written only by the background thread)
+  std::atomic<bool>                     m_stop;                 ///<  Tell the background thread to exit once the ring is empty
+  std::thread                           m_thread;               ///<  The background thread
+  xtsc::u64                             m_num_records;          ///<  See get_num_records
+  xtsc::u64                             m_num_dropped;          ///<  See get_num_dropped
+  xtsc::u64                             m_num_backpressure;     ///<  See get_num_backpressure
+  xtsc::u64                             m_num_oversize;         ///<  See get_num_oversize
+};
+
+
+
+/**
+ * Register xtsc_async_binary_appender with log4xtensa so that it can be named in a logging
+ * configuration file.  This must be called before the logging configuration file is
+ * read (that is, before xtsc_initialize()).  Calling it more than once is harmless.
+ */
+XTSC_COMP_API void xtsc_register_async_binary_appender();
+
+
+
+}  // namespace xtsc_component
+
+
+
+#endif  // _XTSC_ASYNC_BINARY_APPENDER_H_
@@ -22,6 +22,7 @@
 #include <xtsc/xtsc_response.h>
 #include <xtsc/xtsc_fast_access.h>
 #include <xtsc/xtsc_core.h>
+#include <xtsc/xtsc_slab_allocator.h>
 #include <vector>
 #include <deque>
 #include <queue>
@@ -623,13 +624,13 @@ private:
   void send_read_response(xtsc::xtsc_response& p_axi_response, xtsc::u32);
   void send_write_response(xtsc::xtsc_response& p_axi_response, xtsc::u32);
 
-  /// Get a new copy of an xtsc_request (from the pool)
+  /// Get a new copy of an xtsc_request (from m_allocator)
   xtsc::xtsc_request *copy_request(const xtsc::xtsc_request& request);
 
-  /// Get a new xtsc_request (from the pool)
+  /// Get a new xtsc_request (from m_allocator)
   xtsc::xtsc_request *new_request();
 
-  /// Delete an xtsc_request (return it to the pool)
+  /// Delete an xtsc_request (return it to m_allocator)
   void delete_request(xtsc::xtsc_request*& p_request);
 
   //xtsc utils functions
@@ -742,8 +743,7 @@ private:
   std::map<xtsc::u64, std::queue<axi_trans_info*> >  m_tag_2_axi_trans_info_map;    ///<  Map AXI/PIF request(s) tag to axi_trans_info
   std::map<std::string, xtsc::u32>           m_bit_width_map;                       ///<  For xtsc_connection_interface
 
-  xtsc::u32                                  m_request_count;                       ///<  Count each newly created xtsc_request
-  std::vector<xtsc::xtsc_request*>           m_request_pool;                        ///<  Maintain a pool of xtsc_request to improve performance
+  xtsc_allocator_client                      m_allocator;                           ///<  For xtsc_request, xtsc_response, and the axi_*_info objects
 
   std::vector<sc_core::sc_process_handle>    m_process_handles;                     ///<  For reset 
 
@@ -18,6 +18,7 @@
 #include <xtsc/xtsc_memory.h>
 #include "xtsc/xtsc_dma_request.h"
 #include <deque>
+#include <vector>
 
 
 
@@ -37,7 +38,33 @@ namespace xtsc_component {
    "reg_base_address"   u32     The base address of the DMA programming registers. The
                                 BYTE_OFFSET specified in xtsc_dma_request and
                                 xtsc_dma_descriptor documentation is refering to this
-                                base address.
+                                base address.  When "num_channels" is greater than 1,
+                                this is the base address of channel 0's registers.
+
+   "num_channels"       u32     The number of DMA channels.  Each channel has its own
+                                bank of DMA programming registers, processes its own
+                                DMA requests independently of the other channels, and
+                                uses its own set of request IDs (the ID of each request
+                                sent by channel N has N in bits 3-5).  Valid values
+                                are 1-8.
+                                Default = 1.
+
+   "channel_spacing"    u32     The distance in bytes between the register banks of
+                                consecutive channels.  Channel N's registers start at
+                                "reg_base_address" + N * "channel_spacing".  This
+                                parameter is ignored if "num_channels" is 1.  It must
+                                be a non-zero multiple of 256 that is at least 512.
+                                Default = 0x10000 (room for 255 descriptors).
+
+   "channel_arbitration" char*  When "max_reads" and "max_writes" are non-zero, the
+                                read and write slots they define are shared by all the
+                                channels.  This parameter specifies how a free slot is
+                                awarded when more than one channel is waiting for one.
+                                Valid values are:
+                                  "round_robin"   Rotate among the waiting channels.
+                                  "fixed"         The lowest numbered waiting channel
+                                                  always wins.
+                                Default = "round_robin".
 
    "read_priority"      u32     Priority for READ|BLOCK_READ DMA requests.
                                 Valid values are 0|1|2|3.
@@ -149,11 +176,12 @@ namespace xtsc_component {
                                 method.
                                 Default = As specified by the "turbo" parameter of
                                 xtsc_initialize_parms.
-                                Note:  The xtsc_dma_engine module does not currently
-                                       implement true TurboXim functionality which
-                                       allows the downstream module to specify what
-                                       memory address ranges support fast access and
-                                       which fast access method to use (raw access,
+                                Note:  Unless "turbo_fast_access" is true, the
+                                       xtsc_dma_engine module does not use the
+                                       TurboXim fast access mechanism which allows
+                                       the downstream module to specify what memory
+                                       address ranges support fast access and which
+                                       fast access method to use (raw access,
                                        peek/poke access, etc).
                                 Note:  If "turbo_min_sync" in xtsc_initialize_parms is
                                        set and the xtsc_core programming the DMA
@@ -163,6 +191,23 @@ namespace xtsc_component {
                                        the next DMA before the current DMA is complete
                                        resulting in an exception being thrown.
 
+   "turbo_fast_access"  bool    If true, then when "turbo" is in effect the DMA engine
+                                calls nb_fast_access to obtain raw pointers to the
+                                source and destination memories and moves each
+                                contiguous raw access block with a single memcpy.  Any
+                                part of a descriptor whose source or destination does
+                                not grant byte-ordered (swizzle 0) raw access is moved
+                                using nb_peek/nb_poke as when this parameter is false.
+                                Default = false.
+
+   "turbo_bytes_per_cycle" u32  When "turbo" is in effect, this specifies how many
+                                bytes the DMA engine is modeled as moving each clock
+                                period.  After each descriptor, simulation time is
+                                advanced by size8/turbo_bytes_per_cycle clock periods
+                                (rounded up).  A value of 0 means no simulation time
+                                is consumed by turbo DMA data movement.
+                                Default = 0.
+
 
    "posedge_offset"     u32     This specifies the time at which the first posedge of
                                 this device's clock conceptually occurs.  It is
@@ -207,6 +252,9 @@ public:
     xtsc_memory_parms(width8, delay, start_address8, size8)
   {
     add("reg_base_address",     reg_base_address);
+    add("num_channels",         1);
+    add("channel_spacing",      0x10000);
+    add("channel_arbitration",  "round_robin");
     add("read_priority",        2);
     add("write_priority",       2);
     add("clear_notify_value",   false);
@@ -218,6 +266,8 @@ public:
     add("allow_size_zero",      false);
     add("start_at_index_1",     true);
     add("turbo",                xtsc::xtsc_get_xtsc_initialize_parms().get_bool("turbo"));
+    add("turbo_fast_access",    false);
+    add("turbo_bytes_per_cycle",0);
     add("posedge_offset",       0xFFFFFFFF);
     add("nacc_wait_time",       0xFFFFFFFF);
   }
@@ -253,9 +303,13 @@ public:
  *   xtsc_mmio device can be used to converted this memory-mapped write into an
  *   interrupt signal.
  *
- * - This DMA engine module implements a single DMA channel.  If multiple DMA channels
- *   are desired, then instantiate this module multiple times and use xtsc_router and
- *   xtsc_arbiter objects to connect everything together.
+ * - By default this DMA engine module implements a single DMA channel.  The
+ *   "num_channels" parameter may be used to model up to 8 channels which run
+ *   concurrently, each with its own register bank (see "channel_spacing") and DMA
+ *   request.  The channels share the single master port pair and the "max_reads" and
+ *   "max_writes" slots (see "channel_arbitration").  When the "summary" parameter is
+ *   true, per-channel bandwidth statistics are included in the end-of-simulation
+ *   summary.
  *
  * - By default the DMA engine module does non-overlapped data transfers; however, the
  *   "max_reads" and "max_writes" parameters may be set to allow multiple, overlapped
@@ -348,12 +402,20 @@ public:
   void reset(bool hard_reset = false);
 
 
-  /// Dump descriptor @idx to the specified ostream object
-  void dump_descriptor(xtsc::u32 idx, std::ostream& os = std::cout);
+  /// Dump descriptor @idx of the specified channel to the specified ostream object
+  void dump_descriptor(xtsc::u32 idx, std::ostream& os = std::cout, xtsc::u32 channel_num = 0);
 
 
   /// Dump count (max 255) descriptors starting at start_idx (wrap after 255 to 1) to the specified ostream object
-  void dump_descriptors(xtsc::u32 start_idx = 1, xtsc::u32 count = 1, std::ostream& os = std::cout);
+  void dump_descriptors(xtsc::u32 start_idx = 1, xtsc::u32 count = 1, std::ostream& os = std::cout, xtsc::u32 channel_num = 0);
+
+
+  /// Return the number of DMA channels (see "num_channels")
+  xtsc::u32 get_num_channels() const { return m_num_channels; }
+
+
+  /// Print the memory summary followed by the xtsc_request pool peak and the per-channel DMA statistics
+  virtual void summary(std::ostream& os);
 
 
   /**
@@ -361,11 +423,12 @@ public:
    *
    * This implementation supports the following commands:
    *  \verbatim
-        dump_descriptor <Index>
-          Call xtsc_dma_engine::dump_descriptor(<Index>).
+        dump_descriptor <Index> [<Channel>]
+          Call xtsc_dma_engine::dump_descriptor(<Index>, <Channel>).
 
-        dump_descriptors [<Start> [<Count>]]
-          Call xtsc_dma_engine::dump_descriptors(<Start>, <Count>).  Wrap after 255 to 1.
+        dump_descriptors [<Start> [<Count> [<Channel>]]]
+          Call xtsc_dma_engine::dump_descriptors(<Start>, <Count>, <Channel>).  Wrap
+          after 255 to 1.
 
       \endverbatim
    */
@@ -393,6 +456,58 @@ public:
 protected:
 
 
+  /// The state of one DMA channel
+  class channel {
+  public:
+
+    /// Constructor
+    channel(xtsc::u32 index, xtsc::u32 reg_base_address);
+
+    /// Return the request ID to use for a request of the given kind (m_read_id, m_write_id, etc)
+    xtsc::u8 get_id(xtsc::u8 kind) const { return (xtsc::u8) ((m_index << 3) | kind); }
+
+    xtsc::u32                   m_index;                                ///< This channel's number
+    xtsc::u32                   m_reg_base_address;                     ///< Base address of this channel's DMA registers
+    bool                        m_busy;                                 ///< True if a DMA is in progress on this channel
+    bool                        m_big_endian;                           ///< Determined by write to "go" byte
+    xtsc_request                m_request;                              ///< For sending non-overlapped DMA requests
+    xtsc::u8                    m_data[xtsc::xtsc_max_bus_width8*16];   ///< Buffer read rsp data before sending out write req
+
+    sc_core::sc_event           m_dma_thread_event;                     ///< Used to notify dma_thread that "go" byte was written
+    sc_core::sc_event           m_read_slot_event;                      ///< Notified when this channel is awarded a read slot
+    sc_core::sc_event           m_no_reads_or_writes_event;             ///< Notified when this channel's reads and writes changes to 0
+    sc_core::sc_event           m_single_response_available_event;      ///< Notified when READ or WRITE rsp is received
+    sc_core::sc_event           m_block_read_response_available_event;  ///< Notified when a BLOCK_READ rsp is received
+    sc_core::sc_event           m_block_write_response_available_event; ///< Notified when a BLOCK_WRITE rsp is received
+
+    bool                        m_waiting_for_read_slot;                ///< True if this channel is waiting for a read slot
+    xtsc::u32                   m_num_reads;                            ///< Number of this channel's outstanding read transactions
+    xtsc::u32                   m_num_writes;                           ///< Number of this channel's outstanding write transactions
+    std::deque<xtsc_request*>   m_blank_write_deque;                    ///< deque of pre-formed write request without data
+    std::deque<xtsc_request*>   m_ready_write_deque;                    ///< deque of write requests with data, ready to be moved to m_request_deque
+    std::deque<xtsc::u32>       m_last_write_deque;                     ///< deque of dummy tokens - one for each last transfer write request
+    std::deque<xtsc::u32>       m_done_descriptor_deque;                ///< deque to track when overlapped descriptor complete.  There is one zero
+                                                                        ///< entry for each non-last read request of the descriptor.  The entry for the
+                                                                        ///< last read request of the descriptor is the descriptor index to be written
+                                                                        ///< to the done_descriptor field.
+
+    const xtsc::xtsc_response  *m_p_single_response;                    ///< Current rsp to READ or WRITE request
+
+    xtsc::u32                   m_num_block_transfers;                  ///< Number of BLOCK_READ responses in currect descriptor
+    xtsc::u32                   m_block_read_response_count;            ///< Number of BLOCK_READ responses received so far
+    sc_core::sc_time            m_p_block_read_response_time[16];       ///< Time when each BLOCK_READ rsp was received
+    const xtsc::xtsc_response  *m_p_block_read_response[16];            ///< Maintain our copy of BLOCK_READ responses
+
+    xtsc::u32                   m_block_write_sent_count;               ///< Number of BLOCK_WRITE requests sent so far
+    const xtsc::xtsc_response  *m_p_block_write_response;               ///< Current BLOCK_WRITE response
+
+    xtsc::u64                   m_num_dma_requests;                     ///< Number of DMA requests completed
+    xtsc::u64                   m_num_descriptors;                      ///< Number of descriptors completed
+    xtsc::u64                   m_num_bytes;                            ///< Number of bytes moved
+    sc_core::sc_time            m_busy_time;                            ///< Total time spent on DMA requests
+  };
+
+
   /// We override this method so we can detect writes to the "go" byte (the num_descriptors register)
   virtual void do_write(xtsc::u32 port_num);
 
@@ -401,15 +516,15 @@ protected:
   virtual void do_block_write(xtsc::u32 port_num);
 
 
-  /// DMA engine thread
-  void dma_thread();
+  /// DMA engine thread (one per channel)
+  void dma_thread(xtsc::u32 channel_num);
 
 
   /// Send read/write requests
   void request_thread();
 
 
-  /// Move write requests from m_ready_write_deque to m_request_deque with delays to honor "max_writes"
+  /// Move write requests from each channel's m_ready_write_deque to m_request_deque with delays to honor "max_writes"
   void write_thread();
 
 
@@ -417,35 +532,65 @@ protected:
   void sync_to_posedge(bool always_wait);
 
 
-  /// Check if the "go" byte was written (LSB of num_descriptors register located at "reg_base_address")
+  /// Check if the "go" byte of any channel was written (LSB of its num_descriptors register)
   void check_for_go_byte(xtsc::xtsc_address address8, xtsc::u32 size8, const xtsc::u8 *buffer);
 
 
-  /// Do descriptor using turbo (nb_peek/nb_poke)
-  void use_turbo(xtsc_dma_descriptor &dsc);
+  /// Get channel_num, throwing an exception if it is out of range
+  channel& get_channel(xtsc::u32 channel_num) const;
+
+
+  /// Wait until ch is awarded one of the "max_reads" slots
+  void acquire_read_slot(channel& ch);
+
+
+  /// Award free read slots to waiting channels according to "channel_arbitration"
+  void grant_read_slots();
+
+
+  /// Do descriptor using turbo (nb_peek/nb_poke or, if "turbo_fast_access", raw access memcpy)
+  void use_turbo(channel& ch, xtsc_dma_descriptor &dsc);
+
+
+  /**
+   * Get a raw pointer to address8 using nb_fast_access.
+   *
+   * @param     ch              The channel making the access.
+   *
+   * @param     address8        The address to be accessed.
+   *
+   * @param     write           True if write access is needed, false if read access is needed.
+   *
+   * @param     block_end8      On return, the last address of the raw access block.
+   *
+   * @return the host pointer for address8, or NULL if raw access in byte order is not granted.
+   */
+  xtsc::u8 *get_raw_pointer(channel& ch, xtsc::xtsc_address address8, bool write, xtsc::xtsc_address& block_end8);
 
 
   /// Do descriptor @idx using overlapped requests
-  void do_overlapped_requests(xtsc_dma_descriptor &dsc, xtsc::u32 idx);
+  void do_overlapped_requests(channel& ch, xtsc_dma_descriptor &dsc, xtsc::u32 idx);
 
 
   /// Do descriptor using non-overlapped, non-block READ/WRITE requests
-  void use_single_transfers(xtsc_dma_descriptor &dsc);
+  void use_single_transfers(channel& ch, xtsc_dma_descriptor &dsc);
 
 
   /// Do descriptor using non-overlapped BLOCK_READ/BLOCK_WRITE requests
-  void use_block_transfers(xtsc_dma_descriptor &dsc);
+  void use_block_transfers(channel& ch, xtsc_dma_descriptor &dsc);
 
 
   /// Send out a READ request
-  xtsc::xtsc_response::status_t remote_read(xtsc::xtsc_address          address8,
+  xtsc::xtsc_response::status_t remote_read(channel&                    ch,
+                                            xtsc::xtsc_address          address8,
                                             xtsc::u32                   size8,
                                             xtsc::xtsc_byte_enables     byte_enables,
                                             xtsc::u8                   *buffer);
 
 
   /// Send out a WRITE request
-  xtsc::xtsc_response::status_t remote_write(xtsc::xtsc_address         address8,
+  xtsc::xtsc_response::status_t remote_write(channel&                   ch,
+                                             xtsc::xtsc_address         address8,
                                              xtsc::u32                  size8,
                                              xtsc::xtsc_byte_enables    byte_enables,
                                              xtsc::u8                  *buffer,
@@ -453,14 +598,14 @@ protected:
 
 
   /// Send out a WRITE request of 4 bytes representing a 32-bit value (consider endianess)
-  xtsc::xtsc_response::status_t remote_write_u32(xtsc::xtsc_address address8, xtsc::u32 data);
+  xtsc::xtsc_response::status_t remote_write_u32(channel& ch, xtsc::xtsc_address address8, xtsc::u32 data);
 
 
   /// Common method to compute/re-compute time delays
   virtual void compute_delays();
 
 
-  /// Get a new xtsc_request (from the pool)
+  /// Get a new xtsc_request (from m_request_allocator)
   xtsc_request *new_request();
 
 
@@ -496,9 +641,10 @@ protected:
 
 
   xtsc_respond_if_impl          m_respond_impl;                         ///< m_respond_export binds to this
-  xtsc_request                  m_request;                              ///< For sending non-overlapped DMA requests
-  std::vector<xtsc_request*>    m_request_pool;                         ///< Maintain a pool of requests to improve performance
   xtsc::u32                     m_reg_base_address;                     ///< DMA registers base address ("reg_base_address" parameter)
+  xtsc::u32                     m_num_channels;                         ///< See parameter "num_channels"
+  xtsc::u32                     m_channel_spacing;                      ///< See parameter "channel_spacing"
+  bool                          m_round_robin;                          ///< True if "channel_arbitration" is "round_robin"
   xtsc::u32                     m_max_reads;                            ///< See parameter "max_reads"
   xtsc::u32                     m_max_writes;                           ///< See parameter "max_writes"
   xtsc::u32                     m_descriptor_delay;                     ///< See parameter "descriptor_delay"
@@ -510,7 +656,8 @@ protected:
   bool                          m_allow_size_zero;                      ///< See parameter "allow_size_zero"
   bool                          m_start_at_index_1;                     ///< See parameter "start_at_index_1"
   bool                          m_turbo;                                ///< See parameter "turbo" and method set_turbo()
-  bool                          m_big_endian;                           ///< Determined by write to "go" byte
+  bool                          m_turbo_fast_access;                    ///< See parameter "turbo_fast_access"
+  xtsc::u32                     m_turbo_bytes_per_cycle;                ///< See parameter "turbo_bytes_per_cycle"
 
   xtsc::u64                     m_clock_period_value;                   ///< This device's clock period as u64
   sc_core::sc_time              m_time_resolution;                      ///< The SystemC time resolution
@@ -518,49 +665,28 @@ protected:
   sc_core::sc_time              m_posedge_offset;                       ///< From "posedge_offset" parameter
   sc_core::sc_time              m_posedge_offset_plus_one;              ///< m_posedge_offset plus m_clock_period
 
-  xtsc::u8                      m_data[xtsc::xtsc_max_bus_width8*16];   ///< Buffer read rsp data before sending out write req
-  bool                          m_busy;                                 ///< True if a DMA is in progress
-  sc_core::sc_event             m_dma_thread_event;                     ///< Used to notify dma_thread that "go" byte was written
+  std::vector<channel*>         m_channels;                             ///< The DMA channels
+  xtsc::u32                     m_next_read_channel;                    ///< Where the round-robin search for a read slot starts
+  xtsc::u32                     m_next_write_channel;                   ///< Where the round-robin search for a write slot starts
   sc_core::sc_event             m_request_thread_event;                 ///< Used to notify request_thread that an xtsc_request is ready to send out
   sc_core::sc_event             m_write_thread_event;                   ///< Used to notify write_thread
-  sc_core::sc_event             m_got_read_response_event;              ///< Notified when a read response is received
-  sc_core::sc_event             m_no_reads_or_writes_event;             ///< Notified when total reads and writes changes to 0
-  sc_core::sc_event             m_single_response_available_event;      ///< Notified when READ or WRITE rsp is received (id=0x2|0x3)
-  sc_core::sc_event             m_block_read_response_available_event;  ///< Notified when a BLOCK_READ rsp is received (id=0x4)
-  sc_core::sc_event             m_block_write_response_available_event; ///< Notified when a BLOCK_WRITE rsp is received (id=0x5)
 
   bool                          m_overlap_read_write;                   ///< True if "max_reads" and "max_writes" are non-zero, else false.
-  xtsc::u32                     m_num_reads;                            ///< Number of outstanding read transactions
-  xtsc::u32                     m_num_writes;                           ///< Number of outstanding write transactions
+  xtsc::u32                     m_num_reads;                            ///< Number of outstanding read transactions (all channels)
+  xtsc::u32                     m_num_writes;                           ///< Number of outstanding write transactions (all channels)
   std::deque<xtsc_request*>     m_request_deque;                        ///< deque of overlapped read/write requests for request_thread
-  std::deque<xtsc_request*>     m_blank_write_deque;                    ///< deque of pre-formed write request without data
-  std::deque<xtsc_request*>     m_ready_write_deque;                    ///< deque of write requests with data, ready to be moved to m_request_deque
-  std::deque<xtsc::u32>         m_last_write_deque;                     ///< deque of dummy tokens - one for each last transfer write request
-  std::deque<xtsc::u32>         m_done_descriptor_deque;                ///< deque to track when overlapped descriptor complete.  There is one zero
-                                                                        ///< entry for each non-last read request of the descriptor.  The entry for the
-                                                                        ///< last read request of the descriptor is the descriptor index to be written
-                                                                        ///< to the done_descriptor field.
   bool                          m_waiting_for_nacc;                     ///< True if request_thread is waiting for RSP_NACC from downstream
   bool                          m_request_got_nacc;                     ///< True if request_thread request got RSP_NACC 
-
-  const xtsc::xtsc_response    *m_p_single_response;                    ///< Current rsp to READ or WRITE request
-
-  xtsc::u32                     m_num_block_transfers;                  ///< Number of BLOCK_READ responses in currect descriptor
-  xtsc::u32                     m_block_read_response_count;            ///< Number of BLOCK_READ responses received so far
-  sc_core::sc_time              m_p_block_read_response_time[16];       ///< Time when each BLOCK_READ rsp was received
-  const xtsc::xtsc_response    *m_p_block_read_response[16];            ///< Maintain our copy of BLOCK_READ responses
-
-  xtsc::u32                     m_block_write_sent_count;               ///< Number of BLOCK_WRITE requests sent so far
-  const xtsc::xtsc_response    *m_p_block_write_response;               ///< Current BLOCK_WRITE response
+  xtsc_allocator_client         m_request_allocator;                    ///< For xtsc_request objects
 
   sc_core::sc_time              m_nacc_wait_time;                       ///< See "nacc_wait_time" in xtsc_dma_engine_parms
 
-  static const xtsc::u8         m_read_id               = 0x2;          ///< xtsc_request::m_id for READ
-  static const xtsc::u8         m_write_id              = 0x3;          ///< xtsc_request::m_id for WRITE
-  static const xtsc::u8         m_block_read_id         = 0x4;          ///< xtsc_request::m_id for BLOCK_READ
-  static const xtsc::u8         m_block_write_id        = 0x5;          ///< xtsc_request::m_id for BLOCK_WRITE
-  static const xtsc::u8         m_overlapped_read_id    = 0x6;          ///< xtsc_request::m_id for overlapped READ/BLOCK_READ
-  static const xtsc::u8         m_overlapped_write_id   = 0x7;          ///< xtsc_request::m_id for overlapped WRITE/BLOCK_WRITE
+  static const xtsc::u8         m_read_id               = 0x2;          ///< xtsc_request::m_id for READ (in bits 0-2)
+  static const xtsc::u8         m_write_id              = 0x3;          ///< xtsc_request::m_id for WRITE (in bits 0-2)
+  static const xtsc::u8         m_block_read_id         = 0x4;          ///< xtsc_request::m_id for BLOCK_READ (in bits 0-2)
+  static const xtsc::u8         m_block_write_id        = 0x5;          ///< xtsc_request::m_id for BLOCK_WRITE (in bits 0-2)
+  static const xtsc::u8         m_overlapped_read_id    = 0x6;          ///< xtsc_request::m_id for overlapped READ/BLOCK_READ (in bits 0-2)
+  static const xtsc::u8         m_overlapped_write_id   = 0x7;          ///< xtsc_request::m_id for overlapped WRITE/BLOCK_WRITE (in bits 0-2)
 
 };
 
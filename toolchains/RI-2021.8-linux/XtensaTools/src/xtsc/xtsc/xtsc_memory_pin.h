@@ -23,6 +23,7 @@
 #include <xtsc/xtsc_module_pin_base.h>
 #include <xtsc/xtsc_memory_b.h>
 #include <xtsc/xtsc_request_if.h>
+#include <xtsc/xtsc_slab_allocator.h>
 
 
 
@@ -237,6 +238,17 @@ class xtsc_tlm2pin_memory_transactor;
    "vcd_handle"         void*   Pointer to SystemC VCD object (sc_trace_file *) or
                                 0 if tracing is not desired.
                                 Default = 0.
+
+   "activity_driven"    bool    If true, threads which would otherwise wake up once
+                                each clock period while waiting on another party (for
+                                example, waiting for PENABLE/PREADY on APB or waiting
+                                for the Write Address channel on AXI4) instead wait
+                                for the relevant signal or event and then re-sync to
+                                "sample_phase" or "drive_phase".  Pins are sampled and
+                                driven in the same clock cycles as when this parameter
+                                is false, but far fewer SystemC context switches occur
+                                when the interface is mostly idle.
+                                Default = false.
                                 
    "busy_percentage"    u32     This specifies the percentage of requests that will
                                 receive a busy/not-ready response.  This is for testing
@@ -629,6 +641,7 @@ public:
     add("busy_percentage",      0);
     add("data_busy_percentage", 0);
     add("vcd_handle",           (void*)NULL);
+    add("activity_driven",      false);
     add("cbox",                 false);
     add("banked",               false);
     add("num_subbanks",         0);
@@ -870,6 +883,9 @@ public:
 
         poke <StartAddress> <NumBytes> <Byte1> <Byte2> . . . <ByteN>
           Poke <NumBytes> (=N) of memory starting at <StartAddress>.
+
+        summary
+          Call xtsc_memory_pin::summary().
       \endverbatim
    */
   void execute(const std::string&               cmd_line,
@@ -915,6 +931,14 @@ public:
   virtual void reset(bool hard_reset = false);
 
 
+  /**
+   * Print the peak usage of the pif_req_info, axi_addr_info, and axi_data_info pools.
+   * Pooled objects are never freed, so the number of each kind that has been created is
+   * the peak number in use.
+   */
+  void summary(std::ostream& os = std::cout);
+
+
   /// Return true if pin port names include the set_id as a suffix
   bool get_append_id() const { return m_append_id; }
 
@@ -1256,6 +1280,10 @@ protected:
   std::deque<axi_addr_info*>   *m_axi_wr_rsp_fifo;              ///< The fifo of wr addr requests awaiting wr responses           (per mem port)
   std::vector<axi_addr_info*>   m_axi_addr_pool;                ///< Pool of axi_addr_info objects
   std::vector<axi_data_info*>   m_axi_data_pool;                ///< Pool of axi_data_info objects
+  xtsc_allocator_client         m_allocator;                    ///< Backing store for the three pools above
+  xtsc::u32                     m_num_pif_req_infos;            ///< Number of pif_req_info objects created (peak number in use)
+  xtsc::u32                     m_num_axi_addr_infos;           ///< Number of axi_addr_info objects created (peak number in use)
+  xtsc::u32                     m_num_axi_data_infos;           ///< Number of axi_data_info objects created (peak number in use)
   xtsc::u32                     m_request_fifo_depth;           ///< From "request_fifo_depth" parameter
   xtsc::u32                     m_num_ports;                    ///< The number of ports this memory has
   xtsc::u32                     m_num_axi_rd_ports;             ///< Number of AXI4 read  memory ports
@@ -1345,6 +1373,7 @@ protected:
   bool                          m_has_lock;                     ///< True if memory interface has a lock pin
                                                                 ///<  (DRAM0|DRAM0BS|DRAM0RW|DRAM1|DRAM1BS|DRAM1RW only)
   bool                          m_has_xfer_en;                  ///< True if memory interface has Xfer enable pin 
+  bool                          m_activity_driven;              ///< See "activity_driven" parameter
                                                                 ///<  (NA PIF|IDMA0|DROM0|XLMI0)
   bool                         *m_testing_busy;                 ///< We're de-asserting PIReqRdy|AxREADY because of "busy_percentage"
   bool                         *m_testing_busy_data;            ///< We're de-asserting           WREADY because of "data_busy_percentage"
@@ -1359,6 +1388,7 @@ protected:
   sc_core::sc_event            *m_respond_event;                ///< Event used to notify pif_request_thread            (per mem port)
   sc_core::sc_event            *m_axi_rd_rsp_event;             ///< Event used to notify axi_rd_rsp_thread             (per mem port)
   sc_core::sc_event            *m_axi_wr_data_event;            ///< Event used to notify axi_wr_data_thread            (per mem port)
+  sc_core::sc_event            *m_axi_wr_addr_event;            ///< Event used to notify axi_wr_data_thread of a write address (per mem port)
   sc_core::sc_event            *m_axi_wr_rsp_event;             ///< Event used to notify axi_wr_rsp_thread             (per mem port)
   sc_core::sc_event            *m_axi_addr_rdy_event;           ///< Event used to notify axi_drive_addr_rdy_thread     (per mem port)
   sc_core::sc_event            *m_axi_data_rdy_event;           ///< Event used to notify axi_drive_data_rdy_thread     (per mem port)
@@ -22,6 +22,7 @@
 #endif
 #include <xtsc/xtsc_parms.h>
 #include <xtsc/xtsc_memory_b.h>
+#include <xtsc/xtsc_memory_checkpoint.h>
 #include <cstring>
 #include <vector>
 
@@ -516,7 +517,10 @@ public:
    * Non-hardware writes (for example, writes from the debugger).
    * @see xtsc::xtsc_request_if::nb_poke
    */
-  void poke(xtsc::xtsc_address address8, xtsc::u32 size8, const xtsc::u8 *buffer) { m_p_memory->poke(address8, size8, buffer); }
+  void poke(xtsc::xtsc_address address8, xtsc::u32 size8, const xtsc::u8 *buffer) {
+    if (m_p_checkpoint) { m_p_checkpoint->before_write(address8, size8); }
+    m_p_memory->poke(address8, size8, buffer);
+  }
 
 
   /**
@@ -604,6 +608,11 @@ public:
           Call xtsc_memory_tlm2::change_clock_period(<ClockPeriodFactor>).  Return previous
           <ClockPeriodFactor> for this device.
 
+        checkpoint save|restore|discard
+          Call xtsc_memory_tlm2::checkpoint_save(), xtsc_memory_tlm2::checkpoint_restore(),
+          or xtsc_memory_tlm2::checkpoint_discard().  For restore, return the number of
+          pages restored.
+
         invalidate_direct_mem_ptr <StartAddress> <EndAddress> [<Port>]
           Call xtsc_memory_tlm2::invalidate_direct_mem_ptr(<Port, <StartAddress>,
           <EndAddress>).  Default <Port> is 0.
@@ -621,6 +630,9 @@ public:
         reset [<Hard>]
           Call xtsc_memory_tlm2::reset(<Hard>).  Where <Hard> is 0|1 (default 0).
 
+        summary
+          Call xtsc_memory_tlm2::summary().
+
         test_end_req_phase 0|1
           Set m_test_end_req_phase to 0|1.  Return previous value of m_test_end_req_phase.
 
@@ -691,6 +703,41 @@ public:
   void reset(bool hard_reset = false);
 
 
+  /**
+   * Print, for each port, the peak number of transactions held in the nb2b_thread and
+   * tlm_accepted_thread payload event queues.  This memory allocates no objects of its
+   * own per transaction (the tlm_generic_payload objects belong to the initiator), so
+   * these queues are its only per-transaction storage.
+   */
+  void summary(std::ostream& os = std::cout);
+
+
+  /**
+   * Save a copy-on-write checkpoint of the memory contents (any previous checkpoint is
+   * discarded).  No memory contents are copied by this call; instead, each page is
+   * copied the first time it is about to be modified afterwards.  All DMI pointers are
+   * invalidated on all ports and, while a checkpoint is active, DMI is only granted for
+   * reads so that all writes come through b_transport/nb_transport/transport_dbg.
+   *
+   * @see xtsc_memory_checkpoint
+   */
+  void checkpoint_save();
+
+
+  /**
+   * Restore the memory contents to what they were when checkpoint_save() was called.
+   * The cost is proportional to the number of pages modified since then.  The
+   * checkpoint remains active so it can be restored again.
+   *
+   * @returns the number of pages restored.
+   */
+  xtsc::u32 checkpoint_restore();
+
+
+  /// Discard the checkpoint (if any)
+  void checkpoint_discard();
+
+
   /**
    * Method to change the clock period.
    *
@@ -801,6 +848,7 @@ protected:
 
   /// Helper method to write a u8 value (allocate as needed).
   virtual void write_u8(xtsc::xtsc_address address8, xtsc::u8 value) {
+    if (m_p_checkpoint) { m_p_checkpoint->before_write(address8, 1); }
     m_p_memory->write_u8(address8, value);
   }
 
@@ -813,6 +861,7 @@ protected:
 
   /// Helper method to write a u32 value (allocate as needed).
   virtual void write_u32(xtsc::xtsc_address address8, xtsc::u32 value, bool big_endian = false) {
+    if (m_p_checkpoint) { m_p_checkpoint->before_write(address8, 4); }
     m_p_memory->write_u32(address8, value, false);
   }
 
@@ -830,12 +879,17 @@ protected:
 
   tlm_fw_transport_if_impl            **m_tlm_fw_transport_if_impl;     ///<  The m_target_sockets_BW objects bind to these
   xtsc::xtsc_memory_b                  *m_p_memory;                     ///<  The memory itself
+  xtsc_memory_checkpoint               *m_p_checkpoint;                 ///<  Created by the first checkpoint_save() call
 
   peq                                 **m_nb2b_thread_peq;              ///<  For nb_transport/nb2b_thread (per port)
   xtsc::u32                             m_port_nb2b_thread;             ///<  Used by nb2b_thread to get its port number
+  std::vector<xtsc::u32>                m_nb2b_thread_peq_count;        ///<  Transactions in m_nb2b_thread_peq (per port)
+  std::vector<xtsc::u32>                m_nb2b_thread_peq_peak;         ///<  Peak of m_nb2b_thread_peq_count (per port)
 
   peq                                 **m_tlm_accepted_thread_peq;      ///<  For tlm_accepted_thread (per port)
   xtsc::u32                             m_port_tlm_accepted_thread;     ///<  Used by tlm_accepted_thread to get its port number
+  std::vector<xtsc::u32>                m_tlm_accepted_thread_peq_count;///<  Transactions in m_tlm_accepted_thread_peq (per port)
+  std::vector<xtsc::u32>                m_tlm_accepted_thread_peq_peak; ///<  Peak of m_tlm_accepted_thread_peq_count (per port)
 
   sc_core::sc_time                      m_clock_period;                 ///<  The clock period of this memory
 
@@ -21,9 +21,11 @@
 #include <xtsc/xtsc_response.h>
 #include <xtsc/xtsc_address_range_entry.h>
 #include <xtsc/xtsc_fast_access.h>
+#include <xtsc/xtsc_slab_allocator.h>
 #include <vector>
 #include <map>
 #include <cstring>
+#include <fstream>
 
 
 
@@ -41,6 +43,134 @@ class xtsc_pin2tlm_memory_transactor;
 class xtsc_router;
 
 
+/**
+ * One record of an xtsc_memory_trace binary trace file.
+ *
+ * One record is written for each xtsc::xtsc_request and each xtsc::xtsc_response that
+ * passes through an xtsc_memory_trace whose "binary_trace_file" parameter is set.
+ *
+ * @see xtsc_memory_trace_parms "binary_trace_file"
+ * @see xtsc_memory_trace_reader
+ */
+struct XTSC_COMP_API xtsc_memory_trace_record {
+
+  /// Record kinds
+  typedef enum kind_t {
+    REQUEST             = 0,    ///< nb_request() call
+    RESPONSE            = 1,    ///< nb_respond() call that was accepted
+    RESPONSE_BUSY       = 2,    ///< nb_respond() call that was rejected (returned false)
+  } kind_t;
+
+  xtsc::u64             m_timestamp;    ///<  Simulation time in units of the time resolution
+  xtsc::u64             m_address8;     ///<  Byte address
+  xtsc::u64             m_tag;          ///<  Transaction tag
+  xtsc::u32             m_size8;        ///<  Byte size of the transfer
+  xtsc::u32             m_latency;      ///<  Clock periods since the transaction's first request, or since its first request after an RSP_NACC (0 for requests)
+  xtsc::u32             m_port;         ///<  Port number
+  xtsc::u8              m_kind;         ///<  See kind_t
+  xtsc::u8              m_type;         ///<  Request type (xtsc_request::type_t) or response status (xtsc_response::status_t)
+
+  /// Return the string name of the specified kind
+  static const char *get_kind_name(xtsc::u8 kind);
+};
+
+
+
+/**
+ * Reader for binary trace files written by xtsc_memory_trace.
+ *
+ * This class does not require a running simulation and can be used from any host
+ * program to post-process a binary trace file.  The file format is:
+ *  \verbatim
+   Header (32 bytes):
+     char[8]    "XTSCMTB1"
+     u32        Format version (1)
+     u32        Number of ports
+     u64        Time resolution in femtoseconds (size of one timestamp tick)
+     u64        XTSC system clock period in timestamp ticks
+   Followed by zero or more chunks:
+     u32        Number of records in the chunk
+     u32        Number of encoded bytes in the chunk
+     u8[]       Encoded records
+    \endverbatim
+ * All multi-byte header fields are little-endian.  Within a chunk each record is
+ * encoded as LEB128 variable-length integers: the timestamp, address, and tag are
+ * stored as zig-zag encoded differences from the previous record of the chunk, and the
+ * port, kind, type, size, and latency are stored as-is.  Each chunk can be decoded
+ * independently of the others.
+ *
+ * @see xtsc_memory_trace_record
+ * @see xtsc_memory_trace_parms "binary_trace_file"
+ */
+class XTSC_COMP_API xtsc_memory_trace_reader {
+public:
+
+  /**
+   * Constructor.  Opens file_name and reads its header.
+   *
+   * @param     file_name       The binary trace file to read.
+   *
+   * @throws xtsc::xtsc_exception if the file cannot be opened or is not a binary trace file.
+   */
+  xtsc_memory_trace_reader(const std::string& file_name);
+
+
+  /**
+   * Read the next record.
+   *
+   * @param     record          Set to the next record of the file.
+   *
+   * @returns false when there are no more records, otherwise returns true.
+   */
+  bool read(xtsc_memory_trace_record& record);
+
+
+  /// Get the number of ports of the xtsc_memory_trace which wrote the file
+  xtsc::u32 get_num_ports() const { return m_num_ports; }
+
+
+  /// Get the size of one timestamp tick in femtoseconds
+  xtsc::u64 get_time_resolution_fs() const { return m_time_resolution_fs; }
+
+
+  /// Get the XTSC system clock period in timestamp ticks
+  xtsc::u64 get_clock_period() const { return m_clock_period; }
+
+
+  /**
+   * Write the remaining records to os in CSV format, one line per record with a header
+   * line of column names.
+   */
+  void convert_to_csv(std::ostream& os);
+
+
+  /**
+   * Write the remaining records to os in VCD format.  Each port has kind, type, address,
+   * size, tag, and latency signals.  When a port has more than one record at the same
+   * timestamp, only the last one is visible in the waveform.  Throws xtsc_exception if a
+   * record's port is not less than the number of ports in the file header.
+   */
+  void convert_to_vcd(std::ostream& os);
+
+
+private:
+
+  /// Read the next chunk into m_chunk.  Return false at end of file.
+  bool read_chunk();
+
+  std::string                           m_file_name;            ///<  The binary trace file
+  std::ifstream                         m_file;                 ///<  The binary trace file stream
+  xtsc::u32                             m_num_ports;            ///<  From the file header
+  xtsc::u64                             m_time_resolution_fs;   ///<  From the file header
+  xtsc::u64                             m_clock_period;         ///<  From the file header
+  std::vector<xtsc::u8>                 m_chunk;                ///<  The encoded bytes of the current chunk
+  xtsc::u32                             m_chunk_offset;         ///<  Offset of the next record in m_chunk
+  xtsc::u32                             m_records_left;         ///<  Records remaining in the current chunk
+  xtsc_memory_trace_record              m_previous;             ///<  Previous record of the current chunk
+};
+
+
+
 /**
  * Constructor parameters for a xtsc_memory_trace object.
  *
@@ -110,6 +240,21 @@ class xtsc_router;
                                 called.
                                 Default = 0.
 
+   "binary_trace_file"   char*  If not NULL or empty, then a compact binary record of
+                                each request and response (timestamp, port, kind,
+                                type/status, address, size, tag, and latency) is written
+                                to the file named by this parameter.  The records are
+                                written in compressed chunks and are much faster to
+                                write and much smaller than a VCD file.  Binary tracing
+                                is independent of "allow_tracing" and "enable_tracing".
+                                Use xtsc_memory_trace_reader to read the file or convert
+                                it to CSV or VCD format.
+                                Default = NULL.
+
+   "binary_trace_chunk"  u32    The number of records buffered and compressed together
+                                before being written to "binary_trace_file".
+                                Default = 4096.
+
     \endverbatim
  *
  * @see xtsc_memory_trace
@@ -198,6 +343,8 @@ protected:
     add("enable_tracing",       true);
     add("track_latency",        false);
     add("num_transfers",        0);
+    add("binary_trace_file",    (char*)NULL);
+    add("binary_trace_chunk",   4096);
   }
 };
 
@@ -490,6 +637,60 @@ public:
    * @see cntr_type
    */
   void dump_lifetime_histogram(std::ostream& os = std::cout, const std::string& types = "", const std::string& ports = "");
+
+
+  /**
+   * Return the specified percentile of the aggregate latency or lifetime histogram of
+   * the specified xtsc::xtsc_request::type_t types and ports.
+   *
+   * The histograms use log-linear buckets (see latency_histogram) so the value returned
+   * is exact for values below 64 clock periods and within about 3% above that.
+   *
+   * @param     histogram       Either "latency" or "lifetime".
+   *
+   * @param     percentile      The desired percentile from 0.0 to 100.0 (for example,
+   *                            50.0, 99.0, or 99.9).
+   *
+   * @param     types           A comma separated list of the xtsc::xtsc_request::type_t
+   *                            types desired (for example, "READ,BLOCK_READ").  The
+   *                            empty string ("") or asterisk ("*") both mean all
+   *                            tracked request types.
+   *
+   * @param     ports           A comma separated list of the desired port numbers (for
+   *                            examples, "1,3,5").  The empty string ("") or asterisk
+   *                            ("*") both mean all ports.
+   */
+  xtsc::u64 get_percentile(const std::string& histogram, double percentile, const std::string& types = "",
+                           const std::string& ports = "");
+
+
+  /**
+   * Dump the 50th, 99th, and 99.9th percentiles of the aggregate latency and lifetime
+   * histograms of the specified xtsc::xtsc_request::type_t types and ports.  For
+   * example:
+   *  \verbatim
+      latency:  p50=27 p99=47 p999=47
+      lifetime: p50=61 p99=76 p999=76
+      \endverbatim
+   *
+   * @see get_percentile
+   */
+  void dump_percentiles(std::ostream& os = std::cout, const std::string& types = "", const std::string& ports = "");
+
+
+  /**
+   * Dump statistic info for the interval since the previous call to this method (or
+   * since the start of simulation) and then start a new interval.
+   *
+   * The output has the same format as dump_statistic_info except that it only reflects
+   * transactions which completed during the interval and the tag of the transaction
+   * with the maximum latency and lifetime is not shown.  This method can be called
+   * (for example, from the command interface) at any time without affecting the
+   * cumulative statistics.
+   *
+   * @see dump_statistic_info
+   */
+  void snapshot_statistic_info(std::ostream& os = std::cout, const std::string& types = "", const std::string& ports = "");
   
   
   /**
@@ -508,6 +709,10 @@ public:
           Call dump_lifetime_histogram() for the specified request <Types> and <Ports>.
           Default all <Types> and <Ports>.
 
+        dump_percentiles [<Types> [<Ports>]]
+          Call dump_percentiles() for the specified request <Types> and <Ports>.
+          Default all <Types> and <Ports>.
+
         dump_statistic_info [<Types> [<Ports>]]
           Call statistic_info::dump() for each of the specified request <Types> and <Ports>.
           Default all <Types> and <Ports>.
@@ -527,9 +732,17 @@ public:
         get_num_ports
           Return value from calling xtsc_memory_trace::get_num_ports().
 
+        get_percentile <Histogram> <Percentile> [<Types> [<Ports>]]
+          Return value from calling xtsc_memory_trace::get_percentile(<Histogram>,
+          <Percentile>, <Types>, <Ports>).  Default all <Types> and <Ports>.
+
         reset
           Call xtsc_memory_trace::reset().  
 
+        snapshot_statistic_info [<Types> [<Ports>]]
+          Call snapshot_statistic_info() for the specified request <Types> and <Ports>.
+          Default all <Types> and <Ports>.
+
       \endverbatim
    */
   virtual void execute(const std::string&               cmd_line,
@@ -680,6 +893,10 @@ public:
   log4xtensa::TextLogger& get_text_logger() { return m_text; }
 
 
+  /// Write any buffered binary trace records to "binary_trace_file"
+  void flush_binary_trace();
+
+
 protected:
 
 
@@ -730,6 +947,11 @@ protected:
 
   // Clear the transaction list when "enable_latency_tracking" is set to false
   void clear_transaction_list();
+
+
+  /// Buffer one binary trace record (and write the chunk when it is full)
+  void binary_trace(xtsc::u32 port_num, xtsc::u8 kind, xtsc::u8 type, xtsc::u64 address8, xtsc::u32 size8, xtsc::u64 tag,
+                    bool last_response);
     
     
   /**
@@ -754,11 +976,36 @@ protected:
   };
   
 
-  /// Get a new transaction_info (from the pool)
+  /**
+   * Open-addressing hash table which maps a transaction tag to its transaction_info.
+   *
+   * Linear probing is used over a power-of-2 sized table which doubles when it becomes
+   * half full.  erase() uses backward-shift deletion so no tombstones are needed.
+   */
+  class pending_table {
+  public:
+    pending_table();
+    transaction_info *find(u64 tag) const;                      ///< Return the entry for tag or 0 if none
+    void insert(u64 tag, transaction_info *p_info);             ///< Add tag (which must not already be present)
+    transaction_info *erase(u64 tag);                           ///< Remove tag and return its entry (0 if none)
+    void get_all(std::vector<transaction_info*>& infos) const;  ///< Append all entries to infos
+    void clear();                                               ///< Remove all entries
+    bool empty() const { return (m_size == 0); }                ///< True if there are no entries
+  private:
+    xtsc::u32 home(u64 tag) const { return (xtsc::u32) ((tag * 0x9E3779B97F4A7C15ull) >> 32) & m_mask; }
+    void grow();
+    std::vector<u64>                    m_tags;                 ///< Tag of each slot
+    std::vector<transaction_info*>      m_infos;                ///< Entry of each slot (0 means the slot is empty)
+    xtsc::u32                           m_mask;                 ///< Number of slots minus 1
+    xtsc::u32                           m_size;                 ///< Number of entries
+  };
+
+
+  /// Get a new transaction_info (from m_allocator)
   transaction_info *new_transaction_info(type_t type);
   
 
-  /// Delete an transaction_info (return it to the pool)
+  /// Delete an transaction_info (return it to m_allocator)
   void delete_transaction_info(transaction_info*& p_transaction_info);
 
 
@@ -787,6 +1034,35 @@ protected:
   static cntr_type get_cntr_type(std::string name);
 
 
+  /**
+   * Log-linear (HDR-style) histogram of clock period counts.
+   *
+   * Values below 2*sub_bucket_count are counted exactly.  Above that, each power of 2 is
+   * split into sub_bucket_count linear buckets, so a value is known to within
+   * 1/sub_bucket_count (about 3%).  The buckets are a fixed array so recording a value
+   * never allocates.
+   */
+  class latency_histogram {
+  public:
+    static const xtsc::u32 sub_bucket_bits  = 5;                                ///< log2 of sub_bucket_count
+    static const xtsc::u32 sub_bucket_count = 1 << sub_bucket_bits;             ///< Linear buckets per power of 2
+    static const xtsc::u32 bucket_count     = (64 - sub_bucket_bits + 1) * sub_bucket_count;   ///< Buckets to cover all u64 values
+    latency_histogram();
+    void record(u64 value) { m_counts[get_bucket(value)] += 1; m_total += 1; } ///< Count one occurrence of value
+    u64 get_total() const { return m_total; }                                 ///< Number of values recorded
+    u64 get_percentile(double percentile) const;                              ///< Highest value of the bucket holding percentile
+    void add(const latency_histogram& other);                                 ///< Add the counts of other
+    void subtract(const latency_histogram& other);                            ///< Subtract the counts of other
+    void dump(std::ostream& os, bool one_per_line) const;                     ///< Dump "Low,Count" lines or a "Low=Count,..." list
+    static xtsc::u32 get_bucket(u64 value);                                   ///< Return the bucket counting value
+    static u64 get_bucket_low(xtsc::u32 bucket);                              ///< Return the lowest value counted by bucket
+    static u64 get_bucket_high(xtsc::u32 bucket);                             ///< Return the highest value counted by bucket
+  private:
+    u64                 m_counts[bucket_count];                 ///< Count of each bucket
+    u64                 m_total;                                ///< Sum of m_counts
+  };
+
+
   /**
    * This class is used to keep track of transaction statistics.
    *
@@ -801,14 +1077,19 @@ protected:
   public:
     statistic_info();
     bool dump(std::ostream& os = std::cout, const std::string& prefix = "");
+    void subtract(const statistic_info& base);  ///< Make this the statistics since base was copied from it
     xtsc::u64           m_max_latency;          ///< Maximum latency
     xtsc::u64           m_max_lifetime;         ///< Maximum lifetime
     xtsc::u64           m_max_latency_tag;      ///< Transaction tag with maximum latency
     xtsc::u64           m_max_lifetime_tag;     ///< Transaction tag with maximum lifetime
     xtsc::u64           m_cntrs[cntr_count];    ///< Array of counters
-    std::map<u64, u64>  m_latency_histogram;    ///< Map latency  (first) to count (second)
-    std::map<u64, u64>  m_lifetime_histogram;   ///< Map lifetime (first) to count (second)
+    latency_histogram   m_latency_histogram;    ///< Latency  histogram
+    latency_histogram   m_lifetime_histogram;   ///< Lifetime histogram
   };  
+
+
+  /// Common helper method to sum the latency or lifetime histograms of the specified types and ports into histogram
+  void get_histogram(latency_histogram& histogram, const std::string& types, const std::string& ports, bool latency);
   
   
   /// Implementation of xtsc_request_if.
@@ -962,11 +1243,19 @@ protected:
   bool                                  m_enable_tracing;               ///<  See "enable_tracing" parameter enable_tracing method/command
   bool                                  m_track_latency;                ///<  See "track_latency" parameter and enable_latency_tracking method/command
   bool                                  m_did_track;                    ///<  True if m_track_latency was ever true.
-  std::vector<transaction_info*>        m_transaction_pool;             ///<  Maintain a pool of transaction_info objects to improve performance
-  std::map<u64, transaction_info*>      m_pending_transactions;         ///<  Map of all transactions in progress
+  xtsc_allocator_client                 m_allocator;                    ///<  For transaction_info objects
+  pending_table                         m_pending_transactions;         ///<  All transactions in progress
   std::map<type_t, statistic_info*>    *m_statistics_maps;              ///<  Map request type to statistic_info (one map per port)
+  std::map<type_t, statistic_info*>    *m_snapshot_maps;                ///<  Copy of m_statistics_maps at the last snapshot_statistic_info
+  sc_core::sc_time                      m_snapshot_time;                ///<  Time of the last snapshot_statistic_info
   sc_core::sc_time                      m_system_clock_period;          ///<  The XTSC System Clock Period (SCP)
   sc_core::sc_time                      m_system_clock_period_half;     ///<  One-half of the XTSC System Clock Period (SCP/2)
+  std::string                           m_binary_trace_file_name;       ///<  See "binary_trace_file" parameter
+  xtsc::u32                             m_binary_trace_chunk;           ///<  See "binary_trace_chunk" parameter
+  std::ofstream                        *m_binary_trace_stream;          ///<  The binary trace file (0 if not binary tracing)
+  std::vector<xtsc_memory_trace_record> m_binary_trace_records;         ///<  Records waiting to be written
+  std::vector<xtsc::u8>                 m_binary_trace_buffer;          ///<  Encoded bytes of the chunk being written
+  std::map<u64, u64>                    m_binary_trace_start;           ///<  Map tag to timestamp of the transaction's first request
   
   log4xtensa::TextLogger&               m_text;                         ///<  Text logger
 
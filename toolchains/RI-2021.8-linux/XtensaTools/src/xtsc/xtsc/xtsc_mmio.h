@@ -161,6 +161,21 @@ namespace xtsc_component {
                                 of 0 means one delta cycle.
                                 Default = 1.
 
+   "max_decode_span"    u32     At the end of construction, the address range from the
+                                lowest register byte address to the highest register
+                                byte address (the aperture) is compared against this
+                                parameter.  If the aperture spans this many bytes or
+                                fewer, a flat decode table indexed by byte offset into
+                                the aperture is built so that each memory-mapped access
+                                is decoded in constant time.  Each table entry holds the
+                                register and the precomputed bit range (and, for
+                                registers of 64 bits or less, a u64 mask) that the
+                                byte address maps to.  If the aperture is larger than
+                                this parameter, then accesses are decoded using an
+                                address map lookup instead.  A value of 0 means never
+                                build the decode table.
+                                Default = 0x10000 (64 KB).
+
     \endverbatim
  *
  * @see xtsc_mmio
@@ -187,6 +202,7 @@ public:
     add("clock_period",         0xFFFFFFFF);
     add("response_time",        1);
     add("always_write",         true);
+    add("max_decode_span",      0x10000);
   }
 
   /// Our C++ type (the xtsc_parms base class uses this for error messages)
@@ -614,9 +630,11 @@ protected:
   class register_definition;
   class output_definition;
   class input_definition;
+  class decode_entry;
 
   // Shorthand aliases
   typedef std::map<xtsc::xtsc_address, register_definition*>    address_register_map;
+  typedef std::vector<decode_entry>                             decode_table;
   typedef std::map<std::string, register_definition*>           register_definition_map;
   typedef std::map<std::string, output_definition*>             output_definition_map;
   typedef std::map<std::string, input_definition*>              input_definition_map;
@@ -653,6 +671,25 @@ protected:
   register_definition *get_register(xtsc::xtsc_address address, xtsc::u32& high_bit, xtsc::u32& low_bit);
 
 
+  /**
+   * Decode address into the register byte lane it maps to.
+   *
+   * If the flat decode table was built (see the "max_decode_span" parameter) and address
+   * is inside the aperture, this is a single table index.  Otherwise, get_register() is
+   * used to fill in m_decode_scratch.
+   *
+   * @param     address         in      The address of interest.
+   *
+   * @returns A pointer to the decode_entry for address.  The m_p_register member of the
+   *          returned entry is NULL if address does not map to a register.
+   */
+  const decode_entry *decode(xtsc::xtsc_address address);
+
+
+  /// Build m_decode_table from m_address_register_map (if the aperture is small enough)
+  void build_decode_table();
+
+
   /// Extract a u32 value (named argument_name) from the word at m_words[index]
   xtsc::u32 get_u32(xtsc::u32 index, const std::string& argument_name);
 
@@ -799,6 +836,8 @@ protected:
     output_set                  m_output_set;           ///< Set of output_definition's
     input_set                   m_input_set;            ///< Set of input_definition's
     bool                        m_read_only;            ///< Is the register read only
+    bool                        m_narrow;               ///< True if m_bit_width <= 64 (values are handled as u64)
+    bool                        m_touched;              ///< True while in xtsc_mmio::m_touched_registers
   };
 
 
@@ -821,11 +860,30 @@ protected:
     std::string                 m_reg_name;             ///< Name or our associated register
     xtsc::u32                   m_high_bit;             ///< High bit of register
     xtsc::u32                   m_low_bit;              ///< Low bit of register
+    xtsc::u64                   m_mask;                 ///< Mask of [m_high_bit:m_low_bit] (0 if register is not m_narrow)
+    sc_dt::sc_unsigned         *m_p_value;              ///< Reused for the value written to m_p_wire_write_port
     wire_write_port            *m_p_wire_write_port;    ///< sc_port for this output
   };
 
 
 
+  /**
+   * One byte address of the memory-mapped aperture.
+   */
+  class decode_entry {
+  public:
+
+    /// Constructor
+    decode_entry() : m_p_register(NULL), m_high_bit(0), m_low_bit(0), m_mask(0) {}
+
+    register_definition        *m_p_register;           ///< Register the byte address maps to (NULL if none)
+    xtsc::u32                   m_high_bit;             ///< High bit of register
+    xtsc::u32                   m_low_bit;              ///< Low bit of register
+    xtsc::u64                   m_mask;                 ///< Mask of [m_high_bit:m_low_bit] (0 if register is not m_narrow)
+  };
+
+
+
   /**
    * Input definition and sc_export.
    */
@@ -906,6 +964,12 @@ protected:
   xtsc::u32                     m_line_count;                   ///< Current line number in script file
   std::vector<std::string>      m_words;                        ///< Current line in script file tokenized into words
   address_register_map          m_address_register_map;         ///< Map from address to register definition
+  decode_table                  m_decode_table;                 ///< Flat decode table (empty if aperture > "max_decode_span")
+  xtsc::xtsc_address            m_decode_base;                  ///< Lowest address covered by m_decode_table
+  xtsc::u32                     m_max_decode_span;              ///< See "max_decode_span" parameter
+  decode_entry                  m_decode_scratch;               ///< Returned by decode() when m_decode_table is not used
+  std::vector<register_definition*>
+                                m_touched_registers;            ///< Registers written by the current write_bytes() call
   register_definition_map       m_register_definition_map;      ///< Map of register definitions
   output_definition_map         m_output_definition_map;        ///< Map of output definitions
   input_definition_map          m_input_definition_map;         ///< Map of input definitions
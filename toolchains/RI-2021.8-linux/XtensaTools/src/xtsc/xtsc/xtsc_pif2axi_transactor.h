@@ -23,6 +23,7 @@
 #include <xtsc/xtsc_response.h>
 #include <xtsc/xtsc_fast_access.h>
 #include <xtsc/xtsc_core.h>
+#include <xtsc/xtsc_slab_allocator.h>
 #include <vector>
 #include <deque>
 #include <queue>
@@ -598,26 +599,44 @@ private:
  };
 
 
-  /// Get a new copy of an xtsc_request (from the pool)
+  /// Get a new copy of an xtsc_request (from m_allocator)
   xtsc::xtsc_request *copy_request(const xtsc::xtsc_request& request);
 
 
-  /// Get a new xtsc_request (from the pool)
+  /// Get a new xtsc_request (from m_allocator)
   xtsc::xtsc_request *new_request();
 
 
-  /// Delete an xtsc_request (return it to the pool)
+  /// Delete an xtsc_request (return it to m_allocator)
   void delete_request(xtsc::xtsc_request*& p_request);
 
 
-  /// Get a new req_rsp_info (from the pool)
+  /// Get a new req_rsp_info (from m_allocator)
   req_rsp_info *new_req_rsp_info();
 
 
-  /// Delete a req_rsp_info (return it to the pool)
+  /// Delete a req_rsp_info (return it to m_allocator)
   void delete_req_rsp_info(req_rsp_info*& p_req_rsp_info);
 
 
+  /// Get a new req_sched_info (from m_allocator)
+  req_sched_info *new_req_sched_info(xtsc::xtsc_request *p_pif_request, const sc_core::sc_time& sched_time);
+
+
+  /// Delete a req_sched_info (return it to m_allocator)
+  void delete_req_sched_info(req_sched_info*& p_req_sched_info);
+
+
+  /// Get a new xtsc_response (from m_allocator)
+  xtsc::xtsc_response *new_response(const xtsc::xtsc_request&           request,
+                                    xtsc::xtsc_response::status_t       status          = xtsc::xtsc_response::RSP_OK,
+                                    bool                                last_transfer   = true);
+
+
+  /// Delete an xtsc_response (return it to m_allocator)
+  void delete_response(xtsc::xtsc_response*& p_response);
+
+
   /// SystemC thread to handle read requests to each target
   void read_request_thread(void);
 
@@ -713,10 +732,7 @@ private:
   std::map<xtsc::u64, xtsc::u64>           **m_axi_tag_from_pif_tag_map;            ///<  Map for tags of axi requests created from pif requests 
   std::deque<xtsc::u64>                    **m_pif_request_order_dq;                ///<  PIF request ordered queue
   std::map<std::string, xtsc::u32>           m_bit_width_map;                       ///<  For xtsc_connection_interface
-  std::vector<xtsc::xtsc_request*>           m_request_pool;                        ///<  Maintain a pool of xtsc_request to improve performance
-  xtsc::u32                                  m_request_count;                       ///<  Count each newly created xtsc_request
-  std::vector<req_rsp_info*>                 m_req_rsp_info_pool;                   ///<  Maintain a pool of req_rsp_info to improve performance
-  xtsc::u32                                  m_req_rsp_info_count;                  ///<  Count each newly created req_rsp_info
+  xtsc_allocator_client                      m_allocator;                           ///<  For xtsc_request, xtsc_response, req_rsp_info, and req_sched_info objects
   std::vector<sc_core::sc_process_handle>    m_process_handles;                     ///<  For reset 
   xtsc::xtsc_sim_mode                        m_sim_mode;                            ///<  Current Simulation mode of the transactor
   sc_core::sc_time                           m_time_resolution;                     ///<  SystemC time resolution
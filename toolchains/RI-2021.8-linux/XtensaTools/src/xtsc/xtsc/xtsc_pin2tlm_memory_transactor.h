@@ -23,6 +23,7 @@
 #include <xtsc/xtsc_request_if.h>
 #include <xtsc/xtsc_respond_if.h>
 #include <xtsc/xtsc_module_pin_base.h>
+#include <xtsc/xtsc_slab_allocator.h>
 
 
 
@@ -210,6 +211,16 @@ class xtsc_tlm2pin_memory_transactor;
    "vcd_handle"         void*   Pointer to SystemC VCD object (sc_trace_file *) or 0 if
                                 tracing is not desired.
 
+   "activity_driven"    bool    If true, threads which would otherwise wake up once
+                                each clock period while waiting on another party (for
+                                example, waiting for PREADY on APB) instead wait for
+                                the relevant signal to change and then re-sync to
+                                "sample_phase".  Pins are sampled in the same clock
+                                cycles as when this parameter is false, but far fewer
+                                SystemC context switches occur when the interface is
+                                mostly idle.
+                                Default = false.
+
 
    Parameters which apply to PIF|IDMA0 only (Note The snoop port is reserved for future use):
 
@@ -496,6 +507,7 @@ public:
     add("has_lock",             false);
     add("has_xfer_en",          false);
     add("vcd_handle",           (void*)NULL);
+    add("activity_driven",      false);
     add("cbox",                 false);
     add("banked",               false);
     add("num_subbanks",         0);
@@ -1244,6 +1256,7 @@ protected:
   bool                          m_has_lock;                     ///< True if memory interface has a lock pin 
                                                                 ///<  (DRAM0|DRAM0BS|DRAM0RW|DRAM1|DRAM1BS|DRAM1RW only)
   bool                          m_has_xfer_en;                  ///< True if memory interface has Xfer enable pin
+  bool                          m_activity_driven;              ///< See "activity_driven" parameter
                                                                 ///<  (not applicable for PIF|IDMA0|AXI|IDMA|DROM0|XLMI0|APB)
 
   sc_core::sc_event            *m_pif_req_event;                ///< Notify pif_send_tlm_request_thread                                 (per mem port)
@@ -1295,6 +1308,7 @@ protected:
   std::vector<axi_addr_info*>   m_axi_addr_pool;                ///< Pool of axi_addr_info objects
   std::vector<axi_data_info*>   m_axi_data_pool;                ///< Pool of axi_data_info objects
   std::vector<axi_req_info*>    m_axi_req_pool;                 ///< Pool of axi_req_info objects
+  xtsc_allocator_client         m_allocator;                    ///< Backing store for the pools above
   address_deque                *m_load_address_deque;           ///< deque of XLMI load addresses                                       (per mem port)
   bool                         *m_previous_response_last;       ///< true if previous response was a last transfer                      (per mem port)
   map_bool_signal               m_map_bool_signal;              ///< The optional map of all sc_signal<bool> signals
@@ -0,0 +1,323 @@
+#ifndef _XTSC_SAMPLING_CONTROLLER_H_
+#define _XTSC_SAMPLING_CONTROLLER_H_
+
+// Copyright (c) 2005-2018 by Cadence Design Systems, Inc.  ALL RIGHTS RESERVED.
+// These coded instructions, statements, and computer programs are the
+// copyrighted works and confidential proprietary information of Cadence Design Systems, Inc.
+// They may not be modified, copied, reproduced, distributed, or disclosed to
+// third parties in any manner, medium, or form, in whole or in part, without
+// the prior written consent of Cadence Design Systems, Inc.
+
+/**
+ * @file
+ */
+
+
+#include <xtsc/xtsc.h>
+#include <xtsc/xtsc_parms.h>
+#include <vector>
+
+
+
+namespace xtsc {
+class xtsc_core;
+}
+
+
+
+namespace xtsc_component {
+
+
+/**
+ * Constructor parameters for a xtsc_sampling_controller object.
+ *
+ *  \verbatim
+   Name                   Type    Description
+   ------------------     ----    --------------------------------------------------------
+
+   "functional_cycles"    u32     The number of clock periods simulated in functional
+                                  mode (TurboXim) at the start of each sampling period.
+                                  This is the fast-forward part of the period which is
+                                  not measured.  If 0, the simulation is switched to (or
+                                  stays in) cycle-accurate mode and every period consists
+                                  of only the detailed warm-up and the measurement
+                                  window.
+                                  Default = 1000000.
+
+   "warmup_cycles"        u32     The number of clock periods simulated in cycle-
+                                  accurate mode after switching from functional mode and
+                                  before the measurement window starts.  This allows the
+                                  pipelines, queues, and other micro-architectural
+                                  state which functional mode does not model to reach a
+                                  representative state.
+                                  Default = 2000.
+
+   "measure_cycles"       u32     The number of clock periods in each measurement
+                                  window.  The cycle count and instruction count of each
+                                  core at the start and end of the window give one
+                                  cycles-per-instruction (CPI) sample for that core.
+                                  Default = 1000.
+
+   "num_samples"          u32     The number of sampling periods to run.  After the last
+                                  one, the simulation is left in functional mode for the
+                                  rest of the run.  A value of 0 means to keep sampling
+                                  until the end of simulation.
+                                  Default = 0.
+
+   "confidence"           u32     The confidence level, in percent, of the confidence
+                                  intervals reported for the mean CPI and for the
+                                  extrapolated cycle counts.  Supported values are 80,
+                                  90, 95, 98, 99, and 999 (meaning 99.9%).
+                                  Default = 95.
+
+   "switch_poll_cycles"   u32     The number of clock periods to wait between calls to
+                                  xtsc::xtsc_prepare_to_switch_sim_mode() while waiting
+                                  for the system to become ready to switch.
+                                  Default = 1.
+
+   "switch_settle_cycles" u32     The number of clock periods to wait after
+                                  xtsc::xtsc_prepare_to_switch_sim_mode() first returns
+                                  true so that transactions in passive modules can
+                                  propagate through the system.  The system must still be
+                                  ready after this delay for the switch to be made.
+                                  Default = 10.
+
+   "clock_period"         u32     This is the length of this device's clock period
+                                  expressed in terms of the SystemC time resolution
+                                  (from sc_get_time_resolution()).  A value of
+                                  0xFFFFFFFF means to use the XTSC system clock
+                                  period (from xtsc_get_system_clock_period()).
+                                  Default = 0xFFFFFFFF (i.e. use the system clock
+                                  period).
+
+    \endverbatim
+ *
+ * @see xtsc_sampling_controller
+ * @see xtsc::xtsc_parms
+ */
+class XTSC_COMP_API xtsc_sampling_controller_parms : public xtsc::xtsc_parms {
+public:
+
+  /**
+   * Constructor for an xtsc_sampling_controller_parms object.
+   *
+   * @param     functional_cycles       See the "functional_cycles" parameter.
+   *
+   * @param     warmup_cycles           See the "warmup_cycles" parameter.
+   *
+   * @param     measure_cycles          See the "measure_cycles" parameter.
+   */
+  xtsc_sampling_controller_parms(xtsc::u32 functional_cycles = 1000000,
+                                 xtsc::u32 warmup_cycles     = 2000,
+                                 xtsc::u32 measure_cycles    = 1000)
+  {
+    add("functional_cycles",    functional_cycles);
+    add("warmup_cycles",        warmup_cycles);
+    add("measure_cycles",       measure_cycles);
+    add("num_samples",          0);
+    add("confidence",           95);
+    add("switch_poll_cycles",   1);
+    add("switch_settle_cycles", 10);
+    add("clock_period",         0xFFFFFFFF);
+  }
+
+
+  /// Return what kind of xtsc_parms this is (our C++ type)
+  virtual const char* kind() const { return "xtsc_sampling_controller_parms"; }
+
+};
+
+
+
+/**
+ * A controller for statistical sampling of performance by alternating between
+ * functional (TurboXim) and cycle-accurate simulation.
+ *
+ * A cycle-accurate simulation of a long workload can take days.  This module runs most
+ * of the workload in functional mode and only periodically switches to cycle-accurate
+ * mode to measure a short window (the SMARTS approach).  Each sampling period consists
+ * of:
+ *  - "functional_cycles" clock periods in functional mode (fast-forward),
+ *  - "warmup_cycles" clock periods in cycle-accurate mode (detailed warm-up), and
+ *  - "measure_cycles" clock periods in cycle-accurate mode (measurement window).
+ *
+ * Mode switches use the protocol described for xtsc::xtsc_prepare_to_switch_sim_mode()
+ * followed by xtsc::xtsc_switch_sim_mode(), so all devices which have registered an
+ * xtsc::xtsc_mode_switch_if are switched together.
+ *
+ * Each measurement window yields one cycles-per-instruction (CPI) sample per core from
+ * the difference in xtsc_core::get_cycle_count() and in the "Instructions" counter of
+ * xtsc_core::get_summary_count().  The cycle count of each core for the whole run is
+ * then estimated as its total instruction count times its mean sampled CPI, and a
+ * confidence interval is formed from the standard error of the mean CPI.  The estimate
+ * is logged at end of simulation and is also available from the report() method and
+ * the "report" command.
+ *
+ * Here is an example of the code in sc_main.cpp:
+ * \verbatim
+    xtsc_sampling_controller_parms sampling_parms(10000000, 20000, 10000);
+    sampling_parms.set("num_samples", 200);
+    xtsc_sampling_controller sampler("sampler", sampling_parms);
+    sampler.add_core(core0);
+    sampler.add_core(core1);
+   \endverbatim
+ *
+ * Note:  The parameters of this module cannot be given in xtsc::xtsc_initialize_parms.
+ *        Like other xtsc_parms, they can be set from the command line with
+ *        xtsc::xtsc_parms::extract_parms().
+ *
+ * Note:  The samples are only representative if "functional_cycles" is not a multiple
+ *        of the period of some phase behavior of the workload.
+ *
+ * @see xtsc_sampling_controller_parms
+ * @see xtsc::xtsc_switch_sim_mode()
+ * @see xtsc::xtsc_prepare_to_switch_sim_mode()
+ * @see xtsc::xtsc_mode_switch_if
+ */
+class XTSC_COMP_API xtsc_sampling_controller :
+  public sc_core::sc_module,
+  public xtsc::xtsc_module,
+  public xtsc::xtsc_command_handler_interface
+{
+public:
+
+  SC_HAS_PROCESS(xtsc_sampling_controller);
+
+
+  /// Our C++ type (SystemC uses this)
+  virtual const char* kind() const { return "xtsc_sampling_controller"; }
+
+
+  /**
+   * Constructor for an xtsc_sampling_controller.
+   *
+   * @param     module_name     Name of the xtsc_sampling_controller sc_module.
+   *
+   * @param     sampling_parms  The remaining parameters for construction.
+   *
+   * @see xtsc_sampling_controller_parms
+   */
+  xtsc_sampling_controller(sc_core::sc_module_name module_name, const xtsc_sampling_controller_parms& sampling_parms);
+
+
+  /// Destructor.
+  ~xtsc_sampling_controller();
+
+
+  /// For xtsc_connection_interface (this module has no ports)
+  virtual xtsc::u32 get_bit_width(const std::string& port_name, xtsc::u32 interface_num = 0) const;
+
+
+  /// For xtsc_connection_interface (this module has no ports)
+  virtual sc_core::sc_object *get_port(const std::string& port_name);
+
+
+  /// Reset the xtsc_sampling_controller (discard all samples)
+  void reset(bool hard_reset = false);
+
+
+  /**
+   * Take CPI samples from core.
+   *
+   * @param     core            The xtsc_core to sample.
+   */
+  void add_core(xtsc::xtsc_core& core);
+
+
+  /// Return the number of completed measurement windows
+  xtsc::u32 get_num_samples() const { return m_num_samples; }
+
+
+  /**
+   * Print the sampled CPI and extrapolated cycle count of each core.
+   *
+   * @param     os              The ostream object on which to print the report.
+   */
+  void report(std::ostream& os = std::cout) const;
+
+
+  /**
+   * Implementation of the xtsc::xtsc_command_handler_interface.
+   *
+   * This implementation supports the following commands:
+   *  \verbatim
+        get_num_samples
+          Return xtsc_sampling_controller::get_num_samples().
+
+        report
+          Call xtsc_sampling_controller::report().
+
+        reset
+          Call xtsc_sampling_controller::reset().
+      \endverbatim
+   */
+  void execute(const std::string&               cmd_line,
+               const std::vector<std::string>&  words,
+               const std::vector<std::string>&  words_lc,
+               std::ostream&                    result);
+
+
+protected:
+
+  /// The samples taken from one core
+  class core_info {
+  public:
+    core_info(xtsc::xtsc_core& core) :
+      m_p_core                  (&core),
+      m_start_cycles            (0),
+      m_start_instructions      (0),
+      m_num_samples             (0),
+      m_sum_cpi                 (0.0),
+      m_sum_cpi_squared         (0.0),
+      m_measured_cycles         (0),
+      m_measured_instructions   (0)
+    {}
+    xtsc::xtsc_core    *m_p_core;                       ///< The core
+    xtsc::u64           m_start_cycles;                 ///< Cycle count at the start of the current window
+    xtsc::u64           m_start_instructions;           ///< Instruction count at the start of the current window
+    xtsc::u32           m_num_samples;                  ///< Number of windows in which this core retired instructions
+    double              m_sum_cpi;                      ///< Sum of the CPI samples
+    double              m_sum_cpi_squared;              ///< Sum of the squares of the CPI samples
+    xtsc::u64           m_measured_cycles;              ///< Total cycles in all measurement windows
+    xtsc::u64           m_measured_instructions;        ///< Total instructions in all measurement windows
+  };
+
+
+  /// SystemC callback: log the report
+  void end_of_simulation();
+
+
+  /// Alternate between functional, warm-up, and measurement windows
+  void sampling_thread();
+
+
+  /// Switch all registered devices to mode using the mode-switching protocol
+  void switch_sim_mode(xtsc::xtsc_sim_mode mode);
+
+
+  /// Return the "Instructions" summary counter of core
+  xtsc::u64 get_instruction_count(const xtsc::xtsc_core& core) const;
+
+
+  log4xtensa::TextLogger&               m_text;                         ///< Text logger
+  xtsc::u32                             m_functional_cycles;            ///< See "functional_cycles" parameter
+  xtsc::u32                             m_warmup_cycles;                ///< See "warmup_cycles" parameter
+  xtsc::u32                             m_measure_cycles;               ///< See "measure_cycles" parameter
+  xtsc::u32                             m_max_samples;                  ///< See "num_samples" parameter
+  xtsc::u32                             m_confidence;                   ///< See "confidence" parameter
+  double                                m_z;                            ///< Normal quantile for m_confidence
+  xtsc::u32                             m_switch_poll_cycles;           ///< See "switch_poll_cycles" parameter
+  xtsc::u32                             m_switch_settle_cycles;         ///< See "switch_settle_cycles" parameter
+  sc_core::sc_time                      m_clock_period;                 ///< This device's clock period
+  xtsc::u32                             m_num_samples;                  ///< Number of completed measurement windows
+  xtsc::u32                             m_num_switches;                 ///< Number of mode switches made
+  sc_core::sc_time                      m_switch_time;                  ///< Simulation time spent waiting to switch
+  std::vector<core_info*>               m_cores;                        ///< See add_core()
+};
+
+
+
+}  // namespace xtsc_component
+
+
+#endif  // _XTSC_SAMPLING_CONTROLLER_H_
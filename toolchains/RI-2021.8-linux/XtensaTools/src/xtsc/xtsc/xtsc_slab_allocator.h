@@ -0,0 +1,175 @@
+#ifndef _XTSC_SLAB_ALLOCATOR_H_
+#define _XTSC_SLAB_ALLOCATOR_H_
+
+// Copyright (c) 2005-2018 by Cadence Design Systems Inc.  ALL RIGHTS RESERVED.
+// These coded instructions, statements, and computer programs are the
+// copyrighted works and confidential proprietary information of Cadence Design Systems Inc.
+// They may not be modified, copied, reproduced, distributed, or disclosed to
+// third parties in any manner, medium, or form, in whole or in part, without
+// the prior written consent of Cadence Design Systems Inc.
+
+/**
+ * @file
+ */
+
+
+#include <xtsc/xtsc.h>
+#include <iostream>
+#include <new>
+#include <string>
+#include <utility>
+
+
+
+namespace xtsc_component {
+
+
+/**
+ * The size-class slab allocator shared by all the components in this library for their
+ * per-transaction objects (xtsc_request, xtsc_response, and the various request_info,
+ * response_info, and transaction_info classes).
+ *
+ * Allocations are rounded up to a multiple of granularity bytes and served from the
+ * free list of that size class.  When a free list is empty, a slab of slab_bytes is
+ * obtained from the heap and carved into chunks of that size class.  Freed chunks go
+ * back on the free list of their size class (slabs are never returned to the heap), so
+ * same-sized objects from all components are packed together and recycled in LIFO
+ * (cache-warm) order.  Allocations larger than max_size bytes go straight to the heap.
+ *
+ * Components do not use this class directly; each one owns an xtsc_allocator_client
+ * which forwards to this class and keeps that component's statistics.
+ *
+ * Like the rest of the SystemC simulation, this allocator is not thread-safe.
+ *
+ * @see xtsc_allocator_client
+ * @see xtsc_dump_allocator_stats
+ */
+class XTSC_COMP_API xtsc_slab_allocator {
+public:
+
+  static const xtsc::u32 granularity    = 16;           ///<  Size classes are multiples of this many bytes
+  static const xtsc::u32 max_size       = 2048;         ///<  Larger allocations bypass the slabs
+  static const xtsc::u32 slab_bytes     = 64*1024;      ///<  Bytes obtained from the heap per slab
+
+
+  /// Allocate size8 bytes
+  static void *allocate(size_t size8);
+
+
+  /// Free p which was obtained from allocate(size8)
+  static void deallocate(void *p, size_t size8);
+
+
+  /// Dump the per-size-class slab usage
+  static void dump_statistics(std::ostream& os = std::cout);
+
+};
+
+
+
+/**
+ * A component's handle to xtsc_slab_allocator.  A component owns one of these and uses
+ * it in place of new and delete for its per-transaction objects.  The client keeps the
+ * component's allocation statistics (live, peak, and total allocations) and reports
+ * them in xtsc_dump_allocator_stats().
+ *
+ * Objects obtained from create() must be returned with destroy() (to any client; the
+ * statistics are only approximate if objects are passed between components).
+ */
+class XTSC_COMP_API xtsc_allocator_client {
+public:
+
+  /**
+   * Constructor.
+   *
+   * @param     name            The name shown in xtsc_dump_allocator_stats() (typically
+   *                            the hierarchical name of the owning component).
+   */
+  xtsc_allocator_client(const std::string& name);
+
+
+  /// Destructor.  Objects still live are not freed.
+  ~xtsc_allocator_client();
+
+
+  /// Construct a T from args in slab memory
+  template <class T, class... Args>
+  T *create(Args&&... args) {
+    void *p = allocate(sizeof(T));
+    try {
+      return new (p) T(std::forward<Args>(args)...);
+    }
+    catch (...) {
+      deallocate(p, sizeof(T));
+      throw;
+    }
+  }
+
+
+  /// Destroy an object obtained from create()
+  template <class T>
+  void destroy(T *p) {
+    if (p) {
+      p->~T();
+      deallocate((void*) p, sizeof(T));
+    }
+  }
+
+
+  /// Allocate size8 raw bytes
+  void *allocate(size_t size8);
+
+
+  /// Free raw bytes obtained from allocate(size8)
+  void deallocate(void *p, size_t size8);
+
+
+  /// Return the name of this client
+  const std::string& get_name() const { return m_name; }
+
+
+  /// Return the number of objects currently allocated
+  xtsc::u64 get_num_live() const { return m_num_live; }
+
+
+  /// Return the largest value get_num_live() has had
+  xtsc::u64 get_num_peak() const { return m_num_peak; }
+
+
+  /// Return the number of bytes currently allocated (after rounding to the size class)
+  xtsc::u64 get_bytes_live() const { return m_bytes_live; }
+
+
+  /// Return the total number of allocations
+  xtsc::u64 get_num_allocations() const { return m_num_allocations; }
+
+
+  /// Dump this client's statistics on one line
+  void dump_statistics(std::ostream& os = std::cout) const;
+
+
+private:
+
+  std::string                   m_name;                 ///<  See get_name()
+  xtsc::u64                     m_num_live;             ///<  See get_num_live()
+  xtsc::u64                     m_num_peak;             ///<  See get_num_peak()
+  xtsc::u64                     m_bytes_live;           ///<  See get_bytes_live()
+  xtsc::u64                     m_num_allocations;      ///<  See get_num_allocations()
+};
+
+
+
+/**
+ * Dump the allocation statistics of every xtsc_allocator_client (live, peak, total
+ * allocations, and allocations per microsecond of simulation time) followed by the
+ * slab usage of each size class of xtsc_slab_allocator.
+ */
+XTSC_COMP_API void xtsc_dump_allocator_stats(std::ostream& os = std::cout);
+
+
+
+}  // namespace xtsc_component
+
+
+
+#endif  // _XTSC_SLAB_ALLOCATOR_H_
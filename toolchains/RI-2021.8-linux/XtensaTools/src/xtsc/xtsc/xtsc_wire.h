@@ -101,7 +101,11 @@ class xtsc_wire_source;
                                 at module construction time as host OS shared memory
                                 using shm_open() on Linux and CreateFileMapping() on
                                 MS Windows.  If this parameter is set true, then neither
-                                "read_file" nor "write_file" may be used.
+                                "read_file" nor "write_file" may be used.  When the
+                                writer and readers are in different simulation
+                                processes, use xtsc_parallel_barrier to keep the
+                                processes' simulation times together and to notify the
+                                write event when the other process writes the wire.
                                 Default = false.
 
    "shared_memory_name" char*   The name of the host OS shared memory.  If this
@@ -325,6 +329,37 @@ public:
   void reset(bool hard_reset = false);
 
 
+  /**
+   * When "host_shared_memory" is true, the writer and the readers of this wire may be in
+   * different OS processes.  Writes done by the other process do not notify the write
+   * event of this wire, so this method compares the host shared memory contents against
+   * the contents seen on the previous call and, if they differ, updates the wire value
+   * and notifies the write event.
+   *
+   * This method is typically called by xtsc_parallel_barrier after each barrier.
+   *
+   * @returns true if the host shared memory contents changed since the previous call.  If
+   *          "host_shared_memory" is false, this method does nothing and returns false.
+   *
+   * @see xtsc_parallel_barrier
+   * @see enable_barrier_sync()
+   */
+  bool sync_host_shared_memory();
+
+
+  /**
+   * Make writes done by other processes visible to nb_read() only when
+   * sync_host_shared_memory() is called, instead of as soon as they reach host shared
+   * memory.  Writes done by this process are still visible at once.  This makes what
+   * each reader sees independent of how the host schedules the processes.
+   *
+   * This method is called by xtsc_parallel_barrier::add_channel().
+   *
+   * @see xtsc_parallel_barrier
+   */
+  void enable_barrier_sync() { m_barrier_sync = true; }
+
+
   /**
    * Implementation of the xtsc::xtsc_command_handler_interface.
    *
@@ -503,7 +538,9 @@ protected:
   std::string                           m_shmem_name;              ///<  Shared Memory: name
   xtsc::u8                             *m_p_buffer;                ///<  Shared Memory: intermediate buffer between sc_unsigned & host OS shared memory
   xtsc::u8                             *m_p_shmem;                 ///<  Shared Memory: pointer to host OS shared memory
+  xtsc::u8                             *m_p_shmem_sync;            ///<  Shared Memory: contents seen by sync_host_shared_memory()
   xtsc::u32                             m_shmem_total_size;        ///<  Shared Memory: number of bytes in shared memory
+  bool                                  m_barrier_sync;            ///<  See enable_barrier_sync()
 
 };
 
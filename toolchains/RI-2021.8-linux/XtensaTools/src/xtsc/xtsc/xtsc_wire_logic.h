@@ -632,6 +632,14 @@ protected:
   void handle_lua_function();
 
 
+  /**
+   * Compile the per-output-bit RPN assignments in m_assignments into word-parallel
+   * compiled_assignment objects (up to 64 output bits each) and build the bit-level
+   * dependency lists of each input.
+   */
+  void compile_assignments();
+
+
   /**
    * Parse operand at m_words[index] (this could also be the LHS of the assign).
    *
@@ -655,10 +663,13 @@ protected:
   class output_definition;
   class input_definition;
   class iterator_definition;
+  class compiled_operand;
+  class compiled_assignment;
 
   // Shorthand aliases
   typedef std::vector<xtsc::u32>                                rpn_assignment;
   typedef std::vector<rpn_assignment*>                          assignment_table;
+  typedef std::vector<compiled_assignment*>                     compiled_assignment_vector;
   typedef std::vector<output_definition*>                       output_definition_vector;
   typedef std::map<std::string, output_definition*>             output_definition_map;
   typedef std::vector<input_definition*>                        input_definition_vector;
@@ -698,6 +709,14 @@ protected:
   bool is_identifier(const std::string& name);
 
 
+  /// Return the lanes of operand as a bitsliced word (lane l holds input bit m_base + l*m_stride)
+  xtsc::u64 gather(const compiled_operand& operand) const;
+
+
+  /// Evaluate compiled and store the result in the bits of its output's m_value
+  void evaluate(const compiled_assignment& compiled);
+
+
 
   /**
    * Information about a delayed output value
@@ -712,6 +731,59 @@ protected:
 
 
 
+  /**
+   * One operand of a compiled_assignment.  Lane l of the operand is input bit
+   * (m_base + l * m_stride) of input m_input.
+   */
+  class compiled_operand {
+  public:
+    compiled_operand(xtsc::u32 input, xtsc::u32 base) : m_input(input), m_base(base), m_stride(0) {}
+    xtsc::u32                   m_input;                ///< Index into m_inputs
+    xtsc::u32                   m_base;                 ///< Input bit of lane 0
+    xtsc::i32                   m_stride;               ///< Input bit increment from one lane to the next
+  };
+
+
+
+  /**
+   * A group of up to 64 RPN assignments which share the same output, the same op codes,
+   * and the same operand inputs, and whose output and input bit indices each advance by
+   * a constant stride.  The group is evaluated once using 64-bit words in which lane l
+   * (bit l) computes the output bit of the l-th rpn_assignment of the group.
+   */
+  class compiled_assignment {
+  public:
+    compiled_assignment(xtsc::u32 output, xtsc::u32 output_base) :
+      m_output          (output),
+      m_output_base     (output_base),
+      m_output_stride   (0),
+      m_num_lanes       (1),
+      m_stamp           (0)
+    {}
+    xtsc::u32                   m_output;               ///< Index into m_outputs
+    xtsc::u32                   m_output_base;          ///< Output bit of lane 0
+    xtsc::i32                   m_output_stride;        ///< Output bit increment from one lane to the next
+    xtsc::u32                   m_num_lanes;            ///< Number of output bits computed (1-64)
+    std::vector<xtsc::u32>      m_program;              ///< Op codes; each op_PUSH is followed by an index into m_operands
+    std::vector<compiled_operand>
+                                m_operands;             ///< Operands in the order pushed
+    xtsc::u64                   m_stamp;                ///< Value of m_eval_stamp when last scheduled for evaluation
+  };
+
+
+
+  /**
+   * The lanes of one compiled_assignment which read bits from one 64-bit word of an input.
+   */
+  class compiled_dependency {
+  public:
+    compiled_dependency(xtsc::u32 compiled, xtsc::u64 mask) : m_compiled(compiled), m_mask(mask) {}
+    xtsc::u32                   m_compiled;             ///< Index into m_compiled_assignments
+    xtsc::u64                   m_mask;                 ///< Bits of the input word read by m_compiled
+  };
+
+
+
   /**
    * Output definition and sc_port.
    */
@@ -857,6 +929,11 @@ protected:
     std::string                 m_initial_value;        ///< From <InitialValue> in definition_file
     bool                        m_detect_value_change;  ///< True if any dependent output has a <WritePolicy> of change
     assignment_table            m_assignments;          ///< Vector of RPN assignments; 1 for each output bit touched by this input
+    std::vector<xtsc::u64>      m_packed;               ///< m_value packed 64 bits per word (bit 0 of word 0 is bit 0 of m_value)
+    std::vector<std::vector<compiled_dependency> >
+                                m_dependencies;         ///< Per word of m_packed, the compiled assignments reading that word
+    std::vector<xtsc::u32>      m_compiled;             ///< Indices into m_compiled_assignments of all that read this input
+    bool                        m_stale;                ///< True from reset until the first nb_write() (evaluate all of m_compiled)
     output_set                  m_lua_function_outputs; ///< Set of all lua_function outputs that depend on this input
     output_set                  m_outputs;              ///< Set of all outputs that depend on this input
     xtsc_wire_write_if_impl    *m_p_wire_write_impl;    ///< m_p_wire_write_export binds to this
@@ -925,9 +1002,12 @@ protected:
   std::set<std::string>         m_input_set;                    ///< Set of names of all inputs
   std::set<std::string>         m_output_set;                   ///< Set of names of all outputs
   std::set<std::string>         m_io_set;                       ///< Set of names of all inputs and outputs
-  std::vector<bool>             m_stack;                        ///< Stack of operand values
+  std::vector<xtsc::u64>        m_stack;                        ///< Stack of operand values (one output bit per lane)
   xtsc::u32                     m_max_depth;                    ///< Maximum stack depth needed
   assignment_table              m_assignments;                  ///< List of all defined RPN assignments
+  compiled_assignment_vector    m_compiled_assignments;         ///< m_assignments compiled into word-parallel groups
+  std::vector<xtsc::u32>        m_dirty;                        ///< Compiled assignments to evaluate in the current nb_write()
+  xtsc::u64                     m_eval_stamp;                   ///< Incremented for each nb_write() to de-duplicate m_dirty
   xtsc::u32                     m_next_delay_thread_index;      ///< Used by delay_thread upon entry to get its output
   xtsc::xtsc_port_table         m_port_table_all;               ///< All wire inputs and outputs
   xtsc::xtsc_port_table         m_port_table_all_inputs;        ///< All wire inputs
@@ -25,6 +25,7 @@
 #include <xtsc/xtsc_response.h>
 #include <xtsc/xtsc_fast_access.h>
 #include <xtsc/xtsc_core.h>
+#include <xtsc/xtsc_slab_allocator.h>
 #include <vector>
 #include <list>
 #include <set>
@@ -1002,6 +1003,7 @@ private:
   std::vector<transaction_info*>                m_transaction_info_pool;        ///<  Maintain a pool to improve performance: transaction_info
   std::vector<xtsc::xtsc_request*>              m_request_pool;                 ///<  Maintain a pool to improve performance: xtsc_request
   std::vector<xtsc::u8*>                        m_buffer_pool;                  ///<  Maintain a pool of u8 buffers of size m_width8*m_max_transfers
+  xtsc_allocator_client                         m_allocator;                    ///<  Backing store for xtsc_request, xtsc_response, and transaction_info
 
   xtsc::u32                                     m_transaction_count;            ///<  Count each newly created transaction in new_transaction
   xtsc::u32                                     m_transaction_info_count;       ///<  Count each newly created transaction_info
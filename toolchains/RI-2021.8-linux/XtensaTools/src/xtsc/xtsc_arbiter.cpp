@@ -20,6 +20,9 @@
 #include <xtsc/xtsc_logging.h>
 #include <algorithm>
 #include <cassert>
+#if defined(_WIN32)
+#include <intrin.h>
+#endif
 
 
 
@@ -127,6 +130,17 @@ static bool start_address_less_then(const xtsc_address_range_entry* range1, cons
   return (range1->m_start_address8 < range2->m_start_address8);
 }
 
+// Return the index of the least-significant set bit of word (word must be non-zero)
+static inline u32 count_trailing_zeros(u64 word) {
+#if defined(_WIN32)
+  unsigned long index;
+  _BitScanForward64(&index, word);
+  return (u32) index;
+#else
+  return (u32) __builtin_ctzll(word);
+#endif
+}
+
 }
 
 
@@ -162,6 +176,7 @@ xtsc_component::xtsc_arbiter::xtsc_arbiter(sc_module_name module_name, const xts
   m_apb_response_done_event         ("m_apb_response_done_event"),
   m_align_request_phase_thread_event("m_align_request_phase_thread_event"),
 #endif
+  m_allocator           (name()),
   m_profile_buffers     (arbiter_parms.get_bool("profile_buffers")),
   m_text                (log4xtensa::TextLogger::getInstance(name())),
   m_binary              (log4xtensa::BinaryLogger::getInstance(name()))
@@ -331,6 +346,7 @@ xtsc_component::xtsc_arbiter::xtsc_arbiter(sc_module_name module_name, const xts
   u32 request_fifo_depth = arbiter_parms.get_u32("request_fifo_depth");
   m_request_deques = new deque<request_info*>*[m_num_masters];
   m_request_fifos = new sc_fifo<int>*[m_num_masters];
+  m_pending_requests.assign((m_num_masters + 63) / 64, 0);
   for (u32 i=0; i<m_num_masters; i++) {
     ostringstream oss;
     u32 depth = (request_fifo_depths.size() ? request_fifo_depths[i] : request_fifo_depth);
@@ -1104,22 +1120,58 @@ void xtsc_component::xtsc_arbiter::reset(bool /*hard_reset*/) {
 
 
 bool xtsc_component::xtsc_arbiter::arbitrate(u32 &port_num) {
-  do {
-    if (!m_lock) {
-      port_num = (port_num + 1) % m_num_masters;
-    }
+  if (m_lock) {
     XTSC_DEBUG(m_text, "arbitrate() port_num=" << port_num << " m_token=" << m_token << 
                        " num_available()=" << m_request_fifos[port_num]->num_available());
     if (m_request_fifos[port_num]->num_available()) {
       XTSC_DEBUG(m_text, "arbitrate() got: " << m_request_deques[port_num]->front()->m_request);
       return true;
     }
-  } while (port_num != m_token);
+    return false;
+  }
+  // Round-robin starting after port_num and ending with m_token, visiting only ports with pending requests
+  u32 start     = port_num;
+  u32 limit     = (m_token + m_num_masters - start - 1) % m_num_masters;
+  u32 previous  = 0;
+  bool first    = true;
+  for (u32 port = next_pending_port(start); port < m_num_masters; port = next_pending_port(port)) {
+    u32 distance = (port + m_num_masters - start - 1) % m_num_masters;
+    if ((distance > limit) || (!first && (distance <= previous))) {
+      break;
+    }
+    first    = false;
+    previous = distance;
+    XTSC_DEBUG(m_text, "arbitrate() port_num=" << port << " m_token=" << m_token << 
+                       " num_available()=" << m_request_fifos[port]->num_available());
+    if (m_request_fifos[port]->num_available()) {
+      port_num = port;
+      XTSC_DEBUG(m_text, "arbitrate() got: " << m_request_deques[port_num]->front()->m_request);
+      return true;
+    }
+  }
+  port_num = m_token;
   return false;
 }
 
 
 
+u32 xtsc_component::xtsc_arbiter::next_pending_port(u32 port_num) const {
+  u32 num_words = (u32) m_pending_requests.size();
+  u32 start     = (port_num + 1) % m_num_masters;
+  u32 index     = start >> 6;
+  u64 word      = m_pending_requests[index] & (~0ULL << (start & 63));
+  for (u32 i=0; i<=num_words; ++i) {
+    if (word) {
+      return (index << 6) + count_trailing_zeros(word);
+    }
+    index = (index + 1) % num_words;
+    word  = m_pending_requests[index];
+  }
+  return m_num_masters;
+}
+
+
+
 bool xtsc_component::xtsc_arbiter::arbitrate_policy(u32 &port_num) {
   if (m_lock) {
     if (m_use_lock_port_groups) {
@@ -1149,8 +1201,16 @@ bool xtsc_component::xtsc_arbiter::arbitrate_policy(u32 &port_num) {
     u32 smallest_priority = 0xFFFFFFFF;
     u32 tentative_port    = 0xFFFFFFFF;
     u32 num_requests      = 0;
-    for (u32 i=1; i<=m_num_masters; ++i) {
-      u32 port = (port_num + i) % m_num_masters;
+    u32 previous          = 0;
+    bool first            = true;
+    // Visit ports with pending requests in round-robin order starting after port_num
+    for (u32 port = next_pending_port(port_num); port < m_num_masters; port = next_pending_port(port)) {
+      u32 distance = (port + m_num_masters - port_num - 1) % m_num_masters;
+      if (!first && (distance <= previous)) {
+        break;
+      }
+      first    = false;
+      previous = distance;
       if (m_request_fifos[port]->num_available()) {
         m_ports_with_requests[num_requests++] = port;
         if (m_port_policy_table[port]->m_current_priority < smallest_priority) {
@@ -1455,6 +1515,7 @@ void xtsc_component::xtsc_arbiter::reset_fifos() {
       while (!m_request_deques[i]->empty()) {
         request_info *p_request_info = m_request_deques[i]->front();
         m_request_deques[i]->pop_front();
+        if (m_request_deques[i]->empty()) clear_request_pending(i);
         delete_request_info(p_request_info);
       }
     }
@@ -1518,6 +1579,7 @@ void xtsc_component::xtsc_arbiter::arbiter_thread(void) {
           // Get our current transaction
           request_info *p_request_info = m_request_deques[port_num]->front();
           m_request_deques[port_num]->pop_front();
+          if (m_request_deques[port_num]->empty()) clear_request_pending(port_num);
           int dummy;
           m_request_fifos[port_num]->nb_read(dummy);
           XTSC_DEBUG(m_text, __FUNCTION__ << "() got: " << p_request_info->m_request);
@@ -1603,6 +1665,7 @@ void xtsc_component::xtsc_arbiter::arbiter_apb_thread(void) {
           request_info *p_request_info = m_request_deques[port_num]->front();
           m_p_apb_request_info = p_request_info;
           m_request_deques[port_num]->pop_front();
+          if (m_request_deques[port_num]->empty()) clear_request_pending(port_num);
           int dummy;
           m_request_fifos[port_num]->nb_read(dummy);
           XTSC_DEBUG(m_text, __FUNCTION__ << "() got: " << p_request_info->m_request);
@@ -1683,6 +1746,7 @@ void xtsc_component::xtsc_arbiter::arbiter_pwc_thread(void) {
           // Get our current transaction
           request_info *p_request_info = m_request_deques[port_num]->front();
           m_request_deques[port_num]->pop_front();
+          if (m_request_deques[port_num]->empty()) clear_request_pending(port_num);
           int dummy;
           m_request_fifos[port_num]->nb_read(dummy);
           m_token = port_num;
@@ -1804,6 +1868,7 @@ void xtsc_component::xtsc_arbiter::arbiter_special_thread(void) {
               }
             }
             m_request_deques[port_num]->pop_front();
+            if (m_request_deques[port_num]->empty()) clear_request_pending(port_num);
             int dummy;
             m_request_fifos[port_num]->nb_read(dummy);
             request_granted = true;
@@ -2326,6 +2391,7 @@ void xtsc_component::xtsc_arbiter::nacc_remaining_requests() {
     while (m_request_fifos[port_num]->num_available()) {
       request_info *p_request_info = m_request_deques[port_num]->front();
       m_request_deques[port_num]->pop_front();
+      if (m_request_deques[port_num]->empty()) clear_request_pending(port_num);
       int dummy;
       m_request_fifos[port_num]->nb_read(dummy);
       xtsc_response response(p_request_info->m_request, xtsc_response::RSP_NACC);
@@ -2789,92 +2855,51 @@ void xtsc_component::xtsc_arbiter::add_route_id_bits(xtsc_request& request, u32
 
 
 xtsc_component::xtsc_arbiter::request_info *xtsc_component::xtsc_arbiter::new_request_info(u32 port_num, const xtsc_request& request) {
-  if (m_request_pool.empty()) {
-    request_info *p_request_info = new request_info(request, port_num);
-    XTSC_DEBUG(m_text, "Creating a new request_info " << p_request_info << " for " << request);
-    p_request_info->m_request.set_byte_address(translate(port_num, p_request_info->m_request.get_byte_address()));
-    return p_request_info;
-  }
-  else {
-    request_info *p_request_info = m_request_pool.back();
-    XTSC_DEBUG(m_text, "Reusing request_info " << p_request_info << " for " << request);
-    m_request_pool.pop_back();
-    p_request_info->m_request = request;
-    p_request_info->m_port_num = port_num;
-    p_request_info->m_request.set_byte_address(translate(port_num, p_request_info->m_request.get_byte_address()));
-    p_request_info->m_time_stamp = sc_time_stamp();
-    return p_request_info;
-  }
+  request_info *p_request_info = m_allocator.create<request_info>(request, port_num);
+  XTSC_DEBUG(m_text, "Creating request_info " << p_request_info << " for " << request);
+  p_request_info->m_request.set_byte_address(translate(port_num, p_request_info->m_request.get_byte_address()));
+  return p_request_info;
 }
 
 
 
 xtsc_component::xtsc_arbiter::request_info *xtsc_component::xtsc_arbiter::copy_request_info(const request_info& info) {
-  if (m_request_pool.empty()) {
-    request_info *p_request_info = new request_info(info);
-    XTSC_DEBUG(m_text, "Creating a new request_info " << p_request_info << " for " << info.m_request);
-    return p_request_info;
-  }
-  else {
-    request_info *p_request_info = m_request_pool.back();
-    XTSC_DEBUG(m_text, "Reusing request_info " << p_request_info << " for " << info.m_request);
-    m_request_pool.pop_back();
-    *p_request_info = info;
-    return p_request_info;
-  }
+  request_info *p_request_info = m_allocator.create<request_info>(info);
+  XTSC_DEBUG(m_text, "Creating request_info " << p_request_info << " for " << info.m_request);
+  return p_request_info;
 }
 
 
 
 void xtsc_component::xtsc_arbiter::delete_request_info(request_info*& p_request_info) {
   XTSC_DEBUG(m_text, "Recycling request_info " << p_request_info);
-  m_request_pool.push_back(p_request_info);
+  m_allocator.destroy(p_request_info);
   p_request_info = 0;
 }
 
 
 
 xtsc_component::xtsc_arbiter::response_info *xtsc_component::xtsc_arbiter::new_response_info(const xtsc_response& response) {
-  if (m_response_pool.empty()) {
-    response_info *p_response_info = new response_info(response);
-    XTSC_DEBUG(m_text, "Creating a new response_info " << p_response_info << " for " << response);
-    return p_response_info;
-  }
-  else {
-    response_info *p_response_info = m_response_pool.back();
-    XTSC_DEBUG(m_text, "Reusing response_info " << p_response_info << " for " << response);
-    m_response_pool.pop_back();
-    p_response_info->m_response = response;
-    p_response_info->m_response.set_exclusive_ok(response.get_exclusive_ok());
-    p_response_info->m_time_stamp = sc_time_stamp();
-    return p_response_info;
-  }
+  response_info *p_response_info = m_allocator.create<response_info>(response);
+  XTSC_DEBUG(m_text, "Creating response_info " << p_response_info << " for " << response);
+  p_response_info->m_response.set_exclusive_ok(response.get_exclusive_ok());
+  return p_response_info;
 }
 
 
 
 xtsc_component::xtsc_arbiter::response_info *xtsc_component::xtsc_arbiter::new_response_info(const xtsc_request& request) {
-  if (m_response_pool.empty()) {
-    response_info *p_response_info = new response_info(request);
-    XTSC_DEBUG(m_text, "Creating a new response_info " << p_response_info << " for " << request);
-    return p_response_info;
-  }
-  else {
-    response_info *p_response_info = m_response_pool.back();
-    XTSC_DEBUG(m_text, "Reusing response_info " << p_response_info << " for " << request);
-    m_response_pool.pop_back();
-    p_response_info->m_response = request;
-    p_response_info->m_response.set_exclusive_ok(request.get_exclusive());
-    p_response_info->m_time_stamp = sc_time_stamp();
-    return p_response_info;
-  }
+  response_info *p_response_info = m_allocator.create<response_info>(request);
+  XTSC_DEBUG(m_text, "Creating response_info " << p_response_info << " for " << request);
+  p_response_info->m_response.set_exclusive_ok(request.get_exclusive());
+  return p_response_info;
 }
 
 
 
 void xtsc_component::xtsc_arbiter::delete_response_info(response_info*& p_response_info) {
   XTSC_DEBUG(m_text, "Recycling response_info " << p_response_info);
-  m_response_pool.push_back(p_response_info);
+  m_allocator.destroy(p_response_info);
   p_response_info = 0;
 }
 
@@ -3047,22 +3072,15 @@ void xtsc_component::xtsc_arbiter::do_request(u32 port_num, const xtsc_request&
   XTSC_DEBUG(m_text, request << " Port #" << port_num << " (nb_request: Added to request fifo)");
   m_request_deques[port_num]->push_back(p_request_info);
   m_request_fifos[port_num]->nb_write(0);
+  set_request_pending(port_num);
   m_arbiter_thread_event.notify(SC_ZERO_TIME);
 }
 
 
 
 xtsc_component::xtsc_arbiter::req_rsp_info *xtsc_component::xtsc_arbiter::new_req_rsp_info(request_info *p_first_request_info) {
-  req_rsp_info *p_req_rsp_info;
-  if (m_req_rsp_info_pool.empty()) {
-    p_req_rsp_info = new req_rsp_info();
-    XTSC_DEBUG(m_text, "Creating a new req_rsp_info " << p_req_rsp_info);
-  }
-  else {
-    p_req_rsp_info = m_req_rsp_info_pool.back();
-    XTSC_DEBUG(m_text, "Reusing req_rsp_info " << p_req_rsp_info);
-    m_req_rsp_info_pool.pop_back();
-  }
+  req_rsp_info *p_req_rsp_info = m_allocator.create<req_rsp_info>();
+  XTSC_DEBUG(m_text, "Creating req_rsp_info " << p_req_rsp_info);
   p_req_rsp_info->m_p_first_request_info = p_first_request_info;
   return p_req_rsp_info;
 }
@@ -3072,8 +3090,7 @@ xtsc_component::xtsc_arbiter::req_rsp_info *xtsc_component::xtsc_arbiter::new_re
 void xtsc_component::xtsc_arbiter::delete_req_rsp_info(req_rsp_info*& p_req_rsp_info) {
   XTSC_DEBUG(m_text, "Recycling req_rsp_info " << p_req_rsp_info);
   delete_request_info(p_req_rsp_info->m_p_first_request_info);
-  memset(p_req_rsp_info, 0, sizeof(req_rsp_info));
-  m_req_rsp_info_pool.push_back(p_req_rsp_info);
+  m_allocator.destroy(p_req_rsp_info);
   p_req_rsp_info = 0;
 }
 
@@ -0,0 +1,246 @@
+// Copyright (c) 2005-2018 by Cadence Design Systems Inc.  ALL RIGHTS RESERVED.
+// These coded instructions, statements, and computer programs are the
+// copyrighted works and confidential proprietary information of Cadence Design Systems Inc.
+// They may not be modified, copied, reproduced, distributed, or disclosed to
+// third parties in any manner, medium, or form, in whole or in part, without
+// the prior written consent of Cadence Design Systems Inc.
+
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <chrono>
+#include <xtsc/xtsc_async_binary_appender.h>
+#include <log4xtensa/spi/factory.h>
+#include <log4xtensa/spi/loggingevent.h>
+
+using namespace std;
+using namespace xtsc;
+
+
+
+namespace xtsc_component {
+
+// All live instances (for dump_all_statistics)
+static mutex                                    instances_mutex;
+static vector<xtsc_async_binary_appender*>      instances;
+
+
+static u32 get_u32_property(const log4xtensa::helpers::Properties& properties, const char *key, u32 default_value) {
+  if (!properties.exists(key)) {
+    return default_value;
+  }
+  string value = properties.getProperty(key);
+  unsigned long long result = strtoull(value.c_str(), NULL, 0);
+  if (result > 0xFFFFFFFFull) {
+    ostringstream oss;
+    oss << "xtsc_async_binary_appender: \"" << key << "\" (" << value << ") does not fit in 32 bits";
+    throw xtsc_exception(oss.str());
+  }
+  return (u32) result;
+}
+
+
+class xtsc_async_binary_appender_factory : public log4xtensa::spi::AppenderFactory {
+public:
+  log4xtensa::SharedAppenderPtr createObject(const log4xtensa::helpers::Properties& properties) {
+    return log4xtensa::SharedAppenderPtr(new xtsc_async_binary_appender(properties));
+  }
+  log4xtensa::tstring getTypeName() {
+    return LOG4XTENSA_TEXT("xtsc_component::xtsc_async_binary_appender");
+  }
+};
+
+}
+
+
+
+void xtsc_component::xtsc_register_async_binary_appender() {
+  unique_ptr<log4xtensa::spi::AppenderFactory> factory(new xtsc_async_binary_appender_factory);
+  if (!log4xtensa::spi::getAppenderFactoryRegistry().get(factory->getTypeName())) {
+    log4xtensa::spi::getAppenderFactoryRegistry().put(std::move(factory));
+  }
+}
+
+
+
+xtsc_component::xtsc_async_binary_appender::xtsc_async_binary_appender(const log4xtensa::helpers::Properties& properties) :
+  log4xtensa::Appender  (properties),
+  m_file_name           (properties.getProperty(LOG4XTENSA_TEXT("File"))),
+  m_ring_records        (get_u32_property(properties, "RingRecords", 65536)),
+  m_record_bytes        (get_u32_property(properties, "RecordBytes", 256)),
+  m_write_bytes         (get_u32_property(properties, "WriteBytes",  1024*1024)),
+  m_backpressure        (properties.getProperty(LOG4XTENSA_TEXT("Backpressure"), LOG4XTENSA_TEXT("false")) == "true")
+{
+  init();
+}
+
+
+
+xtsc_component::xtsc_async_binary_appender::xtsc_async_binary_appender(const string&    file_name,
+                                                                        u32              ring_records,
+                                                                        u32              record_bytes,
+                                                                        u32              write_bytes,
+                                                                        bool             backpressure) :
+  m_file_name           (file_name),
+  m_ring_records        (ring_records),
+  m_record_bytes        (record_bytes),
+  m_write_bytes         (write_bytes),
+  m_backpressure        (backpressure)
+{
+  init();
+}
+
+
+
+void xtsc_component::xtsc_async_binary_appender::init() {
+  if (m_file_name == "") {
+    throw xtsc_exception("xtsc_async_binary_appender: the \"File\" property is required");
+  }
+  if (!m_ring_records || !m_record_bytes) {
+    ostringstream oss;
+    oss << "xtsc_async_binary_appender '" << m_file_name << "': \"RingRecords\" and \"RecordBytes\" must be non-zero";
+    throw xtsc_exception(oss.str());
+  }
+  // Larger values cannot be rounded up to a power of 2 in a u32
+  if (m_ring_records > 0x80000000) {
+    ostringstream oss;
+    oss << "xtsc_async_binary_appender '" << m_file_name << "': \"RingRecords\" (" << m_ring_records
+        << ") must not exceed 2147483648 (0x80000000)";
+    throw xtsc_exception(oss.str());
+  }
+  u32 ring_records = 1;
+  while (ring_records < m_ring_records) {
+    ring_records <<= 1;
+  }
+  m_ring_records        = ring_records;
+  m_num_records         = 0;
+  m_num_dropped         = 0;
+  m_num_backpressure    = 0;
+  m_num_oversize        = 0;
+  m_head                = 0;
+  m_tail                = 0;
+  m_stop                = false;
+  m_ring.resize((u64) m_ring_records * (4 + m_record_bytes));
+  m_buffer.reserve(m_write_bytes);
+  m_file.open(m_file_name.c_str(), ios::out | ios::binary | ios::trunc);
+  if (!m_file.is_open()) {
+    ostringstream oss;
+    oss << "xtsc_async_binary_appender: cannot open \"" << m_file_name << "\" for writing";
+    throw xtsc_exception(oss.str());
+  }
+  m_thread = thread(&xtsc_async_binary_appender::drain, this);
+  lock_guard<mutex> lock(instances_mutex);
+  instances.push_back(this);
+}
+
+
+
+xtsc_component::xtsc_async_binary_appender::~xtsc_async_binary_appender() {
+  destructorImpl();
+  if (m_thread.joinable()) {
+    close();
+  }
+  lock_guard<mutex> lock(instances_mutex);
+  instances.erase(remove(instances.begin(), instances.end(), this), instances.end());
+}
+
+
+
+void xtsc_component::xtsc_async_binary_appender::close() {
+  if (m_thread.joinable()) {
+    m_stop.store(true, memory_order_release);
+    m_thread.join();
+    m_file.close();
+  }
+  closed = true;
+}
+
+
+
+void xtsc_component::xtsc_async_binary_appender::append(const log4xtensa::spi::InternalLoggingEvent& event) {
+  const log4xtensa::tstring& message = event.getMessage();
+  u32 num_bytes = (u32) (message.size() * sizeof(message[0]));
+  if (num_bytes > m_record_bytes) {
+    m_num_oversize += 1;
+    return;
+  }
+  u64 head = m_head.load(memory_order_relaxed);
+  if (head - m_tail.load(memory_order_acquire) >= m_ring_records) {
+    if (!m_backpressure) {
+      m_num_dropped += 1;
+      return;
+    }
+    m_num_backpressure += 1;
+    while (head - m_tail.load(memory_order_acquire) >= m_ring_records) {
+      this_thread::yield();
+    }
+  }
+  u8 *slot = &m_ring[(head & (m_ring_records - 1)) * (4 + m_record_bytes)];
+  memcpy(slot, &num_bytes, 4);
+  memcpy(slot + 4, message.data(), num_bytes);
+  m_head.store(head + 1, memory_order_release);
+  m_num_records += 1;
+}
+
+
+
+void xtsc_component::xtsc_async_binary_appender::write_slot(u32 index) {
+  const u8 *slot = &m_ring[(u64) index * (4 + m_record_bytes)];
+  u32 num_bytes;
+  memcpy(&num_bytes, slot, 4);
+  if (m_buffer.size() + num_bytes > m_write_bytes) {
+    m_file.write(&m_buffer[0], m_buffer.size());
+    m_buffer.clear();
+  }
+  m_buffer.insert(m_buffer.end(), (const char*) slot + 4, (const char*) slot + 4 + num_bytes);
+}
+
+
+
+void xtsc_component::xtsc_async_binary_appender::drain() {
+  while (true) {
+    u64 tail = m_tail.load(memory_order_relaxed);
+    u64 head = m_head.load(memory_order_acquire);
+    if (tail == head) {
+      if (m_stop.load(memory_order_acquire) && (m_head.load(memory_order_acquire) == tail)) {
+        break;
+      }
+      // Ring is empty: push out what we have so the file is not far behind a paused simulation
+      if (!m_buffer.empty()) {
+        m_file.write(&m_buffer[0], m_buffer.size());
+        m_buffer.clear();
+        m_file.flush();
+      }
+      this_thread::sleep_for(chrono::microseconds(100));
+      continue;
+    }
+    for (; tail != head; ++tail) {
+      write_slot((u32) (tail & (m_ring_records - 1)));
+    }
+    m_tail.store(tail, memory_order_release);
+  }
+  if (!m_buffer.empty()) {
+    m_file.write(&m_buffer[0], m_buffer.size());
+    m_buffer.clear();
+  }
+  m_file.flush();
+}
+
+
+
+void xtsc_component::xtsc_async_binary_appender::dump_statistics(ostream& os) const {
+  os << m_file_name << ": records=" << m_num_records << " dropped=" << m_num_dropped << " backpressure=" << m_num_backpressure
+     << " oversize=" << m_num_oversize << endl;
+}
+
+
+
+// static
+void xtsc_component::xtsc_async_binary_appender::dump_all_statistics(ostream& os) {
+  lock_guard<mutex> lock(instances_mutex);
+  for (vector<xtsc_async_binary_appender*>::const_iterator i = instances.begin(); i != instances.end(); ++i) {
+    (*i)->dump_statistics(os);
+  }
+}
@@ -226,7 +226,7 @@ xtsc_component::xtsc_axi2pif_transactor::xtsc_axi2pif_transactor(
     m_rd_nsm_vld                         (nullptr),
     m_wr_nsm_vld                         (nullptr),
 
-    m_request_count                      (0),
+    m_allocator                          (name()),
     m_mode_switch_pending                (false),
     m_text                               (TextLogger::getInstance(name()))
 {
@@ -542,7 +542,6 @@ xtsc_component::xtsc_axi2pif_transactor::xtsc_axi2pif_transactor(
   reset();
 }
 
-// Delete all requests of m_request_pool
 xtsc_component::xtsc_axi2pif_transactor::~xtsc_axi2pif_transactor(void) {
   XTSC_TRACE(m_text, "Enter ::~xtsc_axi2pif_transactor()");
 
@@ -600,10 +599,6 @@ xtsc_component::xtsc_axi2pif_transactor::~xtsc_axi2pif_transactor(void) {
   delete [] m_write_request_active;
   delete [] m_write_request_active_tag;
 
-  while (m_request_pool.size()) {
-    delete m_request_pool.back();
-    m_request_pool.pop_back();
-  }
 }
 
 void xtsc_component::xtsc_axi2pif_transactor::end_of_simulation(void) 
@@ -611,12 +606,12 @@ void xtsc_component::xtsc_axi2pif_transactor::end_of_simulation(void)
   XTSC_TRACE(m_text, "Enter ::end_of_simulation()");
 
   LogLevel ll = log4xtensa::INFO_LOG_LEVEL;
-  bool mismatch = ( m_request_pool.size() != m_request_count );
+  bool mismatch = (m_allocator.get_num_live() != 0);
   if (mismatch) {
     ll = log4xtensa::ERROR_LOG_LEVEL;
-    XTSC_LOG(m_text, ll, "Error: 1 or more mismatches between pool sizes and counts which indicates a leak: ");
+    XTSC_LOG(m_text, ll, "Error: 1 or more transaction objects were not returned which indicates a leak: ");
   }
-  XTSC_LOG(m_text, ll, m_request_pool.size() << "/" << m_request_count << " (m_request_pool/m_request_count)");
+  XTSC_LOG(m_text, ll, m_allocator.get_num_live() << "/" << m_allocator.get_num_peak() << " (live/peak transaction objects)");
 }
 
 
@@ -999,7 +994,7 @@ xtsc_component::xtsc_axi2pif_transactor::request_thread(void)
           if (drop_on_floor) {
             XTSC_INFO(m_text, "Dropping " << xtsc_response::get_status_name(status, true) << ": " << p_axi_request);
           } else {
-            axi_trans_info *i_axi_trans_info = new axi_trans_info;
+            axi_trans_info *i_axi_trans_info = m_allocator.create<axi_trans_info>();
             i_axi_trans_info->m_axi_request = p_axi_request;
             i_axi_trans_info->m_is_nsm_error = true;
             i_axi_trans_info->m_is_read = is_rd;
@@ -1031,7 +1026,7 @@ xtsc_component::xtsc_axi2pif_transactor::request_thread(void)
             m_axi_request_order_fifo[port_num]->pop();
           }
 
-          delete i_axi_req_info;
+          m_allocator.destroy(i_axi_req_info);
         } else {
           handle_axi_request(i_axi_req_info, port_num);
         }
@@ -1238,13 +1233,13 @@ void xtsc_component::xtsc_axi2pif_transactor::handle_axi_request(axi_req_info *i
         if (p_axi_request->get_transfer_number() > 1) {
           delete_request(p_axi_request);
         }
-        delete i_axi_req_info;
+        m_allocator.destroy(i_axi_req_info);
       } else {
         XTSC_DEBUG(m_text, "Popping m_axi_request_order_fifo[" << port_num << "]->front() " << m_axi_request_order_fifo[port_num]->front());
         assert(m_axi_request_order_fifo[port_num]->front() == m_read_request_fifo[port_num]->front()->m_axi_request->get_tag());
 
         XTSC_DEBUG(m_text, "Deleting axi_req_info: " << i_axi_req_info << " with tag=" << i_axi_req_info->m_axi_request->get_tag());
-        delete i_axi_req_info;
+        m_allocator.destroy(i_axi_req_info);
         
         m_axi_request_order_fifo[port_num]->pop();
       }
@@ -1429,7 +1424,7 @@ xtsc_component::xtsc_axi2pif_transactor::conv_read_axi2pif_request(xtsc_request
     XTSC_DEBUG(m_text, "Block not possible as vld_num_transfers: " << vld_num_transfers << ", addr_aligned: " << addr_aligned << ", size8: " << size8 << ", m_pif_width8: " << m_pif_width8);
   }
 
-  axi_trans_info *i_axi_trans_info                     = new axi_trans_info();
+  axi_trans_info *i_axi_trans_info                     = m_allocator.create<axi_trans_info>();
   i_axi_trans_info->m_is_read                          = true;
   i_axi_trans_info->m_axi_request                      = p_axi_request;
 
@@ -1608,7 +1603,7 @@ xtsc_component::xtsc_axi2pif_transactor::conv_write_axi2pif_request(xtsc_request
   // If its second to last beats for a previous transaction
   // m_write_request_fifo already has the first request stored
   if (transfer_num == 1) {
-    i_axi_trans_info                                = new axi_trans_info();
+    i_axi_trans_info                                = m_allocator.create<axi_trans_info>();
     i_axi_trans_info->m_is_read                     = false;
     i_axi_trans_info->m_axi_request                 = p_axi_request;
 
@@ -1906,42 +1901,23 @@ void xtsc_component::xtsc_axi2pif_transactor::send_write_response(xtsc_response&
 
 xtsc_request *xtsc_component::xtsc_axi2pif_transactor::copy_request(const xtsc_request& request) {
   XTSC_TRACE(m_text, "Enter ::copy_request(request:" << request << ")");
-  xtsc_request *p_request = NULL;
-  if (m_request_pool.empty()) {
-    m_request_count += 1;
-    XTSC_TRACE(m_text, "Created new xtsc_request, count #" << m_request_count << ". Copy");
-    p_request = new xtsc_request();
-  }
-  else {
-    p_request = m_request_pool.back();
-    m_request_pool.pop_back();
-    XTSC_TRACE(m_text, "Used xtsc_request from pool, size #" << m_request_pool.size());
-  }
-  *p_request = request; //Copy contents
+  xtsc_request *p_request = m_allocator.create<xtsc_request>(request);
+  XTSC_TRACE(m_text, "Created xtsc_request, live #" << m_allocator.get_num_live() << ". Copy");
   return p_request;
 }
 
 
 xtsc_request *xtsc_component::xtsc_axi2pif_transactor::new_request() {
   XTSC_TRACE(m_text, "Enter ::new_request()");
-  xtsc_request *p_request = NULL;
-  if (m_request_pool.empty()) {
-    m_request_count += 1;
-    p_request = new xtsc_request();
-    XTSC_TRACE(m_text, "Created new xtsc_request, count #" << m_request_count << ". New");
-  }
-  else {
-    p_request = m_request_pool.back();
-    m_request_pool.pop_back();
-    XTSC_TRACE(m_text, "Used xtsc_request from pool, size #" << m_request_pool.size());
-  }
+  xtsc_request *p_request = m_allocator.create<xtsc_request>();
+  XTSC_TRACE(m_text, "Created xtsc_request, live #" << m_allocator.get_num_live() << ". New");
   return p_request;
 }
 
 void xtsc_component::xtsc_axi2pif_transactor::delete_request(xtsc_request*& p_request) {
   XTSC_TRACE(m_text, "Enter ::delete_request(*p_request:" << *p_request << ")");
-  m_request_pool.push_back(p_request);
-  XTSC_TRACE(m_text, "Returned xtsc_request to pool, size #" << m_request_pool.size());
+  m_allocator.destroy(p_request);
+  XTSC_TRACE(m_text, "Returned xtsc_request, live #" << m_allocator.get_num_live());
   p_request = 0;
 }
 
@@ -1954,14 +1930,14 @@ void xtsc_component::xtsc_axi2pif_transactor::clear_fifos(void)
       axi_req_info *i_axi_req_info = m_read_request_fifo[port_num]->front();
       m_read_request_fifo[port_num]->pop();
       XTSC_DEBUG(m_text, "Deleting axi_req_info: " << i_axi_req_info << " with tag=" << i_axi_req_info->m_axi_request->get_tag());
-      delete i_axi_req_info;
+      m_allocator.destroy(i_axi_req_info);
     }
     
     while (!m_write_request_fifo[port_num]->empty()) {
       axi_req_info *i_axi_req_info = m_write_request_fifo[port_num]->front();
       m_write_request_fifo[port_num]->pop();
       XTSC_DEBUG(m_text, "Deleting axi_req_info: " << i_axi_req_info << " with tag=" << i_axi_req_info->m_axi_request->get_tag());
-      delete i_axi_req_info;
+      m_allocator.destroy(i_axi_req_info);
     }
     
     while (!m_read_response_fifo[port_num]->empty()) {
@@ -1969,7 +1945,7 @@ void xtsc_component::xtsc_axi2pif_transactor::clear_fifos(void)
       m_read_response_fifo[port_num]->pop();
       XTSC_DEBUG(m_text, "Deleting axi_rsp_trans_info: " << i_axi_rsp_trans_info << " with tag=" << i_axi_rsp_trans_info->m_axi_request_tag);
       delete_axi_rsp(i_axi_rsp_trans_info, port_num);
-      delete i_axi_rsp_trans_info;
+      m_allocator.destroy(i_axi_rsp_trans_info);
     }
     
     while (!m_write_response_fifo[port_num]->empty()) {
@@ -1977,7 +1953,7 @@ void xtsc_component::xtsc_axi2pif_transactor::clear_fifos(void)
       m_write_response_fifo[port_num]->pop();
       XTSC_DEBUG(m_text, "Deleting axi_rsp_trans_info: " << i_axi_rsp_trans_info << " with tag=" << i_axi_rsp_trans_info->m_axi_request_tag);
       delete_axi_rsp(i_axi_rsp_trans_info, port_num);
-      delete i_axi_rsp_trans_info;
+      m_allocator.destroy(i_axi_rsp_trans_info);
     }
   }
 }
@@ -2055,7 +2031,7 @@ xtsc_component::xtsc_axi2pif_transactor::send_rd_nsm_rsps(xtsc::u32 port_num)
 
   //send error response
   xtsc::u32 num_trfs = i_axi_trans_info->m_axi_request->get_num_transfers();
-  xtsc_response *response = new xtsc_response(*i_axi_trans_info->m_axi_request, xtsc_response::RSP_DATA_ERROR, false);
+  xtsc_response *response = m_allocator.create<xtsc_response>(*i_axi_trans_info->m_axi_request, xtsc_response::RSP_DATA_ERROR, false);
   for (u32 trf_num=1; trf_num <= num_trfs; ++trf_num) {
     response->set_transfer_number(trf_num);
 
@@ -2067,7 +2043,7 @@ xtsc_component::xtsc_axi2pif_transactor::send_rd_nsm_rsps(xtsc::u32 port_num)
     wait(m_clock_period);
   }
 
-  delete response;
+  m_allocator.destroy(response);
   delete_trans_info(i_axi_trans_info, port_num);
 }
 
@@ -2107,12 +2083,13 @@ xtsc_component::xtsc_axi2pif_transactor::send_wr_nsm_rsps(xtsc::u32 port_num)
 
   //send error response
   xtsc::u32 num_trfs = i_axi_trans_info->m_axi_request->get_num_transfers();
-  xtsc_response *response = new xtsc_response(*i_axi_trans_info->m_axi_request, xtsc_response::RSP_DATA_ERROR, true);
+  xtsc_response *response = m_allocator.create<xtsc_response>(*i_axi_trans_info->m_axi_request, xtsc_response::RSP_DATA_ERROR, true);
     
   send_write_response(*response, port_num);
 
   wait(m_clock_period);
 
+  m_allocator.destroy(response);
   delete_trans_info(i_axi_trans_info, port_num);
 }
 
@@ -2133,9 +2110,9 @@ xtsc_component::xtsc_axi2pif_transactor::delete_axi_rsp(axi_rsp_trans_info *i_ax
     delete_trans_info(i_axi_trans_info, port_num);
   }
 
-  delete i_response;
+  m_allocator.destroy(i_response);
   XTSC_DEBUG(m_text, "Deleting axi_rsp_trans_info: " << i_axi_rsp_trans_info << ".");
-  delete i_axi_rsp_trans_info;
+  m_allocator.destroy(i_axi_rsp_trans_info);
 }
 
 void
@@ -2166,7 +2143,7 @@ xtsc_component::xtsc_axi2pif_transactor::delete_trans_info(axi_trans_info *p_axi
   }
 
   delete_request(p_axi_request);
-  delete p_axi_trans_info;
+  m_allocator.destroy(p_axi_trans_info);
 }
 
 /******** xtsc_request_if_impl **********/
@@ -2247,7 +2224,7 @@ void xtsc_component::xtsc_axi2pif_transactor::xtsc_request_if_impl::nb_request_w
 {
   XTSC_TRACE(m_transactor.m_text, "Enter ::nb_request_worker(request:" << *p_axi_request << ") Port #" << m_port_num);
 
-  axi_req_info *i_axi_req_info   = new axi_req_info();
+  axi_req_info *i_axi_req_info   = m_transactor.m_allocator.create<axi_req_info>();
   i_axi_req_info->m_axi_request  = p_axi_request;
 
   sc_time add_delay              = (m_type == "READ") 
@@ -2446,7 +2423,7 @@ void xtsc_component::xtsc_axi2pif_transactor::xtsc_respond_if_impl::read_respons
   i_axi_trans_info->m_num_pif_rsps_arrvd++;
   bool last = (i_axi_trans_info->m_total_pif_requests == i_axi_trans_info->m_num_pif_rsps_arrvd);
 
-  p_axi_response = new xtsc_response(*p_axi_request, p_pif_response->get_status(), last);
+  p_axi_response = m_transactor.m_allocator.create<xtsc_response>(*p_axi_request, p_pif_response->get_status(), last);
   p_axi_response->set_transfer_number(i_axi_trans_info->m_num_pif_rsps_arrvd);
   p_axi_response->set_exclusive_ok(p_pif_response->get_exclusive_ok());
   memcpy(p_axi_response->get_buffer(), p_pif_response->get_buffer(), size8);
@@ -2454,7 +2431,7 @@ void xtsc_component::xtsc_axi2pif_transactor::xtsc_respond_if_impl::read_respons
   XTSC_DEBUG(m_transactor.m_text, "Created new xtsc_response: " << *p_axi_response);
 
   // Now, we have p_axi_response ready to be sent back
-  axi_rsp_trans_info *i_axi_rsp_trans_info = new axi_rsp_trans_info;
+  axi_rsp_trans_info *i_axi_rsp_trans_info = m_transactor.m_allocator.create<axi_rsp_trans_info>();
   i_axi_rsp_trans_info->m_axi_response     = p_axi_response;
   i_axi_rsp_trans_info->m_axi_request_tag  = p_axi_request->get_tag();
 
@@ -2586,12 +2563,12 @@ void xtsc_component::xtsc_axi2pif_transactor::xtsc_respond_if_impl::write_respon
 
     // send the axi response back
     bool last = true;
-    xtsc_response *p_axi_response = new xtsc_response(*p_axi_request,i_axi_trans_info->m_curr_response_status, last);
+    xtsc_response *p_axi_response = m_transactor.m_allocator.create<xtsc_response>(*p_axi_request,i_axi_trans_info->m_curr_response_status, last);
     p_axi_response->set_exclusive_ok(p_pif_response->get_exclusive_ok());
 
     XTSC_DEBUG(m_transactor.m_text, "Created new xtsc_response: " << *p_axi_response);
     
-    axi_rsp_trans_info *i_axi_rsp_trans_info = new axi_rsp_trans_info;
+    axi_rsp_trans_info *i_axi_rsp_trans_info = m_transactor.m_allocator.create<axi_rsp_trans_info>();
     i_axi_rsp_trans_info->m_axi_response     = p_axi_response;
     i_axi_rsp_trans_info->m_axi_request_tag  = p_axi_request->get_tag();
 
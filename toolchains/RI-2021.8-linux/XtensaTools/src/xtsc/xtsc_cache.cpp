@@ -9,6 +9,7 @@
 
 
 #include <iostream>
+#include <cstring>
 #include <ctype.h>
 #include <xtsc/xtsc_cache.h>
 
@@ -39,7 +40,8 @@ xtsc_component::xtsc_cache::xtsc_cache(const sc_module_name module_name, const x
   m_read_priority                         (cache_parms.get_u32("read_priority")),
   m_write_priority                        (cache_parms.get_u32("write_priority")),
   m_profile_cache                         (cache_parms.get_bool("profile_cache")),
-  m_use_pif_attribute                     (cache_parms.get_bool("use_pif_attribute"))
+  m_use_pif_attribute                     (cache_parms.get_bool("use_pif_attribute")),
+  m_tag_index_ways                        (cache_parms.get_u32("tag_index_ways"))
 {
 
   // Check memory parameters ...
@@ -54,6 +56,7 @@ xtsc_component::xtsc_cache::xtsc_cache(const sc_module_name module_name, const x
        if (repl_policy == "RR"    )  m_replacement_policy  = REPL_RR;
   else if (repl_policy == "LRU"   )  m_replacement_policy  = REPL_LRU;
   else if (repl_policy == "RANDOM")  m_replacement_policy  = REPL_RANDOM;
+  else if (repl_policy == "PLRU"  )  m_replacement_policy  = REPL_PLRU;
   else {
     ostringstream oss;
     oss << kind() << " '" << name() << "': Invalid or unsupported replacement policy (" << policy  << ").";
@@ -82,6 +85,7 @@ xtsc_component::xtsc_cache::xtsc_cache(const sc_module_name module_name, const x
   }
 
   m_lru_selected                   = (m_replacement_policy == REPL_LRU) ? true : false;
+  m_plru_selected                  = (m_replacement_policy == REPL_PLRU) ? true : false;
 
   // Configure cache structure ...
   configure();
@@ -168,6 +172,7 @@ xtsc_component::xtsc_cache::xtsc_cache(const sc_module_name module_name, const x
   XTSC_LOG(m_text, ll, " profile_cache           =   " << boolalpha << m_profile_cache);
   XTSC_LOG(m_text, ll, " use_pif_attribute       =   " << boolalpha << m_use_pif_attribute);
   XTSC_LOG(m_text, ll, " bypass_delay            =   " << cache_parms.get_u32("bypass_delay"));
+  XTSC_LOG(m_text, ll, " tag_index_ways          =   " << m_tag_index_ways << (m_tag_index ? " (indexed)" : ""));
 
   ostringstream oss;
   dump_config(oss);
@@ -190,6 +195,13 @@ xtsc_component::xtsc_cache::~xtsc_cache(void) {
       delete [] m_lru[i];
     delete [] m_lru;
   }
+  if (m_plru_selected) {
+    for (u32 i = 0; i < m_num_sets; i++)
+      delete [] m_plru[i];
+    delete [] m_plru;
+  }
+  delete [] m_tag_index;
+  delete [] m_invalid_ways;
 }
 
 
@@ -354,6 +366,17 @@ void xtsc_component::xtsc_cache::configure() {
     oss << kind() << " '" << name() << "': Total number of sets (" << dec << m_num_sets << ") is not a power of 2.";
     throw xtsc_exception(oss.str());
   }
+  m_num_ways_log2         = 0;
+  shift_value             = m_num_ways;
+  for (u32 i = 0; i < 32; ++i) {
+    if (shift_value & 0x1) m_num_ways_log2 = i;
+    shift_value >>= 1;
+  }
+  if (m_plru_selected && ((1U << m_num_ways_log2) != m_num_ways)) {
+    ostringstream oss;
+    oss << kind() << " '" << name() << "': Number of ways (" << dec << m_num_ways << ") must be a power of 2 for PLRU replacement policy.";
+    throw xtsc_exception(oss.str());
+  }
 
   m_set_byte_size         = m_line_byte_width * m_num_ways;
   m_set_shift             = m_line_byte_width_log2;
@@ -371,6 +394,20 @@ void xtsc_component::xtsc_cache::configure() {
       m_lru[i]             = new u32  [m_num_ways];
     }
   }
+  m_plru                  = NULL;
+  if (m_plru_selected) {
+    m_plru                 = new u8*  [m_num_sets];
+    for (u32 i = 0; i < m_num_sets; i++) {
+      // Node n (1-based) of the binary tree has children 2n and 2n+1; each bit points toward the next victim
+      m_plru[i]            = new u8   [m_num_ways];
+    }
+  }
+  m_tag_index             = NULL;
+  m_invalid_ways          = NULL;
+  if (m_tag_index_ways && (m_num_ways >= m_tag_index_ways)) {
+    m_tag_index            = new map<xtsc_address, u32> [m_num_sets];
+    m_invalid_ways         = new set<u32>               [m_num_sets];
+  }
   XTSC_DEBUG(m_text, "tag_shift=" << m_tag_shift << ", set_mask=0x" << hex << m_set_mask << ", set_shift=" << dec << m_set_shift << ", num_ways =" << m_num_ways << ", num_sets=" << m_num_sets);
 }
 
@@ -537,7 +574,7 @@ u32 xtsc_component::xtsc_cache::flush_dirty_lines() {
         xtsc_memory::peek(cache_line_address, m_line_byte_width, m_line_buffer);
         xtsc_address mem_line_address      = (get_tag(set_num, way_num) << m_tag_shift) | (set_num  << m_set_shift);
         m_request_port->nb_poke(mem_line_address, m_line_byte_width, m_line_buffer);
-        m_lines[set_num][way_num].valid    = false;
+        clear_valid(set_num, way_num);
         m_lines[set_num][way_num].dirty    = false;
         m_lines[set_num][way_num].lrf      = m_lines[set_num][0].lrf;
         if (m_lru_selected)
@@ -566,6 +603,18 @@ void xtsc_component::xtsc_cache::initialize() {
       for (u32 way_num = 0; way_num < m_num_ways; way_num++)
         m_lru[set_num][way_num]          = (m_num_ways - way_num - 1);
   }
+  if (m_plru_selected) {
+    for (u32 set_num = 0; set_num < m_num_sets; set_num++)
+      memset(m_plru[set_num], 0, m_num_ways);
+  }
+  if (m_tag_index) {
+    for (u32 set_num = 0; set_num < m_num_sets; set_num++) {
+      m_tag_index[set_num].clear();
+      m_invalid_ways[set_num].clear();
+      for (u32 way_num = 0; way_num < m_num_ways; way_num++)
+        m_invalid_ways[set_num].insert(m_invalid_ways[set_num].end(), way_num);
+    }
+  }
 }
 
 
@@ -874,7 +923,8 @@ void xtsc_component::xtsc_cache::do_write(u32 port_num) {
 
 void xtsc_component::xtsc_cache::do_bypass(u32 port_num) {
   xtsc_request  *p_request      = &m_p_active_request_info[port_num]->m_request;
-  m_p_active_response[port_num] = new xtsc_response(*p_request);
+  delete_response(m_p_active_response[port_num]);
+  m_p_active_response[port_num] = new_response(*p_request);
   switch (p_request->get_type()) {
   case xtsc_request::READ:         ext_mem_read(port_num);        break;
   case xtsc_request::BLOCK_READ:   ext_mem_block_read(port_num);  break;
@@ -920,7 +970,7 @@ void xtsc_component::xtsc_cache::ext_mem_block_read(xtsc_address           src_m
   do {
     m_block_read_response_count = 0;
     if (m_p_block_read_response[0]) {
-      delete m_p_block_read_response[0];
+      m_response_allocator.destroy(m_p_block_read_response[0]);
       m_p_block_read_response[0] = 0;
     }
     tries += 1;
@@ -958,7 +1008,7 @@ void xtsc_component::xtsc_cache::ext_mem_block_read(u32 port_num) {
   u32 tries = 0;
   do {
     if (m_p_block_read_response[0]) {
-      delete m_p_block_read_response[0];
+      m_response_allocator.destroy(m_p_block_read_response[0]);
       m_p_block_read_response[0] = 0;
     }
     tries += 1;
@@ -1035,7 +1085,7 @@ void xtsc_component::xtsc_cache::ext_mem_block_write(xtsc_address          dst_m
     u32 tries = 0;
     do {
       if (m_p_block_write_response) {
-        delete m_p_block_write_response;
+        m_response_allocator.destroy(m_p_block_write_response);
         m_p_block_write_response = 0;
       }
       tries += 1;
@@ -1075,7 +1125,7 @@ void xtsc_component::xtsc_cache::ext_mem_block_write(u32 port_num, bool cache_by
   u32 tries = 0;
   do {
     if (m_p_block_write_response) {
-      delete m_p_block_write_response;
+      m_response_allocator.destroy(m_p_block_write_response);
       m_p_block_write_response = 0;
     }
     tries += 1;
@@ -1174,7 +1224,7 @@ void xtsc_component::xtsc_cache::ext_mem_rcw(u32 port_num) {
   u32 tries = 0;
   do {
     if (m_p_single_response) {
-      delete m_p_single_response;
+      m_response_allocator.destroy(m_p_single_response);
       m_p_single_response = 0;
     }
     tries += 1;
@@ -1274,12 +1324,21 @@ void xtsc_component::xtsc_cache::ext_mem_write(u32 port_num) {
 
 
 u32 xtsc_component::xtsc_cache::find_hit(xtsc_address address_tag, u32 set_num) {
+  if (m_tag_index) {
+    map<xtsc_address, u32>::const_iterator i = m_tag_index[set_num].find(address_tag);
+    if (i == m_tag_index[set_num].end()) {
+      return m_num_ways;
+    }
+    u32 way = i->second;
+    XTSC_DEBUG(m_text, "Cache HIT on set " << set_num << ", line " << way << ", tag = 0x" << hex << address_tag);
+    touch_line(set_num, way);
+    return way;
+  }
   u32 way = 0;
   for (way = 0; way < m_num_ways; way++) {
     if (is_valid(set_num, way) && (get_tag(set_num, way) == address_tag)) {
       XTSC_DEBUG(m_text, "Cache HIT on set " << set_num << ", line " << way << ", tag = 0x" << hex << address_tag);
-      if (m_lru_selected)
-        update_lru(set_num, m_lru[set_num][way]);
+      touch_line(set_num, way);
       return way;
     }
   }
@@ -1291,12 +1350,20 @@ u32 xtsc_component::xtsc_cache::find_hit(xtsc_address address_tag, u32 set_num)
 u32 xtsc_component::xtsc_cache::find_replace_line(u32 set_num) {
   if (m_num_ways == 0) return 0; // Direct-mapped cache model
   u32 way = 0;
-  for (way = 0; way < m_num_ways; way++)
-    if (!is_valid(set_num, way)) {
-      if (m_lru_selected)
-        update_lru(set_num, m_lru[set_num][way]);
+  if (m_tag_index) {
+    if (!m_invalid_ways[set_num].empty()) {
+      way = *m_invalid_ways[set_num].begin();
+      touch_line(set_num, way);
       return way;
     }
+  }
+  else {
+    for (way = 0; way < m_num_ways; way++)
+      if (!is_valid(set_num, way)) {
+        touch_line(set_num, way);
+        return way;
+      }
+  }
 
   switch(m_replacement_policy) {
   case REPL_RANDOM:
@@ -1308,6 +1375,9 @@ u32 xtsc_component::xtsc_cache::find_replace_line(u32 set_num) {
   case REPL_LRU:
     way = find_replace_lru(set_num);
     break;
+  case REPL_PLRU:
+    way = find_replace_plru(set_num);
+    break;
   default:
     way = find_replace_rr(set_num);
   }
@@ -1336,6 +1406,19 @@ u32 xtsc_component::xtsc_cache::find_replace_lru(u32 set_num) {
 
 
 
+u32 xtsc_component::xtsc_cache::find_replace_plru(u32 set_num) {
+  const u8 *tree = m_plru[set_num];
+  u32 node = 1;
+  while (node < m_num_ways) {
+    node = 2 * node + tree[node];
+  }
+  u32 way = node - m_num_ways;
+  update_plru(set_num, way);
+  return way;
+}
+
+
+
 u32 xtsc_component::xtsc_cache::find_replace_random(u32 set_num) {
   u32 way = rand() % m_num_ways;
   return way;
@@ -1484,6 +1567,35 @@ void xtsc_component::xtsc_cache::update_lru(u32 set_num, u32 ref) {
 
 
 
+void xtsc_component::xtsc_cache::update_plru(u32 set_num, u32 way_num) {
+  u8 *tree = m_plru[set_num];
+  u32 node = 1;
+  for (u32 level = m_num_ways_log2; level > 0; level--) {
+    u32 bit = (way_num >> (level - 1)) & 0x1;
+    tree[node] = (u8) !bit;
+    node = 2 * node + bit;
+  }
+}
+
+
+
+void xtsc_component::xtsc_cache::index_line(u32 set_num, u32 way_num) {
+  m_tag_index[set_num][m_lines[set_num][way_num].tag] = way_num;
+  m_invalid_ways[set_num].erase(way_num);
+}
+
+
+
+void xtsc_component::xtsc_cache::unindex_line(u32 set_num, u32 way_num) {
+  map<xtsc_address, u32>::iterator i = m_tag_index[set_num].find(m_lines[set_num][way_num].tag);
+  if ((i != m_tag_index[set_num].end()) && (i->second == way_num)) {
+    m_tag_index[set_num].erase(i);
+  }
+  m_invalid_ways[set_num].insert(way_num);
+}
+
+
+
 void xtsc_component::xtsc_cache::worker_thread(void) {
 
   // Get the port number for this "instance" of worker_thread
@@ -1619,10 +1731,10 @@ bool xtsc_component::xtsc_cache::xtsc_respond_if_impl::nb_respond(const xtsc_res
   u8 rsp_id = response.get_id();
   if ((rsp_id == m_cache.m_read_id) || (rsp_id == m_cache.m_write_id) || (rsp_id == m_cache.m_rcw_id)) {
     if (m_cache.m_p_single_response) {
-      delete m_cache.m_p_single_response;
+      m_cache.m_response_allocator.destroy(m_cache.m_p_single_response);
       m_cache.m_p_single_response = 0;
     }
-    m_cache.m_p_single_response = new xtsc_response(response);
+    m_cache.m_p_single_response = m_cache.m_response_allocator.create<xtsc_response>(response);
     m_cache.m_single_response_available_event.notify(SC_ZERO_TIME);
   }
   else if (rsp_id == m_cache.m_block_read_id) {
@@ -1633,19 +1745,19 @@ bool xtsc_component::xtsc_cache::xtsc_respond_if_impl::nb_respond(const xtsc_res
       throw xtsc_exception(oss.str());
     }
     if (m_cache.m_p_block_read_response[m_cache.m_block_read_response_count]) {
-      delete m_cache.m_p_block_read_response[m_cache.m_block_read_response_count];
+      m_cache.m_response_allocator.destroy(m_cache.m_p_block_read_response[m_cache.m_block_read_response_count]);
       m_cache.m_p_block_read_response[m_cache.m_block_read_response_count] = 0;
     }
-    m_cache.m_p_block_read_response[m_cache.m_block_read_response_count] = new xtsc_response(response);
+    m_cache.m_p_block_read_response[m_cache.m_block_read_response_count] = m_cache.m_response_allocator.create<xtsc_response>(response);
     m_cache.m_block_read_response_available_event.notify(SC_ZERO_TIME);
     m_cache.m_block_read_response_count += 1;
   }
   else if (rsp_id == m_cache.m_block_write_id) {
     if (m_cache.m_p_block_write_response) {
-      delete m_cache.m_p_block_write_response;
+      m_cache.m_response_allocator.destroy(m_cache.m_p_block_write_response);
       m_cache.m_p_block_write_response = 0;
     }
-    m_cache.m_p_block_write_response = new xtsc_response(response);
+    m_cache.m_p_block_write_response = m_cache.m_response_allocator.create<xtsc_response>(response);
     m_cache.m_block_write_response_available_event.notify(SC_ZERO_TIME);
   }
   else {
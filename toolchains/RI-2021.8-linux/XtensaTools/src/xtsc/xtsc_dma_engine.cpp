@@ -8,8 +8,12 @@
 // written consent of Cadence Design Systems, Inc.
 
 
+#define SC_INCLUDE_DYNAMIC_PROCESSES    // For sc_spawn and sc_bind (see dma_thread)
 #include "xtsc/xtsc_dma_engine.h"
+#include <xtsc/xtsc_fast_access.h>
+#include <cstring>
 #include <string>
+#include <vector>
 #include <sstream>
 
 using namespace std;
@@ -19,6 +23,30 @@ using namespace xtsc;
 
 
 
+xtsc_component::xtsc_dma_engine::channel::channel(u32 index, u32 reg_base_address) :
+  m_index                       (index),
+  m_reg_base_address            (reg_base_address),
+  m_busy                        (false),
+  m_big_endian                  (false),
+  m_waiting_for_read_slot       (false),
+  m_num_reads                   (0),
+  m_num_writes                  (0),
+  m_p_single_response           (0),
+  m_num_block_transfers         (0),
+  m_block_read_response_count   (0),
+  m_block_write_sent_count      (0),
+  m_p_block_write_response      (0),
+  m_num_dma_requests            (0),
+  m_num_descriptors             (0),
+  m_num_bytes                   (0),
+  m_busy_time                   (SC_ZERO_TIME)
+{
+  for (u32 i=0; i<16; ++i) {
+    m_p_block_read_response[i] = 0;
+  }
+}
+
+
 
 xtsc_component::xtsc_dma_engine::xtsc_dma_engine(sc_module_name module_name, const xtsc_dma_engine_parms& dma_parms) :
   xtsc_memory                           (module_name, dma_parms),
@@ -26,22 +54,16 @@ xtsc_component::xtsc_dma_engine::xtsc_dma_engine(sc_module_name module_name, con
   m_respond_export                      ("m_respond_export"),
   m_respond_impl                        ("m_respond_impl", *this),
 #if IEEE_1666_SYSTEMC >= 201101L
-  m_dma_thread_event                    ("m_dma_thread_event"),
   m_request_thread_event                ("m_request_thread_event"),
   m_write_thread_event                  ("m_write_thread_event"),
-  m_got_read_response_event             ("m_got_read_response_event"),
-  m_no_reads_or_writes_event            ("m_no_reads_or_writes_event"),
-  m_single_response_available_event     ("m_single_response_available_event"),
-  m_block_read_response_available_event ("m_block_read_response_available_event"),
-  m_block_write_response_available_event("m_block_write_response_available_event"),
 #endif
-  m_request_got_nacc                    (false)
+  m_request_got_nacc                    (false),
+  m_request_allocator                   (string(name()) + ".xtsc_request")
 {
 
-  m_p_single_response      = 0;
-  m_p_block_write_response = 0;
-
   m_reg_base_address    = dma_parms.get_u32("reg_base_address");
+  m_num_channels        = dma_parms.get_u32("num_channels");
+  m_channel_spacing     = dma_parms.get_u32("channel_spacing");
   m_max_reads           = dma_parms.get_u32("max_reads");
   m_max_writes          = dma_parms.get_u32("max_writes");
   m_descriptor_delay    = dma_parms.get_u32("descriptor_delay");
@@ -53,9 +75,38 @@ xtsc_component::xtsc_dma_engine::xtsc_dma_engine(sc_module_name module_name, con
   m_allow_size_zero     = dma_parms.get_bool("allow_size_zero");
   m_start_at_index_1    = dma_parms.get_bool("start_at_index_1");
   m_turbo               = dma_parms.get_bool("turbo");
-  m_big_endian          = false;
+  m_turbo_fast_access   = dma_parms.get_bool("turbo_fast_access");
+  m_turbo_bytes_per_cycle = dma_parms.get_u32("turbo_bytes_per_cycle");
   m_overlap_read_write  = (m_max_reads > 0) && (m_max_writes > 0);
 
+  if ((m_num_channels < 1) || (m_num_channels > 8)) {
+    ostringstream oss;
+    oss << kind() << " '" << name() << "': \"num_channels\" (" << m_num_channels << ") must be between 1 and 8 (inclusive).";
+    throw xtsc_exception(oss.str());
+  }
+
+  if ((m_num_channels > 1) && ((m_channel_spacing < 512) || (m_channel_spacing & 0xFF))) {
+    ostringstream oss;
+    oss << kind() << " '" << name() << "': \"channel_spacing\" (0x" << hex << m_channel_spacing
+        << ") must be a multiple of 0x100 that is at least 0x200.";
+    throw xtsc_exception(oss.str());
+  }
+
+  const char *channel_arbitration = dma_parms.get_c_str("channel_arbitration");
+  string arbitration(channel_arbitration ? channel_arbitration : "");
+  if (arbitration == "round_robin") {
+    m_round_robin = true;
+  }
+  else if (arbitration == "fixed") {
+    m_round_robin = false;
+  }
+  else {
+    ostringstream oss;
+    oss << kind() << " '" << name() << "': \"channel_arbitration\" (\"" << arbitration
+        << "\") must be \"round_robin\" or \"fixed\".";
+    throw xtsc_exception(oss.str());
+  }
+
   if ((m_max_reads == 0) != (m_max_writes == 0)) {
     ostringstream oss;
     oss << kind() << " '" << name() << "': \"max_reads\" (" << m_max_reads << ") and \"max_writes\" (" << m_max_writes
@@ -73,10 +124,10 @@ xtsc_component::xtsc_dma_engine::xtsc_dma_engine(sc_module_name module_name, con
   m_port_types["m_respond_export"] = RESPOND_EXPORT;
   m_port_types["master_port"]      = PORT_TABLE;
 
-  xtsc_address reg_end_address8 = m_reg_base_address + 256 + 256 - 1;
+  xtsc_address reg_end_address8 = m_reg_base_address + (m_num_channels - 1) * m_channel_spacing + 256 + 256 - 1;
   if ((m_reg_base_address < m_start_address8) || (reg_end_address8 > m_end_address8)) {
     ostringstream oss;
-    oss << kind() << " '" << name() << "': Minimum DMA register space (0x" << hex << setfill('0') << setw(8) << m_reg_base_address 
+    oss << kind() << " '" << name() << "': Minimum DMA register space (0x" << hex << setfill('0') << setw(8) << m_reg_base_address
         << "-0x" << setw(8) << reg_end_address8 << ") is not completely contained with the xtsc_memory address range (0x"
         << setw(8) << m_start_address8 << "-0x" << m_end_address8 << ")";
     throw xtsc_exception(oss.str());
@@ -116,13 +167,22 @@ xtsc_component::xtsc_dma_engine::xtsc_dma_engine(sc_module_name module_name, con
   m_has_posedge_offset = (m_posedge_offset != SC_ZERO_TIME);
   m_posedge_offset_plus_one = m_posedge_offset + m_clock_period;
 
-  for (u32 i=0; i<16; ++i) {
-    m_p_block_read_response[i] = 0;
+  for (u32 i=0; i<m_num_channels; ++i) {
+    channel *p_channel = new channel(i, m_reg_base_address + i * m_channel_spacing);
+    m_channels.push_back(p_channel);
+    ostringstream oss;
+    oss << "dma_thread";
+    if (m_num_channels > 1) { oss << "_" << i; }
+    xtsc_event_register(p_channel->m_dma_thread_event,                     oss.str() + "_event",                                  this);
+    xtsc_event_register(p_channel->m_read_slot_event,                      oss.str() + "_read_slot_event",                        this);
+    xtsc_event_register(p_channel->m_no_reads_or_writes_event,             oss.str() + "_no_reads_or_writes_event",               this);
+    xtsc_event_register(p_channel->m_single_response_available_event,      oss.str() + "_single_response_available_event",        this);
+    xtsc_event_register(p_channel->m_block_read_response_available_event,  oss.str() + "_block_read_response_available_event",    this);
+    xtsc_event_register(p_channel->m_block_write_response_available_event, oss.str() + "_block_write_response_available_event",   this);
+    // Bind the channel number so it does not depend on the order in which the threads first run
+    m_process_handles.push_back(sc_spawn(sc_bind(&xtsc_dma_engine::dma_thread, this, i), oss.str().c_str()));
   }
 
-  SC_THREAD(dma_thread);
-  m_process_handles.push_back(sc_get_current_process_handle());
-
   if (m_overlap_read_write) {
     SC_THREAD(request_thread);
     m_process_handles.push_back(sc_get_current_process_handle());
@@ -133,27 +193,26 @@ xtsc_component::xtsc_dma_engine::xtsc_dma_engine(sc_module_name module_name, con
 
   m_respond_export(m_respond_impl);
 
-  xtsc_register_command(*this, *this, "dump_descriptor", 1, 1,
-      "dump_descriptor <Index>", 
-      "Call xtsc_dma_engine::dump_descriptor(<Index>)."
+  xtsc_register_command(*this, *this, "dump_descriptor", 1, 2,
+      "dump_descriptor <Index> [<Channel>]",
+      "Call xtsc_dma_engine::dump_descriptor(<Index>, <Channel>)."
   );
 
-  xtsc_register_command(*this, *this, "dump_descriptors", 0, 2,
-      "dump_descriptors [<Start> [<Count>]]", 
-      "Call xtsc_dma_engine::dump_descriptors(<Start>, <Count>)."
+  xtsc_register_command(*this, *this, "dump_descriptors", 0, 3,
+      "dump_descriptors [<Start> [<Count> [<Channel>]]]",
+      "Call xtsc_dma_engine::dump_descriptors(<Start>, <Count>, <Channel>)."
   );
 
-  xtsc_event_register(m_dma_thread_event,                     "m_dma_thread_event",                     this);
   xtsc_event_register(m_request_thread_event,                 "m_request_thread_event",                 this);
   xtsc_event_register(m_write_thread_event,                   "m_write_thread_event",                   this);
-  xtsc_event_register(m_got_read_response_event,              "m_got_read_response_event",              this);
-  xtsc_event_register(m_no_reads_or_writes_event,             "m_no_reads_or_writes_event",             this);
-  xtsc_event_register(m_single_response_available_event,      "m_single_response_available_event",      this);
-  xtsc_event_register(m_block_read_response_available_event,  "m_block_read_response_available_event",  this);
-  xtsc_event_register(m_block_write_response_available_event, "m_block_write_response_available_event", this);
 
   log4xtensa::LogLevel ll = xtsc_get_constructor_log_level();
   XTSC_LOG(m_text, ll, hex << " reg_base_address    = 0x" << setfill('0') << setw(8) << m_reg_base_address);
+  XTSC_LOG(m_text, ll,        " num_channels        = "   << m_num_channels);
+  if (m_num_channels > 1) {
+  XTSC_LOG(m_text, ll, hex << " channel_spacing     = 0x" << m_channel_spacing);
+  XTSC_LOG(m_text, ll,        " channel_arbitration = "   << arbitration);
+  }
   XTSC_LOG(m_text, ll,        " read_priority       = "   << (u32) m_read_priority);
   XTSC_LOG(m_text, ll,        " write_priority      = "   << (u32) m_write_priority);
   XTSC_LOG(m_text, ll,        " overlap_descriptors = "   << boolalpha << m_overlap_descriptors);
@@ -164,6 +223,8 @@ xtsc_component::xtsc_dma_engine::xtsc_dma_engine(sc_module_name module_name, con
   XTSC_LOG(m_text, ll,        " allow_size_zero     = "   << boolalpha << m_allow_size_zero);
   XTSC_LOG(m_text, ll,        " start_at_index_1    = "   << boolalpha << m_start_at_index_1);
   XTSC_LOG(m_text, ll,        " turbo               = "   << boolalpha << m_turbo);
+  XTSC_LOG(m_text, ll,        " turbo_fast_access   = "   << boolalpha << m_turbo_fast_access);
+  XTSC_LOG(m_text, ll,        " turbo_bytes_per_cycle = " << m_turbo_bytes_per_cycle);
   XTSC_LOG(m_text, ll,        " descriptor_delay    = "   << m_descriptor_delay);
   if (posedge_offset == 0xFFFFFFFF) {
   XTSC_LOG(m_text, ll,        " posedge_offset      = 0xFFFFFFFF => " << m_posedge_offset.value() << " (" << m_posedge_offset << ")");
@@ -176,10 +237,13 @@ xtsc_component::xtsc_dma_engine::xtsc_dma_engine(sc_module_name module_name, con
   XTSC_LOG(m_text, ll,        " nacc_wait_time      = "   << nacc_wait_time << " (" << m_nacc_wait_time << ")");
   }
 
-  m_deny_fast_access.push_back(m_reg_base_address);
-  m_deny_fast_access.push_back(m_reg_base_address+3);
-  XTSC_INFO(m_text, "No fast access to xtsc_dma_request num_descriptors register: 0x" << hex << m_reg_base_address <<
-                    "-0x" << m_reg_base_address+3);
+  for (u32 i=0; i<m_num_channels; ++i) {
+    xtsc_address go_address8 = m_channels[i]->m_reg_base_address;
+    m_deny_fast_access.push_back(go_address8);
+    m_deny_fast_access.push_back(go_address8+3);
+    XTSC_INFO(m_text, "No fast access to xtsc_dma_request num_descriptors register: 0x" << hex << go_address8 <<
+                      "-0x" << go_address8+3);
+  }
 
   reset();
 }
@@ -188,6 +252,10 @@ xtsc_component::xtsc_dma_engine::xtsc_dma_engine(sc_module_name module_name, con
 
 xtsc_component::xtsc_dma_engine::~xtsc_dma_engine(void) {
   XTSC_DEBUG(m_text, "In ~xtsc_dma_engine()");
+  for (u32 i=0; i<m_channels.size(); ++i) {
+    delete m_channels[i];
+  }
+  m_channels.clear();
 }
 
 
@@ -219,28 +287,45 @@ xtsc_port_table xtsc_component::xtsc_dma_engine::get_port_table(const string& po
 
 
 
+xtsc_component::xtsc_dma_engine::channel& xtsc_component::xtsc_dma_engine::get_channel(u32 channel_num) const {
+  if (channel_num >= m_num_channels) {
+    ostringstream oss;
+    oss << kind() << " \"" << name() << "\": channel " << channel_num << " is outside the legal range of [0-"
+        << (m_num_channels-1) << "]";
+    throw xtsc_exception(oss.str());
+  }
+  return *m_channels[channel_num];
+}
+
+
+
 void xtsc_component::xtsc_dma_engine::check_for_go_byte(xtsc_address address8, u32 size8, const u8 *buffer) {
-  u32 offset = m_reg_base_address - address8;
-  if (offset < size8) {
-    if (m_busy) {
-      ostringstream oss;
-      oss << kind() << " \"" << name() << "\": num_descriptors register written while xtsc_dma_engine is already busy.";
-      throw xtsc_exception(oss.str());
-    }
-    if (((size8 > 0) && (*(buffer+offset+0) != 0)) ||
-        ((size8 > 1) && (*(buffer+offset+1) != 0)) ||
-        ((size8 > 2) && (*(buffer+offset+2) != 0)) ||
-        ((size8 > 3) && (*(buffer+offset+3) != 0)))
-    {
-      XTSC_DEBUG(m_text, "num_descriptors register written.  Notifying dma_thread.");
-      m_dma_thread_event.notify(SC_ZERO_TIME);
+  for (u32 i=0; i<m_num_channels; ++i) {
+    channel& ch = *m_channels[i];
+    u32 offset = ch.m_reg_base_address - address8;
+    if (offset < size8) {
+      if (ch.m_busy) {
+        ostringstream oss;
+        oss << kind() << " \"" << name() << "\": num_descriptors register";
+        if (m_num_channels > 1) { oss << " of channel " << i; }
+        oss << " written while xtsc_dma_engine is already busy.";
+        throw xtsc_exception(oss.str());
+      }
+      if (((size8 > 0) && (*(buffer+offset+0) != 0)) ||
+          ((size8 > 1) && (*(buffer+offset+1) != 0)) ||
+          ((size8 > 2) && (*(buffer+offset+2) != 0)) ||
+          ((size8 > 3) && (*(buffer+offset+3) != 0)))
+      {
+        XTSC_DEBUG(m_text, "num_descriptors register of channel " << i << " written.  Notifying dma_thread.");
+        ch.m_dma_thread_event.notify(SC_ZERO_TIME);
+      }
     }
   }
 }
 
 
 
-void xtsc_component::xtsc_dma_engine::dump_descriptor(u32 idx, ostream& os) {
+void xtsc_component::xtsc_dma_engine::dump_descriptor(u32 idx, ostream& os, u32 channel_num) {
 
   if ((idx < 1) || (idx > 255)) {
     ostringstream oss;
@@ -248,6 +333,8 @@ void xtsc_component::xtsc_dma_engine::dump_descriptor(u32 idx, ostream& os) {
     throw xtsc_exception(oss.str());
   }
 
+  channel& ch = get_channel(channel_num);
+
   // Save state of stream
   char c = os.fill('0');
   ios::fmtflags old_flags = os.flags();
@@ -255,17 +342,17 @@ void xtsc_component::xtsc_dma_engine::dump_descriptor(u32 idx, ostream& os) {
 
   xtsc_dma_descriptor dsc;
 
-  dsc.source_address8             = read_u32(m_reg_base_address+(0x100*idx)+0x00, m_big_endian);
-  dsc.destination_address8        = read_u32(m_reg_base_address+(0x100*idx)+0x04, m_big_endian);
-  dsc.size8                       = read_u32(m_reg_base_address+(0x100*idx)+0x08, m_big_endian);
-  dsc.num_transfers               = read_u32(m_reg_base_address+(0x100*idx)+0x0C, m_big_endian);
+  dsc.source_address8             = read_u32(ch.m_reg_base_address+(0x100*idx)+0x00, ch.m_big_endian);
+  dsc.destination_address8        = read_u32(ch.m_reg_base_address+(0x100*idx)+0x04, ch.m_big_endian);
+  dsc.size8                       = read_u32(ch.m_reg_base_address+(0x100*idx)+0x08, ch.m_big_endian);
+  dsc.num_transfers               = read_u32(ch.m_reg_base_address+(0x100*idx)+0x0C, ch.m_big_endian);
 
   os << "Descriptor #" << left << dec << setfill(' ') << setw(3) << idx << " 0x" << setfill('0') << right << hex << setw(8)
-     << (m_reg_base_address+(0x100*idx)+0x00) << ":";
+     << (ch.m_reg_base_address+(0x100*idx)+0x00) << ":";
   if (dsc.size8 != 0) {
     os << " 0x" << setw(8) << dsc.source_address8
        << " 0x" << setw(8) << dsc.destination_address8
-       << " 0x" << setw(4) << dsc.size8 << dec << setfill(' ') 
+       << " 0x" << setw(4) << dsc.size8 << dec << setfill(' ')
        << " "   << setw(2) << dsc.num_transfers;
   }
   os << endl;
@@ -279,7 +366,7 @@ void xtsc_component::xtsc_dma_engine::dump_descriptor(u32 idx, ostream& os) {
 
 
 
-void xtsc_component::xtsc_dma_engine::dump_descriptors(u32 start_idx, u32 count, ostream& os) {
+void xtsc_component::xtsc_dma_engine::dump_descriptors(u32 start_idx, u32 count, ostream& os, u32 channel_num) {
   if (count > 255) {
     ostringstream oss;
     oss << kind() << " \"" << name() << "\": dump_descriptors called with count=" << count << " which exceeds the maximum of 255.";
@@ -288,13 +375,13 @@ void xtsc_component::xtsc_dma_engine::dump_descriptors(u32 start_idx, u32 count,
   u32 idx = start_idx;
   for (u32 i = 0; i<count; ++i, ++idx) {
     if (idx == 256) { idx = 1; }
-    dump_descriptor(idx, os);
+    dump_descriptor(idx, os, channel_num);
   }
 }
 
 
 
-void xtsc_component::xtsc_dma_engine::execute(const string&             cmd_line, 
+void xtsc_component::xtsc_dma_engine::execute(const string&             cmd_line,
                                               const vector<string>&     words,
                                               const vector<string>&     words_lc,
                                               ostream&                  result)
@@ -304,13 +391,15 @@ void xtsc_component::xtsc_dma_engine::execute(const string&             cmd_line
   if (false) {
   }
   else if (words[0] == "dump_descriptor") {
-    u32 idx = xtsc_command_argtou32(cmd_line, words, 1);
-    dump_descriptor(idx, res);
+    u32 idx         = xtsc_command_argtou32(cmd_line, words, 1);
+    u32 channel_num = ((words.size() > 2) ? xtsc_command_argtou32(cmd_line, words, 2) :   0);
+    dump_descriptor(idx, res, channel_num);
   }
   else if (words[0] == "dump_descriptors") {
-    u32 start_idx = ((words.size() > 1) ? xtsc_command_argtou32(cmd_line, words, 1) :   1);
-    u32 end_idx   = ((words.size() > 2) ? xtsc_command_argtou32(cmd_line, words, 2) : 255);
-    dump_descriptors(start_idx, end_idx, res);
+    u32 start_idx   = ((words.size() > 1) ? xtsc_command_argtou32(cmd_line, words, 1) :   1);
+    u32 end_idx     = ((words.size() > 2) ? xtsc_command_argtou32(cmd_line, words, 2) : 255);
+    u32 channel_num = ((words.size() > 3) ? xtsc_command_argtou32(cmd_line, words, 3) :   0);
+    dump_descriptors(start_idx, end_idx, res, channel_num);
   }
   else {
     return xtsc_memory::execute(cmd_line, words, words_lc, result);
@@ -321,6 +410,31 @@ void xtsc_component::xtsc_dma_engine::execute(const string&             cmd_line
 
 
 
+void xtsc_component::xtsc_dma_engine::summary(ostream& os) {
+  xtsc_memory::summary(os);
+  ios::fmtflags flags = os.flags();
+  os << std::left << std::setw(18) << "Peak pool usage" << " : " << m_request_allocator.get_num_peak() << " xtsc_request" << endl;
+  os.flags(flags);
+  os << endl;
+  os << "Channel    Requests  Descriptors           Bytes   Busy time (ns)      MB/s busy" << endl;
+  for (u32 i=0; i<m_num_channels; ++i) {
+    channel& ch = *m_channels[i];
+    double busy_seconds = ch.m_busy_time.to_seconds();
+    os << setw(7) << i << " " << setw(11) << ch.m_num_dma_requests << " " << setw(12) << ch.m_num_descriptors << " "
+       << setw(15) << ch.m_num_bytes << " " << setw(16) << (u64) (busy_seconds * 1e9) << " ";
+    if (busy_seconds > 0) {
+      os << setw(14) << fixed << setprecision(2) << (ch.m_num_bytes / busy_seconds * 1e-6);
+      os.unsetf(ios::floatfield);
+    }
+    else {
+      os << setw(14) << "-";
+    }
+    os << endl;
+  }
+}
+
+
+
 void xtsc_component::xtsc_dma_engine::do_write(u32 port_num) {
   xtsc_memory::do_write(port_num);
   xtsc_request       *p_request     = &m_p_active_request_info[port_num]->m_request;
@@ -365,23 +479,13 @@ void xtsc_component::xtsc_dma_engine::sync_to_posedge(bool always_wait) {
 
 
 void xtsc_component::xtsc_dma_engine::reset(bool hard_reset) {
-  m_num_block_transfers       = 0;
-  m_block_read_response_count = 0;
-  m_num_reads                 = 0;
-  m_num_writes                = 0;
-
-  m_waiting_for_nacc          = false;
-  m_request_got_nacc          = false;
+  m_num_reads                   = 0;
+  m_num_writes                  = 0;
+  m_next_read_channel           = 0;
+  m_next_write_channel          = 0;
 
-  if (m_p_block_write_response) {
-    delete m_p_block_write_response;
-    m_p_block_write_response = 0;
-  }
-
-  if (m_p_single_response) {
-    delete m_p_single_response;
-    m_p_single_response = 0;
-  }
+  m_waiting_for_nacc            = false;
+  m_request_got_nacc            = false;
 
   while (!m_request_deque.empty()) {
     xtsc_request *p_request = m_request_deque.front();
@@ -389,42 +493,60 @@ void xtsc_component::xtsc_dma_engine::reset(bool hard_reset) {
     delete_request(p_request);
   }
 
-  while (!m_blank_write_deque.empty()) {
-    xtsc_request *p_request = m_blank_write_deque.front();
-    m_blank_write_deque.pop_front();
-    delete_request(p_request);
-  }
+  for (u32 i=0; i<m_channels.size(); ++i) {
+    channel& ch = *m_channels[i];
 
-  while (!m_ready_write_deque.empty()) {
-    xtsc_request *p_request = m_ready_write_deque.front();
-    m_ready_write_deque.pop_front();
-    delete_request(p_request);
-  }
+    ch.m_num_block_transfers       = 0;
+    ch.m_block_read_response_count = 0;
+    ch.m_num_reads                 = 0;
+    ch.m_num_writes                = 0;
+    ch.m_waiting_for_read_slot     = false;
 
-  while (!m_last_write_deque.empty()) {
-    m_last_write_deque.pop_front();
-  }
+    if (ch.m_p_block_write_response) {
+      m_response_allocator.destroy(ch.m_p_block_write_response);
+      ch.m_p_block_write_response = 0;
+    }
+
+    if (ch.m_p_single_response) {
+      m_response_allocator.destroy(ch.m_p_single_response);
+      ch.m_p_single_response = 0;
+    }
+
+    while (!ch.m_blank_write_deque.empty()) {
+      xtsc_request *p_request = ch.m_blank_write_deque.front();
+      ch.m_blank_write_deque.pop_front();
+      delete_request(p_request);
+    }
+
+    while (!ch.m_ready_write_deque.empty()) {
+      xtsc_request *p_request = ch.m_ready_write_deque.front();
+      ch.m_ready_write_deque.pop_front();
+      delete_request(p_request);
+    }
+
+    ch.m_last_write_deque.clear();
+    ch.m_done_descriptor_deque.clear();
 
-  while (!m_done_descriptor_deque.empty()) {
-    m_done_descriptor_deque.pop_front();
+    // Cancel any event notifications
+    ch.m_dma_thread_event                    .cancel();
+    ch.m_read_slot_event                     .cancel();
+    ch.m_no_reads_or_writes_event            .cancel();
+    ch.m_single_response_available_event     .cancel();
+    ch.m_block_read_response_available_event .cancel();
+    ch.m_block_write_response_available_event.cancel();
   }
 
-  // Cancel any event notifications
-  m_dma_thread_event                    .cancel();
   m_request_thread_event                .cancel();
   m_write_thread_event                  .cancel();
-  m_got_read_response_event             .cancel();
-  m_no_reads_or_writes_event            .cancel();
-  m_single_response_available_event     .cancel();
-  m_block_read_response_available_event .cancel();
-  m_block_write_response_available_event.cancel();
 
   xtsc_memory::reset(hard_reset);
 }
 
 
 
-void xtsc_component::xtsc_dma_engine::dma_thread() {
+void xtsc_component::xtsc_dma_engine::dma_thread(u32 channel_num) {
+
+  channel& ch = *m_channels[channel_num];
 
   try {
 
@@ -432,40 +554,44 @@ void xtsc_component::xtsc_dma_engine::dma_thread() {
 
     while (true) {
 
-      m_busy = false;
-      wait(m_dma_thread_event);
-      if (!read_u32(m_reg_base_address+0x00, false /* don't care */)) continue;
-      m_busy = true;
-      m_big_endian = false;
-      req.num_descriptors         = read_u32(m_reg_base_address+0x00, false);
+      ch.m_busy = false;
+      wait(ch.m_dma_thread_event);
+      if (!read_u32(ch.m_reg_base_address+0x00, false /* don't care */)) continue;
+      ch.m_busy = true;
+      ch.m_big_endian = false;
+      sc_time start_time = sc_time_stamp();
+      req.num_descriptors         = read_u32(ch.m_reg_base_address+0x00, false);
       if (req.num_descriptors > 255) {
-        req.num_descriptors       = read_u32(m_reg_base_address+0x00, true);
+        req.num_descriptors       = read_u32(ch.m_reg_base_address+0x00, true);
         if (req.num_descriptors > 255) {
           ostringstream oss;
           oss << kind() << " \"" << name() << "\": num_descriptors cannot exceed 255"
-              << " (DMA request address: 0x" << hex << setfill('0') << setw(8) << (m_reg_base_address+0x00) << ")";
+              << " (DMA request address: 0x" << hex << setfill('0') << setw(8) << (ch.m_reg_base_address+0x00) << ")";
           throw xtsc_exception(oss.str());
         }
-        m_big_endian = true;
+        ch.m_big_endian = true;
       }
-      req.notify_address8       = read_u32(m_reg_base_address+0x04, m_big_endian);
-      req.notify_value          = read_u32(m_reg_base_address+0x08, m_big_endian);
-      req.turboxim_event_id     = read_u32(m_reg_base_address+0x0C, m_big_endian);
-      req.done_descriptor       = read_u32(m_reg_base_address+0x10, m_big_endian);
+      req.notify_address8       = read_u32(ch.m_reg_base_address+0x04, ch.m_big_endian);
+      req.notify_value          = read_u32(ch.m_reg_base_address+0x08, ch.m_big_endian);
+      req.turboxim_event_id     = read_u32(ch.m_reg_base_address+0x0C, ch.m_big_endian);
+      req.done_descriptor       = read_u32(ch.m_reg_base_address+0x10, ch.m_big_endian);
 
 
       if (req.notify_address8 & (m_width8-1)) {
         ostringstream oss;
         oss << kind() << " \"" << name() << "\": notify_address8=0x" << hex << req.notify_address8
             << " is not aligned to PIF width=" << dec << m_width8
-            << " (DMA request address: 0x" << hex << setfill('0') << setw(8) << (m_reg_base_address+0x04) << ")";
+            << " (DMA request address: 0x" << hex << setfill('0') << setw(8) << (ch.m_reg_base_address+0x04) << ")";
         throw xtsc_exception(oss.str());
       }
 
       {
         ostringstream oss;
-        oss << "DMA request:"
-            << " num_descriptors="   << req.num_descriptors << hex
+        oss << "DMA request:";
+        if (m_num_channels > 1) {
+          oss << " channel=" << ch.m_index;
+        }
+        oss << " num_descriptors="   << req.num_descriptors << hex
             << " notify_address8=0x" << req.notify_address8
             << " notify_value=0x"    << req.notify_value;
         if (!m_start_at_index_1) {
@@ -474,14 +600,20 @@ void xtsc_component::xtsc_dma_engine::dma_thread() {
         XTSC_INFO(m_text, oss.str());
       }
 
-      xtsc_address reg_end_address8 = m_reg_base_address + 256 + (256 * req.num_descriptors) - 1;
-      if ((m_reg_base_address < m_start_address8) || (reg_end_address8 > m_end_address8)) {
+      xtsc_address reg_end_address8 = ch.m_reg_base_address + 256 + (256 * req.num_descriptors) - 1;
+      if ((ch.m_reg_base_address < m_start_address8) || (reg_end_address8 > m_end_address8)) {
         ostringstream oss;
-        oss << kind() << " '" << name() << "': Required DMA register space (0x" << hex << setfill('0') << setw(8) << m_reg_base_address 
+        oss << kind() << " '" << name() << "': Required DMA register space (0x" << hex << setfill('0') << setw(8) << ch.m_reg_base_address
             << "-0x" << setw(8) << reg_end_address8 << ") is not completely contained with the xtsc_memory address range (0x"
             << setw(8) << m_start_address8 << "-0x" << m_end_address8 << ")";
         throw xtsc_exception(oss.str());
       }
+      if ((m_num_channels > 1) && (256 + (256 * req.num_descriptors) > m_channel_spacing)) {
+        ostringstream oss;
+        oss << kind() << " '" << name() << "': Required DMA register space of channel " << ch.m_index << " (0x" << hex
+            << (256 + (256 * req.num_descriptors)) << " bytes) exceeds \"channel_spacing\" (0x" << m_channel_spacing << ")";
+        throw xtsc_exception(oss.str());
+      }
 
       u32 first_descriptor = 1;
       if (!m_start_at_index_1) {
@@ -489,7 +621,7 @@ void xtsc_component::xtsc_dma_engine::dma_thread() {
         if (first_descriptor > 255) {
           ostringstream oss;
           oss << kind() << " '" << name() << "': The done_descriptor value (" << first_descriptor << ") at address 0x" << hex << setfill('0')
-              << setw(8) << (m_reg_base_address+0x10) << " is outside the legal range of [0,255]";
+              << setw(8) << (ch.m_reg_base_address+0x10) << " is outside the legal range of [0,255]";
           throw xtsc_exception(oss.str());
         }
         first_descriptor += 1;
@@ -504,15 +636,16 @@ void xtsc_component::xtsc_dma_engine::dma_thread() {
         if (idx > 255) { idx = idx - 255; }
 
         ostringstream des;
+        if (m_num_channels > 1) { des << "Ch" << ch.m_index; }
         des << "#" << (i+1) << "/" << req.num_descriptors;
         if (!m_start_at_index_1) { des << "@" << idx; }
 
         xtsc_dma_descriptor dsc;
 
-        dsc.source_address8             = read_u32(m_reg_base_address+(0x100*idx)+0x00, m_big_endian);
-        dsc.destination_address8        = read_u32(m_reg_base_address+(0x100*idx)+0x04, m_big_endian);
-        dsc.size8                       = read_u32(m_reg_base_address+(0x100*idx)+0x08, m_big_endian);
-        dsc.num_transfers               = read_u32(m_reg_base_address+(0x100*idx)+0x0C, m_big_endian);
+        dsc.source_address8             = read_u32(ch.m_reg_base_address+(0x100*idx)+0x00, ch.m_big_endian);
+        dsc.destination_address8        = read_u32(ch.m_reg_base_address+(0x100*idx)+0x04, ch.m_big_endian);
+        dsc.size8                       = read_u32(ch.m_reg_base_address+(0x100*idx)+0x08, ch.m_big_endian);
+        dsc.num_transfers               = read_u32(ch.m_reg_base_address+(0x100*idx)+0x0C, ch.m_big_endian);
 
         // Sanity checks
         if ((dsc.num_transfers != 1) &&
@@ -523,28 +656,28 @@ void xtsc_component::xtsc_dma_engine::dma_thread() {
         {
           ostringstream oss;
           oss << kind() << " \"" << name() << "\": num_transfers=" << dsc.num_transfers << " is invalid (must be 1|2|4|8|16)"
-              << " (descriptor address: 0x" << hex << setfill('0') << setw(8) << (m_reg_base_address+(0x100*idx+0x0C)) << ")";
+              << " (descriptor address: 0x" << hex << setfill('0') << setw(8) << (ch.m_reg_base_address+(0x100*idx+0x0C)) << ")";
           throw xtsc_exception(oss.str());
         }
         if (dsc.size8 & (m_width8*dsc.num_transfers-1)) {
           ostringstream oss;
           oss << kind() << " \"" << name() << "\": size8=0x" << hex << dsc.size8
               << " is not aligned to the block transfer size=0x" << (m_width8*dsc.num_transfers)
-              << " (descriptor address: 0x" << hex << setfill('0') << setw(8) << (m_reg_base_address+(0x100*idx+0x08)) << ")";
+              << " (descriptor address: 0x" << hex << setfill('0') << setw(8) << (ch.m_reg_base_address+(0x100*idx+0x08)) << ")";
           throw xtsc_exception(oss.str());
         }
         if (dsc.source_address8 & (m_width8*dsc.num_transfers-1)) {
           ostringstream oss;
           oss << kind() << " \"" << name() << "\": source_address8=0x" << hex << dsc.source_address8
               << " is not aligned to the block transfer size=0x" << (m_width8*dsc.num_transfers)
-              << " (descriptor address: 0x" << hex << setfill('0') << setw(8) << (m_reg_base_address+(0x100*idx+0x08)) << ")";
+              << " (descriptor address: 0x" << hex << setfill('0') << setw(8) << (ch.m_reg_base_address+(0x100*idx+0x08)) << ")";
           throw xtsc_exception(oss.str());
         }
         if (dsc.destination_address8 & (m_width8*dsc.num_transfers-1)) {
           ostringstream oss;
           oss << kind() << " \"" << name() << "\": destination_address8=0x" << hex << dsc.destination_address8
               << " is not aligned to the block transfer size=0x" << (m_width8*dsc.num_transfers)
-              << " (descriptor address: 0x" << hex << setfill('0') << setw(8) << (m_reg_base_address+(0x100*idx+0x08)) << ")";
+              << " (descriptor address: 0x" << hex << setfill('0') << setw(8) << (ch.m_reg_base_address+(0x100*idx+0x08)) << ")";
           throw xtsc_exception(oss.str());
         }
         if (!dsc.size8 && !m_allow_size_zero) {
@@ -564,19 +697,22 @@ void xtsc_component::xtsc_dma_engine::dma_thread() {
             << " num_transfers=0x"              << dsc.num_transfers
         );
 
+        ch.m_num_descriptors += 1;
+        ch.m_num_bytes       += dsc.size8;
+
         if (m_turbo) {
-          use_turbo(dsc);
+          use_turbo(ch, dsc);
         }
         else if (m_overlap_read_write) {
-          do_overlapped_requests(dsc, idx);
+          do_overlapped_requests(ch, dsc, idx);
           if (((i+1)==req.num_descriptors) || !m_overlap_descriptors) {
             bool first = true;
-            while (m_num_reads || m_num_writes || m_request_deque.size() || m_ready_write_deque.size() || m_blank_write_deque.size()) {
+            while (ch.m_num_reads || ch.m_num_writes || ch.m_ready_write_deque.size() || ch.m_blank_write_deque.size()) {
               if (first) {
                 XTSC_INFO(m_text, "Waiting for Descriptor " << des.str() << " to complete");
                 first = false;
               }
-              wait(m_no_reads_or_writes_event);
+              wait(ch.m_no_reads_or_writes_event);
             }
             if (!first) {
               XTSC_INFO(m_text, "Descriptor " << des.str() << " completed.");
@@ -584,16 +720,16 @@ void xtsc_component::xtsc_dma_engine::dma_thread() {
           }
         }
         else if (dsc.num_transfers == 1) {
-          use_single_transfers(dsc);
-          write_u32(m_reg_base_address+0x10, idx, m_big_endian);
+          use_single_transfers(ch, dsc);
+          write_u32(ch.m_reg_base_address+0x10, idx, ch.m_big_endian);
         }
         else {
-          use_block_transfers(dsc);
-          write_u32(m_reg_base_address+0x10, idx, m_big_endian);
+          use_block_transfers(ch, dsc);
+          write_u32(ch.m_reg_base_address+0x10, idx, ch.m_big_endian);
         }
       }
 
-      xtsc_response::status_t status = remote_write_u32(req.notify_address8, req.notify_value);
+      xtsc_response::status_t status = remote_write_u32(ch, req.notify_address8, req.notify_value);
       if (status != xtsc_response::RSP_OK) {
         ostringstream oss;
         oss << kind() << " \"" << name() << "\": unable to write notify address=0x" << hex << req.notify_address8
@@ -601,15 +737,22 @@ void xtsc_component::xtsc_dma_engine::dma_thread() {
         throw xtsc_exception(oss.str());
       }
       if (m_clear_notify_value) {
-        remote_write_u32(req.notify_address8, 0);
+        remote_write_u32(ch, req.notify_address8, 0);
       }
 
       if (req.turboxim_event_id) {
         xtsc_fire_turboxim_event_id(req.turboxim_event_id);
       }
 
-      m_busy = false;
-      XTSC_INFO(m_text, "DMA done");
+      ch.m_num_dma_requests += 1;
+      ch.m_busy_time        += sc_time_stamp() - start_time;
+      ch.m_busy = false;
+      if (m_num_channels > 1) {
+        XTSC_INFO(m_text, "DMA done (channel " << ch.m_index << ")");
+      }
+      else {
+        XTSC_INFO(m_text, "DMA done");
+      }
 
     }
 
@@ -667,16 +810,31 @@ void xtsc_component::xtsc_dma_engine::write_thread() {
       XTSC_DEBUG(m_text, "Waiting for m_write_thread_event");
       wait(m_write_thread_event);
       XTSC_DEBUG(m_text, "Got m_write_thread_event");
-      while (!m_last_write_deque.empty() && (m_num_writes < m_max_writes)) {
-        xtsc_request *p_request = m_ready_write_deque.front();
-        m_ready_write_deque.pop_front();
-        m_request_deque.push_back(p_request);
-        m_request_thread_event.notify(SC_ZERO_TIME);
-        if (p_request->get_last_transfer()) {
-          m_last_write_deque.pop_front();
-          m_num_writes += 1;
-          XTSC_DEBUG(m_text, "Inc m_num_writes to " << m_num_writes);
+      while (m_num_writes < m_max_writes) {
+        // Award the write slot to a channel with a complete write ready to go
+        channel *p_channel = NULL;
+        for (u32 i=0; i<m_num_channels; ++i) {
+          u32 c = (m_round_robin ? ((m_next_write_channel + i) % m_num_channels) : i);
+          if (!m_channels[c]->m_last_write_deque.empty()) {
+            p_channel = m_channels[c];
+            break;
+          }
+        }
+        if (!p_channel) break;
+        channel& ch = *p_channel;
+        m_next_write_channel = (ch.m_index + 1) % m_num_channels;
+        bool last = false;
+        while (!last) {
+          xtsc_request *p_request = ch.m_ready_write_deque.front();
+          ch.m_ready_write_deque.pop_front();
+          m_request_deque.push_back(p_request);
+          last = p_request->get_last_transfer();
         }
+        m_request_thread_event.notify(SC_ZERO_TIME);
+        ch.m_last_write_deque.pop_front();
+        ch.m_num_writes += 1;
+        m_num_writes += 1;
+        XTSC_DEBUG(m_text, "Inc m_num_writes to " << m_num_writes << " (channel " << ch.m_index << ")");
       }
     }
   }
@@ -692,32 +850,124 @@ void xtsc_component::xtsc_dma_engine::write_thread() {
 
 
 
-// Use nb_peek/nb_poke
-void xtsc_component::xtsc_dma_engine::use_turbo(xtsc_dma_descriptor &dsc) {
-  u32 chunk_size = dsc.num_transfers * m_width8;
+void xtsc_component::xtsc_dma_engine::acquire_read_slot(channel& ch) {
+  bool others_waiting = false;
+  for (u32 i=0; i<m_num_channels; ++i) {
+    if (m_channels[i]->m_waiting_for_read_slot) {
+      others_waiting = true;
+      break;
+    }
+  }
+  if (!others_waiting && (m_num_reads < m_max_reads)) {
+    m_num_reads += 1;
+  }
+  else {
+    ch.m_waiting_for_read_slot = true;
+    while (ch.m_waiting_for_read_slot) {
+      XTSC_DEBUG(m_text, "Channel " << ch.m_index << " waiting for a read slot");
+      wait(ch.m_read_slot_event);
+    }
+    XTSC_DEBUG(m_text, "Channel " << ch.m_index << " got a read slot");
+  }
+  ch.m_num_reads += 1;
+  XTSC_DEBUG(m_text, "Inc m_num_reads to " << m_num_reads << " (channel " << ch.m_index << ")");
+}
+
+
+
+void xtsc_component::xtsc_dma_engine::grant_read_slots() {
+  while (m_num_reads < m_max_reads) {
+    channel *p_channel = NULL;
+    for (u32 i=0; i<m_num_channels; ++i) {
+      u32 c = (m_round_robin ? ((m_next_read_channel + i) % m_num_channels) : i);
+      if (m_channels[c]->m_waiting_for_read_slot) {
+        p_channel = m_channels[c];
+        break;
+      }
+    }
+    if (!p_channel) break;
+    m_next_read_channel = (p_channel->m_index + 1) % m_num_channels;
+    p_channel->m_waiting_for_read_slot = false;
+    p_channel->m_read_slot_event.notify(SC_ZERO_TIME);
+    m_num_reads += 1;
+  }
+}
+
+
+
+// Use nb_peek/nb_poke or, if m_turbo_fast_access, memcpy between raw access blocks
+void xtsc_component::xtsc_dma_engine::use_turbo(channel& ch, xtsc_dma_descriptor &dsc) {
+  u32 chunk_size        = dsc.num_transfers * m_width8;
+  u64 total_size8       = dsc.size8;
+  u64 memcpy_size8      = 0;
   while (dsc.size8) {
-    m_request_port->nb_peek(dsc.source_address8, chunk_size, m_data);
-    m_request_port->nb_poke(dsc.destination_address8, chunk_size, m_data);
-    dsc.source_address8 += chunk_size;
-    dsc.destination_address8 += chunk_size;
-    dsc.size8 -= chunk_size;
+    if (m_turbo_fast_access) {
+      xtsc_address src_end8 = 0;
+      xtsc_address dst_end8 = 0;
+      const u8 *src = get_raw_pointer(ch, dsc.source_address8, false, src_end8);
+      u8       *dst = src ? get_raw_pointer(ch, dsc.destination_address8, true, dst_end8) : NULL;
+      if (src && dst) {
+        // One memcpy for as much as both raw access blocks allow
+        u64 size8 = dsc.size8;
+        size8 = min(size8, (u64) (src_end8 - dsc.source_address8      + 1));
+        size8 = min(size8, (u64) (dst_end8 - dsc.destination_address8 + 1));
+        memmove(dst, src, (size_t) size8);
+        XTSC_DEBUG(m_text, "use_turbo memcpy 0x" << hex << dsc.source_address8 << " => 0x" << dsc.destination_address8 <<
+                           " size8=0x" << size8);
+        dsc.source_address8      += (u32) size8;
+        dsc.destination_address8 += (u32) size8;
+        dsc.size8                -= (u32) size8;
+        memcpy_size8             += size8;
+        continue;
+      }
+    }
+    // A raw block memcpy above need not end on a chunk boundary, so the last chunk may be short
+    u32 step8 = (u32) min((u64) chunk_size, (u64) dsc.size8);
+    m_request_port->nb_peek(dsc.source_address8, step8, ch.m_data);
+    m_request_port->nb_poke(dsc.destination_address8, step8, ch.m_data);
+    dsc.source_address8 += step8;
+    dsc.destination_address8 += step8;
+    dsc.size8 -= step8;
+  }
+  if (m_turbo_fast_access) {
+    XTSC_INFO(m_text, "use_turbo moved 0x" << hex << memcpy_size8 << " of 0x" << total_size8 << " bytes by memcpy");
+  }
+  if (m_turbo_bytes_per_cycle && total_size8) {
+    u64 cycles = (total_size8 + m_turbo_bytes_per_cycle - 1) / m_turbo_bytes_per_cycle;
+    wait(m_clock_period * (double) cycles);
+  }
+}
+
+
+
+u8 *xtsc_component::xtsc_dma_engine::get_raw_pointer(channel& ch, xtsc_address address8, bool write, xtsc_address& block_end8) {
+  xtsc_fast_access_request request(*this, address8, m_width8, ch.m_big_endian);
+  if (!m_request_port->nb_fast_access(request)) {
+    return NULL;
+  }
+  if ((request.get_access_type() != xtsc_fast_access_request::ACCESS_RAW) || request.get_swizzle()) {
+    return NULL;
+  }
+  if (write ? !request.is_writable() : !request.is_readable()) {
+    return NULL;
+  }
+  xtsc_fast_access_block block = request.get_result_block();
+  if ((address8 < block.get_block_beg_address()) || (address8 > block.get_block_end_address())) {
+    return NULL;
   }
+  block_end8 = block.get_block_end_address();
+  u8 *raw_data = (u8*) request.get_raw_data();
+  return raw_data + (address8 - (block.get_block_beg_address() & ~(xtsc_address) 3));
 }
 
 
 
-void xtsc_component::xtsc_dma_engine::do_overlapped_requests(xtsc_dma_descriptor &dsc, u32 idx) {
+void xtsc_component::xtsc_dma_engine::do_overlapped_requests(channel& ch, xtsc_dma_descriptor &dsc, u32 idx) {
   xtsc_request::type_t type = xtsc_request::READ;
   xtsc_request *p_request = NULL;
   u32 bytes = m_width8 * dsc.num_transfers;
   while (dsc.size8) {
-    while (m_num_reads >= m_max_reads) {
-      XTSC_DEBUG(m_text, "Waiting for m_got_read_response_event");
-      wait(m_got_read_response_event);
-      XTSC_DEBUG(m_text, "Got m_got_read_response_event");
-    }
-    m_num_reads += 1;
-    XTSC_DEBUG(m_text, "Inc m_num_reads to " << m_num_reads);
+    acquire_read_slot(ch);
     wait(m_clock_period);
     // Form the read request and put it in m_request_deque for request_thread to send downstream
     type = (dsc.num_transfers == 1) ? xtsc_request::READ : xtsc_request::BLOCK_READ;
@@ -730,12 +980,12 @@ void xtsc_component::xtsc_dma_engine::do_overlapped_requests(xtsc_dma_descriptor
                           0xFFFF,                       // byte_enables (ignored)
                           true,                         // last_transfer
                           0,                            // route_id
-                          m_overlapped_read_id,         // id
+                          ch.get_id(m_overlapped_read_id), // id
                           m_read_priority               // priority
                           );
     m_request_deque.push_back(p_request);
     bool last_req = (dsc.size8 == bytes);
-    m_done_descriptor_deque.push_back(last_req ? idx : 0);
+    ch.m_done_descriptor_deque.push_back(last_req ? idx : 0);
     m_request_thread_event.notify(SC_ZERO_TIME);
     u64 tag = (m_reuse_tag ? p_request->get_tag() : 0);
     // Now pre-form write requests without data and put them in m_blank_write_deque to await read responses
@@ -749,10 +999,10 @@ void xtsc_component::xtsc_dma_engine::do_overlapped_requests(xtsc_dma_descriptor
                               m_width8,                 // size
                               tag,                      // tag  (0 => XTSC assigns tag)
                               dsc.num_transfers,        // num_transfers
-                              0xFFFFFFFFull,            // byte_enables 
+                              0xFFFFFFFFull,            // byte_enables
                               last,                     // last_transfer
                               0,                        // route_id
-                              m_overlapped_write_id,    // id
+                              ch.get_id(m_overlapped_write_id), // id
                               m_write_priority          // priority
                               );
         tag = p_request->get_tag();
@@ -764,11 +1014,11 @@ void xtsc_component::xtsc_dma_engine::do_overlapped_requests(xtsc_dma_descriptor
                               dsc.num_transfers,        // num_transfers
                               last,                     // last_transfer
                               0,                        // route_id
-                              m_overlapped_write_id,    // id
+                              ch.get_id(m_overlapped_write_id), // id
                               m_write_priority          // priority
                               );
       }
-      m_blank_write_deque.push_back(p_request);
+      ch.m_blank_write_deque.push_back(p_request);
       dsc.destination_address8 += m_width8;
     }
     dsc.source_address8 += bytes;
@@ -779,9 +1029,9 @@ void xtsc_component::xtsc_dma_engine::do_overlapped_requests(xtsc_dma_descriptor
 
 
 // Use non-overlapped, non-block READ/WRITE
-void xtsc_component::xtsc_dma_engine::use_single_transfers(xtsc_dma_descriptor &dsc) {
+void xtsc_component::xtsc_dma_engine::use_single_transfers(channel& ch, xtsc_dma_descriptor &dsc) {
   while (dsc.size8) {
-    xtsc_response::status_t status = remote_read(dsc.source_address8, m_width8, 0xFFFF, m_data);
+    xtsc_response::status_t status = remote_read(ch, dsc.source_address8, m_width8, 0xFFFF, ch.m_data);
     if (status != xtsc_response::RSP_OK) {
       ostringstream oss;
       oss << kind() << " \"" << name() << "\": unable to read source address=0x" << hex << dsc.source_address8
@@ -789,8 +1039,8 @@ void xtsc_component::xtsc_dma_engine::use_single_transfers(xtsc_dma_descriptor &
       throw xtsc_exception(oss.str());
     }
     wait(m_clock_period);
-    u64 tag = (m_reuse_tag ? m_request.get_tag() : 0);
-    status = remote_write(dsc.destination_address8, m_width8, 0xFFFF, m_data, tag);
+    u64 tag = (m_reuse_tag ? ch.m_request.get_tag() : 0);
+    status = remote_write(ch, dsc.destination_address8, m_width8, 0xFFFF, ch.m_data, tag);
     if (status != xtsc_response::RSP_OK) {
       ostringstream oss;
       oss << kind() << " \"" << name() << "\": unable to write destination address=0x" << hex << dsc.destination_address8
@@ -806,12 +1056,12 @@ void xtsc_component::xtsc_dma_engine::use_single_transfers(xtsc_dma_descriptor &
 
 
 // Use non-overlapped BLOCK_READ/BLOCK_WRITE
-void xtsc_component::xtsc_dma_engine::use_block_transfers(xtsc_dma_descriptor &dsc) {
-  m_num_block_transfers = dsc.num_transfers;
+void xtsc_component::xtsc_dma_engine::use_block_transfers(channel& ch, xtsc_dma_descriptor &dsc) {
+  ch.m_num_block_transfers = dsc.num_transfers;
   xtsc_response::status_t status;
   while (dsc.size8) {
     sync_to_posedge(true);
-    m_request.initialize(xtsc_request::BLOCK_READ,      // type
+    ch.m_request.initialize(xtsc_request::BLOCK_READ,   // type
                          dsc.source_address8,           // address
                          m_width8,                      // size
                          0,                             // tag  (0 => XTSC assigns tag)
@@ -819,37 +1069,37 @@ void xtsc_component::xtsc_dma_engine::use_block_transfers(xtsc_dma_descriptor &d
                          0xFFFF,                        // byte_enables (ignored)
                          true,                          // last_transfer
                          0,                             // route_id
-                         m_block_read_id,               // id
+                         ch.get_id(m_block_read_id),    // id
                          m_read_priority                // priority
                          );
 
     u32 tries = 0;
     do {
-      if (m_p_block_read_response[0]) {
-        delete m_p_block_read_response[0];
-        m_p_block_read_response[0] = 0;
+      if (ch.m_p_block_read_response[0]) {
+        m_response_allocator.destroy(ch.m_p_block_read_response[0]);
+        ch.m_p_block_read_response[0] = 0;
       }
       tries += 1;
-      XTSC_INFO(m_text, m_request << " Try #" << tries);
-      m_block_read_response_count = 0;
-      m_request_port->nb_request(m_request);
+      XTSC_INFO(m_text, ch.m_request << " Try #" << tries);
+      ch.m_block_read_response_count = 0;
+      m_request_port->nb_request(ch.m_request);
       wait(m_clock_period);
-    } while (m_p_block_read_response[0] && (m_p_block_read_response[0]->get_status() == xtsc_response::RSP_NACC));
-
-    m_block_write_sent_count = 0;
-    u64 tag = (m_reuse_tag ? m_request.get_tag() : 0);
-    while (m_block_write_sent_count < m_num_block_transfers) {
-      while (m_block_write_sent_count >= m_block_read_response_count) {
-        wait(m_block_read_response_available_event);
-        XTSC_DEBUG(m_text, "use_block_transfers 0x" << hex << dsc.source_address8 << ": tag=" << dec << m_request.get_tag() <<
+    } while (ch.m_p_block_read_response[0] && (ch.m_p_block_read_response[0]->get_status() == xtsc_response::RSP_NACC));
+
+    ch.m_block_write_sent_count = 0;
+    u64 tag = (m_reuse_tag ? ch.m_request.get_tag() : 0);
+    while (ch.m_block_write_sent_count < ch.m_num_block_transfers) {
+      while (ch.m_block_write_sent_count >= ch.m_block_read_response_count) {
+        wait(ch.m_block_read_response_available_event);
+        XTSC_DEBUG(m_text, "use_block_transfers 0x" << hex << dsc.source_address8 << ": tag=" << dec << ch.m_request.get_tag() <<
                            " got m_block_read_response_available_event");
       }
-      sc_time req_net = m_p_block_read_response_time[m_block_write_sent_count] + m_clock_period;
+      sc_time req_net = ch.m_p_block_read_response_time[ch.m_block_write_sent_count] + m_clock_period;
       while (sc_time_stamp() < req_net) {
         sync_to_posedge(true);
       }
 
-      status = m_p_block_read_response[m_block_write_sent_count]->get_status();
+      status = ch.m_p_block_read_response[ch.m_block_write_sent_count]->get_status();
       if (status != xtsc_response::RSP_OK) {
         ostringstream oss;
         oss << kind() << " \"" << name() << "\": unable to block read source address=0x" << hex << dsc.source_address8
@@ -857,8 +1107,8 @@ void xtsc_component::xtsc_dma_engine::use_block_transfers(xtsc_dma_descriptor &d
         throw xtsc_exception(oss.str());
       }
 
-      if (m_block_write_sent_count == 0) {
-        m_request.initialize(xtsc_request::BLOCK_WRITE,     // type
+      if (ch.m_block_write_sent_count == 0) {
+        ch.m_request.initialize(xtsc_request::BLOCK_WRITE,  // type
                              dsc.destination_address8,      // address
                              m_width8,                      // size
                              tag,                           // tag  (0 => XTSC assigns tag)
@@ -866,47 +1116,47 @@ void xtsc_component::xtsc_dma_engine::use_block_transfers(xtsc_dma_descriptor &d
                              0xFFFF,                        // byte_enables (ignored)
                              false,                         // last_transfer
                              0,                             // route_id
-                             m_block_write_id,              // id
+                             ch.get_id(m_block_write_id),   // id
                              m_write_priority               // priority
                              );
-        tag = m_request.get_tag();
+        tag = ch.m_request.get_tag();
       }
       else {
-        bool last = ((m_block_write_sent_count + 1) == m_num_block_transfers);
-        m_request.initialize(tag,                           // tag
+        bool last = ((ch.m_block_write_sent_count + 1) == ch.m_num_block_transfers);
+        ch.m_request.initialize(tag,                        // tag
                              dsc.destination_address8,      // address
                              m_width8,                      // size
                              dsc.num_transfers,             // num_transfers
                              last,                          // last_transfer
                              0,                             // route_id
-                             m_block_write_id,              // id
+                             ch.get_id(m_block_write_id),   // id
                              m_write_priority               // priority
                              );
       }
 
-      memcpy(m_request.get_buffer(), m_p_block_read_response[m_block_write_sent_count]->get_buffer(), m_width8);
+      memcpy(ch.m_request.get_buffer(), ch.m_p_block_read_response[ch.m_block_write_sent_count]->get_buffer(), m_width8);
       u32 tries = 0;
       do {
-        if (m_p_block_write_response) {
-          delete m_p_block_write_response;
-          m_p_block_write_response = 0;
+        if (ch.m_p_block_write_response) {
+          m_response_allocator.destroy(ch.m_p_block_write_response);
+          ch.m_p_block_write_response = 0;
         }
         tries += 1;
-        XTSC_INFO(m_text, m_request << "Try #" << tries);
-        m_request_port->nb_request(m_request);
+        XTSC_INFO(m_text, ch.m_request << "Try #" << tries);
+        m_request_port->nb_request(ch.m_request);
         wait(m_clock_period);
-      } while (m_p_block_write_response && (m_p_block_write_response->get_status() == xtsc_response::RSP_NACC));
+      } while (ch.m_p_block_write_response && (ch.m_p_block_write_response->get_status() == xtsc_response::RSP_NACC));
 
-      m_block_write_sent_count += 1;
+      ch.m_block_write_sent_count += 1;
       dsc.destination_address8 += m_width8;
 
     }
 
-    if (!m_p_block_write_response) {
-      wait(m_block_write_response_available_event);
+    if (!ch.m_p_block_write_response) {
+      wait(ch.m_block_write_response_available_event);
     }
 
-    status = m_p_block_write_response->get_status();
+    status = ch.m_p_block_write_response->get_status();
     if (status != xtsc_response::RSP_OK) {
       ostringstream oss;
       oss << kind() << " \"" << name() << "\": unable to block write destination address=0x" << hex << dsc.destination_address8
@@ -915,22 +1165,23 @@ void xtsc_component::xtsc_dma_engine::use_block_transfers(xtsc_dma_descriptor &d
     }
 
 
-    u32 bytes_in_block = m_width8 * m_num_block_transfers;
+    u32 bytes_in_block = m_width8 * ch.m_num_block_transfers;
     dsc.source_address8 += bytes_in_block;
     dsc.size8 -= bytes_in_block;
 
   }
-  m_num_block_transfers = 0;
+  ch.m_num_block_transfers = 0;
 }
 
 
 
-xtsc_response::status_t xtsc_component::xtsc_dma_engine::remote_read(xtsc_address       address8,
+xtsc_response::status_t xtsc_component::xtsc_dma_engine::remote_read(channel&           ch,
+                                                                     xtsc_address       address8,
                                                                      u32                size8,
                                                                      xtsc_byte_enables  byte_enables,
                                                                      u8                *buffer)
 {
-  m_request.initialize(xtsc_request::READ,      // type
+  ch.m_request.initialize(xtsc_request::READ,   // type
                        address8,                // address8
                        size8,                   // size8
                        0,                       // tag  (0 => XTSC assigns)
@@ -938,50 +1189,51 @@ xtsc_response::status_t xtsc_component::xtsc_dma_engine::remote_read(xtsc_addres
                        byte_enables,            // byte_enables
                        true,                    // last_transfer
                        0,                       // route_id
-                       m_read_id,               // id
+                       ch.get_id(m_read_id),    // id
                        m_read_priority          // priority
                        );
   u32 tries = 0;
   do {
     tries += 1;
-    XTSC_INFO(m_text, m_request << "Try #" << tries);
-    m_request_port->nb_request(m_request);
-    wait(m_single_response_available_event);
-    XTSC_DEBUG(m_text, "remote_read 0x" << hex << address8 << ": tag=" << dec << m_request.get_tag() <<
+    XTSC_INFO(m_text, ch.m_request << "Try #" << tries);
+    m_request_port->nb_request(ch.m_request);
+    wait(ch.m_single_response_available_event);
+    XTSC_DEBUG(m_text, "remote_read 0x" << hex << address8 << ": tag=" << dec << ch.m_request.get_tag() <<
                        " got m_single_response_available_event");
-  } while (m_p_single_response->get_status() == xtsc_response::RSP_NACC);
+  } while (ch.m_p_single_response->get_status() == xtsc_response::RSP_NACC);
 
-  if (m_p_single_response->get_status() == xtsc_response::RSP_OK) {
-    memcpy(buffer, m_p_single_response->get_buffer(), size8);
+  if (ch.m_p_single_response->get_status() == xtsc_response::RSP_OK) {
+    memcpy(buffer, ch.m_p_single_response->get_buffer(), size8);
   }
 
-  return m_p_single_response->get_status();
+  return ch.m_p_single_response->get_status();
 }
 
 
 
-xtsc_response::status_t xtsc_component::xtsc_dma_engine::remote_write_u32(xtsc_address address8, u32 data) {
+xtsc_response::status_t xtsc_component::xtsc_dma_engine::remote_write_u32(channel& ch, xtsc_address address8, u32 data) {
   u8 buffer[4];
   u8 *p_data = reinterpret_cast<u8*>(&data);
   xtsc_byte_enables byte_enables = 0x000F;
-  if (m_big_endian) {
+  if (ch.m_big_endian) {
     for (int i=0; i<4; i++) {
       buffer[i] = p_data[3-i];
     }
     p_data = buffer;
   }
-  return remote_write(address8, 4, byte_enables, p_data);
+  return remote_write(ch, address8, 4, byte_enables, p_data);
 }
 
 
 
-xtsc_response::status_t xtsc_component::xtsc_dma_engine::remote_write(xtsc_address      address8,
+xtsc_response::status_t xtsc_component::xtsc_dma_engine::remote_write(channel&          ch,
+                                                                      xtsc_address      address8,
                                                                       u32               size8,
                                                                       xtsc_byte_enables byte_enables,
                                                                       u8               *buffer,
                                                                       u64               tag)
 {
-  m_request.initialize(xtsc_request::WRITE,     // type
+  ch.m_request.initialize(xtsc_request::WRITE,  // type
                        address8,                // address8
                        size8,                   // size8
                        tag,                     // tag (0 => XTSC assigns)
@@ -989,21 +1241,21 @@ xtsc_response::status_t xtsc_component::xtsc_dma_engine::remote_write(xtsc_addre
                        byte_enables,            // byte_enables
                        true,                    // last_transfer
                        0,                       // route_id
-                       m_write_id,              // id
+                       ch.get_id(m_write_id),   // id
                        m_write_priority         // priority
                        );
-  memcpy(m_request.get_buffer(), buffer, size8);
+  memcpy(ch.m_request.get_buffer(), buffer, size8);
   u32 tries = 0;
   do {
     tries += 1;
-    XTSC_INFO(m_text, m_request << "Try #" << tries);
-    m_request_port->nb_request(m_request);
-    wait(m_single_response_available_event);
-    XTSC_DEBUG(m_text, "remote_write 0x" << hex << address8 << ": tag=" << dec << m_request.get_tag() << 
+    XTSC_INFO(m_text, ch.m_request << "Try #" << tries);
+    m_request_port->nb_request(ch.m_request);
+    wait(ch.m_single_response_available_event);
+    XTSC_DEBUG(m_text, "remote_write 0x" << hex << address8 << ": tag=" << dec << ch.m_request.get_tag() <<
                        " got m_single_response_available_event");
-  } while (m_p_single_response->get_status() == xtsc_response::RSP_NACC);
+  } while (ch.m_p_single_response->get_status() == xtsc_response::RSP_NACC);
 
-  return m_p_single_response->get_status();
+  return ch.m_p_single_response->get_status();
 }
 
 
@@ -1027,23 +1279,15 @@ void xtsc_component::xtsc_dma_engine::compute_delays() {
 
 
 xtsc_request *xtsc_component::xtsc_dma_engine::new_request() {
-  if (m_request_pool.empty()) {
-    xtsc_request *p_request = new xtsc_request();
-    XTSC_DEBUG(m_text, "Creating a new xtsc_request " << p_request);
-    return p_request;
-  }
-  else {
-    xtsc_request *p_request = m_request_pool.back();
-    XTSC_DEBUG(m_text, "Reusing xtsc_request " << p_request);
-    m_request_pool.pop_back();
-    return p_request;
-  }
+  xtsc_request *p_request = m_request_allocator.create<xtsc_request>();
+  XTSC_DEBUG(m_text, "Creating xtsc_request " << p_request);
+  return p_request;
 }
 
 
 
 void xtsc_component::xtsc_dma_engine::delete_request(xtsc_request*& p_request) {
-  m_request_pool.push_back(p_request);
+  m_request_allocator.destroy(p_request);
   p_request = 0;
 }
 
@@ -1051,7 +1295,14 @@ void xtsc_component::xtsc_dma_engine::delete_request(xtsc_request*& p_request) {
 
 bool xtsc_component::xtsc_dma_engine::xtsc_respond_if_impl::nb_respond(const xtsc_response& response) {
   XTSC_INFO(m_dma.m_text, response);
-  u8 rsp_id = response.get_id();
+  u32 channel_num = (response.get_id() >> 3);
+  u8  rsp_id      = (response.get_id() & 0x7);
+  if (channel_num >= m_dma.m_num_channels) {
+    ostringstream oss;
+    oss << m_dma.kind() << " '" << m_dma.name() << "' nb_respond(): Got response with unsupported id=" << (u32) response.get_id();
+    throw xtsc_exception(oss.str());
+  }
+  channel& ch = *m_dma.m_channels[channel_num];
   if ((rsp_id == m_dma.m_overlapped_read_id) || (rsp_id == m_dma.m_overlapped_write_id)) {
     xtsc_response::status_t status = response.get_status();
     if (status == xtsc_response::RSP_NACC) {
@@ -1073,13 +1324,13 @@ bool xtsc_component::xtsc_dma_engine::xtsc_respond_if_impl::nb_respond(const xts
           oss << m_dma.kind() << " '" << m_dma.name() << "' received a write response with a read ID: " << response << endl;
           throw xtsc_exception(oss.str());
         }
-        if (m_dma.m_blank_write_deque.empty()) {
+        if (ch.m_blank_write_deque.empty()) {
           ostringstream oss;
           oss << m_dma.kind() << " '" << m_dma.name() << "' received unexpected response: " << response << endl;
           throw xtsc_exception(oss.str());
         }
-        xtsc_request *p_request = m_dma.m_blank_write_deque.front();
-        m_dma.m_blank_write_deque.pop_front();
+        xtsc_request *p_request = ch.m_blank_write_deque.front();
+        ch.m_blank_write_deque.pop_front();
         bool last = p_request->get_last_transfer();
         if (response.get_last_transfer() != last) {
           ostringstream oss;
@@ -1096,38 +1347,35 @@ bool xtsc_component::xtsc_dma_engine::xtsc_respond_if_impl::nb_respond(const xts
             }
           }
         }
+        memcpy(p_request->get_buffer(), response.get_buffer(), response.get_byte_size());
+        ch.m_ready_write_deque.push_back(p_request);
         if (last) {
-          if (m_dma.m_num_reads == m_dma.m_max_reads) {
-            m_dma.m_got_read_response_event.notify(SC_ZERO_TIME);
-          }
           m_dma.m_num_reads -= 1;
-          XTSC_DEBUG(m_dma.m_text, "Dec m_num_reads to " << m_dma.m_num_reads);
-          if ((m_dma.m_num_reads == 0) && (m_dma.m_num_writes == 0)) {
-            m_dma.m_no_reads_or_writes_event.notify(SC_ZERO_TIME);
-          }
-          m_dma.m_last_write_deque.push_back(0);
+          ch.m_num_reads -= 1;
+          XTSC_DEBUG(m_dma.m_text, "Dec m_num_reads to " << m_dma.m_num_reads << " (channel " << ch.m_index << ")");
+          m_dma.grant_read_slots();
+          ch.m_last_write_deque.push_back(0);
           m_dma.m_write_thread_event.notify(SC_ZERO_TIME);
         }
-        memcpy(p_request->get_buffer(), response.get_buffer(), response.get_byte_size());
-        m_dma.m_ready_write_deque.push_back(p_request);
       }
       else {
-        if (m_dma.m_done_descriptor_deque.empty()) {
+        if (ch.m_done_descriptor_deque.empty()) {
           ostringstream oss;
           oss << "Program Bug: " << m_dma.kind() << " '" << m_dma.name() << "' m_done_descriptor_deque is un-expectedly empty.";
           throw xtsc_exception(oss.str());
         }
-        u32 idx = m_dma.m_done_descriptor_deque.front();
-        m_dma.m_done_descriptor_deque.pop_front();
+        u32 idx = ch.m_done_descriptor_deque.front();
+        ch.m_done_descriptor_deque.pop_front();
         if (idx != 0) {
-          m_dma.write_u32(m_dma.m_reg_base_address+0x10, idx, m_dma.m_big_endian);
+          m_dma.write_u32(ch.m_reg_base_address+0x10, idx, ch.m_big_endian);
           XTSC_INFO(m_dma.m_text, "Descriptor @" << idx << " completed");
         }
         m_dma.m_num_writes -= 1;
-        XTSC_DEBUG(m_dma.m_text, "Dec m_num_writes to " << m_dma.m_num_writes);
+        ch.m_num_writes -= 1;
+        XTSC_DEBUG(m_dma.m_text, "Dec m_num_writes to " << m_dma.m_num_writes << " (channel " << ch.m_index << ")");
         m_dma.m_write_thread_event.notify(SC_ZERO_TIME);
-        if ((m_dma.m_num_reads == 0) && (m_dma.m_num_writes == 0)) {
-          m_dma.m_no_reads_or_writes_event.notify(SC_ZERO_TIME);
+        if ((ch.m_num_reads == 0) && (ch.m_num_writes == 0)) {
+          ch.m_no_reads_or_writes_event.notify(SC_ZERO_TIME);
         }
       }
     }
@@ -1138,46 +1386,46 @@ bool xtsc_component::xtsc_dma_engine::xtsc_respond_if_impl::nb_respond(const xts
     }
   }
   else if ((rsp_id == m_dma.m_read_id) || (rsp_id == m_dma.m_write_id)) {
-    if (m_dma.m_p_single_response) {
-      delete m_dma.m_p_single_response;
-      m_dma.m_p_single_response = 0;
+    if (ch.m_p_single_response) {
+      m_dma.m_response_allocator.destroy(ch.m_p_single_response);
+      ch.m_p_single_response = 0;
     }
-    m_dma.m_p_single_response = new xtsc_response(response);
+    ch.m_p_single_response = m_dma.m_response_allocator.create<xtsc_response>(response);
     XTSC_DEBUG(m_dma.m_text, "nb_respond() called for tag=" << response.get_tag() <<
-                             " notifying m_dma.m_single_response_available_event");
-    m_dma.m_single_response_available_event.notify(SC_ZERO_TIME);
+                             " notifying m_single_response_available_event");
+    ch.m_single_response_available_event.notify(SC_ZERO_TIME);
   }
   else if (rsp_id == m_dma.m_block_read_id) {
-    if (m_dma.m_block_read_response_count >= m_dma.m_num_block_transfers) {
+    if (ch.m_block_read_response_count >= ch.m_num_block_transfers) {
       ostringstream oss;
-      oss << m_dma.kind() << " '" << m_dma.name() << "' nb_respond(): Received " << (m_dma.m_block_read_response_count+1)
-          << " BLOCK_READ responses.  " << m_dma.m_num_block_transfers << " were expected.";
+      oss << m_dma.kind() << " '" << m_dma.name() << "' nb_respond(): Received " << (ch.m_block_read_response_count+1)
+          << " BLOCK_READ responses.  " << ch.m_num_block_transfers << " were expected.";
       throw xtsc_exception(oss.str());
     }
-    if (m_dma.m_p_block_read_response[m_dma.m_block_read_response_count]) {
-      delete m_dma.m_p_block_read_response[m_dma.m_block_read_response_count];
-      m_dma.m_p_block_read_response[m_dma.m_block_read_response_count] = 0;
+    if (ch.m_p_block_read_response[ch.m_block_read_response_count]) {
+      m_dma.m_response_allocator.destroy(ch.m_p_block_read_response[ch.m_block_read_response_count]);
+      ch.m_p_block_read_response[ch.m_block_read_response_count] = 0;
     }
-    m_dma.m_p_block_read_response[m_dma.m_block_read_response_count] = new xtsc_response(response);
-    m_dma.m_p_block_read_response_time[m_dma.m_block_read_response_count] = sc_time_stamp();
+    ch.m_p_block_read_response[ch.m_block_read_response_count] = m_dma.m_response_allocator.create<xtsc_response>(response);
+    ch.m_p_block_read_response_time[ch.m_block_read_response_count] = sc_time_stamp();
     XTSC_DEBUG(m_dma.m_text, "nb_respond() called for tag=" << response.get_tag() <<
-                             " notifying m_dma.m_block_read_response_available_event");
-    m_dma.m_block_read_response_available_event.notify(SC_ZERO_TIME);
-    m_dma.m_block_read_response_count += 1;
+                             " notifying m_block_read_response_available_event");
+    ch.m_block_read_response_available_event.notify(SC_ZERO_TIME);
+    ch.m_block_read_response_count += 1;
   }
   else if (rsp_id == m_dma.m_block_write_id) {
-    if (m_dma.m_p_block_write_response) {
-      delete m_dma.m_p_block_write_response;
-      m_dma.m_p_block_write_response = 0;
+    if (ch.m_p_block_write_response) {
+      m_dma.m_response_allocator.destroy(ch.m_p_block_write_response);
+      ch.m_p_block_write_response = 0;
     }
-    m_dma.m_p_block_write_response = new xtsc_response(response);
+    ch.m_p_block_write_response = m_dma.m_response_allocator.create<xtsc_response>(response);
     XTSC_DEBUG(m_dma.m_text, "nb_respond() called for tag=" << response.get_tag() <<
-                             " notifying m_dma.m_block_write_response_available_event");
-    m_dma.m_block_write_response_available_event.notify(SC_ZERO_TIME);
+                             " notifying m_block_write_response_available_event");
+    ch.m_block_write_response_available_event.notify(SC_ZERO_TIME);
   }
   else {
     ostringstream oss;
-    oss << m_dma.kind() << " '" << m_dma.name() << "' nb_respond(): Got response with unsupported id=" << (u32) rsp_id;
+    oss << m_dma.kind() << " '" << m_dma.name() << "' nb_respond(): Got response with unsupported id=" << (u32) response.get_id();
     throw xtsc_exception(oss.str());
   }
   return true;
@@ -74,6 +74,7 @@ xtsc_component::xtsc_lookup::xtsc_lookup(sc_module_name module_name, const xtsc_
   m_lua_data_function   (""),
   m_lua_delay_function  (""),
   m_lua_function        (false),
+  m_cache_lua_results   (lookup_parms.get_bool("cache_lua_results")),
   m_data                (m_data_bit_width),
   m_data_temp           (m_data_bit_width),
   m_old_data            (m_data_bit_width),
@@ -343,6 +344,11 @@ xtsc_component::xtsc_lookup::xtsc_lookup(sc_module_name module_name, const xtsc_
     }
   }
 
+  m_data_map       .configure(m_ram ? m_ram_address_bits : m_address_bit_width);
+  m_delay_map      .configure(m_ram ? m_ram_address_bits : m_address_bit_width);
+  m_lua_data_cache .configure(m_address_bit_width);
+  m_lua_delay_cache.configure(m_address_bit_width);
+
   const char *lookup_table = lookup_parms.get_c_str("lookup_table");
 
   if (!lookup_table || !lookup_table[0]) {
@@ -424,6 +430,7 @@ xtsc_component::xtsc_lookup::xtsc_lookup(sc_module_name module_name, const xtsc_
   XTSC_LOG(m_text, ll, " latency                 = "   << m_latency);
   XTSC_LOG(m_text, ll, " delay                   = "   << m_delay);
   XTSC_LOG(m_text, ll, " lookup_table            = "   << m_lookup_table);
+  XTSC_LOG(m_text, ll, " cache_lua_results       = "   << boolalpha << m_cache_lua_results);
   XTSC_LOG(m_text, ll, " default_data            = 0x" << m_default_data.to_string(SC_HEX).substr(m_data_bit_width%4 ? 2 : 3));
   XTSC_LOG(m_text, ll, " override_lookup         = "   << boolalpha << m_override_lookup);
   if (clock_period == 0xFFFFFFFF) {
@@ -450,9 +457,11 @@ xtsc_component::xtsc_lookup::xtsc_lookup(sc_module_name module_name, const xtsc_
 
 
 xtsc_component::xtsc_lookup::~xtsc_lookup(void) {
-  map<string, sc_unsigned*>::iterator imap = m_data_map.begin();
-  for (; imap != m_data_map.end(); ++imap) {
-    sc_unsigned *p_data = (*imap).second;
+  vector<pair<string, sc_unsigned*> > entries;
+  m_data_map.get_entries(entries);
+  m_lua_data_cache.get_entries(entries);
+  for (vector<pair<string, sc_unsigned*> >::iterator i = entries.begin(); i != entries.end(); ++i) {
+    sc_unsigned *p_data = i->second;
     delete p_data;
   }
 }
@@ -513,13 +522,25 @@ void xtsc_component::xtsc_lookup::reset(bool hard_reset) {
   }
   m_recycle_fifo.clear();
 
+  vector<pair<string, sc_unsigned*> > entries;
+  m_lua_data_cache.get_entries(entries);
+  for (vector<pair<string, sc_unsigned*> >::iterator i = entries.begin(); i != entries.end(); ++i) {
+    sc_unsigned *p_data = i->second;
+    delete_sc_unsigned(p_data);
+  }
+  m_lua_data_cache.clear();
+  m_lua_delay_cache.clear();
+
   if (m_file && hard_reset) {
     m_file->reset();
-    for (map<string, sc_unsigned*>::iterator imap = m_data_map.begin(); imap != m_data_map.end(); ++imap) {
-      sc_unsigned *p_data = (*imap).second;
+    entries.clear();
+    m_data_map.get_entries(entries);
+    for (vector<pair<string, sc_unsigned*> >::iterator i = entries.begin(); i != entries.end(); ++i) {
+      sc_unsigned *p_data = i->second;
       delete_sc_unsigned(p_data);
     }
     m_data_map.clear();
+    m_delay_map.clear();
 
     if (!m_file_logged) {
       XTSC_LOG(m_text, xtsc_get_constructor_log_level(), "Loading lookup table from file '" << m_lookup_table << "'.");
@@ -604,12 +625,9 @@ void xtsc_component::xtsc_lookup::reset(bool hard_reset) {
         }
       }
 
-      ostringstream oss;
-      oss << "0x" << address.to_string(SC_HEX).substr(address_bits%4 ? 2 : 3);
-      map<string, sc_unsigned*>::iterator imap = m_data_map.find(oss.str());
-      if (imap == m_data_map.end()) {
-        m_data_map[oss.str()] = p_data;
-        m_delay_map[oss.str()] = delay;
+      if (!m_data_map.find(address)) {
+        m_data_map.insert(address, p_data);
+        m_delay_map.insert(address, delay);
       }
       else {
         ostringstream oss;
@@ -791,50 +809,56 @@ void xtsc_component::xtsc_lookup::do_lookup() {
         (*m_p_effective_ram_addr)[m_ram_write_enables[i]] = 0;
       }
     }
-    ostringstream oss;
-    oss << "0x" << m_p_effective_ram_addr->to_string(SC_HEX).substr(m_ram_address_bits%4 ? 2 : 3);
-    map<string, sc_unsigned*>::iterator imap = m_data_map.find(oss.str());
-    if (imap == m_data_map.end()) {
-      m_data_map[oss.str()] = new_sc_unsigned(m_default_data);
-      imap = m_data_map.find(oss.str());
+    sc_unsigned **pp_entry = m_data_map.find(*m_p_effective_ram_addr);
+    if (!pp_entry) {
+      pp_entry = &m_data_map.insert(*m_p_effective_ram_addr, new_sc_unsigned(m_default_data));
     }
-    sc_unsigned *p_data = new_sc_unsigned(*(imap->second));
+    sc_unsigned *p_data = new_sc_unsigned(**pp_entry);
     m_data_fifo.push_back(p_data);
     if (m_write) {
       if (m_has_ram_write_enables) {
         // Make a copy of the original contents
-        m_data_temp = *(imap->second);
+        m_data_temp = **pp_entry;
         // Write the entire new value
-        *(imap->second) = m_data;
+        **pp_entry = m_data;
         // Restore the original contents of bit fields that are controlled by an inactive enable bit
         for (u32 i=0; i<m_ram_write_enables.size(); i+=4) {
           if (m_ram_write_enables[i+3] != (*m_p_ram_addr)[m_ram_write_enables[i]]) {
-            imap->second->range(m_ram_write_enables[i+2], m_ram_write_enables[i+1]) =
+            (*pp_entry)->range(m_ram_write_enables[i+2], m_ram_write_enables[i+1]) =
                     m_data_temp(m_ram_write_enables[i+2], m_ram_write_enables[i+1]);
           }
         }
       }
       else {
-        *(imap->second) = m_data;
+        **pp_entry = m_data;
       }
     }
   }
   else {
     // Regular lookup
-    ostringstream oss;
-    oss << "0x" << m_address.to_string(SC_HEX).substr(m_address_bit_width%4 ? 2 : 3);
-    map<string, sc_unsigned*>::iterator imap = m_data_map.find(oss.str());
-    if (imap != m_data_map.end()) {
-      m_data_fifo.push_back(imap->second);
+    sc_unsigned **pp_entry = m_data_map.find(m_address);
+    if (pp_entry) {
+      m_data_fifo.push_back(*pp_entry);
     }
     else if (m_lua_function) {
-      ostringstream exp;
-      exp << m_lua_data_function << "(\"" << oss.str() << "\")";
-      string result = m_file->evaluate_lua_expression(exp.str());
-      XTSC_VERBOSE(m_text, exp.str() << " => " << result);
-      sc_unsigned *p_sc_unsigned = new_sc_unsigned(result);
-      m_data_fifo.push_back(p_sc_unsigned);
-      m_recycle_fifo.push_back(p_sc_unsigned);
+      sc_unsigned **pp_cached = m_lua_data_cache.find(m_address);
+      if (pp_cached) {
+        m_data_fifo.push_back(*pp_cached);
+      }
+      else {
+        ostringstream exp;
+        exp << m_lua_data_function << "(\"0x" << m_address.to_string(SC_HEX).substr(m_address_bit_width%4 ? 2 : 3) << "\")";
+        string result = m_file->evaluate_lua_expression(exp.str());
+        XTSC_VERBOSE(m_text, exp.str() << " => " << result);
+        sc_unsigned *p_sc_unsigned = new_sc_unsigned(result);
+        m_data_fifo.push_back(p_sc_unsigned);
+        if (m_cache_lua_results) {
+          m_lua_data_cache.insert(m_address, p_sc_unsigned);
+        }
+        else {
+          m_recycle_fifo.push_back(p_sc_unsigned);
+        }
+      }
     }
     else {
       m_data_fifo.push_back(&m_default_data);
@@ -909,23 +933,32 @@ void xtsc_component::xtsc_lookup::xtsc_lookup_if_impl::nb_send_address(const sc_
     m_lookup.m_address = address;
   }
   if (m_lookup.m_has_ready) {
-    ostringstream oss;
-    oss << "0x" << m_lookup.m_address.to_string(SC_HEX).substr(m_lookup.m_address_bit_width%4 ? 2 : 3);
-    map<string, u32>::iterator id = m_lookup.m_delay_map.find(oss.str());
-    if (id != m_lookup.m_delay_map.end()) {
-      m_lookup.m_delay_next = id->second;
+    u32 *p_delay = m_lookup.m_delay_map.find(m_lookup.m_address);
+    if (p_delay) {
+      m_lookup.m_delay_next = *p_delay;
     }
     else if (m_lookup.m_lua_function && (m_lookup.m_lua_delay_function != "")) {
-      ostringstream exp;
-      exp << m_lookup.m_lua_delay_function << "(\"" << oss.str() << "\")";
-      string result = m_lookup.m_file->evaluate_lua_expression(exp.str());
-      XTSC_VERBOSE(m_lookup.m_text, exp.str() << " => " << result);
-      m_lookup.m_delay_next = xtsc_strtou32(result);
+      u32 *p_cached = m_lookup.m_lua_delay_cache.find(m_lookup.m_address);
+      if (p_cached) {
+        m_lookup.m_delay_next = *p_cached;
+      }
+      else {
+        ostringstream exp;
+        exp << m_lookup.m_lua_delay_function << "(\"0x"
+            << m_lookup.m_address.to_string(SC_HEX).substr(m_lookup.m_address_bit_width%4 ? 2 : 3) << "\")";
+        string result = m_lookup.m_file->evaluate_lua_expression(exp.str());
+        XTSC_VERBOSE(m_lookup.m_text, exp.str() << " => " << result);
+        m_lookup.m_delay_next = xtsc_strtou32(result);
+        if (m_lookup.m_cache_lua_results) {
+          m_lookup.m_lua_delay_cache.insert(m_lookup.m_address, m_lookup.m_delay_next);
+        }
+      }
     }
     else {
       m_lookup.m_delay_next = m_lookup.m_delay;
     }
-    XTSC_DEBUG(m_lookup.m_text, "address=" << oss.str() << " next delay=" << m_lookup.m_delay_next);
+    XTSC_DEBUG(m_lookup.m_text, "address=0x" << m_lookup.m_address.to_string(SC_HEX).substr(m_lookup.m_address_bit_width%4 ? 2 : 3) <<
+                                " next delay=" << m_lookup.m_delay_next);
   }
   else {
     if (m_lookup.pipeline_full()) {
@@ -1087,10 +1120,11 @@ void xtsc_component::xtsc_lookup::xtsc_lookup_if_impl::register_port(sc_port_bas
 
 
 void xtsc_component::xtsc_lookup::dump(ostream &os) {
-  map<string, sc_unsigned*>::iterator imap = m_data_map.begin();
-  for (; imap != m_data_map.end(); ++imap) {
-    string p_address = (*imap).first;
-    sc_unsigned *p_data = (*imap).second;
+  vector<pair<string, sc_unsigned*> > entries;
+  m_data_map.get_entries(entries);
+  for (vector<pair<string, sc_unsigned*> >::iterator i = entries.begin(); i != entries.end(); ++i) {
+    string p_address = i->first;
+    sc_unsigned *p_data = i->second;
     os << p_address << ": 0x" << p_data->to_string(SC_HEX).substr(3) << endl;
   }
 }
@@ -1125,13 +1159,13 @@ string xtsc_component::xtsc_lookup::peek(const string& address) {
     throw xtsc_exception(oss.str());
   }
   validate_address(address);
-  map<string, sc_unsigned*>::iterator imap = m_data_map.find(address);
-  if (imap == m_data_map.end()) {
+  sc_unsigned **pp_entry = m_data_map.find(address);
+  if (!pp_entry) {
     return "";
   }
   else {
     ostringstream oss;
-    oss << "0x" << imap->second->to_string(SC_HEX).substr(3);
+    oss << "0x" << (*pp_entry)->to_string(SC_HEX).substr(3);
     return oss.str();
   }
 }
@@ -1146,14 +1180,14 @@ void xtsc_component::xtsc_lookup::poke(const string& address, const string& data
     throw xtsc_exception(oss.str());
   }
   validate_address(address);
-  map<string, sc_unsigned*>::iterator imap = m_data_map.find(address);
-  if (imap == m_data_map.end()) {
+  sc_unsigned **pp_entry = m_data_map.find(address);
+  if (!pp_entry) {
     m_poke_data = data.c_str();
     sc_unsigned *p_data = new_sc_unsigned(m_poke_data);
-    m_data_map[address] = p_data;
+    m_data_map.insert(address, p_data);
   }
   else {
-    *(imap->second) = data.c_str();
+    **pp_entry = data.c_str();
   }
 }
 
@@ -8,6 +8,8 @@
 // \w*clock_period\w*\|m_read_delay\|m_block_read_delay\|m_block_read_repeat\|m_burst_read_delay\|m_burst_read_repeat\|m_rcw_repeat\|m_rcw_response\|m_write_delay\|m_block_write_delay\|m_block_write_repeat\|m_block_write_response\|m_burst_write_delay\|m_burst_write_repeat\|m_burst_write_response\|m_recovery_time\|m_response_repeat\|\<wait\>
 
 #include <cstdlib>
+#include <chrono>
+#include <fstream>
 #include <ostream>
 #include <string>
 #include <xtsc/xtsc_memory.h>
@@ -20,6 +22,14 @@
 #include <xtsc/xtsc_pin2tlm_memory_transactor.h>
 #include <xtsc/xtsc_logging.h>
 #include <xtsc/xtsc_fast_access.h>
+#if defined(_WIN32)
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 using namespace std;
 #if SYSTEMC_VERSION >= 20050601
@@ -252,6 +262,8 @@ xtsc_component::xtsc_memory::xtsc_memory(sc_module_name module_name, const xtsc_
 #if IEEE_1666_SYSTEMC >= 201101L
   m_script_thread_event   ("m_script_thread_event"),
 #endif
+  m_exclusive_monitor_hits(0),
+  m_exclusive_monitor_misses(0),
   m_exclusive_monitors    (0),
   m_lua_function          (""),
   m_last                  (getenv("XTSC_MEMORY_SCRIPT_FILE_LAST_FALSE") == NULL),
@@ -261,9 +273,22 @@ xtsc_component::xtsc_memory::xtsc_memory(sc_module_name module_name, const xtsc_
   m_p_user_data           (NULL),
   m_is_shared             (false),
   m_pass_dirty            (false),
+  m_request_info_allocator(string(name()) + ".request_info"),
+  m_response_allocator    (string(name()) + ".xtsc_response"),
+  m_user_data_allocator   (string(name()) + ".user_data"),
   m_host_shared_memory    (memory_parms.get_bool      ("host_shared_memory")),
   m_interval_size         (memory_parms.get_u64       ("interval_size")),
   m_host_mutex            (memory_parms.get_bool      ("host_mutex")),
+  m_mmap_storage          (memory_parms.get_bool      ("mmap_storage")),
+  m_mmap_base             (NULL),
+  m_mmap_size8            (0),
+  m_mmap_huge_pages       (memory_parms.get_u32       ("mmap_huge_pages")),
+  m_elf_file              (""),
+  m_binary_file           (""),
+  m_binary_file_offset    (memory_parms.get_u64       ("binary_file_offset")),
+  m_image_bytes_loaded    (0),
+  m_image_load_seconds    (0.0),
+  m_p_checkpoint          (NULL),
   m_use_fast_access       (memory_parms.get_bool      ("use_fast_access")),
   m_deny_fast_access      (memory_parms.get_u64_vector("deny_fast_access")),
   m_fast_access_size      (memory_parms.get_u64_vector("fast_access_size")),
@@ -300,6 +325,15 @@ xtsc_component::xtsc_memory::xtsc_memory(sc_module_name module_name, const xtsc_
   m_width8              = m_p_memory->m_width8;
   m_end_address8        = m_p_memory->m_end_address8;
 
+  if (m_mmap_storage) {
+    create_mmap_storage(m_mmap_huge_pages);
+  }
+
+  const char *elf_file    = memory_parms.get_c_str("elf_file");
+  const char *binary_file = memory_parms.get_c_str("binary_file");
+  if (elf_file)    m_elf_file    = elf_file;
+  if (binary_file) m_binary_file = binary_file;
+
   memory_parms.get("read_only",          m_read_only);
   memory_parms.get("support_exclusive",  m_support_exclusive);
   memory_parms.get("summary",            m_summary);
@@ -544,6 +578,12 @@ xtsc_component::xtsc_memory::xtsc_memory(sc_module_name module_name, const xtsc_
       "Call xtsc_memory::change_clock_period(<ClockPeriodFactor>).  Return previous <ClockPeriodFactor> for this device."
   );
 
+  xtsc_register_command(*this, *this, "checkpoint", 1, 1,
+      "checkpoint save|restore|discard", 
+      "Call xtsc_memory::checkpoint_save(), xtsc_memory::checkpoint_restore(), or xtsc_memory::checkpoint_discard()."
+      "  For restore, return the number of pages restored."
+  );
+
   xtsc_register_command(*this, *this, "dump", 2, 2,
       "dump <StartAddress> <NumBytes>", 
       "Dump <NumBytes> of memory starting at <StartAddress> (includes header and printable ASCII column)."
@@ -640,6 +680,14 @@ xtsc_component::xtsc_memory::xtsc_memory(sc_module_name module_name, const xtsc_
   XTSC_LOG(m_text, ll, hex << " initial_value_file      = "   << m_p_memory->m_initial_value_file);
   XTSC_LOG(m_text, ll, hex << " memory_fill_byte        = 0x" << (u32) m_p_memory->m_memory_fill_byte);
   XTSC_LOG(m_text, ll,        " host_shared_memory      = "   << boolalpha << m_host_shared_memory);
+  XTSC_LOG(m_text, ll,        " mmap_storage            = "   << boolalpha << m_mmap_storage);
+  if (m_mmap_storage) {
+  XTSC_LOG(m_text, ll,        " mmap_huge_pages         = "   << m_mmap_huge_pages);
+  XTSC_LOG(m_text, ll, hex << " mmap backing store      = 0x" << m_mmap_size8 << " bytes @" << (void*) m_mmap_base);
+  }
+  XTSC_LOG(m_text, ll,        " elf_file                = "   << m_elf_file);
+  XTSC_LOG(m_text, ll,        " binary_file             = "   << m_binary_file);
+  XTSC_LOG(m_text, ll, hex << " binary_file_offset      = 0x" << m_binary_file_offset);
   XTSC_LOG(m_text, ll,        " interval_size           = "   << m_interval_size);
   XTSC_LOG(m_text, ll,        " host_mutex              = "   << boolalpha << m_host_mutex);
   if (!m_host_shared_memory | (shared_memory_name && shared_memory_name[0])) {
@@ -708,15 +756,27 @@ xtsc_component::xtsc_memory::xtsc_memory(sc_module_name module_name, const xtsc_
   XTSC_LOG(m_text, ll, hex << " Maximum random value    = 0xFFFFFFFF");
   }
 
+  // The hard reset loads "elf_file" and "binary_file" (see load_initial_values())
   reset(true);
 
+  if (m_image_bytes_loaded) {
+    double mb_per_second = (m_image_load_seconds > 0.0) ? (m_image_bytes_loaded / m_image_load_seconds / (1024.0*1024.0)) : 0.0;
+    XTSC_LOG(m_text, ll,      "Image load for '" << name() << "' = " << m_image_bytes_loaded << " bytes in " << m_image_load_seconds <<
+                              " seconds (" << mb_per_second << " MB/s)");
+  }
+
 }
 
 
 
 xtsc_component::xtsc_memory::~xtsc_memory(void) {
   XTSC_DEBUG(m_text, "In ~xtsc_memory()");
+  if (m_p_checkpoint) {
+    delete m_p_checkpoint;
+    m_p_checkpoint = NULL;
+  }
   if (m_p_memory) {
+    destroy_mmap_storage();
     delete m_p_memory;
     m_p_memory = 0;
   }
@@ -831,6 +891,14 @@ void xtsc_component::xtsc_memory::summary(std::ostream& os) {
   os << endl;
   os << std::left << std::setw(18) << "XTSC Memory"       << " : \"" << name() << "\"" << endl;
   os << std::left << std::setw(18) << "Interval duration" << " : "   << m_statistics_interval_duration << endl;
+  if (m_exclusive_monitors) {
+  os << std::left << std::setw(18) << "Excl. monitors"    << " : "   << m_exclusive_monitors << " created, "
+                                                                     << m_exclusive_monitor_hits << " write hits, "
+                                                                     << m_exclusive_monitor_misses << " write misses" << endl;
+  }
+  os << std::left << std::setw(18) << "Peak pool usage"   << " : "   << m_request_info_allocator.get_num_peak() << " request_info, "
+                                                                     << m_response_allocator.get_num_peak() << " xtsc_response, "
+                                                                     << m_user_data_allocator.get_num_peak() << " user data buffer" << endl;
   for (u32 port_num = 0; port_num < m_num_ports ; port_num++) {
     print_summary_per_port(os, port_num);
   }
@@ -1219,8 +1287,7 @@ void xtsc_component::xtsc_memory::reset(bool hard_reset) {
       delete_request_info(m_p_active_request_info[i]);
     }
     if (m_p_active_response[i]) {
-      delete m_p_active_response[i];
-      m_p_active_response[i] = NULL;
+      delete_response(m_p_active_response[i]);
     }
   }
 
@@ -1236,6 +1303,9 @@ void xtsc_component::xtsc_memory::reset(bool hard_reset) {
   }
 
   if (hard_reset) {
+    if (m_p_checkpoint) {
+      m_p_checkpoint->preserve_all();
+    }
     load_initial_values();
   }
 
@@ -1250,6 +1320,41 @@ void xtsc_component::xtsc_memory::reset(bool hard_reset) {
 
 
 
+void xtsc_component::xtsc_memory::checkpoint_save() {
+  if (!m_p_checkpoint) {
+    m_p_checkpoint = new xtsc_memory_checkpoint(*m_p_memory);
+  }
+  m_p_checkpoint->save();
+  // Writes through previously granted raw access pointers cannot be seen so treat those pages as already modified
+  for (map<xtsc_address, xtsc_address>::const_iterator i = m_raw_access_blocks.begin(); i != m_raw_access_blocks.end(); ++i) {
+    m_p_checkpoint->preserve_range(i->first, i->second);
+  }
+  XTSC_INFO(m_text, "checkpoint_save(): " << m_p_checkpoint->get_num_saved_pages() << " pages preserved");
+}
+
+
+
+u32 xtsc_component::xtsc_memory::checkpoint_restore() {
+  if (!m_p_checkpoint || !m_p_checkpoint->is_active()) {
+    ostringstream oss;
+    oss << kind() << " '" << name() << "': checkpoint_restore() called but no checkpoint has been saved";
+    throw xtsc_exception(oss.str());
+  }
+  u32 num_pages = m_p_checkpoint->restore();
+  XTSC_INFO(m_text, "checkpoint_restore(): " << num_pages << " pages restored");
+  return num_pages;
+}
+
+
+
+void xtsc_component::xtsc_memory::checkpoint_discard() {
+  if (m_p_checkpoint) {
+    m_p_checkpoint->discard();
+  }
+}
+
+
+
 void xtsc_component::xtsc_memory::support_exclusive(bool exclusive) {
   if (m_p_exclusive_script_stream) {
     XTSC_WARN(m_text, "Ignoring call to xtsc_memory::support_exclusive() because \"exclusive_script_file\" is defined.");
@@ -1344,6 +1449,22 @@ void xtsc_component::xtsc_memory::execute(const string&                 cmd_line
     res << m_clock_period.value();
     change_clock_period(clock_period_factor);
   }
+  else if (words[0] == "checkpoint") {
+    if (words[1] == "save") {
+      checkpoint_save();
+    }
+    else if (words[1] == "restore") {
+      res << checkpoint_restore();
+    }
+    else if (words[1] == "discard") {
+      checkpoint_discard();
+    }
+    else {
+      ostringstream oss;
+      oss << "Command '" << cmd_line << "' has invalid argument '" << words[1] << "' (expected save|restore|discard).";
+      throw xtsc_exception(oss.str());
+    }
+  }
   else if (words[0] == "dump") {
     xtsc_address start_address = xtsc_command_argtou64(cmd_line, words, 1);
     u32          num_bytes     = xtsc_command_argtou32(cmd_line, words, 2);
@@ -1810,10 +1931,12 @@ void xtsc_component::xtsc_memory::create_exclusive_monitor(xtsc_request &request
   if (i != m_exclusive_monitor_map.end()) {
     address_range& range = i->second;
     XTSC_INFO(m_text, request << ": Delete monitor 0x" << hex << tran_id << ":0x" << range.first << "-0x" << range.second);
+    index_exclusive_monitor(tran_id, range.first, range.second, false);
     m_exclusive_monitor_map.erase(i);
   }
   address_range range = make_pair(address8, address8 + size8 - 1);
   m_exclusive_monitor_map[tran_id] = range;
+  index_exclusive_monitor(tran_id, range.first, range.second, true);
   XTSC_INFO(m_text, request << ": Add monitor 0x" << hex << tran_id << ":0x" << range.first << "-0x" << range.second);
   m_exclusive_monitors += 1;
 }
@@ -1852,23 +1975,57 @@ bool xtsc_component::xtsc_memory::check_exclusive_write(xtsc_request &request, x
 
 
 
+// Exclusive monitors are indexed by 128-byte granule (the largest exclusive access) so each monitor is in at most 2 granules
+static const u32 exclusive_granule_log2 = 7;
+
+
+
+void xtsc_component::xtsc_memory::index_exclusive_monitor(u64 tran_id, xtsc_address monitor_beg, xtsc_address monitor_end, bool add) {
+  for (xtsc_address granule = (monitor_beg >> exclusive_granule_log2); granule <= (monitor_end >> exclusive_granule_log2); ++granule) {
+    if (add) {
+      m_exclusive_granule_map[granule].push_back(tran_id);
+    }
+    else {
+      map<xtsc_address, vector<u64> >::iterator ig = m_exclusive_granule_map.find(granule);
+      if (ig == m_exclusive_granule_map.end()) continue;
+      vector<u64>& ids = ig->second;
+      ids.erase(remove(ids.begin(), ids.end(), tran_id), ids.end());
+      if (ids.empty()) {
+        m_exclusive_granule_map.erase(ig);
+      }
+    }
+  }
+}
+
+
+
 void xtsc_component::xtsc_memory::check_exclusive_monitors_against_write(xtsc_request &request, xtsc_address address8, u32 size8) {
-  XTSC_DEBUG(m_text, "check_exclusive_monitors_against_write: monitor count = " << m_exclusive_monitor_map.size());
+  if (m_exclusive_monitor_map.empty()) return;
   xtsc_address wrt_beg = address8;
   xtsc_address wrt_end = address8 + size8 - 1;
-  for (map<u64, address_range>::iterator i = m_exclusive_monitor_map.begin(); i != m_exclusive_monitor_map.end();) {
-    address_range& range = i->second;
-    xtsc_address mon_beg = range.first;
-    xtsc_address mon_end = range.second;
-    XTSC_DEBUG(m_text, request << ": Check monitor 0x" << hex << i->first << ":0x" << range.first << "-0x" << range.second);
-    if ((wrt_end >= mon_beg) && (wrt_beg <= mon_end)) {
-      XTSC_INFO(m_text, request << ": Delete monitor 0x" << hex << i->first << ":0x" << range.first << "-0x" << range.second);
-      m_exclusive_monitor_map.erase(i++);
-    }
-    else {
-      ++i;
+  bool         hit     = false;
+  for (xtsc_address granule = (wrt_beg >> exclusive_granule_log2); granule <= (wrt_end >> exclusive_granule_log2); ++granule) {
+    map<xtsc_address, vector<u64> >::iterator ig = m_exclusive_granule_map.find(granule);
+    if (ig == m_exclusive_granule_map.end()) continue;
+    vector<u64> ids(ig->second);        // Copy because index_exclusive_monitor() modifies the granule's list
+    for (vector<u64>::const_iterator it = ids.begin(); it != ids.end(); ++it) {
+      map<u64, address_range>::iterator i = m_exclusive_monitor_map.find(*it);
+      if (i == m_exclusive_monitor_map.end()) continue;
+      address_range range = i->second;
+      if ((wrt_end >= range.first) && (wrt_beg <= range.second)) {
+        XTSC_INFO(m_text, request << ": Delete monitor 0x" << hex << i->first << ":0x" << range.first << "-0x" << range.second);
+        index_exclusive_monitor(i->first, range.first, range.second, false);
+        m_exclusive_monitor_map.erase(i);
+        hit = true;
+      }
     }
   }
+  if (hit) {
+    m_exclusive_monitor_hits += 1;
+  }
+  else {
+    m_exclusive_monitor_misses += 1;
+  }
 }
 
 
@@ -2083,7 +2240,7 @@ void xtsc_component::xtsc_memory::worker_thread(void) {
 void xtsc_component::xtsc_memory::do_active_request(u32 port_num) {
   bool drop_on_floor = false;
   xtsc_request *p_request       = &m_p_active_request_info[port_num]->m_request;
-  m_p_active_response[port_num] = new xtsc_response(m_p_active_request_info[port_num]->m_request);
+  m_p_active_response[port_num] = new_response(m_p_active_request_info[port_num]->m_request);
   bool list = false;
   xtsc_response::status_t drop_status;
   xtsc_response::status_t status = get_status_for_testing_failures(m_p_active_request_info[port_num], port_num, list);
@@ -2191,8 +2348,7 @@ void xtsc_component::xtsc_memory::do_active_request(u32 port_num) {
   }
   m_last_action_time_stamp[port_num] = sc_time_stamp();
   delete_request_info(m_p_active_request_info[port_num]);
-  delete m_p_active_response[port_num];
-  m_p_active_response[port_num] = NULL;
+  delete_response(m_p_active_response[port_num]);
 }
 
 
@@ -2475,6 +2631,7 @@ void xtsc_component::xtsc_memory::do_rcw(u32 port_num) {
     if (compare_data_matches) {
       mem_offset  = get_page_offset(address8);
       xtsc_byte_enables all_be = ((size8 == 64) ? 0xFFFFFFFFFFFFFFFFull : ((1ull << size8) - 1));
+      if (m_p_checkpoint) { m_p_checkpoint->before_write_page(page); }
       if ((bytes & all_be) == all_be) {
         memcpy(m_p_memory->m_page_table[page]+mem_offset, buffer, size8);
         m_statistics[port_num]->m_active_stats_interval->m_num_write_bytes_xfered += size8;
@@ -2540,6 +2697,7 @@ void xtsc_component::xtsc_memory::do_write(u32 port_num) {
     xtsc_byte_enables bytes = byte_enables;
     xtsc_byte_enables all_be = ((size8 == 64) ? 0xFFFFFFFFFFFFFFFFull : ((1ull << size8) - 1));
     if (m_host_mutex) { m_p_memory->lock(address8); }
+    if (m_p_checkpoint) { m_p_checkpoint->before_write_page(page); }
     if ((bytes & all_be) == all_be) {
       memcpy(m_p_memory->m_page_table[page]+mem_offset, buffer, size8);
       m_statistics[port_num]->m_active_stats_interval->m_num_write_bytes_xfered += size8;
@@ -2619,6 +2777,7 @@ void xtsc_component::xtsc_memory::do_block_write(u32 port_num) {
     xtsc_byte_enables bytes = byte_enables;
     xtsc_byte_enables all_be = ((size8 == 64) ? 0xFFFFFFFFFFFFFFFFull : ((1ull << size8) - 1));
     if (m_host_mutex) { m_p_memory->lock(address8); }
+    if (m_p_checkpoint) { m_p_checkpoint->before_write_page(page); }
     if ((bytes & all_be) == all_be) {
       memcpy(m_p_memory->m_page_table[page]+mem_offset, buffer, size8);
       m_statistics[port_num]->m_active_stats_interval->m_num_write_bytes_xfered += size8;
@@ -2781,6 +2940,7 @@ void xtsc_component::xtsc_memory::do_burst_write(u32 port_num) {
       xtsc_byte_enables bytes = byte_enables;
       xtsc_byte_enables all_be = ((size8 == 64) ? 0xFFFFFFFFFFFFFFFFull : ((1ull << size8) - 1));
       if (m_host_mutex) { m_p_memory->lock(address8); }
+      if (m_p_checkpoint) { m_p_checkpoint->before_write_page(page); }
       if ((bytes & all_be) == all_be) {
         memcpy(m_p_memory->m_page_table[page]+mem_offset, buffer, size8);
         m_statistics[port_num]->m_active_stats_interval->m_num_write_bytes_xfered += size8;
@@ -2868,27 +3028,351 @@ xtsc_component::xtsc_memory::request_info *xtsc_component::xtsc_memory::new_requ
                                                                                          xtsc_response::status_t status,
                                                                                          bool                    list)
 {
-  if (m_request_pool.empty()) {
-    XTSC_DEBUG(m_text, "Creating a new request_info");
-    return new request_info(request, status, list);
-  }
-  else {
-    request_info *p_request_info = m_request_pool.back();
-    m_request_pool.pop_back();
-    p_request_info->init(request, status, list);
-    return p_request_info;
-  }
+  return m_request_info_allocator.create<request_info>(request, status, list);
 }
 
 
 
 void xtsc_component::xtsc_memory::delete_request_info(request_info*& p_request_info) {
-  m_request_pool.push_back(p_request_info);
+  m_request_info_allocator.destroy(p_request_info);
   p_request_info = 0;
 }
 
 
 
+xtsc_response *xtsc_component::xtsc_memory::new_response(const xtsc_request& request) {
+  return m_response_allocator.create<xtsc_response>(request);
+}
+
+
+
+void xtsc_component::xtsc_memory::delete_response(xtsc_response*& p_response) {
+  m_response_allocator.destroy(p_response);
+  p_response = 0;
+}
+
+
+
+void xtsc_component::xtsc_memory::create_mmap_storage(u32 mmap_huge_pages) {
+#if defined(_WIN32)
+  ostringstream oss;
+  oss << kind() << " '" << name() << "': \"mmap_storage\" is not supported on MS Windows";
+  throw xtsc_exception(oss.str());
+#else
+  if (m_host_shared_memory) {
+    ostringstream oss;
+    oss << kind() << " '" << name() << "': \"mmap_storage\" and \"host_shared_memory\" cannot both be true";
+    throw xtsc_exception(oss.str());
+  }
+  if (mmap_huge_pages > 2) {
+    ostringstream oss;
+    oss << kind() << " '" << name() << "': \"mmap_huge_pages\"=" << mmap_huge_pages << " is invalid (must be 0, 1, or 2)";
+    throw xtsc_exception(oss.str());
+  }
+
+  u32 num_pages = m_p_memory->m_num_pages;
+  u64 page_size = m_p_memory->m_page_size8;
+  int flags     = MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE;
+  m_mmap_size8  = num_pages * page_size;
+  if (mmap_huge_pages == 2) {
+#if defined(MAP_HUGETLB)
+    // Explicit huge page mappings must be a multiple of the huge page size (assume 1GB to cover both 2MB and 1GB)
+    u64 huge_page_size = 1024*1024*1024;
+    m_mmap_size8 = (m_mmap_size8 + huge_page_size - 1) & ~(huge_page_size - 1);
+    flags |= MAP_HUGETLB;
+#else
+    ostringstream oss;
+    oss << kind() << " '" << name() << "': \"mmap_huge_pages\"=2 is not supported on this host (no MAP_HUGETLB)";
+    throw xtsc_exception(oss.str());
+#endif
+  }
+
+  void *p_mmap = mmap(NULL, m_mmap_size8, PROT_READ | PROT_WRITE, flags, -1, 0);
+  if (p_mmap == MAP_FAILED) {
+    ostringstream oss;
+    oss << kind() << " '" << name() << "': mmap() of 0x" << hex << m_mmap_size8 << " bytes for \"mmap_storage\" failed: "
+        << strerror(errno);
+    throw xtsc_exception(oss.str());
+  }
+  m_mmap_base = (u8 *) p_mmap;
+
+  if (mmap_huge_pages == 1) {
+#if defined(MADV_HUGEPAGE)
+    if (madvise(m_mmap_base, m_mmap_size8, MADV_HUGEPAGE)) {
+      XTSC_WARN(m_text, "madvise(MADV_HUGEPAGE) failed for \"mmap_storage\" (continuing with normal pages): " << strerror(errno));
+    }
+#else
+    XTSC_WARN(m_text, "Transparent huge pages are not supported on this host (continuing with normal pages)");
+#endif
+  }
+
+  // Any pages xtsc_memory_b has allocated so far (from "initial_value_file") are kept so that
+  // load_initial_values_into_mmap_storage() can copy them and so they can be given back at the end
+  m_mmap_owned_pages.assign(num_pages, (u8*) NULL);
+  for (u32 i=0; i<num_pages; ++i) {
+    m_mmap_owned_pages[i] = m_p_memory->m_page_table[i];
+    m_p_memory->m_page_table[i] = m_mmap_base + i * page_size;
+  }
+#endif
+}
+
+
+
+void xtsc_component::xtsc_memory::destroy_mmap_storage() {
+#if defined(_WIN32)
+#else
+  if (!m_mmap_base) return;
+  for (u32 i=0; i<m_mmap_owned_pages.size(); ++i) {
+    m_p_memory->m_page_table[i] = m_mmap_owned_pages[i];
+  }
+  m_mmap_owned_pages.clear();
+  munmap(m_mmap_base, m_mmap_size8);
+  m_mmap_base  = NULL;
+  m_mmap_size8 = 0;
+#endif
+}
+
+
+
+void xtsc_component::xtsc_memory::load_initial_values_into_mmap_storage() {
+#if defined(_WIN32)
+#else
+  u32 num_pages = m_p_memory->m_num_pages;
+  u64 page_size = m_p_memory->m_page_size8;
+
+  // Let xtsc_memory_b fill its own pages and load "initial_value_file" into them (allocating more as needed)
+  for (u32 i=0; i<num_pages; ++i) {
+    m_p_memory->m_page_table[i] = m_mmap_owned_pages[i];
+  }
+  m_p_memory->load_initial_values();
+
+  // Drop all previous contents (the OS supplies zero-filled pages on demand)
+  if (madvise(m_mmap_base, m_mmap_size8, MADV_DONTNEED)) {
+    memset(m_mmap_base, 0, m_mmap_size8);
+  }
+  if (m_p_memory->m_memory_fill_byte) {
+    memset(m_mmap_base, m_p_memory->m_memory_fill_byte, num_pages * page_size);
+  }
+
+  u32 num_loaded = 0;
+  for (u32 i=0; i<num_pages; ++i) {
+    u8 *p_page = m_mmap_base + i * page_size;
+    m_mmap_owned_pages[i] = m_p_memory->m_page_table[i];
+    if (m_mmap_owned_pages[i]) {
+      memcpy(p_page, m_mmap_owned_pages[i], page_size);
+      num_loaded += 1;
+    }
+    m_p_memory->m_page_table[i] = p_page;
+  }
+  XTSC_DEBUG(m_text, "load_initial_values() copied " << num_loaded << " initialized pages into mmap storage");
+#endif
+}
+
+
+
+void xtsc_component::xtsc_memory::load_image_files() {
+  m_image_bytes_loaded = 0;
+  m_image_load_seconds = 0.0;
+  if (m_elf_file.empty() && m_binary_file.empty()) return;
+  if (m_host_shared_memory) {
+    ostringstream oss;
+    oss << kind() << " '" << name() << "': \"elf_file\" and \"binary_file\" cannot be set when \"host_shared_memory\" is true";
+    throw xtsc_exception(oss.str());
+  }
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+  if (!m_elf_file.empty()) {
+    m_image_bytes_loaded += load_image_file(m_elf_file, true);
+  }
+  if (!m_binary_file.empty()) {
+    m_image_bytes_loaded += load_image_file(m_binary_file, false);
+  }
+  m_image_load_seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+  XTSC_DEBUG(m_text, "load_image_files() loaded " << m_image_bytes_loaded << " bytes in " << m_image_load_seconds << " seconds");
+}
+
+
+
+u64 xtsc_component::xtsc_memory::load_image_file(const string& file_name, bool is_elf) {
+  const u8     *p_file  = NULL;
+  u64           size    = 0;
+  int           fd      = -1;
+#if defined(_WIN32)
+  vector<u8>    contents;
+  ifstream      file(file_name.c_str(), ios::in | ios::binary);
+  if (!file) {
+    ostringstream oss;
+    oss << kind() << " '" << name() << "': Cannot open " << (is_elf ? "\"elf_file\"" : "\"binary_file\"") << " '" << file_name << "'";
+    throw xtsc_exception(oss.str());
+  }
+  contents.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+  size   = contents.size();
+  p_file = size ? &contents[0] : NULL;
+#else
+  fd = open(file_name.c_str(), O_RDONLY);
+  struct stat file_stat;
+  if ((fd < 0) || fstat(fd, &file_stat)) {
+    ostringstream oss;
+    oss << kind() << " '" << name() << "': Cannot open " << (is_elf ? "\"elf_file\"" : "\"binary_file\"") << " '" << file_name
+        << "': " << strerror(errno);
+    if (fd >= 0) close(fd);
+    throw xtsc_exception(oss.str());
+  }
+  size = file_stat.st_size;
+  if (size) {
+    void *p_mmap = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p_mmap == MAP_FAILED) {
+      ostringstream oss;
+      oss << kind() << " '" << name() << "': mmap() of '" << file_name << "' failed: " << strerror(errno);
+      close(fd);
+      throw xtsc_exception(oss.str());
+    }
+    p_file = (const u8 *) p_mmap;
+  }
+#endif
+
+  u64 loaded = 0;
+  xtsc_address span8 = m_end_address8 - m_start_address8;      // Byte size of memory minus 1
+
+  try {
+    if (!is_elf) {
+      if (m_binary_file_offset <= span8) {
+        u64 bytes = min(size, span8 - m_binary_file_offset + 1);
+        load_image_bytes(m_start_address8 + m_binary_file_offset, p_file, bytes, fd, 0);
+        loaded = bytes;
+      }
+      XTSC_DEBUG(m_text, "Loaded 0x" << hex << loaded << " bytes of \"binary_file\" '" << file_name << "' at 0x" <<
+                         (m_start_address8 + m_binary_file_offset));
+    }
+    else {
+      if ((size < 52) || (p_file[0] != 0x7F) || (p_file[1] != 'E') || (p_file[2] != 'L') || (p_file[3] != 'F') ||
+          ((p_file[4] != 1) && (p_file[4] != 2)) || ((p_file[5] != 1) && (p_file[5] != 2)))
+      {
+        ostringstream oss;
+        oss << kind() << " '" << name() << "': \"elf_file\" '" << file_name << "' is not a valid 32 or 64 bit ELF file";
+        throw xtsc_exception(oss.str());
+      }
+      bool is_64    = (p_file[4] == 2);
+      bool is_big   = (p_file[5] == 2);
+      // Read a num_bytes wide field at offset in the ELF file's byte order
+      auto field = [&](u64 offset, u32 num_bytes) -> u64 {
+        if ((offset > size) || (num_bytes > size - offset)) {
+          ostringstream oss;
+          oss << kind() << " '" << name() << "': \"elf_file\" '" << file_name << "' is truncated (need 0x" << hex << num_bytes
+              << " bytes at offset 0x" << offset << " but file size is 0x" << size << ")";
+          throw xtsc_exception(oss.str());
+        }
+        u64 value = 0;
+        for (u32 i=0; i<num_bytes; ++i) {
+          u32 shift = 8 * (is_big ? (num_bytes - 1 - i) : i);
+          value |= ((u64) p_file[offset + i]) << shift;
+        }
+        return value;
+      };
+      u64 phoff     = is_64 ? field(32, 8) : field(28, 4);
+      u64 phentsize = is_64 ? field(54, 2) : field(42, 2);
+      u64 phnum     = is_64 ? field(56, 2) : field(44, 2);
+      for (u64 i=0; i<phnum; ++i) {
+        u64 ph = phoff + i * phentsize;
+        const u32 PT_LOAD = 1;
+        if (field(ph, 4) != PT_LOAD) continue;
+        u64 offset = is_64 ? field(ph +  8, 8) : field(ph +  4, 4);
+        u64 paddr  = is_64 ? field(ph + 24, 8) : field(ph + 12, 4);
+        u64 filesz = is_64 ? field(ph + 32, 8) : field(ph + 16, 4);
+        u64 memsz  = is_64 ? field(ph + 40, 8) : field(ph + 20, 4);
+        if ((offset > size) || (filesz > size - offset) || (filesz > memsz)) {
+          ostringstream oss;
+          oss << kind() << " '" << name() << "': \"elf_file\" '" << file_name << "' program header #" << i
+              << " has invalid p_offset/p_filesz/p_memsz";
+          throw xtsc_exception(oss.str());
+        }
+        if (!memsz) continue;
+        // Clip the segment to this memory
+        xtsc_address low  = max((xtsc_address) paddr, m_start_address8);
+        xtsc_address high = min((xtsc_address) (paddr + memsz - 1), m_end_address8);
+        if (low > high) continue;
+        if (filesz && (low < paddr + filesz)) {
+          xtsc_address file_high = min((xtsc_address) (paddr + filesz - 1), high);
+          u64 bytes = file_high - low + 1;
+          load_image_bytes(low, p_file + offset + (low - paddr), bytes, fd, offset + (low - paddr));
+          loaded += bytes;
+        }
+        xtsc_address zero_low = max(low, (xtsc_address) (paddr + filesz));
+        if (zero_low <= high) {
+          load_image_bytes(zero_low, NULL, high - zero_low + 1, -1, 0);
+        }
+        XTSC_DEBUG(m_text, "Loaded PT_LOAD segment #" << i << " of \"elf_file\" '" << file_name << "' into [0x" << hex << low
+                           << "-0x" << high << "]");
+      }
+    }
+  }
+  catch (...) {
+#if !defined(_WIN32)
+    if (p_file) munmap((void*) p_file, size);
+    close(fd);
+#endif
+    throw;
+  }
+
+#if !defined(_WIN32)
+  if (p_file) munmap((void*) p_file, size);
+  close(fd);
+#endif
+
+  return loaded;
+}
+
+
+
+void xtsc_component::xtsc_memory::load_image_bytes(xtsc_address address8, const u8 *p_data, u64 size8, int fd, u64 file_offset) {
+  if (!size8) return;
+
+  if (m_mmap_base) {
+    u64 offset8 = address8 - m_start_address8;
+    u8 *p_dst   = m_mmap_base + offset8;
+#if !defined(_WIN32)
+    if (p_data && (fd >= 0) && (m_mmap_huge_pages == 0)) {
+      // Map whole host pages copy-on-write from the file (file offset and storage offset must be congruent)
+      u64 host_page = (u64) sysconf(_SC_PAGESIZE);
+      u64 head      = (host_page - (offset8 & (host_page - 1))) & (host_page - 1);
+      if ((head < size8) && (((file_offset + head) & (host_page - 1)) == 0)) {
+        u64 body = (size8 - head) & ~(host_page - 1);
+        if (body && (mmap(p_dst + head, body, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, file_offset + head) != MAP_FAILED)) {
+          memcpy(p_dst, p_data, head);
+          memcpy(p_dst + head + body, p_data + head + body, size8 - head - body);
+          return;
+        }
+      }
+    }
+#endif
+    if (p_data) {
+      memcpy(p_dst, p_data, size8);
+    }
+    else {
+      memset(p_dst, 0, size8);
+    }
+    return;
+  }
+
+  u64 page_size8 = m_p_memory->m_page_size8;
+  while (size8) {
+    u32 page   = get_page(address8);
+    u32 offset = get_page_offset(address8);
+    u64 chunk  = min(size8, page_size8 - offset);
+    u8 *p_dst  = m_p_memory->m_page_table[page] + offset;
+    if (p_data) {
+      memcpy(p_dst, p_data, chunk);
+      p_data += chunk;
+    }
+    else {
+      memset(p_dst, 0, chunk);
+    }
+    address8 += chunk;
+    size8    -= chunk;
+  }
+}
+
+
+
 void xtsc_component::xtsc_memory::xtsc_request_if_impl::nb_peek(xtsc_address address8, u32 size8, u8 *buffer) {
   m_memory.peek(address8, size8, buffer);
   if (m_memory.m_filter_peeks) {
@@ -2940,6 +3424,19 @@ bool xtsc_component::xtsc_memory::xtsc_request_if_impl::nb_fast_access(xtsc_fast
   xtsc_address page_start8 = address8 & ~(m_memory.m_p_memory->m_page_size8 - 1);
   xtsc_address page_end8   = page_start8 + m_memory.m_p_memory->m_page_size8 - 1;
 
+  if (m_memory.m_mmap_base) {
+    // With "mmap_storage" the whole memory is contiguous so grant as much as a raw access block can describe
+    xtsc_address block_size8 = 0x80000000;
+    if (m_memory.m_end_address8 - m_memory.m_start_address8 < block_size8) {
+      page_start8 = m_memory.m_start_address8;
+      page_end8   = m_memory.m_end_address8;
+    }
+    else {
+      page_start8 = m_memory.m_start_address8 + ((address8 - m_memory.m_start_address8) & ~(block_size8 - 1));
+      page_end8   = min(page_start8 + block_size8 - 1, m_memory.m_end_address8);
+    }
+  }
+
   if ((address8 < m_memory.m_start_address8) || (address8 > m_memory.m_end_address8)) {
     ostringstream oss;
     oss << "Memory access out-of-range (address=0x" << hex << address8 << ") in nb_fast_access() of memory '"
@@ -2957,14 +3454,23 @@ bool xtsc_component::xtsc_memory::xtsc_request_if_impl::nb_fast_access(xtsc_fast
   }
   
   string access("raw access");
-  if (m_memory.m_use_raw_access) {
-    u32 page = m_memory.get_page(address8);
-    u8 *raw_bytes = m_memory.m_p_memory->m_page_table[page];
-    request.allow_raw_access(page_start8, (u32*)raw_bytes, m_memory.m_p_memory->m_page_size8, 0);
+  bool checkpoint = (m_memory.m_p_checkpoint && m_memory.m_p_checkpoint->is_active());
+  if (m_memory.m_use_raw_access && !checkpoint) {
+    if (m_memory.m_mmap_base) {
+      u8 *raw_bytes = m_memory.m_mmap_base + (page_start8 - m_memory.m_start_address8);
+      request.allow_raw_access(page_start8, (u32*)raw_bytes, (u32) (page_end8 - page_start8 + 1), 0);
+    }
+    else {
+      u32 page = m_memory.get_page(address8);
+      u8 *raw_bytes = m_memory.m_p_memory->m_page_table[page];
+      request.allow_raw_access(page_start8, (u32*)raw_bytes, m_memory.m_p_memory->m_page_size8, 0);
+    }
     xtsc_fast_access_block page_block(address8, page_start8, page_end8);
     request.restrict_to_block(page_block);
+    m_memory.m_raw_access_blocks[page_start8] = page_end8;
   }
-  else if (m_memory.m_use_callback_access) {
+  else if (m_memory.m_use_callback_access || m_memory.m_use_raw_access) {
+    // Raw access is downgraded to callback access while a checkpoint is active so that writes can be seen
     request.allow_callbacks_access(&m_memory, read_callback, write_callback);
     access = "callback access";
   }
@@ -3327,7 +3833,7 @@ void xtsc_component::xtsc_memory::script_thread() {
       }
       else if (m_words[0] == "user_data") {
         if (m_user_data_type == 2) {
-          delete [] m_p_user_data;
+          m_user_data_allocator.deallocate(m_p_user_data, m_user_data_length);
         }
         if (m_words.size() == 1) {
           m_user_data_length = 0;
@@ -3344,7 +3850,7 @@ void xtsc_component::xtsc_memory::script_thread() {
         else {
           if (m_words[1] == "*") {
             m_user_data_length = m_words.size() - 2;
-            m_p_user_data      = new u8[m_user_data_length];
+            m_p_user_data      = (u8 *) m_user_data_allocator.allocate(m_user_data_length);
             m_user_data_type   = 2;
             for (u32 i=0; i < m_user_data_length; ++i) {
               m_p_user_data[i] = (u8) get_u32(i+2, "byte");
@@ -0,0 +1,112 @@
+// Copyright (c) 2005-2018 by Cadence Design Systems, Inc.  ALL RIGHTS RESERVED.
+// These coded instructions, statements, and computer programs are the
+// copyrighted works and confidential proprietary information of Cadence Design Systems, Inc.
+// They may not be modified, copied, reproduced, distributed, or disclosed to
+// third parties in any manner, medium, or form, in whole or in part, without
+// the prior written consent of Cadence Design Systems, Inc.
+
+#include <cstring>
+#include <sstream>
+#include <xtsc/xtsc_memory_checkpoint.h>
+
+
+using namespace std;
+using namespace xtsc;
+
+
+
+xtsc_component::xtsc_memory_checkpoint::xtsc_memory_checkpoint(xtsc_memory_b& memory) :
+  m_memory      (memory),
+  m_active      (false)
+{
+}
+
+
+
+xtsc_component::xtsc_memory_checkpoint::~xtsc_memory_checkpoint() {
+  discard();
+}
+
+
+
+void xtsc_component::xtsc_memory_checkpoint::save() {
+  if (m_memory.m_host_shared_memory) {
+    ostringstream oss;
+    oss << m_memory.m_kind << " '" << m_memory.m_name << "': checkpoints are not supported when \"host_shared_memory\" is true";
+    throw xtsc_exception(oss.str());
+  }
+  discard();
+  m_saved_pages.assign(m_memory.m_num_pages, (u8*) NULL);
+  m_active = true;
+}
+
+
+
+u32 xtsc_component::xtsc_memory_checkpoint::restore() {
+  if (!m_active) {
+    ostringstream oss;
+    oss << m_memory.m_kind << " '" << m_memory.m_name << "': cannot restore checkpoint because none has been saved";
+    throw xtsc_exception(oss.str());
+  }
+  u64 page_size8 = m_memory.m_page_size8;
+  for (vector<u32>::const_iterator i = m_saved_page_list.begin(); i != m_saved_page_list.end(); ++i) {
+    u32 page = *i;
+    if (!m_memory.m_page_table[page]) {
+      m_memory.get_page(m_memory.m_start_address8 + page * page_size8);
+    }
+    memcpy(m_memory.m_page_table[page], m_saved_pages[page], page_size8);
+  }
+  return (u32) m_saved_page_list.size();
+}
+
+
+
+void xtsc_component::xtsc_memory_checkpoint::discard() {
+  for (vector<u32>::const_iterator i = m_saved_page_list.begin(); i != m_saved_page_list.end(); ++i) {
+    delete [] m_saved_pages[*i];
+  }
+  m_saved_page_list.clear();
+  m_saved_pages.clear();
+  m_active = false;
+}
+
+
+
+void xtsc_component::xtsc_memory_checkpoint::preserve_range(xtsc_address low_address8, xtsc_address high_address8) {
+  if (!m_active) return;
+  low_address8  = max(low_address8,  m_memory.m_start_address8);
+  high_address8 = min(high_address8, m_memory.m_end_address8);
+  if (low_address8 > high_address8) return;
+  u32 first = m_memory.get_page_id(low_address8);
+  u32 last  = m_memory.get_page_id(high_address8);
+  for (u32 page = first; page <= last; ++page) {
+    before_write_page(page);
+  }
+}
+
+
+
+void xtsc_component::xtsc_memory_checkpoint::preserve_all() {
+  if (!m_active) return;
+  for (u32 page = 0; page < m_memory.m_num_pages; ++page) {
+    if (m_memory.m_page_table[page]) {
+      before_write_page(page);
+    }
+  }
+}
+
+
+
+void xtsc_component::xtsc_memory_checkpoint::preserve(u32 page) {
+  u64 page_size8 = m_memory.m_page_size8;
+  u8 *p_saved    = new u8[page_size8];
+  if (m_memory.m_page_table[page]) {
+    memcpy(p_saved, m_memory.m_page_table[page], page_size8);
+  }
+  else {
+    // An unallocated page reads as the fill byte
+    memset(p_saved, m_memory.m_memory_fill_byte, page_size8);
+  }
+  m_saved_pages[page] = p_saved;
+  m_saved_page_list.push_back(page);
+}
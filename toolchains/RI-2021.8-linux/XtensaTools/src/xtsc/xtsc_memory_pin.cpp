@@ -8,6 +8,7 @@
 // written consent of Cadence Design Systems, Inc.
 
 #include <iostream>
+#include <iomanip>
 #include <algorithm>
 #include <xtsc/xtsc_fast_access.h>
 #include <xtsc/xtsc_memory_pin.h>
@@ -379,6 +380,10 @@ xtsc_component::xtsc_memory_pin::xtsc_memory_pin(sc_module_name module_name, con
                                 ::get_split_rw  (memory_parms),
                                 ::get_dma       (memory_parms),
                                 ::get_subbanks  (memory_parms)),
+  m_allocator           (name()),
+  m_num_pif_req_infos   (0),
+  m_num_axi_addr_infos  (0),
+  m_num_axi_data_infos  (0),
   m_num_ports           (memory_parms.get_non_zero_u32("num_ports")),
   m_num_axi_rd_ports    (0),
   m_num_axi_wr_ports    (0),
@@ -451,6 +456,7 @@ xtsc_component::xtsc_memory_pin::xtsc_memory_pin(sc_module_name module_name, con
   m_respond_event               = 0;
   m_axi_rd_rsp_event            = 0;
   m_axi_wr_data_event           = 0;
+  m_axi_wr_addr_event           = 0;
   m_axi_wr_rsp_event            = 0;
   m_axi_addr_rdy_event          = 0;
   m_axi_data_rdy_event          = 0;
@@ -504,6 +510,7 @@ xtsc_component::xtsc_memory_pin::xtsc_memory_pin(sc_module_name module_name, con
   m_has_busy            = memory_parms.get_bool("has_busy");
   m_has_lock            = memory_parms.get_bool("has_lock");
   m_has_xfer_en         = memory_parms.get_bool("has_xfer_en");
+  m_activity_driven     = memory_parms.get_bool("activity_driven");
   m_busy_percentage     = (i32) memory_parms.get_u32 ("busy_percentage");
   m_data_busy_percentage= (i32) memory_parms.get_u32 ("data_busy_percentage");
   m_cbox                = memory_parms.get_bool("cbox");
@@ -773,6 +780,7 @@ xtsc_component::xtsc_memory_pin::xtsc_memory_pin(sc_module_name module_name, con
     m_testing_busy_data         = new bool                      [m_num_ports];
     m_axi_rd_rsp_event          = new sc_event                  [m_num_ports];
     m_axi_wr_data_event         = new sc_event                  [m_num_ports];
+    m_axi_wr_addr_event         = new sc_event                  [m_num_ports];
     m_axi_wr_rsp_event          = new sc_event                  [m_num_ports];
     m_axi_addr_rdy_event        = new sc_event                  [m_num_ports];
     m_axi_data_rdy_event        = new sc_event                  [m_num_ports];
@@ -1693,6 +1701,11 @@ xtsc_component::xtsc_memory_pin::xtsc_memory_pin(sc_module_name module_name, con
       "Poke <NumBytes> (=N) of memory starting at <StartAddress>."
   );
 
+  xtsc_register_command(*this, *this, "summary", 0, 0,
+      "summary", 
+      "Call xtsc_memory_pin::summary()."
+  );
+
   // Log our construction
   log4xtensa::LogLevel ll = xtsc_get_constructor_log_level();
   XTSC_LOG(m_text, ll, "Constructed " << kind() << " '" << name() << "':");
@@ -1734,6 +1747,7 @@ xtsc_component::xtsc_memory_pin::xtsc_memory_pin(sc_module_name module_name, con
   XTSC_LOG(m_text, ll, " initial_value_file     = "   << hex        << m_p_memory->m_initial_value_file);
   XTSC_LOG(m_text, ll, " memory_fill_byte       = 0x" << hex        << (u32) m_p_memory->m_memory_fill_byte);
   XTSC_LOG(m_text, ll, " vcd_handle             = "                 << m_p_trace_file);
+  XTSC_LOG(m_text, ll, " activity_driven        = "   << boolalpha  << m_activity_driven);
   if (clock_period == 0xFFFFFFFF) {
   XTSC_LOG(m_text, ll, " clock_period           = 0xFFFFFFFF => "   << m_clock_period.value() << " (" << m_clock_period << ")");
   } else {
@@ -1976,10 +1990,13 @@ void xtsc_component::xtsc_memory_pin::execute(const string&                 cmd_
   else if (words[0] == "dump_debug_info") {
     if (is_pif_or_idma(m_interface_type)) {
       res << "m_pif_req_pool.size()=" << m_pif_req_pool.size() << endl;
+      res << "m_num_pif_req_infos=" << m_num_pif_req_infos << endl;
     }
     else if (is_axi_or_idma(m_interface_type)) {
       res << "m_axi_addr_pool.size()=" << m_axi_addr_pool.size() << endl;
       res << "m_axi_data_pool.size()=" << m_axi_data_pool.size() << endl;
+      res << "m_num_axi_addr_infos=" << m_num_axi_addr_infos << endl;
+      res << "m_num_axi_data_infos=" << m_num_axi_data_infos << endl;
     }
     else if (is_apb(m_interface_type)) {
       ; // Do nothing
@@ -2036,6 +2053,9 @@ void xtsc_component::xtsc_memory_pin::execute(const string&                 cmd_
       delete [] buffer;
     }
   }
+  else if (words[0] == "summary") {
+    summary(res);
+  }
   else {
     ostringstream oss;
     oss << name() << "::" << __FUNCTION__ << "() called for unknown command '" << cmd_line << "'.";
@@ -2047,6 +2067,16 @@ void xtsc_component::xtsc_memory_pin::execute(const string&                 cmd_
 
 
 
+void xtsc_component::xtsc_memory_pin::summary(ostream& os) {
+  os << endl;
+  os << std::left << std::setw(18) << "XTSC Memory Pin"   << " : \"" << name() << "\"" << endl;
+  os << std::left << std::setw(18) << "Peak pool usage"   << " : "   << m_num_pif_req_infos << " pif_req_info, "
+                                                                     << m_num_axi_addr_infos << " axi_addr_info, "
+                                                                     << m_num_axi_data_infos << " axi_data_info" << endl;
+}
+
+
+
 xtsc::u32 xtsc_component::xtsc_memory_pin::connect(xtsc_tlm2pin_memory_transactor&      tlm2pin,
                                                    u32                                  tlm2pin_port,
                                                    u32                                  mem_port,
@@ -2326,6 +2356,7 @@ void xtsc_component::xtsc_memory_pin::reset(bool hard_reset) {
     if (m_respond_event)      m_respond_event     [port].cancel();
     if (m_axi_rd_rsp_event)   m_axi_rd_rsp_event  [port].cancel();
     if (m_axi_wr_data_event)  m_axi_wr_data_event [port].cancel();
+    if (m_axi_wr_addr_event)  m_axi_wr_addr_event [port].cancel();
     if (m_axi_wr_rsp_event)   m_axi_wr_rsp_event  [port].cancel();
     if (m_axi_addr_rdy_event) m_axi_addr_rdy_event[port].cancel();
     if (m_axi_data_rdy_event) m_axi_data_rdy_event[port].cancel();
@@ -3217,9 +3248,9 @@ void xtsc_component::xtsc_memory_pin::axi_req_addr_thread(void) {
             m_axi_rd_rsp_event[port].notify(SC_ZERO_TIME); // Notify axi_rd_rsp_thread()
           }
           else {
-            ;  // Do nothing:
-            //    m_axi_wr_data_event is notified from axi_req_data_thread()
-            //    m_axi_wr_rsp_event  is notified from axi_wr_data_thread()
+            // m_axi_wr_data_event is notified from axi_req_data_thread()
+            // m_axi_wr_rsp_event  is notified from axi_wr_data_thread()
+            m_axi_wr_addr_event[port].notify(SC_ZERO_TIME);     // Notify axi_wr_data_thread() if waiting for an address
           }
           m_axi_addr_rdy_event[port].notify(SC_ZERO_TIME);      // Notify axi_drive_addr_rdy_thread()
           XTSC_VERBOSE(m_text, *p_info << " (axi_req_addr_thread[" << port << "])");
@@ -3523,7 +3554,13 @@ void xtsc_component::xtsc_memory_pin::axi_wr_data_thread(void) {
                                 "), now waiting for Write Address channel.");
               first_time = false;
             }
-            wait(m_clock_period);
+            if (m_activity_driven) {
+              wait(m_axi_wr_addr_event[port]);
+              sync_to_drive_phase();
+            }
+            else {
+              wait(m_clock_period);
+            }
           }
           if (!first_time) {
             XTSC_INFO(m_text, "Port #" << port << " done waiting for Write Address channel.");
@@ -3662,12 +3699,21 @@ void xtsc_component::xtsc_memory_pin::apb_request_thread(void) {
       while (m_p_psel[port]->read()) {
         sc_time delay = m_drive_phase + (m_p_pwrite[port]->read() ? m_write_delay : m_read_delay);
         m_apb_req_event[port].notify(delay);
-        do {
-          wait(m_clock_period);
+        wait(m_clock_period);
+        while (true) {
           if (!m_p_penable[port]->read()) {
             throw xtsc_exception("PENABLE is low when APB protocol requires it to be high");
           }
-        } while (!m_p_pready[port]->read());
+          if (m_p_pready[port]->read()) break;
+          if (m_activity_driven) {
+            // Sleep until PREADY rises (or PENABLE falls) then re-check at the next sample phase
+            wait(m_p_pready[port]->posedge_event() | m_p_penable[port]->negedge_event());
+            sync_to_sample_phase();
+          }
+          else {
+            wait(m_clock_period);
+          }
+        }
         wait(m_clock_period);
       }
 
@@ -4340,7 +4386,8 @@ void xtsc_component::xtsc_memory_pin::swizzle_byte_enables(xtsc_byte_enables& by
 xtsc_component::xtsc_memory_pin::pif_req_info *xtsc_component::xtsc_memory_pin::new_pif_req_info(u32 port) {
   if (m_pif_req_pool.empty()) {
     XTSC_DEBUG(m_text, "Creating a new pif_req_info");
-    return new pif_req_info(*this, port);
+    m_num_pif_req_infos += 1;
+    return m_allocator.create<pif_req_info>(*this, port);
   }
   else {
     pif_req_info *p_pif_req_info = m_pif_req_pool.back();
@@ -4429,7 +4476,8 @@ ostream& operator<<(ostream& os, const xtsc_memory_pin::pif_req_info& info) {
 xtsc_component::xtsc_memory_pin::axi_addr_info *xtsc_component::xtsc_memory_pin::new_axi_addr_info(u32 port) {
   if (m_axi_addr_pool.empty()) {
     XTSC_DEBUG(m_text, "Creating a new axi_addr_info");
-    return new axi_addr_info(*this, port);
+    m_num_axi_addr_infos += 1;
+    return m_allocator.create<axi_addr_info>(*this, port);
   }
   else {
     axi_addr_info *p_axi_addr_info = m_axi_addr_pool.back();
@@ -4527,7 +4575,8 @@ ostream& operator<<(ostream& os, const xtsc_memory_pin::axi_addr_info& info) {
 xtsc_component::xtsc_memory_pin::axi_data_info *xtsc_component::xtsc_memory_pin::new_axi_data_info(u32 port) {
   if (m_axi_data_pool.empty()) {
     XTSC_DEBUG(m_text, "Creating a new axi_data_info");
-    return new axi_data_info(*this, port);
+    m_num_axi_data_infos += 1;
+    return m_allocator.create<axi_data_info>(*this, port);
   }
   else {
     axi_data_info *p_axi_data_info = m_axi_data_pool.back();
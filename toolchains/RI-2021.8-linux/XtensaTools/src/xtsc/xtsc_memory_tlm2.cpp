@@ -10,6 +10,7 @@
 
 #include <cstdlib>
 #include <ostream>
+#include <iomanip>
 #include <string>
 #include <xtsc/xtsc_memory_tlm2.h>
 #include <xtsc/xtsc_tlm2.h>
@@ -27,6 +28,14 @@ using namespace log4xtensa;
 
 
 
+// Track one more transaction in a peq and its high-water mark
+static inline void count_peq_entry(u32& count, u32& peak) {
+  count += 1;
+  if (count > peak) peak = count;
+}
+
+
+
 xtsc_component::xtsc_memory_tlm2_parms::xtsc_memory_tlm2_parms(const xtsc_core&  core,
                                                                const char       *memory_interface,
                                                                u32               delay,
@@ -113,6 +122,7 @@ xtsc_component::xtsc_memory_tlm2::xtsc_memory_tlm2(sc_module_name module_name, c
   m_num_ports                   (memory_parms.get_non_zero_u32  ("num_ports")),
   m_tlm_fw_transport_if_impl    (NULL),
   m_p_memory                    (NULL),
+  m_p_checkpoint                (NULL),
   m_nb2b_thread_peq             (NULL),
   m_port_nb2b_thread            (0),
   m_tlm_accepted_thread_peq     (NULL),
@@ -165,6 +175,10 @@ xtsc_component::xtsc_memory_tlm2::xtsc_memory_tlm2(sc_module_name module_name, c
   m_tlm_fw_transport_if_impl    = new tlm_fw_transport_if_impl         *[m_num_ports];
   m_nb2b_thread_peq             = new peq                              *[m_num_ports];
   m_tlm_accepted_thread_peq     = new peq                              *[m_num_ports];
+  m_nb2b_thread_peq_count        .assign(m_num_ports, 0);
+  m_nb2b_thread_peq_peak         .assign(m_num_ports, 0);
+  m_tlm_accepted_thread_peq_count.assign(m_num_ports, 0);
+  m_tlm_accepted_thread_peq_peak .assign(m_num_ports, 0);
 
   for (u32 i=0; i<m_num_ports; ++i) {
 
@@ -268,6 +282,12 @@ xtsc_component::xtsc_memory_tlm2::xtsc_memory_tlm2(sc_module_name module_name, c
       "Call xtsc_memory_tlm2::change_clock_period(<ClockPeriodFactor>).  Return previous <ClockPeriodFactor> for this device."
   );
 
+  xtsc_register_command(*this, *this, "checkpoint", 1, 1,
+      "checkpoint save|restore|discard", 
+      "Call xtsc_memory_tlm2::checkpoint_save(), xtsc_memory_tlm2::checkpoint_restore(), or xtsc_memory_tlm2::checkpoint_discard()."
+      "  For restore, return the number of pages restored."
+  );
+
   xtsc_register_command(*this, *this, "invalidate_direct_mem_ptr", 2, 3,
       "invalidate_direct_mem_ptr <StartAddress> <EndAddress> [<Port>]", 
       "Call xtsc_memory_tlm2::invalidate_direct_mem_ptr(<StartAddress>, <EndAddress>, <Port>).  Default <Port> is 0."
@@ -294,6 +314,11 @@ xtsc_component::xtsc_memory_tlm2::xtsc_memory_tlm2(sc_module_name module_name, c
       "Call xtsc_memory_tlm2::reset(<Hard>).  Where <Hard> is 0|1 (default 0)."
   );
 
+  xtsc_register_command(*this, *this, "summary", 0, 0,
+      "summary", 
+      "Call xtsc_memory_tlm2::summary()."
+  );
+
   if (!m_immediate_timing)
   xtsc_register_command(*this, *this, "test_end_req_phase", 1, 1,
       "test_end_req_phase 0|1", 
@@ -363,6 +388,10 @@ xtsc_component::xtsc_memory_tlm2::xtsc_memory_tlm2(sc_module_name module_name, c
 
 xtsc_component::xtsc_memory_tlm2::~xtsc_memory_tlm2(void) {
   XTSC_DEBUG(m_text, "In ~xtsc_memory_tlm2()");
+  if (m_p_checkpoint) {
+    delete m_p_checkpoint;
+    m_p_checkpoint = NULL;
+  }
   if (m_p_memory) {
     delete m_p_memory;
     m_p_memory = 0;
@@ -578,6 +607,22 @@ void xtsc_component::xtsc_memory_tlm2::execute(const string&                 cmd
     res << m_clock_period.value();
     change_clock_period(clock_period_factor);
   }
+  else if (words[0] == "checkpoint") {
+    if (words[1] == "save") {
+      checkpoint_save();
+    }
+    else if (words[1] == "restore") {
+      res << checkpoint_restore();
+    }
+    else if (words[1] == "discard") {
+      checkpoint_discard();
+    }
+    else {
+      ostringstream oss;
+      oss << "Command '" << cmd_line << "' has invalid argument '" << words[1] << "' (expected save|restore|discard).";
+      throw xtsc_exception(oss.str());
+    }
+  }
   else if (words[0] == "invalidate_direct_mem_ptr") {
     u64 start_address = xtsc_command_argtou64(cmd_line, words, 1);
     u64 end_address   = xtsc_command_argtou64(cmd_line, words, 2);
@@ -626,6 +671,9 @@ void xtsc_component::xtsc_memory_tlm2::execute(const string&                 cmd
   else if (words[0] == "reset") {
     reset((words.size() == 1) ? false : xtsc_command_argtobool(cmd_line, words, 1));
   }
+  else if (words[0] == "summary") {
+    summary(res);
+  }
   else if (words[0] == "test_end_req_phase") {
     bool new_value = xtsc_command_argtobool(cmd_line, words, 1);
     res << (m_test_end_req_phase ? 1 : 0);
@@ -766,6 +814,9 @@ void xtsc_component::xtsc_memory_tlm2::reset(bool hard_reset) {
   m_port_tlm_accepted_thread = 0;
 
   if (hard_reset) {
+    if (m_p_checkpoint) {
+      m_p_checkpoint->preserve_all();
+    }
     load_initial_values();
   }
 
@@ -774,6 +825,52 @@ void xtsc_component::xtsc_memory_tlm2::reset(bool hard_reset) {
 
 
 
+void xtsc_component::xtsc_memory_tlm2::summary(ostream& os) {
+  os << endl;
+  os << std::left << std::setw(18) << "XTSC Memory TLM2"  << " : \"" << name() << "\"" << endl;
+  for (u32 port=0; port<m_num_ports; ++port) {
+    os << std::left << std::setw(18) << "Peak peq usage"  << " : port " << port << ": "
+       << m_nb2b_thread_peq_peak[port] << " nb2b_thread, " << m_tlm_accepted_thread_peq_peak[port] << " tlm_accepted_thread" << endl;
+  }
+}
+
+
+
+void xtsc_component::xtsc_memory_tlm2::checkpoint_save() {
+  if (!m_p_checkpoint) {
+    m_p_checkpoint = new xtsc_memory_checkpoint(*m_p_memory);
+  }
+  m_p_checkpoint->save();
+  // Force initiators to come back for DMI so they only get read access while the checkpoint is active
+  for (u32 port=0; port<m_num_ports; ++port) {
+    invalidate_direct_mem_ptr(port, m_start_address8, m_end_address8);
+  }
+  XTSC_INFO(m_text, "checkpoint_save()");
+}
+
+
+
+u32 xtsc_component::xtsc_memory_tlm2::checkpoint_restore() {
+  if (!m_p_checkpoint || !m_p_checkpoint->is_active()) {
+    ostringstream oss;
+    oss << kind() << " '" << name() << "': checkpoint_restore() called but no checkpoint has been saved";
+    throw xtsc_exception(oss.str());
+  }
+  u32 num_pages = m_p_checkpoint->restore();
+  XTSC_INFO(m_text, "checkpoint_restore(): " << num_pages << " pages restored");
+  return num_pages;
+}
+
+
+
+void xtsc_component::xtsc_memory_tlm2::checkpoint_discard() {
+  if (m_p_checkpoint) {
+    m_p_checkpoint->discard();
+  }
+}
+
+
+
 void xtsc_component::xtsc_memory_tlm2::invalidate_direct_mem_ptr(u32 port, u64 start_address, u64 end_address) {
   u64 beg_range = (u64) start_address;
   u64 end_range = (u64) end_address;
@@ -797,6 +894,7 @@ void xtsc_component::xtsc_memory_tlm2::nb2b_thread(void) {
 
 #if ((defined(SC_API_VERSION_STRING) && (SC_API_VERSION_STRING != sc_api_version_2_2_0)) || IEEE_1666_SYSTEMC >= 201101L)  
   m_nb2b_thread_peq[port_num]->cancel_all();
+  m_nb2b_thread_peq_count[port_num] = 0;
 #endif
 
   try {
@@ -812,6 +910,7 @@ void xtsc_component::xtsc_memory_tlm2::nb2b_thread(void) {
 
       // Drain all transactions from m_nb2b_thread_peq that are due now
       while (tlm_generic_payload *p_trans = m_nb2b_thread_peq[port_num]->get_next_transaction()) { 
+        m_nb2b_thread_peq_count[port_num] -= 1;
 
         // Forward each transaction to b_transport() for handling 
         time = SC_ZERO_TIME;
@@ -852,6 +951,7 @@ void xtsc_component::xtsc_memory_tlm2::tlm_accepted_thread(void) {
 
 #if ((defined(SC_API_VERSION_STRING) && (SC_API_VERSION_STRING != sc_api_version_2_2_0)) || IEEE_1666_SYSTEMC >= 201101L)  
   m_tlm_accepted_thread_peq[port_num]->cancel_all();
+  m_tlm_accepted_thread_peq_count[port_num] = 0;
 #endif
 
   try {
@@ -867,6 +967,7 @@ void xtsc_component::xtsc_memory_tlm2::tlm_accepted_thread(void) {
 
       // Drain all transactions from m_tlm_accepted_thread_peq that are due now
       while (tlm_generic_payload *p_trans = m_tlm_accepted_thread_peq[port_num]->get_next_transaction()) { 
+        m_tlm_accepted_thread_peq_count[port_num] -= 1;
         if (m_test_end_req_phase) {
           // Send each transaction back to the TLM2 initiator.
           // We don't care about the tlm_sync_enum return value nor the gp response status.
@@ -883,6 +984,7 @@ void xtsc_component::xtsc_memory_tlm2::tlm_accepted_thread(void) {
         else {
           m_nb2b_thread_peq[port_num]->notify(*p_trans);
         }
+        count_peq_entry(m_nb2b_thread_peq_count[port_num], m_nb2b_thread_peq_peak[port_num]);
       }
     }
 
@@ -912,11 +1014,13 @@ tlm_sync_enum xtsc_component::xtsc_memory_tlm2::tlm_fw_transport_if_impl::nb_tra
       XTSC_DEBUG(m_memory.m_text, trans << " " << xtsc_tlm_phase_text(phase) << " " << t << " nb_transport_fw[" << m_port_num <<
                                   "] (adding to m_tlm_accepted_thread_peq)");
       m_memory.m_tlm_accepted_thread_peq[m_port_num]->notify(trans, t);
+      count_peq_entry(m_memory.m_tlm_accepted_thread_peq_count[m_port_num], m_memory.m_tlm_accepted_thread_peq_peak[m_port_num]);
       return TLM_ACCEPTED;
     }
     else {
       t = t + m_memory.m_nb_transport_delay;
       m_memory.m_nb2b_thread_peq[m_port_num]->notify(trans, t);
+      count_peq_entry(m_memory.m_nb2b_thread_peq_count[m_port_num], m_memory.m_nb2b_thread_peq_peak[m_port_num]);
       phase = END_REQ;
       return TLM_UPDATED;
     }
@@ -1046,6 +1150,7 @@ void xtsc_component::xtsc_memory_tlm2::tlm_fw_transport_if_impl::b_transport(tlm
         memcpy(ptr, m_memory.m_p_memory->m_page_table[page]+mem_offset, len);
       }
       else {
+        if (m_memory.m_p_checkpoint) { m_memory.m_p_checkpoint->before_write(addr, len); }
         memcpy(m_memory.m_p_memory->m_page_table[page]+mem_offset, ptr, len);
       }
     }
@@ -1056,6 +1161,7 @@ void xtsc_component::xtsc_memory_tlm2::tlm_fw_transport_if_impl::b_transport(tlm
             ptr[i] = m_memory.m_p_memory->read_u8(addr);
           }
           else {
+            if (m_memory.m_p_checkpoint) { m_memory.m_p_checkpoint->before_write(addr, 1); }
             m_memory.m_p_memory->write_u8(addr, ptr[i]);
           }
         }
@@ -1171,7 +1277,7 @@ bool xtsc_component::xtsc_memory_tlm2::tlm_fw_transport_if_impl::get_direct_mem_
     }
   }
 
-  if (!out_of_range && m_memory.m_read_only) {
+  if (!out_of_range && (m_memory.m_read_only || (m_memory.m_p_checkpoint && m_memory.m_p_checkpoint->is_active()))) {
     if (trans.is_write()) {
       dmi_data.allow_write();
       allow = false;
@@ -1237,6 +1343,7 @@ u32 xtsc_component::xtsc_memory_tlm2::tlm_fw_transport_if_impl::transport_dbg(tl
     m_memory.m_p_memory->peek((xtsc_address) adr, len, ptr);
   }
   else {
+    if (m_memory.m_p_checkpoint) { m_memory.m_p_checkpoint->before_write((xtsc_address) adr, len); }
     m_memory.m_p_memory->poke((xtsc_address) adr, len, ptr);
   }
 
@@ -10,6 +10,9 @@
 #include <algorithm>
 #include <ostream>
 #include <string>
+#if defined(_WIN32)
+#include <intrin.h>
+#endif
 #include <xtsc/xtsc_memory_trace.h>
 #include <xtsc/xtsc_arbiter.h>
 #include <xtsc/xtsc_core.h>
@@ -29,6 +32,65 @@ using log4xtensa::VERBOSE_LOG_LEVEL;
 
 
 
+namespace xtsc_component {
+
+static const char      binary_trace_magic[8]   = { 'X', 'T', 'S', 'C', 'M', 'T', 'B', '1' };
+static const u32       binary_trace_version    = 1;
+
+
+static inline void put_le(vector<u8>& buf, u64 value, u32 num_bytes) {
+  for (u32 i=0; i<num_bytes; ++i) {
+    buf.push_back((u8) (value >> (8*i)));
+  }
+}
+
+
+static inline u64 get_le(const u8 *buf, u32 num_bytes) {
+  u64 value = 0;
+  for (u32 i=0; i<num_bytes; ++i) {
+    value |= ((u64) buf[i]) << (8*i);
+  }
+  return value;
+}
+
+
+static inline void put_varint(vector<u8>& buf, u64 value) {
+  while (value >= 0x80) {
+    buf.push_back((u8) (value | 0x80));
+    value >>= 7;
+  }
+  buf.push_back((u8) value);
+}
+
+
+// Returns false if the buffer ends in the middle of the value
+static inline bool get_varint(const vector<u8>& buf, u32& offset, u64& value) {
+  value = 0;
+  for (u32 shift=0; (offset < buf.size()) && (shift < 64); shift += 7) {
+    u8 byte = buf[offset++];
+    value |= ((u64) (byte & 0x7F)) << shift;
+    if (!(byte & 0x80)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+
+static inline u64 zig_zag(u64 current, u64 previous) {
+  i64 delta = (i64) (current - previous);
+  return (((u64) delta) << 1) ^ (u64) (delta >> 63);
+}
+
+
+static inline u64 un_zig_zag(u64 value, u64 previous) {
+  return previous + ((value >> 1) ^ (~(value & 1) + 1));
+}
+
+}
+
+
+
 xtsc_component::xtsc_memory_trace_parms::xtsc_memory_trace_parms(const xtsc_core&       core,
                                                                  const char            *memory_interface,
                                                                  sc_trace_file         *p_trace_file,
@@ -92,12 +154,19 @@ xtsc_component::xtsc_memory_trace::xtsc_memory_trace(sc_module_name module_name,
   m_enable_tracing      (trace_parms.get_bool("enable_tracing") && m_allow_tracing),
   m_track_latency       (trace_parms.get_bool("track_latency")),
   m_did_track           (m_track_latency),
+  m_allocator           (name()),
+  m_snapshot_maps       (0),
   m_system_clock_period (xtsc_get_system_clock_period()),
+  m_binary_trace_chunk  (trace_parms.get_non_zero_u32("binary_trace_chunk")),
+  m_binary_trace_stream (0),
   m_text                (log4xtensa::TextLogger::getInstance(name()))
 {
 
   m_system_clock_period_half = m_system_clock_period / 2;
 
+  const char *binary_trace_file = trace_parms.get_c_str("binary_trace_file");
+  m_binary_trace_file_name = binary_trace_file ? binary_trace_file : "";
+
   if ((m_width8 != 4) && (m_width8 != 8) && (m_width8 != 16) && (m_width8 != 32) && (m_width8 != 64)) {
     ostringstream oss;
     oss << kind() << " '" << name() << "' has illegal \"byte_width\"=" << m_width8 << " (legal values are 4|8|16|32|64)";
@@ -113,6 +182,23 @@ xtsc_component::xtsc_memory_trace::xtsc_memory_trace(sc_module_name module_name,
     }
   }
 
+  if (m_binary_trace_file_name != "") {
+    m_binary_trace_stream = new ofstream(m_binary_trace_file_name.c_str(), ios::out | ios::binary);
+    if (!m_binary_trace_stream->is_open()) {
+      ostringstream oss;
+      oss << kind() << " '" << name() << "' cannot open \"binary_trace_file\"=\"" << m_binary_trace_file_name << "\" for writing.";
+      throw xtsc_exception(oss.str());
+    }
+    u64 resolution_fs = (u64) (sc_get_time_resolution().to_seconds() * 1e15 + 0.5);
+    m_binary_trace_buffer.assign(binary_trace_magic, binary_trace_magic + sizeof(binary_trace_magic));
+    put_le(m_binary_trace_buffer, binary_trace_version,                 4);
+    put_le(m_binary_trace_buffer, m_num_ports,                          4);
+    put_le(m_binary_trace_buffer, resolution_fs,                        8);
+    put_le(m_binary_trace_buffer, m_system_clock_period.value(),        8);
+    m_binary_trace_stream->write((const char*) &m_binary_trace_buffer[0], m_binary_trace_buffer.size());
+    m_binary_trace_records.reserve(m_binary_trace_chunk);
+  }
+
   m_request_ports       = new sc_port<xtsc_request_if>*  [m_num_ports];
   m_respond_exports     = new sc_export<xtsc_respond_if>*[m_num_ports];
   m_respond_impl        = new xtsc_respond_if_impl*      [m_num_ports];
@@ -199,6 +285,11 @@ xtsc_component::xtsc_memory_trace::xtsc_memory_trace(sc_module_name module_name,
       "Call dump_lifetime_histogram() for the specified request <Types> and <Ports> (default all)."
   );
 
+  xtsc_register_command(*this, *this, "dump_percentiles", 0, 2,
+      "dump_percentiles [<Types> [<Ports>]]", 
+      "Call dump_percentiles() for the specified request <Types> and <Ports> (default all)."
+  );
+
   xtsc_register_command(*this, *this, "dump_statistic_info", 0, 2,
       "dump_statistic_info [<Types> [<Ports>]]", 
       "Call statistic_info::dump() for each of the specified request <Types> and <Ports> (default all)."
@@ -224,6 +315,16 @@ xtsc_component::xtsc_memory_trace::xtsc_memory_trace(sc_module_name module_name,
       "Return value from calling xtsc_memory_trace::get_num_ports()."
   );
 
+  xtsc_register_command(*this, *this, "get_percentile", 2, 4,
+      "get_percentile <Histogram> <Percentile> [<Types> [<Ports>]]", 
+      "Return value from calling xtsc_memory_trace::get_percentile(<Histogram>, <Percentile>, <Types>, <Ports>)."
+  );
+
+  xtsc_register_command(*this, *this, "snapshot_statistic_info", 0, 2,
+      "snapshot_statistic_info [<Types> [<Ports>]]", 
+      "Call snapshot_statistic_info() for the specified request <Types> and <Ports> (default all)."
+  );
+
   xtsc_register_command(*this, *this, "reset", 0, 1,
       "reset", 
       "Call xtsc_memory_trace:reset()."
@@ -243,6 +344,10 @@ xtsc_component::xtsc_memory_trace::xtsc_memory_trace(sc_module_name module_name,
   }
   XTSC_LOG(m_text, ll,        " track_latency   = "   << boolalpha << m_track_latency);
   XTSC_LOG(m_text, ll,        " num_transfers   = "   << m_num_transfers);
+  XTSC_LOG(m_text, ll,        " binary_trace_file = " << m_binary_trace_file_name);
+  if (m_binary_trace_stream) {
+  XTSC_LOG(m_text, ll,        " binary_trace_chunk= " << m_binary_trace_chunk);
+  }
 
   reset(true);
 
@@ -271,8 +376,24 @@ xtsc_component::xtsc_memory_trace::~xtsc_memory_trace(void) {
     m_statistics_maps[i].clear();
   }
   delete [] m_statistics_maps;
+
+  if (m_snapshot_maps) {
+    for (u32 i=0; i<m_num_ports; i++) {
+      for (map<type_t, statistic_info*>::iterator it=m_snapshot_maps[i].begin(); it!=m_snapshot_maps[i].end(); ++it) {
+        delete it->second;
+      }
+    }
+    delete [] m_snapshot_maps;
+  }
   
   clear_transaction_list();
+
+  if (m_binary_trace_stream) {
+    flush_binary_trace();
+    m_binary_trace_stream->close();
+    delete m_binary_trace_stream;
+    m_binary_trace_stream = 0;
+  }
 }
 
 
@@ -372,8 +493,10 @@ xtsc_port_table xtsc_component::xtsc_memory_trace::get_port_table(const string&
 
 void xtsc_component::xtsc_memory_trace::clear_transaction_list() {
   if (!m_pending_transactions.empty()) {
-    for (map<u64, transaction_info*>::iterator it=m_pending_transactions.begin(); it!=m_pending_transactions.end(); ++it) {
-      delete it->second;
+    vector<transaction_info*> infos;
+    m_pending_transactions.get_all(infos);
+    for (vector<transaction_info*>::iterator it=infos.begin(); it!=infos.end(); ++it) {
+      delete_transaction_info(*it);
     } 
     m_pending_transactions.clear();
   }
@@ -381,6 +504,71 @@ void xtsc_component::xtsc_memory_trace::clear_transaction_list() {
 
 
 
+void xtsc_component::xtsc_memory_trace::binary_trace(u32          port_num,
+                                                     u8           kind,
+                                                     u8           type,
+                                                     u64          address8,
+                                                     u32          size8,
+                                                     u64          tag,
+                                                     bool         last_response)
+{
+  u64 now = sc_time_stamp().value();
+  xtsc_memory_trace_record record;
+  record.m_timestamp    = now;
+  record.m_address8     = address8;
+  record.m_tag          = tag;
+  record.m_size8        = size8;
+  record.m_latency      = 0;
+  record.m_port         = port_num;
+  record.m_kind         = kind;
+  record.m_type         = type;
+  if (kind == xtsc_memory_trace_record::REQUEST) {
+    m_binary_trace_start.insert(pair<u64, u64>(tag, now));
+  }
+  else {
+    map<u64, u64>::iterator it = m_binary_trace_start.find(tag);
+    if (it != m_binary_trace_start.end()) {
+      u64 period = m_system_clock_period.value();
+      record.m_latency = (u32) ((now - it->second + period/2) / period);
+      if (last_response) {
+        m_binary_trace_start.erase(it);
+      }
+    }
+  }
+  m_binary_trace_records.push_back(record);
+  if (m_binary_trace_records.size() >= m_binary_trace_chunk) {
+    flush_binary_trace();
+  }
+}
+
+
+
+void xtsc_component::xtsc_memory_trace::flush_binary_trace() {
+  if (!m_binary_trace_stream || m_binary_trace_records.empty()) return;
+  m_binary_trace_buffer.clear();
+  xtsc_memory_trace_record previous;
+  memset(&previous, 0, sizeof(previous));
+  for (vector<xtsc_memory_trace_record>::const_iterator i = m_binary_trace_records.begin(); i != m_binary_trace_records.end(); ++i) {
+    put_varint(m_binary_trace_buffer, zig_zag(i->m_timestamp, previous.m_timestamp));
+    put_varint(m_binary_trace_buffer, zig_zag(i->m_address8,  previous.m_address8));
+    put_varint(m_binary_trace_buffer, zig_zag(i->m_tag,       previous.m_tag));
+    put_varint(m_binary_trace_buffer, i->m_port);
+    m_binary_trace_buffer.push_back(i->m_kind);
+    m_binary_trace_buffer.push_back(i->m_type);
+    put_varint(m_binary_trace_buffer, i->m_size8);
+    put_varint(m_binary_trace_buffer, i->m_latency);
+    previous = *i;
+  }
+  vector<u8> chunk_header;
+  put_le(chunk_header, m_binary_trace_records.size(), 4);
+  put_le(chunk_header, m_binary_trace_buffer.size(),  4);
+  m_binary_trace_stream->write((const char*) &chunk_header[0],          chunk_header.size());
+  m_binary_trace_stream->write((const char*) &m_binary_trace_buffer[0], m_binary_trace_buffer.size());
+  m_binary_trace_records.clear();
+}
+
+
+
 void xtsc_component::xtsc_memory_trace::dump_latencies(ostream& os) {
   for (u32 i=0; i<m_num_ports; i++) {
     for (map<type_t, statistic_info*>::iterator it=m_statistics_maps[i].begin(); it!=m_statistics_maps[i].end(); ++it) {
@@ -427,41 +615,33 @@ bool xtsc_component::xtsc_memory_trace::get_ports(const string& ports, set<u32>&
 
 
 
-void xtsc_component::xtsc_memory_trace::dump_histogram(ostream& os, const string& types, const string& ports, bool latency) {
+void xtsc_component::xtsc_memory_trace::get_histogram(latency_histogram&      histogram,
+                                                      const string&           types,
+                                                      const string&           ports,
+                                                      bool                    latency)
+{
   set<type_t> types_set; bool all_types = get_types(types, types_set);
   set<u32>    ports_set; bool all_ports = get_ports(ports, ports_set);
-  u64 maximum = 0;
   for (u32 i=0; i<m_num_ports; i++) {
     if (!all_ports && (ports_set.find(i) == ports_set.end())) continue;
     for (map<type_t, statistic_info*>::iterator it=m_statistics_maps[i].begin(); it!=m_statistics_maps[i].end(); ++it) {
       if (!all_types && (types_set.find(it->first) == types_set.end())) continue;
-      u64 value = latency ? it->second->m_max_latency : it->second->m_max_lifetime;
-      if (value > maximum ) {
-        maximum = value;
-      }
-    }
-  }
-  for (u64 l=0; l<=maximum; l++) {
-    u64 tot = 0;
-    for (u32 i=0; i<m_num_ports; i++) {
-      if (!all_ports && (ports_set.find(i) == ports_set.end())) continue;
-      for (map<type_t, statistic_info*>::iterator it=m_statistics_maps[i].begin(); it!=m_statistics_maps[i].end(); ++it) {
-        if (!all_types && (types_set.find(it->first) == types_set.end())) continue;
-        map<u64, u64>  histogram = latency ? it->second->m_latency_histogram : it->second->m_lifetime_histogram;
-        map<u64, u64>::iterator il = histogram.find(l); 
-        if (il != histogram.end()) {
-          tot += il->second;
-        }
-      }
-    }
-    if (tot) {
-      os << l << "," << tot << endl;
+      histogram.add(latency ? it->second->m_latency_histogram : it->second->m_lifetime_histogram);
     }
   }
 }
 
 
 
+void xtsc_component::xtsc_memory_trace::dump_histogram(ostream& os, const string& types, const string& ports, bool latency) {
+  latency_histogram *p_histogram = new latency_histogram;
+  get_histogram(*p_histogram, types, ports, latency);
+  p_histogram->dump(os, true);
+  delete p_histogram;
+}
+
+
+
 xtsc::u64 xtsc_component::xtsc_memory_trace::get_counter(const string& cntr_name, const string& types, const string& ports) {
   cntr_type cntr = get_cntr_type(cntr_name);
   set<type_t> types_set; bool all_types = get_types(types, types_set);
@@ -497,6 +677,75 @@ void xtsc_component::xtsc_memory_trace::dump_statistic_info(ostream& os, const s
 
 
 
+void xtsc_component::xtsc_memory_trace::snapshot_statistic_info(ostream& os, const string& types, const string& ports) {
+  if (!m_snapshot_maps) {
+    m_snapshot_maps = new map<type_t, statistic_info*>[m_num_ports];
+    for (u32 i=0; i<m_num_ports; i++) {
+      for (map<type_t, statistic_info*>::iterator it=m_statistics_maps[i].begin(); it!=m_statistics_maps[i].end(); ++it) {
+        m_snapshot_maps[i].insert(pair<type_t, statistic_info*>(it->first, new statistic_info));
+      }
+    }
+  }
+  set<type_t> types_set; bool all_types = get_types(types, types_set);
+  set<u32>    ports_set; bool all_ports = get_ports(ports, ports_set);
+  os << "Interval " << m_snapshot_time << " to " << sc_time_stamp() << ":" << endl;
+  statistic_info *p_interval = new statistic_info;
+  for (u32 i=0; i<m_num_ports; i++) {
+    if (!all_ports && (ports_set.find(i) == ports_set.end())) continue;
+    for (map<type_t, statistic_info*>::iterator it=m_statistics_maps[i].begin(); it!=m_statistics_maps[i].end(); ++it) {
+      if (!all_types && (types_set.find(it->first) == types_set.end())) continue;
+      statistic_info *p_base = m_snapshot_maps[i][it->first];
+      *p_interval = *it->second;
+      p_interval->subtract(*p_base);
+      *p_base = *it->second;
+      ostringstream oss;
+      if (p_interval->dump(oss, "  ")) {
+        os << "Port #" << i << " " << xtsc_request::get_type_name(it->first) << ": " << endl;
+        os << oss.str() << endl;
+      }
+    }
+  }
+  delete p_interval;
+  m_snapshot_time = sc_time_stamp();
+}
+
+
+
+u64 xtsc_component::xtsc_memory_trace::get_percentile(const string& histogram, double percentile, const string& types, const string& ports) {
+  if ((histogram != "latency") && (histogram != "lifetime")) {
+    ostringstream oss;
+    oss << kind() << " '" << name() << "': get_percentile() histogram=\"" << histogram << "\" is not \"latency\" or \"lifetime\"";
+    throw xtsc_exception(oss.str());
+  }
+  if ((percentile < 0.0) || (percentile > 100.0)) {
+    ostringstream oss;
+    oss << kind() << " '" << name() << "': get_percentile() percentile=" << percentile << " is not in the range 0.0 to 100.0";
+    throw xtsc_exception(oss.str());
+  }
+  latency_histogram *p_histogram = new latency_histogram;
+  get_histogram(*p_histogram, types, ports, (histogram == "latency"));
+  u64 value = p_histogram->get_percentile(percentile);
+  delete p_histogram;
+  return value;
+}
+
+
+
+void xtsc_component::xtsc_memory_trace::dump_percentiles(ostream& os, const string& types, const string& ports) {
+  latency_histogram *p_latency  = new latency_histogram;
+  latency_histogram *p_lifetime = new latency_histogram;
+  get_histogram(*p_latency,  types, ports, true);
+  get_histogram(*p_lifetime, types, ports, false);
+  os << "latency:  p50=" << p_latency ->get_percentile(50.0) << " p99=" << p_latency ->get_percentile(99.0)
+     << " p999=" << p_latency ->get_percentile(99.9) << endl;
+  os << "lifetime: p50=" << p_lifetime->get_percentile(50.0) << " p99=" << p_lifetime->get_percentile(99.0)
+     << " p999=" << p_lifetime->get_percentile(99.9) << endl;
+  delete p_latency;
+  delete p_lifetime;
+}
+
+
+
 void xtsc_component::xtsc_memory_trace::dump_latency_histogram(ostream& os, const string& types, const string& ports) {
   dump_histogram(os, types, ports, true);
 }
@@ -511,6 +760,7 @@ void xtsc_component::xtsc_memory_trace::dump_lifetime_histogram(ostream& os, con
 
 void xtsc_component::xtsc_memory_trace::reset(bool /*hard_reset*/) {
   XTSC_INFO(m_text, "xtsc_memory_trace::reset()");
+  m_binary_trace_start.clear();
 }
 
 
@@ -563,6 +813,11 @@ void xtsc_component::xtsc_memory_trace::execute(const string&           cmd_line
     string ports(""); if (words.size() > 2) { ports = words[2]; }
     dump_lifetime_histogram(res, types, ports);
   }
+  else if (words[0] == "dump_percentiles") {
+    string types(""); if (words.size() > 1) { types = words[1]; }
+    string ports(""); if (words.size() > 2) { ports = words[2]; }
+    dump_percentiles(res, types, ports);
+  }
   else if (words[0] == "dump_statistic_info") {
     string types(""); if (words.size() > 1) { types = words[1]; }
     string ports(""); if (words.size() > 2) { ports = words[2]; }
@@ -588,9 +843,20 @@ void xtsc_component::xtsc_memory_trace::execute(const string&           cmd_line
   else if (words[0] == "get_num_ports") {
     res << m_num_ports;
   }
+  else if (words[0] == "get_percentile") {
+    double percentile = xtsc_command_argtod(cmd_line, words, 2);
+    string types(""); if (words.size() > 3) { types = words[3]; }
+    string ports(""); if (words.size() > 4) { ports = words[4]; }
+    res << get_percentile(words[1], percentile, types, ports);
+  }
   else if (words[0] == "reset") {
     reset();
   }
+  else if (words[0] == "snapshot_statistic_info") {
+    string types(""); if (words.size() > 1) { types = words[1]; }
+    string ports(""); if (words.size() > 2) { ports = words[2]; }
+    snapshot_statistic_info(res, types, ports);
+  }
   else {
     ostringstream oss;
     oss << name() << "::" << __FUNCTION__ << "() called for unknown command '" << cmd_line << "'.";
@@ -766,6 +1032,10 @@ void xtsc_component::xtsc_memory_trace::connect(xtsc_router& router, u32 router_
 
 
 void xtsc_component::xtsc_memory_trace::end_of_simulation() {
+  flush_binary_trace();
+  if (m_binary_trace_stream) {
+    m_binary_trace_stream->flush();
+  }
   if (m_did_track) {
     ostringstream oss;
     oss << "statistic_info dump begin {" << endl;
@@ -819,26 +1089,13 @@ xtsc_component::xtsc_memory_trace::cntr_type xtsc_component::xtsc_memory_trace::
 
 
 xtsc_component::xtsc_memory_trace::transaction_info *xtsc_component::xtsc_memory_trace::new_transaction_info(type_t type) {
-  if (m_transaction_pool.empty()) {
-    transaction_info *p_transaction_info = new transaction_info(sc_time_stamp(), type);
-    return p_transaction_info;
-  }
-  else {
-    transaction_info *p_transaction_info = m_transaction_pool.back();
-    m_transaction_pool.pop_back();
-    p_transaction_info->m_time_req_beg    = sc_time_stamp();
-    p_transaction_info->m_time_req_end    = p_transaction_info->m_time_req_beg;
-    p_transaction_info->m_time_rsp_beg    = sc_core::SC_ZERO_TIME;
-    p_transaction_info->m_time_rsp_end    = sc_core::SC_ZERO_TIME;
-    p_transaction_info->m_type            = type;
-    return p_transaction_info;
-  }
+  return m_allocator.create<transaction_info>(sc_time_stamp(), type);
 }
 
 
 
 void xtsc_component::xtsc_memory_trace::delete_transaction_info(transaction_info*& p_transaction_info) {
-  m_transaction_pool.push_back(p_transaction_info);
+  m_allocator.destroy(p_transaction_info);
   p_transaction_info = 0;
 }
 
@@ -881,22 +1138,225 @@ bool xtsc_component::xtsc_memory_trace::statistic_info::dump(ostream& os, const
   }
   os << endl << prefix << "Histograms (Format: NumCycles=TranCount):" << endl;
   os << prefix << "latency:  ";
-  for (map<u64, u64>::iterator i = m_latency_histogram.begin(); i != m_latency_histogram.end(); ++i) {
-    if (i != m_latency_histogram.begin()) { os << ","; }
-    os << i->first << "=" << i->second;
-  }
-  os << " (tag=" << m_max_latency_tag << ")" << endl;
+  m_latency_histogram.dump(os, false);
+  if (m_max_latency_tag) { os << " (tag=" << m_max_latency_tag << ")"; }
+  os << endl;
   os << prefix << "lifetime: ";
-  for (map<u64, u64>::iterator i = m_lifetime_histogram.begin(); i != m_lifetime_histogram.end(); ++i) {
-    if (i != m_lifetime_histogram.begin()) { os << ","; }
-    os << i->first << "=" << i->second;
-  }
-  os << " (tag=" << m_max_lifetime_tag << ")";
+  m_lifetime_histogram.dump(os, false);
+  if (m_max_lifetime_tag) { os << " (tag=" << m_max_lifetime_tag << ")"; }
+  os << endl;
+  os << prefix << "Percentiles: latency p50=" << m_latency_histogram.get_percentile(50.0) << " p99="
+     << m_latency_histogram.get_percentile(99.0) << " p999=" << m_latency_histogram.get_percentile(99.9)
+     << " lifetime p50=" << m_lifetime_histogram.get_percentile(50.0) << " p99="
+     << m_lifetime_histogram.get_percentile(99.0) << " p999=" << m_lifetime_histogram.get_percentile(99.9);
   return true;
 }
 
 
 
+void xtsc_component::xtsc_memory_trace::statistic_info::subtract(const statistic_info& base) {
+  for (u32 i = 0; i < cntr_count; ++i) { m_cntrs[i] -= base.m_cntrs[i]; }
+  m_latency_histogram .subtract(base.m_latency_histogram);
+  m_lifetime_histogram.subtract(base.m_lifetime_histogram);
+  m_max_latency      = m_latency_histogram .get_percentile(100.0);
+  m_max_lifetime     = m_lifetime_histogram.get_percentile(100.0);
+  m_max_latency_tag  = 0;
+  m_max_lifetime_tag = 0;
+}
+
+
+
+xtsc_component::xtsc_memory_trace::latency_histogram::latency_histogram() :
+  m_total (0)
+{
+  memset(m_counts, 0, sizeof(m_counts));
+}
+
+
+
+u32 xtsc_component::xtsc_memory_trace::latency_histogram::get_bucket(u64 value) {
+  if (value < 2*sub_bucket_count) {
+    return (u32) value;
+  }
+#if defined(_WIN32)
+  unsigned long msb;
+  _BitScanReverse64(&msb, value);
+#else
+  u32 msb = 63 - __builtin_clzll(value);
+#endif
+  u32 shift = (u32) msb - sub_bucket_bits;
+  return 2*sub_bucket_count + (shift-1)*sub_bucket_count + (u32) ((value >> shift) - sub_bucket_count);
+}
+
+
+
+u64 xtsc_component::xtsc_memory_trace::latency_histogram::get_bucket_low(u32 bucket) {
+  if (bucket < 2*sub_bucket_count) {
+    return bucket;
+  }
+  u32 shift = (bucket - 2*sub_bucket_count) / sub_bucket_count + 1;
+  u64 top   = sub_bucket_count + (bucket - 2*sub_bucket_count) % sub_bucket_count;
+  return top << shift;
+}
+
+
+
+u64 xtsc_component::xtsc_memory_trace::latency_histogram::get_bucket_high(u32 bucket) {
+  if (bucket < 2*sub_bucket_count) {
+    return bucket;
+  }
+  u32 shift = (bucket - 2*sub_bucket_count) / sub_bucket_count + 1;
+  u64 top   = sub_bucket_count + (bucket - 2*sub_bucket_count) % sub_bucket_count;
+  return ((top + 1) << shift) - 1;
+}
+
+
+
+u64 xtsc_component::xtsc_memory_trace::latency_histogram::get_percentile(double percentile) const {
+  if (!m_total) return 0;
+  u64 count = (u64) ((percentile / 100.0) * m_total + 0.5);
+  if (count < 1)       count = 1;
+  if (count > m_total) count = m_total;
+  u64 sum = 0;
+  for (u32 i=0; i<bucket_count; ++i) {
+    sum += m_counts[i];
+    if (sum >= count) {
+      return get_bucket_high(i);
+    }
+  }
+  return get_bucket_high(bucket_count - 1);
+}
+
+
+
+void xtsc_component::xtsc_memory_trace::latency_histogram::add(const latency_histogram& other) {
+  for (u32 i=0; i<bucket_count; ++i) { m_counts[i] += other.m_counts[i]; }
+  m_total += other.m_total;
+}
+
+
+
+void xtsc_component::xtsc_memory_trace::latency_histogram::subtract(const latency_histogram& other) {
+  for (u32 i=0; i<bucket_count; ++i) { m_counts[i] -= other.m_counts[i]; }
+  m_total -= other.m_total;
+}
+
+
+
+void xtsc_component::xtsc_memory_trace::latency_histogram::dump(ostream& os, bool one_per_line) const {
+  bool first = true;
+  for (u32 i=0; i<bucket_count; ++i) {
+    if (!m_counts[i]) continue;
+    if (one_per_line) {
+      os << get_bucket_low(i) << "," << m_counts[i] << endl;
+    }
+    else {
+      os << (first ? "" : ",") << get_bucket_low(i) << "=" << m_counts[i];
+    }
+    first = false;
+  }
+}
+
+
+
+xtsc_component::xtsc_memory_trace::pending_table::pending_table() :
+  m_tags        (16, 0),
+  m_infos       (16, (transaction_info*) 0),
+  m_mask        (15),
+  m_size        (0)
+{
+}
+
+
+
+xtsc_component::xtsc_memory_trace::transaction_info *xtsc_component::xtsc_memory_trace::pending_table::find(u64 tag) const {
+  for (u32 i = home(tag); m_infos[i]; i = (i + 1) & m_mask) {
+    if (m_tags[i] == tag) {
+      return m_infos[i];
+    }
+  }
+  return 0;
+}
+
+
+
+void xtsc_component::xtsc_memory_trace::pending_table::insert(u64 tag, transaction_info *p_info) {
+  if (2*(m_size + 1) > m_mask + 1) {
+    grow();
+  }
+  u32 i = home(tag);
+  while (m_infos[i]) {
+    i = (i + 1) & m_mask;
+  }
+  m_tags [i] = tag;
+  m_infos[i] = p_info;
+  m_size += 1;
+}
+
+
+
+xtsc_component::xtsc_memory_trace::transaction_info *xtsc_component::xtsc_memory_trace::pending_table::erase(u64 tag) {
+  u32 i = home(tag);
+  while (m_infos[i] && (m_tags[i] != tag)) {
+    i = (i + 1) & m_mask;
+  }
+  transaction_info *p_info = m_infos[i];
+  if (!p_info) {
+    return 0;
+  }
+  // Backward-shift: move later entries of the probe sequence into the hole
+  u32 hole = i;
+  for (u32 j = (hole + 1) & m_mask; m_infos[j]; j = (j + 1) & m_mask) {
+    u32 h = home(m_tags[j]);
+    if (((j - h) & m_mask) >= ((j - hole) & m_mask)) {
+      m_tags [hole] = m_tags [j];
+      m_infos[hole] = m_infos[j];
+      hole = j;
+    }
+  }
+  m_infos[hole] = 0;
+  m_size -= 1;
+  return p_info;
+}
+
+
+
+void xtsc_component::xtsc_memory_trace::pending_table::get_all(vector<transaction_info*>& infos) const {
+  for (u32 i=0; i<=m_mask; ++i) {
+    if (m_infos[i]) {
+      infos.push_back(m_infos[i]);
+    }
+  }
+}
+
+
+
+void xtsc_component::xtsc_memory_trace::pending_table::clear() {
+  fill(m_infos.begin(), m_infos.end(), (transaction_info*) 0);
+  m_size = 0;
+}
+
+
+
+void xtsc_component::xtsc_memory_trace::pending_table::grow() {
+  vector<u64>               tags;
+  vector<transaction_info*> infos;
+  tags .swap(m_tags);
+  infos.swap(m_infos);
+  u32 num_slots = 2 * (m_mask + 1);
+  m_tags .assign(num_slots, 0);
+  m_infos.assign(num_slots, (transaction_info*) 0);
+  m_mask = num_slots - 1;
+  m_size = 0;
+  for (u32 i=0; i<tags.size(); ++i) {
+    if (infos[i]) {
+      insert(tags[i], infos[i]);
+    }
+  }
+}
+
+
+
 xtsc_component::xtsc_memory_trace::xtsc_request_if_impl::xtsc_request_if_impl(const char               *object_name,
                                                                               xtsc_memory_trace&        trace,
                                                                               u32                       port_num) :
@@ -1039,6 +1499,12 @@ void xtsc_component::xtsc_memory_trace::xtsc_request_if_impl::nb_request(const x
     }
   }
 
+  // Binary trace
+  if (m_trace.m_binary_trace_stream) {
+    m_trace.binary_trace(m_port_num, xtsc_memory_trace_record::REQUEST, (u8) request.get_type(), request.get_byte_address(),
+                         request.get_byte_size(), request.get_tag(), false);
+  }
+
   // Track latency
   if (m_trace.m_track_latency && ((m_trace.m_num_transfers == 0) || (m_trace.m_num_transfers == request.get_num_transfers()))) {
     type_t type = request.get_type();
@@ -1046,14 +1512,14 @@ void xtsc_component::xtsc_memory_trace::xtsc_request_if_impl::nb_request(const x
     if (ix != m_trace.m_statistics_maps[m_port_num].end()) {
       ix->second->m_cntrs[cntr_req_beats] += 1;
       u64 tag = request.get_tag();
-      map<u64, transaction_info*>::iterator it = m_trace.m_pending_transactions.find(tag);
-      if (it == m_trace.m_pending_transactions.end()) {
+      transaction_info *p_info = m_trace.m_pending_transactions.find(tag);
+      if (!p_info) {
         ix->second->m_cntrs[cntr_transactions] += 1;
-        transaction_info *p_info = m_trace.new_transaction_info(type);
-        m_trace.m_pending_transactions.insert(pair<u64, transaction_info*>(tag, p_info));
+        p_info = m_trace.new_transaction_info(type);
+        m_trace.m_pending_transactions.insert(tag, p_info);
       }
       else {
-        it->second->m_time_req_end = sc_time_stamp();
+        p_info->m_time_req_end = sc_time_stamp();
       }
     }
   }
@@ -1202,12 +1668,20 @@ bool xtsc_component::xtsc_memory_trace::xtsc_respond_if_impl::nb_respond(const x
     }
   }
 
+  // Binary trace
+  if (m_trace.m_binary_trace_stream) {
+    u8 kind = accepted ? xtsc_memory_trace_record::RESPONSE : xtsc_memory_trace_record::RESPONSE_BUSY;
+    // An RSP_NACC ends this attempt:  the request may never be retried, so stop tracking its tag
+    bool last = accepted && response.get_last_transfer();
+    m_trace.binary_trace(m_port_num, kind, (u8) response.get_status(), response.get_byte_address(), response.get_byte_size(),
+                         response.get_tag(), last);
+  }
+
   // Track latency
   if (m_trace.m_track_latency) {
     u64 tag = response.get_tag();  
-    map<u64, transaction_info*>::iterator it = m_trace.m_pending_transactions.find(tag);
-    if (it != m_trace.m_pending_transactions.end()) {
-      transaction_info *t_info = it->second;
+    transaction_info *t_info = m_trace.m_pending_transactions.find(tag);
+    if (t_info) {
       map<type_t, statistic_info*>::iterator ix = m_trace.m_statistics_maps[m_port_num].find(t_info->m_type);
       if (ix != m_trace.m_statistics_maps[m_port_num].end()) {
         statistic_info *s_info = ix->second;
@@ -1227,22 +1701,10 @@ bool xtsc_component::xtsc_memory_trace::xtsc_respond_if_impl::nb_respond(const x
             t_info->m_time_rsp_end = now;
             u64 latency  =(u64)((t_info->m_time_rsp_beg - t_info->m_time_req_end + m_trace.m_system_clock_period_half)/m_trace.m_system_clock_period);
             s_info->m_cntrs[cntr_latency]  += latency;
-            map<u64, u64>::iterator il = s_info->m_latency_histogram.find(latency);
-            if (il == s_info->m_latency_histogram.end()) {
-              s_info->m_latency_histogram[latency]  = 1;
-            }
-            else {
-              s_info->m_latency_histogram[latency] += 1;
-            }
+            s_info->m_latency_histogram.record(latency);
             u64 lifetime = (u64)((t_info->m_time_rsp_end - t_info->m_time_req_beg + m_trace.m_system_clock_period_half)/m_trace.m_system_clock_period);
-            map<u64, u64>::iterator id = s_info->m_lifetime_histogram.find(lifetime);
             s_info->m_cntrs[cntr_lifetime]  += lifetime;
-            if (id == s_info->m_lifetime_histogram.end()) {
-              s_info->m_lifetime_histogram[lifetime]  = 1;
-            }
-            else {
-              s_info->m_lifetime_histogram[lifetime] += 1;
-            }
+            s_info->m_lifetime_histogram.record(lifetime);
             if ((latency > s_info->m_max_latency) || (s_info->m_max_latency_tag == 0)) {
               s_info->m_max_latency      = latency;
               s_info->m_max_latency_tag  = tag;
@@ -1251,8 +1713,8 @@ bool xtsc_component::xtsc_memory_trace::xtsc_respond_if_impl::nb_respond(const x
               s_info->m_max_lifetime     = lifetime;
               s_info->m_max_lifetime_tag = tag;
             } 
-            m_trace.delete_transaction_info(t_info);
             m_trace.m_pending_transactions.erase(tag);
+            m_trace.delete_transaction_info(t_info);
           }   
         }
       }
@@ -1278,3 +1740,194 @@ void xtsc_component::xtsc_memory_trace::xtsc_respond_if_impl::register_port(sc_p
 
 
 
+// static
+const char *xtsc_component::xtsc_memory_trace_record::get_kind_name(u8 kind) {
+  switch (kind) {
+    case REQUEST:       return "REQUEST";
+    case RESPONSE:      return "RESPONSE";
+    case RESPONSE_BUSY: return "RESPONSE_BUSY";
+  }
+  return "UNKNOWN";
+}
+
+
+
+xtsc_component::xtsc_memory_trace_reader::xtsc_memory_trace_reader(const string& file_name) :
+  m_file_name           (file_name),
+  m_file                (file_name.c_str(), ios::in | ios::binary),
+  m_num_ports           (0),
+  m_time_resolution_fs  (0),
+  m_clock_period        (0),
+  m_chunk_offset        (0),
+  m_records_left        (0)
+{
+  memset(&m_previous, 0, sizeof(m_previous));
+  if (!m_file.is_open()) {
+    ostringstream oss;
+    oss << "xtsc_memory_trace_reader: cannot open binary trace file \"" << m_file_name << "\"";
+    throw xtsc_exception(oss.str());
+  }
+  u8 header[32];
+  m_file.read((char*) header, sizeof(header));
+  if ((m_file.gcount() != sizeof(header)) || memcmp(header, binary_trace_magic, sizeof(binary_trace_magic))) {
+    ostringstream oss;
+    oss << "xtsc_memory_trace_reader: file \"" << m_file_name << "\" is not an xtsc_memory_trace binary trace file";
+    throw xtsc_exception(oss.str());
+  }
+  u32 version = (u32) get_le(&header[8], 4);
+  if (version != binary_trace_version) {
+    ostringstream oss;
+    oss << "xtsc_memory_trace_reader: file \"" << m_file_name << "\" has unsupported format version " << version;
+    throw xtsc_exception(oss.str());
+  }
+  m_num_ports           = (u32) get_le(&header[12], 4);
+  m_time_resolution_fs  =       get_le(&header[16], 8);
+  m_clock_period        =       get_le(&header[24], 8);
+}
+
+
+
+bool xtsc_component::xtsc_memory_trace_reader::read_chunk() {
+  u8 header[8];
+  m_file.read((char*) header, sizeof(header));
+  if (m_file.gcount() == 0) {
+    return false;
+  }
+  if (m_file.gcount() != sizeof(header)) {
+    ostringstream oss;
+    oss << "xtsc_memory_trace_reader: file \"" << m_file_name << "\" ends in a chunk header";
+    throw xtsc_exception(oss.str());
+  }
+  m_records_left = (u32) get_le(&header[0], 4);
+  u32 num_bytes  = (u32) get_le(&header[4], 4);
+  m_chunk.resize(num_bytes);
+  if (num_bytes) {
+    m_file.read((char*) &m_chunk[0], num_bytes);
+  }
+  if ((u32) m_file.gcount() != num_bytes) {
+    ostringstream oss;
+    oss << "xtsc_memory_trace_reader: file \"" << m_file_name << "\" ends in the middle of a chunk";
+    throw xtsc_exception(oss.str());
+  }
+  m_chunk_offset = 0;
+  memset(&m_previous, 0, sizeof(m_previous));
+  return true;
+}
+
+
+
+bool xtsc_component::xtsc_memory_trace_reader::read(xtsc_memory_trace_record& record) {
+  while (!m_records_left) {
+    if (!read_chunk()) {
+      return false;
+    }
+  }
+  u64 timestamp, address8, tag, port, size8, latency;
+  bool ok = get_varint(m_chunk, m_chunk_offset, timestamp) &&
+            get_varint(m_chunk, m_chunk_offset, address8)  &&
+            get_varint(m_chunk, m_chunk_offset, tag)       &&
+            get_varint(m_chunk, m_chunk_offset, port)      &&
+            (m_chunk_offset + 2 <= m_chunk.size());
+  if (ok) {
+    record.m_kind = m_chunk[m_chunk_offset++];
+    record.m_type = m_chunk[m_chunk_offset++];
+    ok = get_varint(m_chunk, m_chunk_offset, size8) && get_varint(m_chunk, m_chunk_offset, latency);
+  }
+  if (!ok) {
+    ostringstream oss;
+    oss << "xtsc_memory_trace_reader: file \"" << m_file_name << "\" has a corrupt chunk";
+    throw xtsc_exception(oss.str());
+  }
+  record.m_timestamp    = un_zig_zag(timestamp, m_previous.m_timestamp);
+  record.m_address8     = un_zig_zag(address8,  m_previous.m_address8);
+  record.m_tag          = un_zig_zag(tag,       m_previous.m_tag);
+  record.m_port         = (u32) port;
+  record.m_size8        = (u32) size8;
+  record.m_latency      = (u32) latency;
+  m_previous            = record;
+  m_records_left       -= 1;
+  return true;
+}
+
+
+
+void xtsc_component::xtsc_memory_trace_reader::convert_to_csv(ostream& os) {
+  os << "timestamp_fs,port,kind,type,address,size,tag,latency" << endl;
+  xtsc_memory_trace_record record;
+  while (read(record)) {
+    os << (record.m_timestamp * m_time_resolution_fs) << "," << record.m_port << ","
+       << xtsc_memory_trace_record::get_kind_name(record.m_kind) << ",";
+    if (record.m_kind == xtsc_memory_trace_record::REQUEST) {
+      os << xtsc_request::get_type_name((xtsc_request::type_t) record.m_type);
+    }
+    else {
+      os << xtsc_response::get_status_name((xtsc_response::status_t) record.m_type);
+    }
+    os << ",0x" << hex << setfill('0') << setw(8) << record.m_address8 << dec << setfill(' ') << "," << record.m_size8 << ","
+       << record.m_tag << "," << record.m_latency << "\n";
+  }
+  os.flush();
+}
+
+
+
+void xtsc_component::xtsc_memory_trace_reader::convert_to_vcd(ostream& os) {
+  static const char    *signal_names[]  = { "kind", "type", "address", "size", "tag", "latency" };
+  static const u32      signal_widths[] = { 8,      8,      64,        32,     64,    32 };
+  const u32             num_signals     = sizeof(signal_widths) / sizeof(signal_widths[0]);
+
+  vector<string> ids;
+  for (u32 n=0; n<m_num_ports*num_signals; ++n) {
+    string id;
+    u32 value = n;
+    do {
+      id += (char) ('!' + (value % 94));
+      value /= 94;
+    } while (value);
+    ids.push_back(id);
+  }
+
+  os << "$timescale 1 fs $end" << endl;
+  os << "$scope module xtsc_memory_trace $end" << endl;
+  for (u32 port=0; port<m_num_ports; ++port) {
+    os << "$scope module port" << port << " $end" << endl;
+    for (u32 i=0; i<num_signals; ++i) {
+      os << "$var wire " << signal_widths[i] << " " << ids[port*num_signals+i] << " " << signal_names[i] << " $end" << endl;
+    }
+    os << "$upscope $end" << endl;
+  }
+  os << "$upscope $end" << endl;
+  os << "$enddefinitions $end" << endl;
+
+  bool                          first     = true;
+  u64                           timestamp = 0;
+  xtsc_memory_trace_record      record;
+  while (read(record)) {
+    if (record.m_port >= m_num_ports) {
+      ostringstream oss;
+      oss << "xtsc_memory_trace_reader: file \"" << m_file_name << "\" has a record for port " << record.m_port
+          << " but its header says there are only " << m_num_ports << " ports";
+      throw xtsc_exception(oss.str());
+    }
+    if (first || (record.m_timestamp != timestamp)) {
+      timestamp = record.m_timestamp;
+      os << "#" << (timestamp * m_time_resolution_fs) << "\n";
+      first = false;
+    }
+    u64 values[] = { record.m_kind, record.m_type, record.m_address8, record.m_size8, record.m_tag, record.m_latency };
+    for (u32 i=0; i<num_signals; ++i) {
+      os << "b";
+      bool leading = true;
+      for (i32 bit=signal_widths[i]-1; bit>=0; --bit) {
+        bool one = ((values[i] >> bit) & 1) != 0;
+        if (one || !leading || (bit == 0)) {
+          os << (one ? '1' : '0');
+          leading = false;
+        }
+      }
+      os << " " << ids[record.m_port*num_signals+i] << "\n";
+    }
+  }
+  os.flush();
+}
+
@@ -54,6 +54,8 @@ xtsc_component::xtsc_mmio::xtsc_mmio(sc_module_name module_name, const xtsc_mmio
   m_byte_width          = mmio_parms.get_u32("byte_width");
   m_swizzle_bytes       = mmio_parms.get_bool("swizzle_bytes");
   m_always_write        = mmio_parms.get_bool("always_write");
+  m_max_decode_span     = mmio_parms.get_u32("max_decode_span");
+  m_decode_base         = 0;
 
   if ((m_byte_width != 4) && (m_byte_width != 8) && (m_byte_width != 16) && (m_byte_width != 32) && (m_byte_width != 64)) {
     ostringstream oss;
@@ -115,6 +117,8 @@ xtsc_component::xtsc_mmio::xtsc_mmio(sc_module_name module_name, const xtsc_mmio
       p_reg->m_p_initial_value  = new sc_unsigned(p_reg->m_bit_width);
       p_reg->m_p_previous_value = new sc_unsigned(p_reg->m_bit_width);
       p_reg->m_p_current_value  = new sc_unsigned(p_reg->m_bit_width);
+      p_reg->m_narrow           = (p_reg->m_bit_width <= 64);
+      p_reg->m_touched          = false;
       // Handle 4 cases
       // a) No read_only or InitialValue (i.e only 4 words are specified)
       // b) read_only specified, but no InitialValue
@@ -181,6 +185,9 @@ xtsc_component::xtsc_mmio::xtsc_mmio(sc_module_name module_name, const xtsc_mmio
     }
   }
 
+  build_decode_table();
+  m_touched_registers.reserve(m_byte_width);
+
   // Second Pass - Process output and input definitions
   //   output <PortName> <RegisterName> {<HighBit> {<LowBit>}}
   //   input <ExportName> <RegisterName> {<HighBit> {<LowBit>}}
@@ -243,6 +250,12 @@ xtsc_component::xtsc_mmio::xtsc_mmio(sc_module_name module_name, const xtsc_mmio
       p_output->m_reg_name              = reg_name;
       p_output->m_high_bit              = high_bit;
       p_output->m_low_bit               = low_bit;
+      p_output->m_mask                  = 0;
+      if (reg.m_narrow) {
+        u32 width = high_bit - low_bit + 1;
+        p_output->m_mask                = ((width == 64) ? ~0ULL : ((1ULL << width) - 1)) << low_bit;
+      }
+      p_output->m_p_value               = new sc_unsigned(high_bit - low_bit + 1);
       p_output->m_p_wire_write_port     = new wire_write_port(io_name.c_str());
       m_output_definition_map.insert(map<string, output_definition*>::value_type(p_output->m_name, p_output));
       m_output_set.insert(p_output->m_name);
@@ -327,6 +340,12 @@ xtsc_component::xtsc_mmio::xtsc_mmio(sc_module_name module_name, const xtsc_mmio
   XTSC_LOG(m_text, ll, " always_write       = " << boolalpha    << m_always_write);
   XTSC_LOG(m_text, ll, " swizzle_bytes      = " << boolalpha    << m_swizzle_bytes);
   XTSC_LOG(m_text, ll, " use_fast_access    = " << boolalpha    << m_use_fast_access);
+  XTSC_LOG(m_text, ll, " max_decode_span    = 0x" << hex        << m_max_decode_span);
+  if (m_decode_table.empty()) {
+  XTSC_LOG(m_text, ll, " decode table       = (not used)");
+  } else {
+  XTSC_LOG(m_text, ll, " decode table       = 0x" << hex        << m_decode_base << "-0x" << (m_decode_base + m_decode_table.size() - 1));
+  }
   if (clock_period == 0xFFFFFFFF) {
   XTSC_LOG(m_text, ll, " clock_period       = 0x" << hex        << clock_period << " (" << m_clock_period << ")");
   } else {
@@ -853,6 +872,42 @@ xtsc_component::xtsc_mmio::register_definition *xtsc_component::xtsc_mmio::get_r
 
 
 
+const xtsc_component::xtsc_mmio::decode_entry *xtsc_component::xtsc_mmio::decode(xtsc_address address) {
+  if (!m_decode_table.empty()) {
+    xtsc_address offset = address - m_decode_base;
+    if ((address >= m_decode_base) && (offset < m_decode_table.size())) {
+      return &m_decode_table[offset];
+    }
+    m_decode_scratch.m_p_register = NULL;
+    return &m_decode_scratch;
+  }
+  m_decode_scratch.m_p_register = get_register(address, m_decode_scratch.m_high_bit, m_decode_scratch.m_low_bit);
+  m_decode_scratch.m_mask = 0;
+  return &m_decode_scratch;
+}
+
+
+
+void xtsc_component::xtsc_mmio::build_decode_table() {
+  m_decode_table.clear();
+  if (m_address_register_map.empty() || (m_max_decode_span == 0)) return;
+  xtsc_address lowest  = m_address_register_map.begin()->first;
+  xtsc_address highest = m_address_register_map.rbegin()->first;
+  if (highest - lowest >= m_max_decode_span) return;
+  m_decode_base = lowest;
+  m_decode_table.resize(static_cast<u32>(highest - lowest + 1));
+  for (address_register_map::iterator ia = m_address_register_map.begin(); ia != m_address_register_map.end(); ++ia) {
+    decode_entry& entry = m_decode_table[static_cast<u32>(ia->first - lowest)];
+    entry.m_p_register = get_register(ia->first, entry.m_high_bit, entry.m_low_bit);
+    if (entry.m_p_register->m_narrow) {
+      u32 width = entry.m_high_bit - entry.m_low_bit + 1;
+      entry.m_mask = ((1ULL << width) - 1) << entry.m_low_bit;
+    }
+  }
+}
+
+
+
 u32 xtsc_component::xtsc_mmio::get_u32(u32 index, const string& argument_name) {
   u32 value = 0;
   if (index >= m_words.size()) {
@@ -966,11 +1021,15 @@ void xtsc_component::xtsc_mmio::read_bytes(xtsc_address address8, u32 size8, u8
   XTSC_DEBUG(m_text, "read_bytes 0x" << hex << setfill('0') << setw(xtsc_address_nibbles()) << address8 << "/" << size8);
   for (u32 i=0; i<size8; ++i) {
     xtsc_address addr = address8 + i;
-    u32 high_bit = 0;
-    u32 low_bit  = 0;
-    register_definition *p_reg = get_register(addr, high_bit, low_bit);
+    const decode_entry& entry = *decode(addr);
+    register_definition *p_reg = entry.m_p_register;
     if (p_reg != NULL) {
-      buffer[i] = (u8) p_reg->m_p_current_value->range(high_bit, low_bit).to_uint() & 0xFF;
+      if (entry.m_mask) {
+        buffer[i] = (u8) ((p_reg->m_p_current_value->to_uint64() & entry.m_mask) >> entry.m_low_bit);
+      }
+      else {
+        buffer[i] = (u8) p_reg->m_p_current_value->range(entry.m_high_bit, entry.m_low_bit).to_uint() & 0xFF;
+      }
       XTSC_DEBUG(m_text, "read_bytes 0x" << hex << setfill('0') << setw(xtsc_address_nibbles()) << addr << " = " << p_reg->m_name << " = 0x" <<
                          setw(2) << (u32) buffer[i]);
     }
@@ -993,20 +1052,29 @@ void xtsc_component::xtsc_mmio::write_bytes(xtsc_address address8, u32 size8, co
     swizzle_buffer(address8, size8, buf);
   }
 
-  set<register_definition*> touched_registers;
+  m_touched_registers.clear();
   for (u32 i=0; i<size8; ++i) {
     xtsc_address addr = address8 + i;
-    u32 high_bit = 0;
-    u32 low_bit  = 0;
-    register_definition *p_reg = get_register(addr, high_bit, low_bit);
+    const decode_entry& entry = *decode(addr);
+    register_definition *p_reg = entry.m_p_register;
     if (p_reg != NULL && !p_reg->m_read_only) {
-      p_reg->m_p_current_value->range(high_bit, low_bit) = buffer[i];
-      touched_registers.insert(p_reg);
+      if (entry.m_mask) {
+        u64 value = p_reg->m_p_current_value->to_uint64();
+        *p_reg->m_p_current_value = (value & ~entry.m_mask) | ((static_cast<u64>(buffer[i]) << entry.m_low_bit) & entry.m_mask);
+      }
+      else {
+        p_reg->m_p_current_value->range(entry.m_high_bit, entry.m_low_bit) = buffer[i];
+      }
+      if (!p_reg->m_touched) {
+        p_reg->m_touched = true;
+        m_touched_registers.push_back(p_reg);
+      }
       XTSC_DEBUG(m_text, "write_bytes 0x" << hex << setfill('0') << setw(xtsc_address_nibbles()) << addr << " = " << p_reg->m_name << " = 0x" <<
                          setw(2) << (u32) buffer[i]);
     }
   }
-  for (set<register_definition*>::iterator ir = touched_registers.begin(); ir != touched_registers.end(); ++ir) {
+  for (vector<register_definition*>::iterator ir = m_touched_registers.begin(); ir != m_touched_registers.end(); ++ir) {
+    (*ir)->m_touched = false;
     (*ir)->write_outputs(m_always_write);
   }
 
@@ -1076,6 +1144,23 @@ void xtsc_component::xtsc_mmio::register_definition::reset() {
 
 void xtsc_component::xtsc_mmio::register_definition::write_outputs(bool always_write) {
   XTSC_DEBUG(m_mmio.m_text, "write_outputs(" << boolalpha << always_write << ") called");
+  if (m_narrow) {
+    // Compare and extract the outputs as u64 without creating sc_unsigned temporaries
+    u64 current = m_p_current_value->to_uint64();
+    u64 changed = always_write ? ~0ULL : (current ^ m_p_previous_value->to_uint64());
+    for (output_set::iterator io = m_output_set.begin(); io != m_output_set.end(); ++io) {
+      output_definition& output = **io;
+      XTSC_DEBUG(m_mmio.m_text, "write_outputs: register " << m_name << "[" << output.m_high_bit << ":" << output.m_low_bit <<
+                               "] => output \"" << output.m_name << "\"");
+      if (changed & output.m_mask) {
+        *output.m_p_value = (current & output.m_mask) >> output.m_low_bit;
+        (*output.m_p_wire_write_port)->nb_write(*output.m_p_value);
+        XTSC_INFO(m_mmio.m_text, output.m_name << " => " << output.m_p_value->to_string(SC_HEX));
+      }
+    }
+    *m_p_previous_value = current;
+    return;
+  }
   for (output_set::iterator io = m_output_set.begin(); io != m_output_set.end(); ++io) {
     output_definition& output = **io;
     u32 hi = output.m_high_bit;
@@ -1083,8 +1168,9 @@ void xtsc_component::xtsc_mmio::register_definition::write_outputs(bool always_w
     XTSC_DEBUG(m_mmio.m_text, "write_outputs: register " << m_name << "[" << hi << ":" << lo <<
                              "] => output \"" << output.m_name << "\"");
     if (always_write || (m_p_current_value->range(hi, lo) != m_p_previous_value->range(hi, lo))) {
-      (*output.m_p_wire_write_port)->nb_write(m_p_current_value->range(hi, lo));
-      XTSC_INFO(m_mmio.m_text, output.m_name << " => " << m_p_current_value->range(hi, lo).to_string(SC_HEX));
+      *output.m_p_value = m_p_current_value->range(hi, lo);
+      (*output.m_p_wire_write_port)->nb_write(*output.m_p_value);
+      XTSC_INFO(m_mmio.m_text, output.m_name << " => " << output.m_p_value->to_string(SC_HEX));
     }
   }
   *m_p_previous_value = *m_p_current_value;
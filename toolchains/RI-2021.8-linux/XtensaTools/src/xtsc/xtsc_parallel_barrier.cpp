@@ -0,0 +1,286 @@
+// Copyright (c) 2005-2018 by Cadence Design Systems, Inc.  ALL RIGHTS RESERVED.
+// These coded instructions, statements, and computer programs are the
+// copyrighted works and confidential proprietary information of Cadence Design Systems, Inc.
+// They may not be modified, copied, reproduced, distributed, or disclosed to
+// third parties in any manner, medium, or form, in whole or in part, without
+// the prior written consent of Cadence Design Systems, Inc.
+
+#include <sstream>
+#include <iomanip>
+#include <xtsc/xtsc_parallel_barrier.h>
+#include <xtsc/xtsc_queue.h>
+#include <xtsc/xtsc_wire.h>
+#include <xtsc/xtsc_logging.h>
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sched.h>
+#endif
+
+
+using namespace std;
+#if SYSTEMC_VERSION >= 20050601
+using namespace sc_core;
+#endif
+using namespace xtsc;
+
+
+
+// Each slot is written by one process and read by all of the others:  publishing a phase number must release
+// everything this process wrote to host shared memory during the window and observing it must acquire the same.
+static inline u64 slot_load(const u64 *p_slot) {
+#if defined(_WIN32)
+  return *(const volatile u64*)p_slot;
+#else
+  return __atomic_load_n(p_slot, __ATOMIC_ACQUIRE);
+#endif
+}
+
+
+
+static inline void slot_store(u64 *p_slot, u64 value) {
+#if defined(_WIN32)
+  *(volatile u64*)p_slot = value;
+#else
+  __atomic_store_n(p_slot, value, __ATOMIC_RELEASE);
+#endif
+}
+
+
+
+static inline void yield_host_cpu() {
+#if defined(_WIN32)
+  SwitchToThread();
+#else
+  sched_yield();
+#endif
+}
+
+
+
+xtsc_component::xtsc_parallel_barrier::xtsc_parallel_barrier(sc_module_name                      module_name,
+                                                             const xtsc_parallel_barrier_parms&   barrier_parms) :
+  sc_module             (module_name),
+  xtsc_module           (*(sc_module*)this),
+  m_text                (log4xtensa::TextLogger::getInstance(name())),
+  m_num_processes       (barrier_parms.get_non_zero_u32("num_processes")),
+  m_process_index       (barrier_parms.get_u32("process_index")),
+  m_lookahead           (barrier_parms.get_non_zero_u32("lookahead")),
+  m_session_id          (barrier_parms.get_u32("session_id")),
+  m_spin_count          (barrier_parms.get_u32("spin_count")),
+  m_shmem_name          (""),
+  m_p_shmem             (NULL),
+  m_shmem_total_size    (0),
+  m_window              (0),
+  m_num_yields          (0),
+  m_num_channel_updates (0)
+{
+
+  if (m_process_index >= m_num_processes) {
+    ostringstream oss;
+    oss << kind() << " '" << name() << "': \"process_index\"=" << m_process_index << " must be less than \"num_processes\"="
+        << m_num_processes;
+    throw xtsc_exception(oss.str());
+  }
+
+  // Get clock period
+  u32 clock_period = barrier_parms.get_u32("clock_period");
+  if (clock_period == 0xFFFFFFFF) {
+    m_clock_period = xtsc_get_system_clock_period();
+  }
+  else {
+    m_clock_period = sc_get_time_resolution() * clock_period;
+  }
+  m_lookahead_time = m_clock_period * m_lookahead;
+
+  const char *shared_memory_name = barrier_parms.get_c_str("shared_memory_name");
+  if (shared_memory_name && shared_memory_name[0]) {
+    m_shmem_name = shared_memory_name;
+  }
+  else {
+    ostringstream oss;
+    oss << xtsc_get_user_name(name(), kind());
+    oss << "." << name();
+    m_shmem_name = oss.str();
+  }
+  m_shmem_total_size = m_num_processes * SLOT_SIZE;
+  m_p_shmem          = xtsc_get_shared_memory(m_shmem_name, m_shmem_total_size, name(), kind(), 0x0);
+
+  // Our slot is only ever written by us, so if it already has our session ID and a phase number it was left over from an
+  // earlier simulation which used the same "session_id" (or another process is using our "process_index")
+  u64 *p_slot = get_slot(m_process_index);
+  if ((slot_load(&p_slot[0]) == m_session_id) && (slot_load(&p_slot[1]) != 0)) {
+    ostringstream oss;
+    oss << kind() << " '" << name() << "': The slot for \"process_index\"=" << m_process_index << " in host shared memory \""
+        << m_shmem_name << "\" already has \"session_id\"=" << m_session_id << ".  Either it was left over from an earlier"
+        << " simulation (use a new \"session_id\", remove the shared memory, or set the \"unlink_host_shared_memory\" parameter"
+        << " of xtsc_initialize_parms) or another process is using the same \"process_index\".";
+    throw xtsc_exception(oss.str());
+  }
+  // Phase number first so that anyone who sees our session ID also sees phase 0
+  slot_store(&p_slot[1], 0);
+  slot_store(&p_slot[0], m_session_id);
+
+  SC_THREAD(barrier_thread);
+
+  xtsc_register_command(*this, *this, "status", 0, 0,
+      "status",
+      "Return this process's window count and the barrier phase published by each process."
+  );
+
+  xtsc_register_command(*this, *this, "reset", 0, 0,
+      "reset",
+      "Call xtsc_parallel_barrier::reset()."
+  );
+
+  log4xtensa::LogLevel ll = xtsc_get_constructor_log_level();
+  XTSC_LOG(m_text, ll,        "Constructed " << kind() << " '" << name() << "':");
+  XTSC_LOG(m_text, ll,        " num_processes           = "   << m_num_processes);
+  XTSC_LOG(m_text, ll,        " process_index           = "   << m_process_index);
+  XTSC_LOG(m_text, ll,        " lookahead               = "   << m_lookahead << " (" << m_lookahead_time << ")");
+  if (clock_period == 0xFFFFFFFF) {
+  XTSC_LOG(m_text, ll,        " clock_period            = 0x" << hex << clock_period << " (" << m_clock_period << ")");
+  } else {
+  XTSC_LOG(m_text, ll,        " clock_period            = "   << clock_period << " (" << m_clock_period << ")");
+  }
+  if (shared_memory_name && shared_memory_name[0]) {
+  XTSC_LOG(m_text, ll,        " shared_memory_name      = "   << m_shmem_name);
+  } else {
+  XTSC_LOG(m_text, ll,        " shared_memory_name      = \"\" => " << m_shmem_name);
+  }
+  XTSC_LOG(m_text, ll,        "   Total bytes           = " << m_shmem_total_size);
+  XTSC_LOG(m_text, ll,        " session_id              = "   << m_session_id);
+  XTSC_LOG(m_text, ll,        " spin_count              = "   << m_spin_count);
+
+  reset();
+}
+
+
+
+xtsc_component::xtsc_parallel_barrier::~xtsc_parallel_barrier() {
+}
+
+
+
+u32 xtsc_component::xtsc_parallel_barrier::get_bit_width(const string& port_name, u32 interface_num) const {
+  ostringstream oss;
+  oss << kind() << " \"" << name() << "\" has no port named \"" << port_name << "\"" << endl;
+  throw xtsc_exception(oss.str());
+}
+
+
+
+sc_object *xtsc_component::xtsc_parallel_barrier::get_port(const string& port_name) {
+  ostringstream oss;
+  oss << kind() << " \"" << name() << "\" has no port named \"" << port_name << "\"" << endl;
+  throw xtsc_exception(oss.str());
+}
+
+
+
+void xtsc_component::xtsc_parallel_barrier::reset(bool /*hard_reset*/) {
+  XTSC_INFO(m_text, kind() << "::reset()");
+  m_num_yields          = 0;
+  m_num_channel_updates = 0;
+}
+
+
+
+void xtsc_component::xtsc_parallel_barrier::add_channel(xtsc_queue& queue) {
+  queue.enable_barrier_sync();
+  m_queues.push_back(&queue);
+}
+
+
+
+void xtsc_component::xtsc_parallel_barrier::add_channel(xtsc_wire& wire) {
+  wire.enable_barrier_sync();
+  m_wires.push_back(&wire);
+}
+
+
+
+void xtsc_component::xtsc_parallel_barrier::execute(const string&          cmd_line,
+                                                    const vector<string>&  words,
+                                                    const vector<string>&  words_lc,
+                                                    ostream&               result)
+{
+  ostringstream res;
+
+  if (false) {
+  }
+  else if (words[0] == "status") {
+    res << "window=" << m_window;
+    for (u32 i=0; i<m_num_processes; ++i) {
+      u64 phase = get_published_phase(i);
+      res << " " << i << ":";
+      if (phase == DONE) res << "done"; else res << phase;
+    }
+  }
+  else if (words[0] == "reset") {
+    reset();
+  }
+  else {
+    ostringstream oss;
+    oss << __FUNCTION__ << " called for unknown command '" << cmd_line << "'.";
+    throw xtsc_exception(oss.str());
+  }
+
+  result << res.str();
+}
+
+
+
+void xtsc_component::xtsc_parallel_barrier::end_of_simulation() {
+  slot_store(&get_slot(m_process_index)[1], DONE);
+  XTSC_INFO(m_text, "Done after " << m_window << " windows (" << m_num_yields << " host CPU yields, " << m_num_channel_updates <<
+                    " channel updates)");
+}
+
+
+
+void xtsc_component::xtsc_parallel_barrier::barrier_thread() {
+  while (true) {
+    // Keep TurboXim cores from running ahead past the end of this window
+    xtsc_set_relaxed_simulation_barrier(m_lookahead_time);
+    wait(m_lookahead_time);
+    m_window += 1;
+    arrive_and_wait(2*m_window - 1);
+    for (vector<xtsc_queue*>::iterator iq = m_queues.begin(); iq != m_queues.end(); ++iq) {
+      if ((*iq)->sync_host_shared_memory()) m_num_channel_updates += 1;
+    }
+    for (vector<xtsc_wire*>::iterator iw = m_wires.begin(); iw != m_wires.end(); ++iw) {
+      if ((*iw)->sync_host_shared_memory()) m_num_channel_updates += 1;
+    }
+    // No process may start the next window until every process has taken its snapshot of this one
+    arrive_and_wait(2*m_window);
+  }
+}
+
+
+
+u64 xtsc_component::xtsc_parallel_barrier::get_published_phase(u32 process_index) const {
+  const u64 *p_slot = get_slot(process_index);
+  if (slot_load(&p_slot[0]) != m_session_id) return 0;
+  return slot_load(&p_slot[1]);
+}
+
+
+
+void xtsc_component::xtsc_parallel_barrier::arrive_and_wait(u64 phase) {
+  XTSC_DEBUG(m_text, "Arrived at barrier phase " << phase);
+  slot_store(&get_slot(m_process_index)[1], phase);
+  for (u32 i=0; i<m_num_processes; ++i) {
+    if (i == m_process_index) continue;
+    u32 spins = 0;
+    // DONE is larger than any phase number so a finished process never blocks us
+    while (get_published_phase(i) < phase) {
+      if (++spins >= m_spin_count) {
+        yield_host_cpu();
+        m_num_yields += 1;
+        spins = 0;
+      }
+    }
+  }
+  XTSC_DEBUG(m_text, "Released from barrier phase " << phase);
+}
@@ -271,8 +271,7 @@ xtsc_component::xtsc_pif2axi_transactor::xtsc_pif2axi_transactor(
   m_tag_to_req_rsp_info_map            (NULL),
   m_axi_tag_from_pif_tag_map           (NULL),
   m_pif_request_order_dq               (NULL),
-  m_request_count                      (0),
-  m_req_rsp_info_count                 (0),
+  m_allocator                          (name()),
   m_time_resolution                    (sc_get_time_resolution()),
   m_text                               (TextLogger::getInstance(name()))
 {
@@ -591,7 +590,6 @@ xtsc_component::xtsc_pif2axi_transactor::xtsc_pif2axi_transactor(
 
 
 xtsc_component::xtsc_pif2axi_transactor::~xtsc_pif2axi_transactor(void) {
-//Delete all requests of m_request_pool
   for(unsigned int i = 0; i < m_num_ports; i++) {
     delete m_request_exports[i];
     delete m_respond_ports[i];
@@ -653,34 +651,18 @@ xtsc_component::xtsc_pif2axi_transactor::~xtsc_pif2axi_transactor(void) {
   delete[] m_rd_response_peq;
   delete[] m_wr_response_peq;
 
-  while (m_request_pool.size()) {
-    delete m_request_pool.back();
-    m_request_pool.pop_back();
-  }
-  while (m_req_rsp_info_pool.size()) {
-    delete m_req_rsp_info_pool.back();
-    m_req_rsp_info_pool.pop_back();
-  }
 }
 
 
 void xtsc_component::xtsc_pif2axi_transactor::end_of_simulation(void) 
 {
   LogLevel ll = log4xtensa::INFO_LOG_LEVEL;
-  bool mismatch = ( m_request_pool.size() != m_request_count );
+  bool mismatch = (m_allocator.get_num_live() != 0);
   if (mismatch) {
     ll = log4xtensa::ERROR_LOG_LEVEL;
-    XTSC_LOG(m_text, ll, "Error: 1 or more mismatches between pool sizes and counts which indicates a leak: ");
+    XTSC_LOG(m_text, ll, "Error: 1 or more xtsc_request/xtsc_response/req_rsp_info/req_sched_info objects were not returned which indicates a leak: ");
   }
-  XTSC_LOG(m_text, ll, m_request_pool.size() << "/" << m_request_count << " (m_request_pool/m_request_count)");
-
-  bool mismatch_2 = ( m_req_rsp_info_pool.size() != m_req_rsp_info_count );
-  if (mismatch_2) {
-    ll = log4xtensa::ERROR_LOG_LEVEL;
-    XTSC_LOG(m_text, ll, "Error: 1 or more mismatches between pool sizes and counts which indicates a leak: ");
-  }
-  XTSC_LOG(m_text, ll, m_req_rsp_info_pool.size() << "/" << m_req_rsp_info_count << 
-                       " (m_req_rsp_info_pool/m_req_rsp_info_count)");
+  XTSC_LOG(m_text, ll, m_allocator.get_num_live() << "/" << m_allocator.get_num_peak() << " (live/peak xtsc_request, xtsc_response, req_rsp_info, and req_sched_info)");
 
 }
 
@@ -960,70 +942,75 @@ void xtsc_component::xtsc_pif2axi_transactor::execute(const string&         cmd_
 
 
 xtsc_request *xtsc_component::xtsc_pif2axi_transactor::copy_request(const xtsc_request& request) {
-  xtsc_request *p_request = NULL;
-  if (m_request_pool.empty()) {
-    m_request_count += 1;
-    XTSC_TRACE(m_text, "Created new xtsc_request, count #" << m_request_count);
-    p_request = new xtsc_request();
-  }
-  else {
-    p_request = m_request_pool.back();
-    m_request_pool.pop_back();
-    XTSC_TRACE(m_text, "Used xtsc_request from pool, size #" << m_request_pool.size());
-  }
-  *p_request = request; //Copy contents
+  xtsc_request *p_request = m_allocator.create<xtsc_request>(request);
+  XTSC_TRACE(m_text, "Created xtsc_request, live #" << m_allocator.get_num_live());
   return p_request;
 }
 
 
 xtsc_request *xtsc_component::xtsc_pif2axi_transactor::new_request() {
-  xtsc_request *p_request = NULL;
-  if (m_request_pool.empty()) {
-    m_request_count += 1;
-    p_request = new xtsc_request();
-    XTSC_TRACE(m_text, "Created new xtsc_request, count #" << m_request_count);
-  }
-  else {
-    p_request = m_request_pool.back();
-    m_request_pool.pop_back();
-    XTSC_TRACE(m_text, "Used xtsc_request from pool, size #" << m_request_pool.size());
-  }
+  xtsc_request *p_request = m_allocator.create<xtsc_request>();
+  XTSC_TRACE(m_text, "Created xtsc_request, live #" << m_allocator.get_num_live());
   return p_request;
 }
 
 
 void xtsc_component::xtsc_pif2axi_transactor::delete_request(xtsc_request*& p_request) {
-  m_request_pool.push_back(p_request);
-  XTSC_TRACE(m_text, "Returned xtsc_request to pool, size #" << m_request_pool.size());
+  m_allocator.destroy(p_request);
+  XTSC_TRACE(m_text, "Returned xtsc_request, live #" << m_allocator.get_num_live());
   p_request = 0;
 }
 
 
 xtsc_component::xtsc_pif2axi_transactor::req_rsp_info* 
 xtsc_component::xtsc_pif2axi_transactor::new_req_rsp_info() {
-  req_rsp_info *p_req_rsp_info;
-  if (m_req_rsp_info_pool.empty()) {
-    m_req_rsp_info_count += 1;
-    XTSC_TRACE(m_text, "Created a new req_rsp_info, count #" << m_req_rsp_info_count);
-    return new req_rsp_info();
-  }
-  else {
-    req_rsp_info *p_req_rsp_info = m_req_rsp_info_pool.back();
-    m_req_rsp_info_pool.pop_back();
-    XTSC_TRACE(m_text, "Used a req_rsp_info from pool, size #" << m_req_rsp_info_pool.size());
-    return p_req_rsp_info;
-  }
+  req_rsp_info *p_req_rsp_info = m_allocator.create<req_rsp_info>();
+  XTSC_TRACE(m_text, "Created req_rsp_info, live #" << m_allocator.get_num_live());
+  return p_req_rsp_info;
 }
 
 
 void xtsc_component::xtsc_pif2axi_transactor::delete_req_rsp_info(req_rsp_info*& p_req_rsp_info) {
-  p_req_rsp_info->init();
-  m_req_rsp_info_pool.push_back(p_req_rsp_info);
-  XTSC_TRACE(m_text, "Returned req_rsp_info to pool, size #" << m_req_rsp_info_pool.size());
+  m_allocator.destroy(p_req_rsp_info);
+  XTSC_TRACE(m_text, "Returned req_rsp_info, live #" << m_allocator.get_num_live());
   p_req_rsp_info = 0;
 }
 
 
+xtsc_component::xtsc_pif2axi_transactor::req_sched_info* 
+xtsc_component::xtsc_pif2axi_transactor::new_req_sched_info(xtsc_request *p_pif_request, const sc_time& sched_time) {
+  req_sched_info *p_req_sched_info = m_allocator.create<req_sched_info>();
+  p_req_sched_info->m_pif_request  = p_pif_request;
+  p_req_sched_info->m_sched_time   = sched_time;
+  XTSC_TRACE(m_text, "Created req_sched_info, live #" << m_allocator.get_num_live());
+  return p_req_sched_info;
+}
+
+
+void xtsc_component::xtsc_pif2axi_transactor::delete_req_sched_info(req_sched_info*& p_req_sched_info) {
+  m_allocator.destroy(p_req_sched_info);
+  XTSC_TRACE(m_text, "Returned req_sched_info, live #" << m_allocator.get_num_live());
+  p_req_sched_info = 0;
+}
+
+
+xtsc_response *xtsc_component::xtsc_pif2axi_transactor::new_response(const xtsc_request&       request,
+                                                                    xtsc_response::status_t   status,
+                                                                    bool                      last_transfer)
+{
+  xtsc_response *p_response = m_allocator.create<xtsc_response>(request, status, last_transfer);
+  XTSC_TRACE(m_text, "Created xtsc_response, live #" << m_allocator.get_num_live());
+  return p_response;
+}
+
+
+void xtsc_component::xtsc_pif2axi_transactor::delete_response(xtsc_response*& p_response) {
+  m_allocator.destroy(p_response);
+  XTSC_TRACE(m_text, "Returned xtsc_response, live #" << m_allocator.get_num_live());
+  p_response = 0;
+}
+
+
 void xtsc_component::xtsc_pif2axi_transactor::read_request_thread(void) {
   // Get the port number for this "instance" of request_thread
   u32 port_num = m_next_read_request_port_num++;
@@ -1038,7 +1025,7 @@ void xtsc_component::xtsc_pif2axi_transactor::read_request_thread(void) {
         xtsc_request *p_pif_request = p_req_sched_info->m_pif_request;
         delete_request(p_pif_request);
         m_read_request_fifo[port_num]->pop_front();
-        delete p_req_sched_info;
+        delete_req_sched_info(p_req_sched_info);
       }
     }
 
@@ -1063,7 +1050,7 @@ void xtsc_component::xtsc_pif2axi_transactor::read_request_thread(void) {
         }
 
         m_read_request_fifo[port_num]->pop_front();
-        delete p_req_sched_info; 
+        delete_req_sched_info(p_req_sched_info);
         
       }
 
@@ -1144,7 +1131,7 @@ void xtsc_component::xtsc_pif2axi_transactor::write_request_thread(void)
         xtsc_request *p_pif_request = p_req_sched_info->m_pif_request;
         delete_request(p_pif_request);
         m_write_request_fifo[port_num]->pop_front();
-        delete p_req_sched_info;
+        delete_req_sched_info(p_req_sched_info);
       }
     }
 
@@ -1169,7 +1156,7 @@ void xtsc_component::xtsc_pif2axi_transactor::write_request_thread(void)
         }
 
         m_write_request_fifo[port_num]->pop_front();
-        delete p_req_sched_info; 
+        delete_req_sched_info(p_req_sched_info);
       }
 
       XTSC_TRACE(m_text, "write_request_thread[" << port_num << "] going to sleep.");
@@ -1311,7 +1298,7 @@ void xtsc_component::xtsc_pif2axi_transactor::arbitrate_response_thread(void)
         }
 
         send_response(*p_arbitrated_response, port_num);
-        delete p_arbitrated_response;
+        delete_response(p_arbitrated_response);
         wait(m_clock_period);
 
         // Check for the availability of new responses.
@@ -1966,9 +1953,8 @@ void xtsc_component::xtsc_pif2axi_transactor::xtsc_request_if_impl::nb_request(c
 void xtsc_component::xtsc_pif2axi_transactor::xtsc_request_if_impl::nb_request_worker(xtsc::xtsc_request* p_pif_request) 
 {
   if (m_transactor.is_read_access(p_pif_request)) { //includes RCW also
-    req_sched_info *p_req_sched_info = new req_sched_info;
-    p_req_sched_info->m_pif_request  = p_pif_request;
-    p_req_sched_info->m_sched_time   = sc_time_stamp() + m_transactor.m_read_request_delay * m_transactor.m_clock_period;
+    sc_time sched_time = sc_time_stamp() + m_transactor.m_read_request_delay * m_transactor.m_clock_period;
+    req_sched_info *p_req_sched_info = m_transactor.new_req_sched_info(p_pif_request, sched_time);
     m_transactor.m_read_request_fifo[m_port_num]->push_back(p_req_sched_info);
     m_transactor.m_read_request_thread_event[m_port_num]->notify(m_transactor.m_read_request_delay * m_transactor.m_clock_period);
 
@@ -1977,9 +1963,8 @@ void xtsc_component::xtsc_pif2axi_transactor::xtsc_request_if_impl::nb_request_w
 
   } 
   else { 
-    req_sched_info *p_req_sched_info = new req_sched_info;
-    p_req_sched_info->m_pif_request  = p_pif_request;
-    p_req_sched_info->m_sched_time   = sc_time_stamp() + m_transactor.m_write_request_delay * m_transactor.m_clock_period;
+    sc_time sched_time = sc_time_stamp() + m_transactor.m_write_request_delay * m_transactor.m_clock_period;
+    req_sched_info *p_req_sched_info = m_transactor.new_req_sched_info(p_pif_request, sched_time);
     m_transactor.m_write_request_fifo[m_port_num]->push_back(p_req_sched_info);
     m_transactor.m_write_request_thread_event[m_port_num]->notify(m_transactor.m_write_request_delay * m_transactor.m_clock_period);
 
@@ -2112,7 +2097,7 @@ bool xtsc_component::xtsc_pif2axi_transactor::xtsc_respond_if_impl::nb_respond(c
          if (pif_resp_data_offset == 0) {
            //Create Read response for pif
            bool last = (p_req_rsp_info->m_num_pif_resp_sent==p_pif_request->get_num_transfers()-1) ?true:false;
-           xtsc_response *p_pif_response = new xtsc_response(*p_pif_request, p_axi_response->get_status(), last);
+           xtsc_response *p_pif_response = m_transactor.new_response(*p_pif_request, p_axi_response->get_status(), last);
            p_pif_response->set_transfer_number(p_req_rsp_info->m_num_pif_resp_sent+1);
            p_pif_response->set_exclusive_ok(p_axi_response->get_exclusive_ok());
            memcpy(p_pif_response->get_buffer(), p_axi_response->get_buffer(), axi_size8);
@@ -2168,7 +2153,7 @@ bool xtsc_component::xtsc_pif2axi_transactor::xtsc_respond_if_impl::nb_respond(c
              //Exclusive not supported by axi target
              //Dont issue write request to axi. Send back address error in response to complete RCW
              XTSC_DEBUG(m_transactor.m_text, "Exclusive BURST_READ Unsupported. Returning address error.");
-             xtsc_response *p_pif_response    = new xtsc_response(*p_pif_request, xtsc_response::RSP_ADDRESS_ERROR);
+             xtsc_response *p_pif_response    = m_transactor.new_response(*p_pif_request, xtsc_response::RSP_ADDRESS_ERROR);
              sc_time delay                    = m_transactor.m_read_response_delay * m_transactor.m_clock_period;
              m_transactor.m_rd_response_peq[m_port_num]->notify(*p_pif_response, delay);
              XTSC_DEBUG(m_transactor.m_text, "Notify m_rd_response_peq[" << m_port_num << "] after a delay of: (" 
@@ -2181,7 +2166,7 @@ bool xtsc_component::xtsc_pif2axi_transactor::xtsc_respond_if_impl::nb_respond(c
              //Exclusive supported by axi target
              //Excl Lock not established. Dont issue write request to axi. Send back memory data in response to complete RCW 
              XTSC_DEBUG(m_transactor.m_text, "Exclusive BURST_READ Unsuccessful. Returning memory read data.");
-             xtsc_response *p_pif_response    = new xtsc_response(*(p_req_rsp_info->m_pif_request_vec[1]));
+             xtsc_response *p_pif_response    = m_transactor.new_response(*(p_req_rsp_info->m_pif_request_vec[1]));
              memcpy(p_pif_response->get_buffer(), p_axi_response->get_buffer(), size8);
              sc_time delay                    = m_transactor.m_read_response_delay * m_transactor.m_clock_period;
              m_transactor.m_rd_response_peq[m_port_num]->notify(*p_pif_response, delay);
@@ -2199,7 +2184,7 @@ bool xtsc_component::xtsc_pif2axi_transactor::xtsc_respond_if_impl::nb_respond(c
            p_req_rsp_info->m_num_expected_write_resp--;
            if (p_req_rsp_info->m_num_expected_write_resp == 0) {
              //Create Write response for RCW 
-             xtsc_response *p_pif_response     = new xtsc_response(*(p_req_rsp_info->m_pif_request_vec[1]));
+             xtsc_response *p_pif_response     = m_transactor.new_response(*(p_req_rsp_info->m_pif_request_vec[1]));
              XTSC_DEBUG(m_transactor.m_text, "Created PIF response: " << *p_pif_response);
         
              //Prepare return data from RCW response
@@ -2238,7 +2223,7 @@ bool xtsc_component::xtsc_pif2axi_transactor::xtsc_respond_if_impl::nb_respond(c
       XTSC_TRACE(m_transactor.m_text, "Response for WRITE, pending responses: " << p_req_rsp_info->m_num_expected_write_resp);
      
       if (p_req_rsp_info->m_num_expected_write_resp == 0) {
-        xtsc_response *p_pif_response = new xtsc_response(*p_pif_request, p_axi_response->get_status(), true);
+        xtsc_response *p_pif_response = m_transactor.new_response(*p_pif_request, p_axi_response->get_status(), true);
         p_pif_response->set_exclusive_ok(p_axi_response->get_exclusive_ok());
         XTSC_DEBUG(m_transactor.m_text, "Created PIF response: " << *p_pif_response);
      
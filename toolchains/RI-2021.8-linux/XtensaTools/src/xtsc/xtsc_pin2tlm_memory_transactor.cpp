@@ -522,6 +522,7 @@ xtsc_component::xtsc_pin2tlm_memory_transactor::xtsc_pin2tlm_memory_transactor(
   m_resp_cntl           (0),
   m_xID                 (NULL),
   m_xRESP               (5),
+  m_allocator           (name()),
   m_zero_bv             (1),
   m_zero_uint           (1),
   m_text                (TextLogger::getInstance(name()))
@@ -587,6 +588,7 @@ xtsc_component::xtsc_pin2tlm_memory_transactor::xtsc_pin2tlm_memory_transactor(
   m_has_busy            = pin2tlm_parms.get_bool("has_busy");
   m_has_lock            = pin2tlm_parms.get_bool("has_lock");
   m_has_xfer_en         = pin2tlm_parms.get_bool("has_xfer_en");
+  m_activity_driven     = pin2tlm_parms.get_bool("activity_driven");
   m_bus_addr_bits_mask  = ((m_width8 ==  4) ? 0x03 :
                            (m_width8 ==  8) ? 0x07 : 
                            (m_width8 == 16) ? 0x0F :
@@ -1855,6 +1857,7 @@ xtsc_component::xtsc_pin2tlm_memory_transactor::xtsc_pin2tlm_memory_transactor(
   XTSC_LOG(m_text, ll, " big_endian             = "   << boolalpha  << m_big_endian);
   }
   XTSC_LOG(m_text, ll, " vcd_handle             = "                 << m_p_trace_file);
+  XTSC_LOG(m_text, ll, " activity_driven        = "   << boolalpha  << m_activity_driven);
   if (clock_period == 0xFFFFFFFF) {
   XTSC_LOG(m_text, ll, " clock_period           = 0xFFFFFFFF => "   << m_clock_period.value() << " (" << m_clock_period << ")");
   } else {
@@ -3621,12 +3624,21 @@ void xtsc_component::xtsc_pin2tlm_memory_transactor::apb_request_thread(void) {
         // Send xtsc_request downstream
         (*m_request_ports[port])->nb_request(m_apb_info_table[port]->m_request);
 
-        do {
-          wait(m_clock_period);
+        wait(m_clock_period);
+        while (true) {
           if (!m_p_penable[port]->read()) {
             throw xtsc_exception("PENABLE is low when APB protocol requires it to be high");
           }
-        } while (!m_p_pready[port]->read());
+          if (m_p_pready[port]->read()) break;
+          if (m_activity_driven) {
+            // Sleep until PREADY rises (or PENABLE falls) then re-check at the next sample phase
+            wait(m_p_pready[port]->posedge_event() | m_p_penable[port]->negedge_event());
+            sync_to_sample_phase();
+          }
+          else {
+            wait(m_clock_period);
+          }
+        }
         wait(m_clock_period);
       }
 
@@ -3755,7 +3767,7 @@ xtsc_component::xtsc_pin2tlm_memory_transactor::request_info *
 xtsc_component::xtsc_pin2tlm_memory_transactor::new_request_info(u32 port) {
   if (m_request_pool.empty()) {
     XTSC_DEBUG(m_text, "Creating a new request_info");
-    return new request_info(*this, port);
+    return m_allocator.create<request_info>(*this, port);
   }
   else {
     request_info *p_request_info = m_request_pool.back();
@@ -4018,7 +4030,7 @@ ostream& operator<<(ostream& os, const xtsc_pin2tlm_memory_transactor::request_i
 xtsc_component::xtsc_pin2tlm_memory_transactor::axi_addr_info *xtsc_component::xtsc_pin2tlm_memory_transactor::new_axi_addr_info(u32 port) {
   if (m_axi_addr_pool.empty()) {
     XTSC_DEBUG(m_text, "Creating a new axi_addr_info");
-    return new axi_addr_info(*this, port);
+    return m_allocator.create<axi_addr_info>(*this, port);
   }
   else {
     axi_addr_info *p_axi_addr_info = m_axi_addr_pool.back();
@@ -4130,7 +4142,7 @@ ostream& operator<<(ostream& os, const xtsc_pin2tlm_memory_transactor::axi_addr_
 xtsc_component::xtsc_pin2tlm_memory_transactor::axi_data_info *xtsc_component::xtsc_pin2tlm_memory_transactor::new_axi_data_info(u32 port) {
   if (m_axi_data_pool.empty()) {
     XTSC_DEBUG(m_text, "Creating a new axi_data_info");
-    return new axi_data_info(*this, port);
+    return m_allocator.create<axi_data_info>(*this, port);
   }
   else {
     axi_data_info *p_axi_data_info = m_axi_data_pool.back();
@@ -4212,7 +4224,7 @@ xtsc_component::xtsc_pin2tlm_memory_transactor::axi_req_info *
 xtsc_component::xtsc_pin2tlm_memory_transactor::new_axi_req_info(u32 port, axi_addr_info *p_addr_info, axi_data_info *p_data_info) {
   if (m_axi_req_pool.empty()) {
     XTSC_DEBUG(m_text, "Creating a new axi_req_info");
-    return new axi_req_info(*this, port, p_addr_info, p_data_info);
+    return m_allocator.create<axi_req_info>(*this, port, p_addr_info, p_data_info);
   }
   else {
     axi_req_info *p_axi_req_info = m_axi_req_pool.back();
@@ -4403,7 +4415,7 @@ ostream& operator<<(ostream& os, const xtsc_pin2tlm_memory_transactor::apb_info&
 xtsc_response *xtsc_component::xtsc_pin2tlm_memory_transactor::new_response(const xtsc_response& response) {
   if (m_response_pool.empty()) {
     XTSC_DEBUG(m_text, "Creating a new xtsc_response");
-    return new xtsc_response(response);
+    return m_allocator.create<xtsc_response>(response);
   }
   else {
     xtsc_response *p_response = m_response_pool.back();
@@ -12,6 +12,9 @@
 #include <xtsc/xtsc_queue_producer.h>
 #include <xtsc/xtsc_queue_consumer.h>
 #include <xtsc/xtsc_logging.h>
+#if defined(_WIN32)
+#include <intrin.h>
+#endif
 
 
 using namespace std;
@@ -30,6 +33,74 @@ using log4xtensa::UNKNOWN;
 
 
 
+// Copy N words; N is a compile-time constant so the loop is fully unrolled for the common element widths
+template <u32 N>
+static inline void copy_words(u64 *p_dst, const u64 *p_src) {
+  for (u32 i=0; i<N; ++i) {
+    p_dst[i] = p_src[i];
+  }
+}
+
+
+
+// The host shared memory ridx/widx may be written by another OS process:  the producer publishes a row by storing widx
+// (release) only after the row is written and the consumer must load widx (acquire) before reading the row (and likewise
+// for ridx in the other direction).  This makes the shared memory queue a lock-free single-producer/single-consumer ring.
+static inline u32 shmem_load(const u32 *p_index) {
+#if defined(_WIN32)
+  return *(const volatile u32*)p_index;
+#else
+  return __atomic_load_n(p_index, __ATOMIC_ACQUIRE);
+#endif
+}
+
+
+
+static inline void shmem_store(u32 *p_index, u32 value) {
+#if defined(_WIN32)
+  *(volatile u32*)p_index = value;
+#else
+  __atomic_store_n(p_index, value, __ATOMIC_RELEASE);
+#endif
+}
+
+
+
+// The same for the 64-bit positions and sequence numbers of the "shared_memory_mpmc" ring
+static inline u64 shmem_load64(const u64 *p_value) {
+#if defined(_WIN32)
+  return *(const volatile u64*)p_value;
+#else
+  return __atomic_load_n(p_value, __ATOMIC_ACQUIRE);
+#endif
+}
+
+
+
+static inline void shmem_store64(u64 *p_value, u64 value) {
+#if defined(_WIN32)
+  *(volatile u64*)p_value = value;
+#else
+  __atomic_store_n(p_value, value, __ATOMIC_RELEASE);
+#endif
+}
+
+
+
+// If *p_value equals expected, replace it with desired and return true; otherwise, update expected and return false
+static inline bool shmem_cas64(u64 *p_value, u64& expected, u64 desired) {
+#if defined(_WIN32)
+  u64 previous = (u64) _InterlockedCompareExchange64((volatile __int64*)p_value, (__int64)desired, (__int64)expected);
+  if (previous == expected) return true;
+  expected = previous;
+  return false;
+#else
+  return __atomic_compare_exchange_n(p_value, &expected, desired, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+#endif
+}
+
+
+
 xtsc_component::xtsc_queue_parms::xtsc_queue_parms(const xtsc_core&     core,
                                                    const char          *queue_name,
                                                    u32                  depth,
@@ -65,22 +136,21 @@ xtsc_component::xtsc_queue::xtsc_queue(sc_module_name module_name, const xtsc_qu
   m_depth               (queue_parms.get_u32("depth")),
   m_fifo                ("m_fifo", (m_depth ? m_depth : 1)),
   m_use_fifo            (true),
-  m_element_ptrs        (NULL),
   m_tickets             (NULL),
   m_skid_index          (0),
   m_skid_fifos          (NULL),
-  m_skid_buffers        (NULL),
   m_skid_tickets        (NULL),
   m_jerk_index          (0),
   m_jerk_fifos          (NULL),
-  m_jerk_buffers        (NULL),
   m_jerk_tickets        (NULL),
   m_pop_ticket          ((u64)-1),
   m_push_ticket         ((u64)-1),
   m_dummy               (1),    // Length of 1 bit
   m_width1              (queue_parms.get_non_zero_u32("bit_width")),
   m_width8              ((m_width1+7)/8),
+  m_words_per_element   ((m_width1+63)/64),
   m_value               (m_width1),
+  m_element_temp        (m_width1),
   m_text                (log4xtensa::TextLogger::getInstance(name())),
   m_binary              (log4xtensa::BinaryLogger::getInstance(name())),
   m_log_data_binary     (true),
@@ -90,6 +160,7 @@ xtsc_component::xtsc_queue::xtsc_queue(sc_module_name module_name, const xtsc_qu
   m_pop_file_element    (m_width1),
 #if IEEE_1666_SYSTEMC >= 201101L
   m_drain_fifo_event    ("m_drain_fifo_event"),
+  m_checkpoint_restore_event("m_checkpoint_restore_event"),
   m_push_pop_event      ("m_push_pop_event"),
   m_nonempty_event      ("m_nonempty_event"),
   m_nonfull_event       ("m_nonfull_event"),
@@ -104,7 +175,20 @@ xtsc_component::xtsc_queue::xtsc_queue(sc_module_name module_name, const xtsc_qu
   m_shmem_array_size    (0),
   m_shmem_total_size    (0),
   m_p_shmem_ridx        (NULL),
-  m_p_shmem_widx        (NULL)
+  m_p_shmem_widx        (NULL),
+  m_shmem_mpmc          (queue_parms.get_bool("shared_memory_mpmc")),
+  m_shmem_rows_offset   (0),
+  m_p_shmem_enqueue_pos (NULL),
+  m_p_shmem_dequeue_pos (NULL),
+  m_shmem_sync_ridx     (0),
+  m_shmem_sync_widx     (0),
+  m_shmem_barrier_sync  (false),
+  m_shmem_sync_enqueue_pos (0),
+  m_shmem_sync_dequeue_pos (0),
+  m_checkpoint_saved    (false),
+  m_checkpoint_restore_pending(false),
+  m_checkpoint_pop_ticket (0),
+  m_checkpoint_push_ticket(0)
 {
 
   m_dummy = 0;                  // Value of 0
@@ -147,10 +231,11 @@ xtsc_component::xtsc_queue::xtsc_queue(sc_module_name module_name, const xtsc_qu
           << "': It is not legal for \"pop_file\" to be specified if \"host_shared_memory\" is true.";
       throw xtsc_exception(oss.str());
     }
-    if (m_multi_client) {
+    if (m_multi_client && !m_shmem_mpmc) {
       ostringstream oss;
       oss << "Error in " << kind() << " '" << name()
-          << "': It is not legal for \"num_producers\" or \"num_consumers\" to be greater than 1 if \"host_shared_memory\" is true.";
+          << "': It is not legal for \"num_producers\" or \"num_consumers\" to be greater than 1 if \"host_shared_memory\" is true"
+          << " and \"shared_memory_mpmc\" is false.";
       throw xtsc_exception(oss.str());
     }
     if (shared_memory_name && shared_memory_name[0]) {
@@ -163,14 +248,28 @@ xtsc_component::xtsc_queue::xtsc_queue(sc_module_name module_name, const xtsc_qu
       m_shmem_name = oss.str();
     }
     m_use_fifo = false;
-    // Each row contains 64-bit ticket followed by data extended to 64-bit boundary
-    m_shmem_bytes_per_row = ((64 + m_width1 + 63) / 64) * 8;
-    m_shmem_num_rows      = m_depth + 1;
-    m_shmem_array_size    = m_shmem_bytes_per_row*m_shmem_num_rows;
-    m_shmem_total_size    = m_shmem_array_size+8;
-    m_p_shmem             = xtsc_get_shared_memory(m_shmem_name, m_shmem_total_size, name(), kind(), 0x0);
-    m_p_shmem_ridx        = (u32*)&m_p_shmem[m_shmem_array_size+0];
-    m_p_shmem_widx        = (u32*)&m_p_shmem[m_shmem_array_size+4];
+    if (m_shmem_mpmc) {
+      // Two cache lines of positions followed by cells of 64-bit sequence, 64-bit ticket, and data padded to cache lines
+      m_shmem_bytes_per_row = ((128 + m_width1 + 63) / 64) * 8;
+      m_shmem_bytes_per_row = ((m_shmem_bytes_per_row + 63) / 64) * 64;
+      m_shmem_num_rows      = m_depth;
+      m_shmem_rows_offset   = 128;
+      m_shmem_array_size    = m_shmem_bytes_per_row*m_shmem_num_rows;
+      m_shmem_total_size    = m_shmem_rows_offset+m_shmem_array_size;
+      m_p_shmem             = xtsc_get_shared_memory(m_shmem_name, m_shmem_total_size, name(), kind(), 0x0);
+      m_p_shmem_enqueue_pos = (u64*)&m_p_shmem[0];
+      m_p_shmem_dequeue_pos = (u64*)&m_p_shmem[64];
+    }
+    else {
+      // Each row contains 64-bit ticket followed by data extended to 64-bit boundary
+      m_shmem_bytes_per_row = ((64 + m_width1 + 63) / 64) * 8;
+      m_shmem_num_rows      = m_depth + 1;
+      m_shmem_array_size    = m_shmem_bytes_per_row*m_shmem_num_rows;
+      m_shmem_total_size    = m_shmem_array_size+8;
+      m_p_shmem             = xtsc_get_shared_memory(m_shmem_name, m_shmem_total_size, name(), kind(), 0x0);
+      m_p_shmem_ridx        = (u32*)&m_p_shmem[m_shmem_array_size+0];
+      m_p_shmem_widx        = (u32*)&m_p_shmem[m_shmem_array_size+4];
+    }
   }
 
   if (m_use_fifo || m_p_shmem) {
@@ -181,14 +280,14 @@ xtsc_component::xtsc_queue::xtsc_queue(sc_module_name module_name, const xtsc_qu
   }
 
   if (m_use_fifo) {
-    // Create a pool of sc_unsigned objects with pool size equal to the fifo depth
-    m_element_ptrs = new sc_unsigned*[m_depth];
-    for (u32 i=0; i<m_depth; i++) {
-      m_element_ptrs[i] = new sc_unsigned(m_width1);
-    }
+    // Store the elements as packed words in one contiguous table with room for depth elements
+    m_element_words.assign(m_depth * m_words_per_element, 0);
     m_tickets = new u64[m_depth];
     SC_METHOD(drain_fifo_method);
     sensitive << m_drain_fifo_event;
+    SC_METHOD(checkpoint_restore_method);
+    sensitive << m_checkpoint_restore_event;
+    dont_initialize();
   }
 
   m_producers = new sc_export<xtsc_queue_push_if>*[m_num_producers];
@@ -200,11 +299,11 @@ xtsc_component::xtsc_queue::xtsc_queue(sc_module_name module_name, const xtsc_qu
     m_push_multi_impl   = new xtsc_queue_push_if_multi_impl*[m_num_producers];
     if (m_use_fifo) {
       m_skid_fifos      = new sc_fifo<int>                 *[m_num_producers];
-      m_skid_buffers    = new sc_unsigned                  *[m_num_producers];
+      m_skid_words.assign(m_num_producers * m_words_per_element, 0);
       m_skid_tickets    = new u64                           [m_num_producers];
       m_nonfull_events  = new sc_event                     *[m_num_producers];
       m_jerk_fifos      = new sc_fifo<int>                 *[m_num_consumers];
-      m_jerk_buffers    = new sc_unsigned                  *[m_num_consumers];
+      m_jerk_words.assign(m_num_consumers * m_words_per_element, 0);
       m_jerk_tickets    = new u64                           [m_num_consumers];
       m_nonempty_events = new sc_event                     *[m_num_consumers];
       SC_METHOD(delta_cycle_method);
@@ -224,7 +323,6 @@ xtsc_component::xtsc_queue::xtsc_queue(sc_module_name module_name, const xtsc_qu
         ostringstream oss3;
         oss3 << "m_skid_fifos[" << i << "]";
         m_skid_fifos    [i] = new sc_fifo<int>(oss3.str().c_str(), 1);
-        m_skid_buffers  [i] = new sc_unsigned(m_width1);
         m_skid_tickets  [i] = 0;
         ostringstream oss4;
         oss4 << "m_nonfull_events_" << i;
@@ -251,7 +349,6 @@ xtsc_component::xtsc_queue::xtsc_queue(sc_module_name module_name, const xtsc_qu
         ostringstream oss3;
         oss3 << "m_jerk_fifos[" << i << "]";
         m_jerk_fifos     [i] = new sc_fifo<int>(oss3.str().c_str(), 1);
-        m_jerk_buffers   [i] = new sc_unsigned(m_width1);
         m_jerk_tickets   [i] = 0;
         ostringstream oss4;
         oss4 << "m_nonempty_events_" << i;
@@ -305,6 +402,12 @@ xtsc_component::xtsc_queue::xtsc_queue(sc_module_name module_name, const xtsc_qu
       "Return nb_can_push() for the specified <PushPort> (default 0)."
   );
 
+  xtsc_register_command(*this, *this, "checkpoint", 1, 1,
+      "checkpoint save|restore|discard", 
+      "Call xtsc_queue::checkpoint_save(), xtsc_queue::checkpoint_restore(), or xtsc_queue::checkpoint_discard()."
+      "  For restore, return the number of elements in the queue."
+  );
+
   xtsc_register_command(*this, *this, "dump", 0, 0,
       "dump", 
       "Return the os buffer from calling xtsc_queue::dump(os)."
@@ -372,6 +475,7 @@ xtsc_component::xtsc_queue::xtsc_queue(sc_module_name module_name, const xtsc_qu
 
 #if IEEE_1666_SYSTEMC < 201101L
   xtsc_event_register(m_drain_fifo_event, "m_drain_fifo_event", this);
+  xtsc_event_register(m_checkpoint_restore_event, "m_checkpoint_restore_event", this);
   xtsc_event_register(m_push_pop_event,   "m_push_pop_event",   this);
   xtsc_event_register(m_nonempty_event,   "m_nonempty_event",   this);
   xtsc_event_register(m_nonfull_event,    "m_nonfull_event",    this);
@@ -396,10 +500,15 @@ xtsc_component::xtsc_queue::xtsc_queue(sc_module_name module_name, const xtsc_qu
   } else {
   XTSC_LOG(m_text, ll,        " shared_memory_name      = \"\" => " << m_shmem_name);
   }
+  XTSC_LOG(m_text, ll,        " shared_memory_mpmc      = "   << boolalpha << m_shmem_mpmc);
   XTSC_LOG(m_text, ll,        "   Bytes per row         = " << m_shmem_bytes_per_row);
   XTSC_LOG(m_text, ll,        "   Number of rows        = " << m_shmem_num_rows);
+  if (m_shmem_mpmc) {
+  XTSC_LOG(m_text, ll,        "   Byte offset of rows   = " << m_shmem_rows_offset);
+  } else {
   XTSC_LOG(m_text, ll,        "   Byte offset of ridx   = " << m_shmem_array_size+0);
   XTSC_LOG(m_text, ll,        "   Byte offset of widx   = " << m_shmem_array_size+4);
+  }
   XTSC_LOG(m_text, ll,        "   Total bytes           = " << m_shmem_total_size);
   }
 
@@ -412,12 +521,6 @@ xtsc_component::xtsc_queue::xtsc_queue(sc_module_name module_name, const xtsc_qu
 xtsc_component::xtsc_queue::~xtsc_queue() {
   if (m_push_file) delete m_push_file;
   if (m_pop_file)  delete m_pop_file;
-  if (m_element_ptrs) {
-    for (u32 i=0; i<m_depth; i++) {
-      delete m_element_ptrs[i];
-    }
-    delete [] m_element_ptrs;
-  }
   if (m_tickets) delete [] m_tickets;
 }
 
@@ -526,11 +629,19 @@ void xtsc_component::xtsc_queue::reset(bool /* hard_reset */) {
   }
 
   if (m_use_fifo) {
+    m_checkpoint_restore_event.cancel();
+    m_checkpoint_restore_pending = false;
     m_drain_fifo_event.notify(SC_ZERO_TIME);
   }
   else if (m_p_shmem) {
     if (m_host_shared_memory && m_num_producers && m_num_consumers) {
       memset(m_p_shmem, 0, m_shmem_total_size);
+      m_shmem_sync_ridx = 0;
+      m_shmem_sync_widx = 0;
+      m_shmem_sync_enqueue_pos = 0;
+      m_shmem_sync_dequeue_pos = 0;
+      m_shmem_own_pushes.clear();
+      m_shmem_own_pops.clear();
     }
   }
 }
@@ -608,8 +719,11 @@ u32 xtsc_component::xtsc_queue::get_index_of_nth_from_front(u32 nth, const char
     }
     throw xtsc_exception(oss.str());
   }
-  if (m_p_shmem) {
-    u32 ridx = *m_p_shmem_ridx;
+  if (m_shmem_mpmc) {
+    return (u32) ((shmem_load64(m_p_shmem_dequeue_pos) + nth - 1) % m_depth);
+  }
+  else if (m_p_shmem) {
+    u32 ridx = shmem_load(m_p_shmem_ridx);
     return ((ridx + nth - 1) % m_shmem_num_rows);
   }
   else {
@@ -622,17 +736,22 @@ u32 xtsc_component::xtsc_queue::get_index_of_nth_from_front(u32 nth, const char
 void xtsc_component::xtsc_queue::dump(ostream &os) {
   confirm_has_fifo_or_shmem(__FUNCTION__);
   if (m_p_shmem) {
-    for (u32 i = 0; i <= m_depth; ++i) {
-      u32 row_offset = i * m_shmem_bytes_per_row;
-      u64 ticket = *(u64*)&m_p_shmem[row_offset];
-      xtsc_byte_array_to_sc_unsigned(&m_p_shmem[row_offset+8], m_value);
+    for (u32 i = 0; i < m_shmem_num_rows; ++i) {
+      u8 *row = shmem_row(i);
+      u64 ticket = *(u64*)&row[0];
+      xtsc_byte_array_to_sc_unsigned(&row[8], m_value);
       os << "Row " << setw(3) << i << ":" << setw(6) << ticket << " 0x" << m_value.to_string(SC_HEX).substr(m_width1%4 ? 2 : 3) << endl;
     }
-    os << "ridx=" << *m_p_shmem_ridx << " widx=" << *m_p_shmem_widx << endl;
+    if (m_shmem_mpmc) {
+      os << "dequeue=" << shmem_load64(m_p_shmem_dequeue_pos) << " enqueue=" << shmem_load64(m_p_shmem_enqueue_pos) << endl;
+    }
+    else {
+      os << "ridx=" << shmem_load(m_p_shmem_ridx) << " widx=" << shmem_load(m_p_shmem_widx) << endl;
+    }
   }
   else {
     for (u32 i = m_next + m_depth - m_fifo.num_available(); i < m_next + m_depth; ++i) {
-      os << "0x" << m_element_ptrs[i%m_depth]->to_string(SC_HEX).substr(m_width1%4 ? 2 : 3) << "  " << m_tickets[i%m_depth] << endl;
+      os << element_to_string(element_words(i%m_depth)) << "  " << m_tickets[i%m_depth] << endl;
     }
   }
 }
@@ -641,9 +760,12 @@ void xtsc_component::xtsc_queue::dump(ostream &os) {
 
 u32 xtsc_component::xtsc_queue::num_available() {
   confirm_has_fifo_or_shmem(__FUNCTION__);
+  if (m_shmem_mpmc) {
+    return shmem_mpmc_count();
+  }
   if (m_p_shmem) {
-    u32 widx = *m_p_shmem_widx;
-    u32 ridx = *m_p_shmem_ridx;
+    u32 widx = shmem_load(m_p_shmem_widx);
+    u32 ridx = shmem_load(m_p_shmem_ridx);
     return ((widx >= ridx) ? (widx - ridx) : (widx + m_shmem_num_rows - ridx));
   }
   return m_fifo.num_available();
@@ -653,6 +775,9 @@ u32 xtsc_component::xtsc_queue::num_available() {
 
 u32 xtsc_component::xtsc_queue::num_free() {
   confirm_has_fifo_or_shmem(__FUNCTION__);
+  if (m_shmem_mpmc) {
+    return (m_depth - shmem_mpmc_count());
+  }
   if (m_p_shmem) {
     return (m_shmem_num_rows - num_available() - 1);
   }
@@ -664,11 +789,10 @@ u32 xtsc_component::xtsc_queue::num_free() {
 void xtsc_component::xtsc_queue::peek(u32 nth, sc_unsigned& value) {
   u32 index = get_index_of_nth_from_front(nth, __FUNCTION__);
   if (m_p_shmem) {
-    u32 row_offset = index * m_shmem_bytes_per_row;
-    xtsc_byte_array_to_sc_unsigned(&m_p_shmem[row_offset+8], value);
+    xtsc_byte_array_to_sc_unsigned(&shmem_row(index)[8], value);
   }
   else {
-    value = *m_element_ptrs[index];
+    unpack_element(element_words(index), value);
   }
 }
 
@@ -677,12 +801,267 @@ void xtsc_component::xtsc_queue::peek(u32 nth, sc_unsigned& value) {
 void xtsc_component::xtsc_queue::poke(u32 nth, const sc_unsigned& value) {
   u32 index = get_index_of_nth_from_front(nth, __FUNCTION__);
   if (m_p_shmem) {
-    u32 row_offset = index * m_shmem_bytes_per_row;
-    xtsc_sc_unsigned_to_byte_array(value, &m_p_shmem[row_offset+8]);
+    xtsc_sc_unsigned_to_byte_array(value, &shmem_row(index)[8]);
   }
   else {
-    *m_element_ptrs[index] = value;
+    pack_element(value, element_words(index));
+  }
+}
+
+
+
+void xtsc_component::xtsc_queue::checkpoint_save() {
+  confirm_has_fifo_or_shmem(__FUNCTION__);
+  if (m_p_shmem) {
+    ostringstream oss;
+    oss << kind() << " '" << name() << "': checkpoint_save() is not supported when \"host_shared_memory\" is true";
+    throw xtsc_exception(oss.str());
   }
+  if (m_checkpoint_restore_pending) {
+    ostringstream oss;
+    oss << kind() << " '" << name() << "': checkpoint_save() called before the previous checkpoint_restore() completed";
+    throw xtsc_exception(oss.str());
+  }
+  m_checkpoint_tickets.clear();
+  u32 count = m_fifo.num_available();
+  u32 element_size8 = m_words_per_element * 8;
+  m_checkpoint_data.assign(count * element_size8, 0);
+  for (u32 nth = 1; nth <= count; ++nth) {
+    u32 index = get_index_of_nth_from_front(nth, __FUNCTION__);
+    memcpy(&m_checkpoint_data[(nth-1) * element_size8], element_words(index), element_size8);
+    m_checkpoint_tickets.push_back(m_tickets[index]);
+  }
+  m_checkpoint_pop_ticket  = m_pop_ticket;
+  m_checkpoint_push_ticket = m_push_ticket;
+  m_checkpoint_saved       = true;
+  XTSC_INFO(m_text, "checkpoint_save(): " << num_available() << " elements");
+}
+
+
+
+u32 xtsc_component::xtsc_queue::checkpoint_restore() {
+  if (!m_checkpoint_saved) {
+    ostringstream oss;
+    oss << kind() << " '" << name() << "': checkpoint_restore() called but no checkpoint has been saved";
+    throw xtsc_exception(oss.str());
+  }
+  // Pushes and pops are refused until checkpoint_restore_method() has put the saved elements back
+  m_checkpoint_restore_pending = true;
+  drain_fifo_method();
+  // The space freed by drain_fifo_method() is not available to nb_write() until the update phase
+  m_checkpoint_restore_event.notify(SC_ZERO_TIME);
+  u32 count = (u32) m_checkpoint_tickets.size();
+  m_pop_ticket  = m_checkpoint_pop_ticket;
+  m_push_ticket = m_checkpoint_push_ticket;
+  XTSC_INFO(m_text, "checkpoint_restore(): " << count << " elements");
+  return count;
+}
+
+
+
+// Runs when m_checkpoint_restore_event fires
+void xtsc_component::xtsc_queue::checkpoint_restore_method() {
+  if (!m_checkpoint_restore_pending) return;
+  // Elements pushed earlier in the delta cycle of checkpoint_restore() have become readable
+  drain_fifo_method();
+  bool drained = ((u32) m_fifo.num_free() == m_depth);
+  if (m_multi_client) {
+    for (u32 i=0; i < m_num_producers; ++i) { if (m_skid_fifos[i]->num_free() == 0) drained = false; }
+    for (u32 i=0; i < m_num_consumers; ++i) { if (m_jerk_fifos[i]->num_free() == 0) drained = false; }
+  }
+  if (!drained) {
+    m_checkpoint_restore_event.notify(SC_ZERO_TIME);
+    return;
+  }
+  u32 count = (u32) m_checkpoint_tickets.size();
+  for (u32 i=0; i<count; ++i) {
+    memcpy(element_words(m_next), &m_checkpoint_data[i * m_words_per_element * 8], m_words_per_element * 8);
+    m_tickets[m_next] = m_checkpoint_tickets[i];
+    if (!m_fifo.nb_write(m_next)) {
+      ostringstream oss;
+      oss << kind() << " '" << name() << "': checkpoint_restore() could only restore " << i << " of " << count << " elements";
+      throw xtsc_exception(oss.str());
+    }
+    m_next = (m_next + 1) % m_depth;
+  }
+  m_checkpoint_restore_pending = false;
+  XTSC_DEBUG(m_text, "checkpoint_restore_method(): " << count << " elements");
+  m_push_pop_event.notify(SC_ZERO_TIME);
+  m_nonempty_event.notify(SC_ZERO_TIME);
+  m_nonfull_event.notify(SC_ZERO_TIME);
+  if (m_multi_client) {
+    for (u32 i=0; i < m_num_consumers; ++i) { m_nonempty_events[i]->notify(SC_ZERO_TIME); }
+    for (u32 i=0; i < m_num_producers; ++i) { m_nonfull_events [i]->notify(SC_ZERO_TIME); }
+  }
+}
+
+
+
+void xtsc_component::xtsc_queue::checkpoint_discard() {
+  m_checkpoint_saved = false;
+  m_checkpoint_data.clear();
+  m_checkpoint_tickets.clear();
+}
+
+
+
+bool xtsc_component::xtsc_queue::sync_host_shared_memory() {
+  if (!m_p_shmem) return false;
+  if (m_shmem_mpmc) {
+    m_shmem_sync_enqueue_pos = shmem_load64(m_p_shmem_enqueue_pos);
+    m_shmem_sync_dequeue_pos = shmem_load64(m_p_shmem_dequeue_pos);
+    // Everything we pushed or popped is now below the snapshot
+    m_shmem_own_pushes.clear();
+    m_shmem_own_pops.clear();
+  }
+  u32 widx = (m_shmem_mpmc ? (u32) m_shmem_sync_enqueue_pos : shmem_load(m_p_shmem_widx));
+  u32 ridx = (m_shmem_mpmc ? (u32) m_shmem_sync_dequeue_pos : shmem_load(m_p_shmem_ridx));
+  bool pushed = (widx != m_shmem_sync_widx);
+  bool popped = (ridx != m_shmem_sync_ridx);
+  m_shmem_sync_widx = widx;
+  m_shmem_sync_ridx = ridx;
+  if (pushed) {
+    m_nonempty_event.notify(SC_ZERO_TIME);
+  }
+  if (popped) {
+    m_nonfull_event.notify(SC_ZERO_TIME);
+  }
+  if (pushed || popped) {
+    m_push_pop_event.notify(SC_ZERO_TIME);
+    XTSC_DEBUG(m_text, "sync_host_shared_memory(): ridx=" << ridx << " widx=" << widx);
+  }
+  return (pushed || popped);
+}
+
+
+
+u32 xtsc_component::xtsc_queue::shmem_mpmc_count() {
+  u64 dequeue_pos = shmem_load64(m_p_shmem_dequeue_pos);
+  u64 enqueue_pos = shmem_load64(m_p_shmem_enqueue_pos);
+  // Another consumer may have advanced the dequeue position past the enqueue position we loaded
+  if (enqueue_pos <= dequeue_pos) return 0;
+  u64 count = enqueue_pos - dequeue_pos;
+  return ((count > m_depth) ? m_depth : (u32) count);
+}
+
+
+
+u32 xtsc_component::xtsc_queue::shmem_mpmc_num_available() {
+  if (!m_shmem_barrier_sync) return shmem_mpmc_count();
+  u64 dequeue_pos = shmem_load64(m_p_shmem_dequeue_pos);
+  u64 end = shmem_visible_end(dequeue_pos, m_shmem_sync_enqueue_pos, m_shmem_own_pushes);
+  // Each visible push is complete, so this never exceeds the number actually in the ring
+  return (u32) (end - dequeue_pos);
+}
+
+
+
+u32 xtsc_component::xtsc_queue::shmem_mpmc_num_free() {
+  u32 num_free = m_depth - shmem_mpmc_count();
+  if (!m_shmem_barrier_sync) return num_free;
+  // The cell for position P is free once position P-depth has been popped
+  u64 enqueue_pos = shmem_load64(m_p_shmem_enqueue_pos);
+  u64 first = ((enqueue_pos > m_depth) ? (enqueue_pos - m_depth) : 0);
+  u64 end = shmem_visible_end(first, m_shmem_sync_dequeue_pos, m_shmem_own_pops) + m_depth;
+  if (end <= enqueue_pos) return 0;
+  return ((end - enqueue_pos < num_free) ? (u32) (end - enqueue_pos) : num_free);
+}
+
+
+
+u64 xtsc_component::xtsc_queue::shmem_visible_end(u64 pos, u64 snapshot, const set<u64>& own) {
+  if (pos < snapshot) pos = snapshot;
+  while (own.count(pos)) pos += 1;
+  return pos;
+}
+
+
+
+u32 xtsc_component::xtsc_queue::shmem_visible_widx() {
+  return (m_shmem_barrier_sync ? m_shmem_sync_widx : shmem_load(m_p_shmem_widx));
+}
+
+
+
+u32 xtsc_component::xtsc_queue::shmem_visible_ridx() {
+  return (m_shmem_barrier_sync ? m_shmem_sync_ridx : shmem_load(m_p_shmem_ridx));
+}
+
+
+
+bool xtsc_component::xtsc_queue::shmem_mpmc_push(const sc_unsigned& element, u64& ticket) {
+  u64 pos = shmem_load64(m_p_shmem_enqueue_pos);
+  u32 index = 0;
+  while (true) {
+    index = (u32) (pos % m_depth);
+    if (m_shmem_barrier_sync && (pos >= m_depth) &&
+        (shmem_visible_end(pos - m_depth, m_shmem_sync_dequeue_pos, m_shmem_own_pops) == pos - m_depth))
+    {
+      return false;     // Full until the pop which frees this cell becomes visible
+    }
+    i64 dif = (i64) (shmem_load64(shmem_sequence(index)) + index - pos);
+    if (dif == 0) {
+      // Cell is free for position pos:  try to claim it (on failure pos is reloaded)
+      if (shmem_cas64(m_p_shmem_enqueue_pos, pos, pos + 1)) break;
+    }
+    else if (dif < 0) {
+      return false;     // Full
+    }
+    else {
+      pos = shmem_load64(m_p_shmem_enqueue_pos);
+    }
+  }
+  u8 *row = shmem_row(index);
+  ticket = xtsc_create_queue_ticket();
+  *(u64*)&row[0] = ticket;
+  xtsc_sc_unsigned_to_byte_array(element, &row[8]);
+  shmem_store64(shmem_sequence(index), pos + 1 - index);
+  // Count our own push so that sync_host_shared_memory() only reports pushes by others
+  m_shmem_sync_widx += 1;
+  if (m_shmem_barrier_sync) m_shmem_own_pushes.insert(pos);
+  return true;
+}
+
+
+
+bool xtsc_component::xtsc_queue::shmem_mpmc_pop(sc_unsigned& element, u64& ticket, bool peek) {
+  u64 pos = shmem_load64(m_p_shmem_dequeue_pos);
+  u32 index = 0;
+  while (true) {
+    index = (u32) (pos % m_depth);
+    if (m_shmem_barrier_sync && (shmem_visible_end(pos, m_shmem_sync_enqueue_pos, m_shmem_own_pushes) == pos)) {
+      return false;     // Empty until the push to this cell becomes visible
+    }
+    i64 dif = (i64) (shmem_load64(shmem_sequence(index)) + index - (pos + 1));
+    if (dif == 0) {
+      if (peek) {
+        u8 *row = shmem_row(index);
+        ticket = *(u64*)&row[0];
+        xtsc_byte_array_to_sc_unsigned(&row[8], element);
+        // Only valid if no other consumer popped the cell while we were copying it
+        u64 now = shmem_load64(m_p_shmem_dequeue_pos);
+        if (now == pos) return true;
+        pos = now;
+        continue;
+      }
+      // Cell is full for position pos:  try to claim it (on failure pos is reloaded)
+      if (shmem_cas64(m_p_shmem_dequeue_pos, pos, pos + 1)) break;
+    }
+    else if (dif < 0) {
+      return false;     // Empty
+    }
+    else {
+      pos = shmem_load64(m_p_shmem_dequeue_pos);
+    }
+  }
+  u8 *row = shmem_row(index);
+  ticket = *(u64*)&row[0];
+  xtsc_byte_array_to_sc_unsigned(&row[8], element);
+  shmem_store64(shmem_sequence(index), pos + m_depth - index);
+  // Count our own pop so that sync_host_shared_memory() only reports pops by others
+  m_shmem_sync_ridx += 1;
+  if (m_shmem_barrier_sync) m_shmem_own_pops.insert(pos);
+  return true;
 }
 
 
@@ -714,6 +1093,22 @@ void xtsc_component::xtsc_queue::execute(const string&          cmd_line,
     u32 port = (words.size() <= 1) ?  0 : xtsc_command_argtou32(cmd_line, words, 1);
     res << get_queue_push_interface(port).nb_can_push();
   }
+  else if (words[0] == "checkpoint") {
+    if (words[1] == "save") {
+      checkpoint_save();
+    }
+    else if (words[1] == "restore") {
+      res << checkpoint_restore();
+    }
+    else if (words[1] == "discard") {
+      checkpoint_discard();
+    }
+    else {
+      ostringstream oss;
+      oss << "Command '" << cmd_line << "' has invalid argument '" << words[1] << "' (expected save|restore|discard).";
+      throw xtsc_exception(oss.str());
+    }
+  }
   else if (words[0] == "dump") {
     dump(res);
   }
@@ -832,6 +1227,7 @@ void xtsc_component::xtsc_queue::connect(xtsc_queue_consumer& consumer, u32 port
 
 void xtsc_component::xtsc_queue::delta_cycle_method() {
   XTSC_DEBUG(m_text, "delta_cycle_method()");
+  if (m_checkpoint_restore_pending) return;
 
   for (u32 limit = m_skid_index + m_num_producers; ((m_skid_index < limit) && (m_fifo.num_free() != 0)); ++m_skid_index) {
     u32 port = m_skid_index % m_num_producers;
@@ -840,11 +1236,12 @@ void xtsc_component::xtsc_queue::delta_cycle_method() {
       m_skid_fifos[port]->nb_read(dummy);
       m_fifo.nb_write(m_next);
       m_tickets[m_next] = m_skid_tickets[port];
-      *m_element_ptrs[m_next] = *m_skid_buffers[port];
+      copy_element(element_words(m_next), &m_skid_words[port * m_words_per_element]);
       m_next = (m_next + 1) % m_depth;
       m_nonfull_events[port]->notify(SC_ZERO_TIME);
       m_push_pop_event.notify(SC_ZERO_TIME);
-      XTSC_DEBUG(m_text, "delta_cycle_method() moved from skid buffer #" << port << " to fifo: 0x" << hex << *m_skid_buffers[port]);
+      XTSC_DEBUG(m_text, "delta_cycle_method() moved from skid buffer #" << port << " to fifo: " <<
+                         element_to_string(&m_skid_words[port * m_words_per_element]));
     }
   }
   m_skid_index = m_skid_index % m_num_producers;
@@ -857,10 +1254,11 @@ void xtsc_component::xtsc_queue::delta_cycle_method() {
       int index = 0;
       m_fifo.nb_read(index);
       m_jerk_tickets[port] = m_tickets[index];
-      *m_jerk_buffers[port] = *m_element_ptrs[index];
+      copy_element(&m_jerk_words[port * m_words_per_element], element_words(index));
       m_nonempty_events[port]->notify(SC_ZERO_TIME);
       m_push_pop_event.notify(SC_ZERO_TIME);
-      XTSC_DEBUG(m_text, "delta_cycle_method() moved from fifo to jerk buffer #" << port << ": 0x" << hex << *m_jerk_buffers[port]);
+      XTSC_DEBUG(m_text, "delta_cycle_method() moved from fifo to jerk buffer #" << port << ": " <<
+                         element_to_string(&m_jerk_words[port * m_words_per_element]));
     }
   }
   m_jerk_index = m_jerk_index % m_num_consumers;
@@ -870,6 +1268,67 @@ void xtsc_component::xtsc_queue::delta_cycle_method() {
 
 
 
+void xtsc_component::xtsc_queue::pack_element(const sc_unsigned& element, u64 *p_words) {
+  const sc_unsigned *p_element = &element;
+  if ((u32) element.length() != m_width1) {
+    m_element_temp = element;
+    p_element = &m_element_temp;
+  }
+  if (m_words_per_element == 1) {
+    p_words[0] = p_element->to_uint64();
+    return;
+  }
+  for (u32 i=0; i<m_words_per_element; ++i) {
+    u32 lsb = i * 64;
+    u32 msb = min(lsb + 63, m_width1 - 1);
+    p_words[i] = p_element->range(msb, lsb).to_uint64();
+  }
+}
+
+
+
+void xtsc_component::xtsc_queue::unpack_element(const u64 *p_words, sc_unsigned& element) {
+  sc_unsigned *p_element = &element;
+  if ((u32) element.length() != m_width1) {
+    p_element = &m_element_temp;
+  }
+  if (m_words_per_element == 1) {
+    *p_element = p_words[0];
+  }
+  else {
+    for (u32 i=0; i<m_words_per_element; ++i) {
+      u32 lsb = i * 64;
+      u32 msb = min(lsb + 63, m_width1 - 1);
+      p_element->range(msb, lsb) = p_words[i];
+    }
+  }
+  if (p_element != &element) {
+    element = m_element_temp;
+  }
+}
+
+
+
+void xtsc_component::xtsc_queue::copy_element(u64 *p_dst, const u64 *p_src) const {
+  switch (m_words_per_element) {
+    case  1: copy_words< 1>(p_dst, p_src); break;
+    case  2: copy_words< 2>(p_dst, p_src); break;
+    case  4: copy_words< 4>(p_dst, p_src); break;
+    case  8: copy_words< 8>(p_dst, p_src); break;
+    case 16: copy_words<16>(p_dst, p_src); break;
+    default: memcpy(p_dst, p_src, m_words_per_element * 8); break;
+  }
+}
+
+
+
+string xtsc_component::xtsc_queue::element_to_string(const u64 *p_words) {
+  unpack_element(p_words, m_element_temp);
+  return "0x" + m_element_temp.to_string(SC_HEX).substr(m_width1%4 ? 2 : 3);
+}
+
+
+
 void xtsc_component::xtsc_queue::get_next_pop_file_element() {
   if (!m_has_pop_file_element) {
     return;
@@ -900,11 +1359,14 @@ void xtsc_component::xtsc_queue::get_next_pop_file_element() {
 xtsc::u32 xtsc_component::xtsc_queue::xtsc_queue_push_if_impl::nb_num_free_spaces() {
   u32 num_free = 0;
   if (m_queue.m_use_fifo) {
-    num_free = m_queue.m_fifo.num_free();
+    num_free = (m_queue.m_checkpoint_restore_pending ? 0 : m_queue.m_fifo.num_free());
+  }
+  else if (m_queue.m_shmem_mpmc) {
+    num_free = m_queue.shmem_mpmc_num_free();
   }
   else if (m_queue.m_p_shmem) {
-    // num_free = (((*m_queue.m_p_shmem_widx + 1) % m_queue.m_shmem_num_rows) != *m_queue.m_p_shmem_ridx);   // not full
-    num_free = (((*m_queue.m_p_shmem_widx + 1) % m_queue.m_shmem_num_rows) != *m_queue.m_p_shmem_ridx) ? 1 : 0; // TODO
+    // num_free = (((shmem_load(m_queue.m_p_shmem_widx) + 1) % m_queue.m_shmem_num_rows) != shmem_load(m_queue.m_p_shmem_ridx));   // not full
+    num_free = (((m_queue.shmem_visible_widx() + 1) % m_queue.m_shmem_num_rows) != m_queue.shmem_visible_ridx()) ? 1 : 0; // TODO
   }
   else {
     if (m_queue.m_push_file) {
@@ -925,7 +1387,7 @@ xtsc::u32 xtsc_component::xtsc_queue::xtsc_queue_push_if_impl::nb_num_free_space
 bool xtsc_component::xtsc_queue::xtsc_queue_push_if_impl::nb_can_push() {
   bool can_push = false;
   if (m_queue.m_use_fifo) {
-    if (m_queue.m_fifo.num_free() != 0) {
+    if (!m_queue.m_checkpoint_restore_pending && (m_queue.m_fifo.num_free() != 0)) {
       can_push = true;
     }
     else {
@@ -934,8 +1396,11 @@ bool xtsc_component::xtsc_queue::xtsc_queue_push_if_impl::nb_can_push() {
       can_push = false;
     }
   }
+  else if (m_queue.m_shmem_mpmc) {
+    can_push = (m_queue.shmem_mpmc_num_free() != 0);
+  }
   else if (m_queue.m_p_shmem) {
-    can_push = (((*m_queue.m_p_shmem_widx + 1) % m_queue.m_shmem_num_rows) != *m_queue.m_p_shmem_ridx);   // not full
+    can_push = (((m_queue.shmem_visible_widx() + 1) % m_queue.m_shmem_num_rows) != m_queue.shmem_visible_ridx());   // not full
   }
   else {
     if (m_queue.m_push_file) {
@@ -956,11 +1421,14 @@ bool xtsc_component::xtsc_queue::xtsc_queue_push_if_impl::nb_can_push() {
 xtsc::u32 xtsc_component::xtsc_queue::xtsc_queue_pop_if_impl::nb_num_available_entries() {
   u32 num_available = 0;
   if (m_queue.m_use_fifo) {
-    num_available = m_queue.m_fifo.num_available();
+    num_available = (m_queue.m_checkpoint_restore_pending ? 0 : m_queue.m_fifo.num_available());
+  }
+  else if (m_queue.m_shmem_mpmc) {
+    num_available = m_queue.shmem_mpmc_num_available();
   }
   else if (m_queue.m_p_shmem) {
-    // num_available = (*m_queue.m_p_shmem_widx != *m_queue.m_p_shmem_ridx);   // not empty
-    num_available = ((*m_queue.m_p_shmem_widx != *m_queue.m_p_shmem_ridx) ? 1 : 0);       // TODO
+    // num_available = (shmem_load(m_queue.m_p_shmem_widx) != shmem_load(m_queue.m_p_shmem_ridx));   // not empty
+    num_available = ((m_queue.shmem_visible_widx() != m_queue.shmem_visible_ridx()) ? 1 : 0);       // TODO
   }
   else {
     if (m_queue.m_pop_file) {
@@ -981,7 +1449,7 @@ xtsc::u32 xtsc_component::xtsc_queue::xtsc_queue_pop_if_impl::nb_num_available_e
 bool xtsc_component::xtsc_queue::xtsc_queue_pop_if_impl::nb_can_pop() {
   bool can_pop = false;
   if (m_queue.m_use_fifo) {
-    if (m_queue.m_fifo.num_available() != 0) {
+    if (!m_queue.m_checkpoint_restore_pending && (m_queue.m_fifo.num_available() != 0)) {
       can_pop = true;
     }
     else {
@@ -990,8 +1458,11 @@ bool xtsc_component::xtsc_queue::xtsc_queue_pop_if_impl::nb_can_pop() {
       can_pop = false;
     }
   }
+  else if (m_queue.m_shmem_mpmc) {
+    can_pop = (m_queue.shmem_mpmc_num_available() != 0);
+  }
   else if (m_queue.m_p_shmem) {
-    can_pop = (*m_queue.m_p_shmem_widx != *m_queue.m_p_shmem_ridx);   // not empty
+    can_pop = (m_queue.shmem_visible_widx() != m_queue.shmem_visible_ridx());   // not empty
   }
   else {
     if (m_queue.m_pop_file) {
@@ -1017,7 +1488,7 @@ bool xtsc_component::xtsc_queue::xtsc_queue_push_if_impl::nb_push(const sc_unsig
     throw xtsc_exception(oss.str());
   }
   if (m_queue.m_use_fifo) {
-    if (!m_queue.m_fifo.nb_write(m_queue.m_next)) {
+    if (m_queue.m_checkpoint_restore_pending || !m_queue.m_fifo.nb_write(m_queue.m_next)) {
       xtsc_log_queue_event(m_queue.m_binary, INFO_LOG_LEVEL, 0, UNKNOWN, PUSH_FAILED, UNKNOWN_PC, m_queue.m_fifo.num_available(),
                            m_queue.m_depth, m_queue.m_log_data_binary, element);
       return false;
@@ -1025,7 +1496,7 @@ bool xtsc_component::xtsc_queue::xtsc_queue_push_if_impl::nb_push(const sc_unsig
     ticket = xtsc_create_queue_ticket();
     m_queue.m_push_ticket = ticket;
     m_queue.m_tickets[m_queue.m_next] = ticket;
-    *m_queue.m_element_ptrs[m_queue.m_next] = element;
+    m_queue.pack_element(element, m_queue.element_words(m_queue.m_next));
     XTSC_INFO(m_queue.m_text, "Pushed (ticket=" << ticket << " cnt=" << m_queue.m_fifo.num_available()+1 <<
                               "): 0x" << element.to_string(SC_HEX).substr(m_queue.m_width1%4 ? 2 : 3));
     xtsc_log_queue_event(m_queue.m_binary, INFO_LOG_LEVEL, ticket, UNKNOWN, PUSH, UNKNOWN_PC, m_queue.m_fifo.num_available()+1,
@@ -1038,9 +1509,17 @@ bool xtsc_component::xtsc_queue::xtsc_queue_push_if_impl::nb_push(const sc_unsig
     }
     return true;
   }
+  else if (m_queue.m_shmem_mpmc) {
+    if (!m_queue.shmem_mpmc_push(element, ticket)) { return false; }
+    m_queue.m_push_ticket = ticket;
+    XTSC_INFO(m_queue.m_text, "Pushed (ticket=" << ticket << "): 0x" << element.to_string(SC_HEX).substr(m_queue.m_width1%4 ? 2 : 3));
+    m_queue.m_push_pop_event.notify(SC_ZERO_TIME);
+    m_queue.m_nonempty_event.notify(SC_ZERO_TIME);
+    return true;
+  }
   else if (m_queue.m_p_shmem) {
-    u32  widx = *m_queue.m_p_shmem_widx;
-    u32  ridx = *m_queue.m_p_shmem_ridx;
+    u32  widx = m_queue.shmem_visible_widx();
+    u32  ridx = m_queue.shmem_visible_ridx();
     bool full = (((widx + 1) % m_queue.m_shmem_num_rows) == ridx);
     if (full) { return false; }
     bool empty = (ridx == widx);
@@ -1051,7 +1530,8 @@ bool xtsc_component::xtsc_queue::xtsc_queue_push_if_impl::nb_push(const sc_unsig
     xtsc_sc_unsigned_to_byte_array(element, &m_queue.m_p_shmem[row_offset+8]);
     XTSC_INFO(m_queue.m_text, "Pushed (ticket=" << ticket << " ridx=" << ridx << " widx=" << widx <<
                               "): 0x" << element.to_string(SC_HEX).substr(m_queue.m_width1%4 ? 2 : 3));
-    *m_queue.m_p_shmem_widx = (widx + 1) % m_queue.m_shmem_num_rows;
+    shmem_store(m_queue.m_p_shmem_widx, (widx + 1) % m_queue.m_shmem_num_rows);
+    m_queue.m_shmem_sync_widx = (widx + 1) % m_queue.m_shmem_num_rows;   // Not a remote push for sync_host_shared_memory()
     m_queue.m_push_pop_event.notify(SC_ZERO_TIME);
     if (empty) {
       m_queue.m_nonempty_event.notify(SC_ZERO_TIME);
@@ -1086,12 +1566,12 @@ bool xtsc_component::xtsc_queue::xtsc_queue_push_if_impl::nb_push(const sc_unsig
 bool xtsc_component::xtsc_queue::xtsc_queue_pop_if_impl::nb_pop(sc_unsigned& element, u64& ticket) {
   if (m_queue.m_use_fifo) {
     int index = 0;
-    if (!m_queue.m_fifo.nb_read(index)) {
+    if (m_queue.m_checkpoint_restore_pending || !m_queue.m_fifo.nb_read(index)) {
       xtsc_log_queue_event(m_queue.m_binary, INFO_LOG_LEVEL, 0, UNKNOWN, POP_FAILED, UNKNOWN_PC, m_queue.m_fifo.num_available(),
                            m_queue.m_depth, false, m_queue.m_dummy);
       return false;
     }
-    element = *m_queue.m_element_ptrs[index];
+    m_queue.unpack_element(m_queue.element_words(index), element);
     ticket = m_queue.m_tickets[index];
     m_queue.m_pop_ticket = ticket;
     XTSC_INFO(m_queue.m_text, "Popped (ticket=" << ticket << " cnt=" << m_queue.m_fifo.num_available() <<
@@ -1105,9 +1585,17 @@ bool xtsc_component::xtsc_queue::xtsc_queue_pop_if_impl::nb_pop(sc_unsigned& ele
     }
     return true;
   }
+  else if (m_queue.m_shmem_mpmc) {
+    if (!m_queue.shmem_mpmc_pop(element, ticket, false)) { return false; }
+    m_queue.m_pop_ticket = ticket;
+    XTSC_INFO(m_queue.m_text, "Popped (ticket=" << ticket << "): 0x" << element.to_string(SC_HEX).substr(m_queue.m_width1%4 ? 2 : 3));
+    m_queue.m_push_pop_event.notify(SC_ZERO_TIME);
+    m_queue.m_nonfull_event.notify(SC_ZERO_TIME);
+    return true;
+  }
   else if (m_queue.m_p_shmem) {
-    u32  widx  = *m_queue.m_p_shmem_widx;
-    u32  ridx  = *m_queue.m_p_shmem_ridx;
+    u32  widx  = m_queue.shmem_visible_widx();
+    u32  ridx  = m_queue.shmem_visible_ridx();
     bool empty = (ridx == widx);
     if (empty) { return false; }
     bool full = (((widx + 1) % m_queue.m_shmem_num_rows) == ridx);
@@ -1117,7 +1605,8 @@ bool xtsc_component::xtsc_queue::xtsc_queue_pop_if_impl::nb_pop(sc_unsigned& ele
     xtsc_byte_array_to_sc_unsigned(&m_queue.m_p_shmem[row_offset+8], element);
     XTSC_INFO(m_queue.m_text, "Popped (ticket=" << ticket << " ridx=" << ridx << " widx=" << widx <<
                               "): 0x" << element.to_string(SC_HEX).substr(m_queue.m_width1%4 ? 2 : 3));
-    *m_queue.m_p_shmem_ridx = (ridx + 1) % m_queue.m_shmem_num_rows;
+    shmem_store(m_queue.m_p_shmem_ridx, (ridx + 1) % m_queue.m_shmem_num_rows);
+    m_queue.m_shmem_sync_ridx = (ridx + 1) % m_queue.m_shmem_num_rows;   // Not a remote pop for sync_host_shared_memory()
     m_queue.m_push_pop_event.notify(SC_ZERO_TIME);
     if (full) {
       m_queue.m_nonfull_event.notify(SC_ZERO_TIME);
@@ -1150,20 +1639,26 @@ bool xtsc_component::xtsc_queue::xtsc_queue_pop_if_impl::nb_pop(sc_unsigned& ele
 
 void xtsc_component::xtsc_queue::xtsc_queue_pop_if_impl::nb_peek(sc_unsigned& element, u64& ticket) {
   if (m_queue.m_use_fifo) {
-    if (!m_queue.m_fifo.num_available()) {
+    if (m_queue.m_checkpoint_restore_pending || !m_queue.m_fifo.num_available()) {
       return;
     }
     u32 index = m_queue.get_index_of_nth_from_front(1, __FUNCTION__);
-    element = *m_queue.m_element_ptrs[index];
+    m_queue.unpack_element(m_queue.element_words(index), element);
     ticket = m_queue.m_tickets[index];
     m_queue.m_pop_ticket = ticket;
     XTSC_INFO(m_queue.m_text, "Peeked (ticket=" << ticket << " cnt=" << m_queue.m_fifo.num_available() <<
                                "): 0x" << element.to_string(SC_HEX).substr(m_queue.m_width1%4 ? 2 : 3));
     return;
   }
+  else if (m_queue.m_shmem_mpmc) {
+    if (!m_queue.shmem_mpmc_pop(element, ticket, true)) { return; }
+    m_queue.m_pop_ticket = ticket;
+    XTSC_INFO(m_queue.m_text, "Peeked (ticket=" << ticket << "): 0x" << element.to_string(SC_HEX).substr(m_queue.m_width1%4 ? 2 : 3));
+    return;
+  }
   else if (m_queue.m_p_shmem) {
-    u32  widx  = *m_queue.m_p_shmem_widx;
-    u32  ridx  = *m_queue.m_p_shmem_ridx;
+    u32  widx  = m_queue.shmem_visible_widx();
+    u32  ridx  = m_queue.shmem_visible_ridx();
     bool empty = (ridx == widx);
     if (empty) { return; }
     u32 row_offset = ridx * m_queue.m_shmem_bytes_per_row;
@@ -1228,7 +1723,10 @@ void xtsc_component::xtsc_queue::xtsc_queue_pop_if_impl::register_port(sc_port_b
 xtsc::u32 xtsc_component::xtsc_queue::xtsc_queue_push_if_multi_impl::nb_num_free_spaces() {
   u32 num_free = 0;
   if (m_queue.m_use_fifo) {
-    num_free = m_queue.m_skid_fifos[m_port_num]->num_free();
+    num_free = (m_queue.m_checkpoint_restore_pending ? 0 : m_queue.m_skid_fifos[m_port_num]->num_free());
+  }
+  else if (m_queue.m_p_shmem) {
+    num_free = m_queue.shmem_mpmc_num_free();
   }
   else {
     if (m_queue.m_push_file) {
@@ -1249,7 +1747,7 @@ xtsc::u32 xtsc_component::xtsc_queue::xtsc_queue_push_if_multi_impl::nb_num_free
 bool xtsc_component::xtsc_queue::xtsc_queue_push_if_multi_impl::nb_can_push() {
   bool can_push = false;
   if (m_queue.m_use_fifo) {
-    if (m_queue.m_skid_fifos[m_port_num]->num_free() != 0) {
+    if (!m_queue.m_checkpoint_restore_pending && (m_queue.m_skid_fifos[m_port_num]->num_free() != 0)) {
       can_push = true;
     }
     else {
@@ -1258,6 +1756,9 @@ bool xtsc_component::xtsc_queue::xtsc_queue_push_if_multi_impl::nb_can_push() {
       can_push = false;
     }
   }
+  else if (m_queue.m_p_shmem) {
+    can_push = (m_queue.shmem_mpmc_num_free() != 0);
+  }
   else {
     if (m_queue.m_push_file) {
       can_push = true;
@@ -1290,7 +1791,7 @@ bool xtsc_component::xtsc_queue::xtsc_queue_push_if_multi_impl::nb_push(const sc
     ticket = xtsc_create_queue_ticket();
     m_queue.m_skid_tickets[m_port_num] = ticket;
     m_queue.m_skid_fifos[m_port_num]->nb_write(0);
-    *m_queue.m_skid_buffers[m_port_num] = element;
+    m_queue.pack_element(element, &m_queue.m_skid_words[m_port_num * m_queue.m_words_per_element]);
     XTSC_INFO(m_queue.m_text, "Pushed (ticket=" << ticket << " cnt=" << m_queue.m_fifo.num_available()+1 << "): 0x" <<
                               element.to_string(SC_HEX).substr(m_queue.m_width1%4 ? 2 : 3) << " (Port #" << m_port_num << ")");
     xtsc_log_queue_event(m_queue.m_binary, INFO_LOG_LEVEL, ticket, UNKNOWN, PUSH, UNKNOWN_PC, m_queue.m_fifo.num_available()+1,
@@ -1298,6 +1799,15 @@ bool xtsc_component::xtsc_queue::xtsc_queue_push_if_multi_impl::nb_push(const sc
     m_queue.m_push_pop_event.notify(SC_ZERO_TIME);
     return true;
   }
+  else if (m_queue.m_p_shmem) {
+    if (!m_queue.shmem_mpmc_push(element, ticket)) { return false; }
+    m_queue.m_push_ticket = ticket;
+    XTSC_INFO(m_queue.m_text, "Pushed (ticket=" << ticket << "): 0x" << element.to_string(SC_HEX).substr(m_queue.m_width1%4 ? 2 : 3) <<
+                              " (Port #" << m_port_num << ")");
+    m_queue.m_push_pop_event.notify(SC_ZERO_TIME);
+    m_queue.m_nonempty_event.notify(SC_ZERO_TIME);
+    return true;
+  }
   else {
     ticket = 0ULL;
     if (m_queue.m_push_file) {
@@ -1340,7 +1850,10 @@ void xtsc_component::xtsc_queue::xtsc_queue_push_if_multi_impl::register_port(sc
 xtsc::u32 xtsc_component::xtsc_queue::xtsc_queue_pop_if_multi_impl::nb_num_available_entries() {
   u32 num_available = 0;
   if (m_queue.m_use_fifo) {
-    num_available = m_queue.m_jerk_fifos[m_port_num]->num_available();
+    num_available = (m_queue.m_checkpoint_restore_pending ? 0 : m_queue.m_jerk_fifos[m_port_num]->num_available());
+  }
+  else if (m_queue.m_p_shmem) {
+    num_available = m_queue.shmem_mpmc_num_available();
   }
   else {
     if (m_queue.m_pop_file) {
@@ -1361,7 +1874,7 @@ xtsc::u32 xtsc_component::xtsc_queue::xtsc_queue_pop_if_multi_impl::nb_num_avail
 bool xtsc_component::xtsc_queue::xtsc_queue_pop_if_multi_impl::nb_can_pop() {
   bool can_pop = false;
   if (m_queue.m_use_fifo) {
-    if (m_queue.m_jerk_fifos[m_port_num]->num_available() != 0) {
+    if (!m_queue.m_checkpoint_restore_pending && (m_queue.m_jerk_fifos[m_port_num]->num_available() != 0)) {
       can_pop = true;
     }
     else {
@@ -1369,6 +1882,9 @@ bool xtsc_component::xtsc_queue::xtsc_queue_pop_if_multi_impl::nb_can_pop() {
                            m_queue.m_depth, false, m_queue.m_dummy);
     }
   }
+  else if (m_queue.m_p_shmem) {
+    can_pop = (m_queue.shmem_mpmc_num_available() != 0);
+  }
   else {
     if (m_queue.m_pop_file) {
       can_pop = m_queue.m_has_pop_file_element;
@@ -1394,7 +1910,7 @@ bool xtsc_component::xtsc_queue::xtsc_queue_pop_if_multi_impl::nb_pop(sc_unsigne
     }
     int dummy = 0;
     m_queue.m_jerk_fifos[m_port_num]->nb_read(dummy);
-    element = *m_queue.m_jerk_buffers[m_port_num];
+    m_queue.unpack_element(&m_queue.m_jerk_words[m_port_num * m_queue.m_words_per_element], element);
     ticket  =  m_queue.m_jerk_tickets[m_port_num];
     XTSC_INFO(m_queue.m_text, "Popped (ticket=" << ticket << "): 0x" << element.to_string(SC_HEX).substr(m_queue.m_width1%4 ? 2 : 3) <<
                               " (Port #" << m_port_num << ")");
@@ -1403,6 +1919,15 @@ bool xtsc_component::xtsc_queue::xtsc_queue_pop_if_multi_impl::nb_pop(sc_unsigne
     m_queue.m_push_pop_event.notify(SC_ZERO_TIME);
     return true;
   }
+  else if (m_queue.m_p_shmem) {
+    if (!m_queue.shmem_mpmc_pop(element, ticket, false)) { return false; }
+    m_queue.m_pop_ticket = ticket;
+    XTSC_INFO(m_queue.m_text, "Popped (ticket=" << ticket << "): 0x" << element.to_string(SC_HEX).substr(m_queue.m_width1%4 ? 2 : 3) <<
+                              " (Port #" << m_port_num << ")");
+    m_queue.m_push_pop_event.notify(SC_ZERO_TIME);
+    m_queue.m_nonfull_event.notify(SC_ZERO_TIME);
+    return true;
+  }
   else {
     ticket = 0ULL;
     if (m_queue.m_pop_file) {
@@ -145,9 +145,12 @@ xtsc_component::xtsc_router::xtsc_router(sc_module_name module_name, const xtsc_
   m_wait_on_outstanding_write      (router_parms.get_bool("wait_on_outstanding_write")),
   m_log_peek_poke                  (router_parms.get_bool("log_peek_poke")),
   m_num_bit_fields                 (0),
+  m_num_compiled_entries           (0),
+  m_last_routing_segment           (0),
   m_lua_port_function              (""),
   m_lua_addr_function              (""),
   m_lua_function                   (false),
+  m_lua_cache_page_size            (router_parms.get_u32("lua_cache_page_size")),
   m_route_by_priority              (router_parms.get_u32_vector("route_by_priority")),
   m_use_route_by_priority          (m_route_by_priority.size()>0),
   m_use_route_by_type              (false),
@@ -157,6 +160,7 @@ xtsc_component::xtsc_router::xtsc_router(sc_module_name module_name, const xtsc_
   m_waiting_reads_thread_event     ("m_waiting_reads_thread_event"),
   m_outstanding_write_event        ("m_outstanding_write_event"),
 #endif
+  m_allocator                      (name()),
   m_file                           (NULL),
   m_filter_peeks                   (false),
   m_filter_pokes                   (false),
@@ -176,6 +180,13 @@ xtsc_component::xtsc_router::xtsc_router(sc_module_name module_name, const xtsc_
   m_num_slaves                  = router_parms.get_u32("num_slaves");
   m_default_port_num            = router_parms.get_u32("default_port_num");
   m_default_delta               = router_parms.get_u64("default_delta");
+  m_lua_cache_page_mask         = XTSC_MAX_ADDRESS ^ (xtsc_address) (m_lua_cache_page_size - 1);
+
+  if (m_lua_cache_page_size & (m_lua_cache_page_size - 1)) {
+    ostringstream oss;
+    oss << "xtsc_router '" << name() << "': \"lua_cache_page_size\"=" << m_lua_cache_page_size << " is not a power of 2";
+    throw xtsc_exception(oss.str());
+  }
 
   m_transaction_id_counts       = NULL;
   m_transaction_id_timestamps   = NULL;
@@ -635,6 +646,12 @@ xtsc_component::xtsc_router::xtsc_router(sc_module_name module_name, const xtsc_
       }
     }
 
+    compile_routing_table();
+    if (m_routing_table.size()) {
+      XTSC_LOG(m_text, xtsc_get_constructor_log_level(), "Compiled " << m_routing_table.size() << " routing table entries into " <<
+                                                         m_routing_segments.size() << " address segments");
+    }
+
   }
 
   ostringstream route_by_priority;
@@ -806,6 +823,11 @@ xtsc_component::xtsc_router::xtsc_router(sc_module_name module_name, const xtsc_
       "Call xtsc_router::reset()."
   );
 
+  xtsc_register_command(*this, *this, "revoke_fast_access", 0, 0,
+      "revoke_fast_access", 
+      "Call xtsc_router::revoke_fast_access()."
+  );
+
   xtsc_register_command(*this, *this, "watchfilter_add", 2, 2,
       "watchfilter_add <FilterName> <EventName>", 
       "Calls xtsc_router::watchfilter_add(<FilterName>, <Event>) and returns the watchfilter number."
@@ -842,6 +864,7 @@ xtsc_component::xtsc_router::xtsc_router(sc_module_name module_name, const xtsc_
   }
   XTSC_LOG(m_text, ll,        " default_routing            = "   << boolalpha << default_routing);
   XTSC_LOG(m_text, ll,        " routing_table              = "   << (routing_table ? (m_file ? m_file_name : routing_table) : ""));
+  XTSC_LOG(m_text, ll, hex << " lua_cache_page_size        = 0x" << m_lua_cache_page_size);
   XTSC_LOG(m_text, ll, hex << " default_port_num           = 0x" << m_default_port_num);
   XTSC_LOG(m_text, ll, hex << " default_delta              = 0x" << m_default_delta);
   { ostringstream oss; for (u32 i=0; i<m_address_routing_bits.size(); ++i) oss << (i ? "," : "") << m_address_routing_bits[i];
@@ -1073,6 +1096,10 @@ void xtsc_component::xtsc_router::reset(bool /*hard_reset*/) {
   m_last_request_time_stamp     = SC_ZERO_TIME - (m_delay_from_receipt ? m_recovery_time : m_request_delay);
   m_last_response_time_stamp    = SC_ZERO_TIME - (m_delay_from_receipt ? m_recovery_time : m_response_delay);
 
+  m_lua_cache.clear();
+
+  revoke_fast_access();
+
   if (m_is_pwc) {
     m_pending_request_tag        = 0;            // Indicates there is no pending request
     m_active_block_read_tag      = 0;            // Indicates no BLOCK_READ response is in progress
@@ -1209,6 +1236,9 @@ void xtsc_component::xtsc_router::execute(const string&                 cmd_line
   else if (words[0] == "reset") {
     reset();
   }
+  else if (words[0] == "revoke_fast_access") {
+    revoke_fast_access();
+  }
   else if (words[0] == "watchfilter_add") {
     sc_event& event = xtsc_event_get(words[2]);
     res << watchfilter_add(words[1], event);
@@ -2683,42 +2713,144 @@ u32 xtsc_component::xtsc_router::get_port_and_apply_address_translation(xtsc_add
     }
     return port_num;
   }
-  vector<xtsc_address_range_entry>::iterator i_table = m_routing_table.begin();
-  for (i_table=m_routing_table.begin(); i_table != m_routing_table.end(); ++i_table) {
-    if ((address8 >= i_table->m_start_address8) && (address8 <= i_table->m_end_address8)) {
-      address8 += i_table->m_delta;
-      return i_table->m_port_num;
+  if (m_routing_table.size()) {
+    u32 entry_index = m_routing_segments[find_routing_segment(address8)].m_entry_index;
+    if (entry_index != NO_ROUTING_ENTRY) {
+      const xtsc_address_range_entry& entry = m_routing_table[entry_index];
+      address8 += entry.m_delta;
+      return entry.m_port_num;
     }
   }
   if (m_lua_function) {
+    if (m_lua_cache_page_size) {
+      xtsc_address page_address8 = address8 & m_lua_cache_page_mask;
+      map<xtsc_address, lua_cache_entry>::const_iterator i = m_lua_cache.find(page_address8);
+      if (i == m_lua_cache.end()) {
+        xtsc_address translated_address8 = page_address8;
+        u32 port_num = evaluate_lua_routing(translated_address8);
+        i = m_lua_cache.insert(make_pair(page_address8, lua_cache_entry(port_num, translated_address8 - page_address8))).first;
+      }
+      address8 += i->second.m_delta;
+      return i->second.m_port_num;
+    }
+    return evaluate_lua_routing(address8);
+  }
+  // Not in routing table
+  address8 += m_default_delta;
+  return m_default_port_num;
+}
+
+
+
+u32 xtsc_component::xtsc_router::evaluate_lua_routing(xtsc_address& address8) {
+  ostringstream exp;
+  exp << m_lua_port_function << "(0x" << hex << address8 << ")";
+  string result = m_file->evaluate_lua_expression(exp.str());
+  XTSC_VERBOSE(m_text, exp.str() << " => " << result);
+  u32 port_num = 0;
+  try { port_num = xtsc_strtou32(result); if (port_num >= m_num_slaves) throw port_num; } catch (...) {
+    ostringstream oss;
+    oss << "Call to Lua function " << exp.str() << " in \"routing_table\" file '" << m_file_name << "' returned '" << result
+        << "' which is not u32 or is out-of-range.";
+    throw xtsc_exception(oss.str());
+  }
+  if (m_lua_addr_function != "") {
     ostringstream exp;
-    exp << m_lua_port_function << "(0x" << hex << address8 << ")";
+    exp << m_lua_addr_function << "(0x" << hex << address8 << ")";
     string result = m_file->evaluate_lua_expression(exp.str());
-    XTSC_VERBOSE(m_text, exp.str() << " => " << result);
-    u32 port_num = 0;
-    try { port_num = xtsc_strtou32(result); if (port_num >= m_num_slaves) throw port_num; } catch (...) {
+    try { address8 = xtsc_strtou64(result); } catch (...) {
       ostringstream oss;
       oss << "Call to Lua function " << exp.str() << " in \"routing_table\" file '" << m_file_name << "' returned '" << result
-          << "' which is not u32 or is out-of-range.";
+          << "' which is not u64.";
       throw xtsc_exception(oss.str());
     }
-    if (m_lua_addr_function != "") {
-      ostringstream exp;
-      exp << m_lua_addr_function << "(0x" << hex << address8 << ")";
-      string result = m_file->evaluate_lua_expression(exp.str());
-      try { address8 = xtsc_strtou64(result); } catch (...) {
-        ostringstream oss;
-        oss << "Call to Lua function " << exp.str() << " in \"routing_table\" file '" << m_file_name << "' returned '" << result
-            << "' which is not u64.";
-        throw xtsc_exception(oss.str());
+    XTSC_VERBOSE(m_text, exp.str() << " => " << result << " = 0x" << hex << address8);
+  }
+  return port_num;
+}
+
+
+
+void xtsc_component::xtsc_router::revoke_fast_access() {
+  if (m_revocation_set.empty()) return;
+  XTSC_INFO(m_text, "Revoking fast access granted to " << m_revocation_set.size() << " master(s)");
+  // Swap first in case a master re-requests fast access from within revoke_fast_access()
+  set<xtsc_fast_access_revocation_if*> revocation_set;
+  revocation_set.swap(m_revocation_set);
+  for (set<xtsc_fast_access_revocation_if*>::iterator i = revocation_set.begin(); i != revocation_set.end(); ++i) {
+    (*i)->revoke_fast_access();
+  }
+}
+
+
+
+void xtsc_component::xtsc_router::compile_routing_table() {
+  // Any fast access granted under the old routing may now be wrong
+  revoke_fast_access();
+  m_routing_segments.clear();
+  m_num_compiled_entries = m_routing_table.size();
+  m_last_routing_segment = 0;
+  m_lua_cache.clear();
+  if (m_routing_table.empty()) return;
+
+  // Every address at which the first matching entry can change starts a new elementary segment
+  vector<xtsc_address> boundaries;
+  boundaries.push_back(0);
+  vector<xtsc_address_range_entry>::const_iterator irt;
+  for (irt = m_routing_table.begin(); irt != m_routing_table.end(); ++irt) {
+    if (irt->m_start_address8 > irt->m_end_address8) continue;
+    boundaries.push_back(irt->m_start_address8);
+    if (irt->m_end_address8 != XTSC_MAX_ADDRESS) {
+      boundaries.push_back(irt->m_end_address8 + 1);
+    }
+  }
+  sort(boundaries.begin(), boundaries.end());
+  boundaries.erase(unique(boundaries.begin(), boundaries.end()), boundaries.end());
+
+  // Give each elementary segment the first entry containing it and merge neighbors with the same entry
+  for (u32 i=0; i<boundaries.size(); ++i) {
+    xtsc_address start_address8 = boundaries[i];
+    xtsc_address end_address8   = ((i+1 < boundaries.size()) ? boundaries[i+1] - 1 : XTSC_MAX_ADDRESS);
+    u32          entry_index    = NO_ROUTING_ENTRY;
+    for (u32 j=0; j<m_routing_table.size(); ++j) {
+      if ((start_address8 >= m_routing_table[j].m_start_address8) && (start_address8 <= m_routing_table[j].m_end_address8)) {
+        entry_index = j;
+        break;
       }
-      XTSC_VERBOSE(m_text, exp.str() << " => " << result << " = 0x" << hex << address8);
     }
-    return port_num;
+    if (m_routing_segments.size() && (m_routing_segments.back().m_entry_index == entry_index)) {
+      m_routing_segments.back().m_end_address8 = end_address8;
+    }
+    else {
+      m_routing_segments.push_back(routing_segment(start_address8, end_address8, entry_index));
+    }
   }
-  // Not in routing table
-  address8 += m_default_delta;
-  return m_default_port_num;
+}
+
+
+
+u32 xtsc_component::xtsc_router::find_routing_segment(xtsc_address address8) {
+  if (m_routing_table.size() != m_num_compiled_entries) {
+    compile_routing_table();
+  }
+  const routing_segment& last = m_routing_segments[m_last_routing_segment];
+  if ((address8 >= last.m_start_address8) && (address8 <= last.m_end_address8)) {
+    return m_last_routing_segment;
+  }
+  // Binary search for the last segment starting at or below address8 (segment 0 always starts at 0)
+  u32 lo = 0;
+  u32 hi = m_routing_segments.size() - 1;
+  while (lo < hi) {
+    u32 mid = lo + (hi - lo + 1) / 2;
+    if (m_routing_segments[mid].m_start_address8 <= address8) {
+      lo = mid;
+    }
+    else {
+      hi = mid - 1;
+    }
+  }
+  m_last_routing_segment = lo;
+  return lo;
 }
 
 
@@ -2736,89 +2868,50 @@ u32 xtsc_component::xtsc_router::get_port_by_type(u32 type) {
 
 
 xtsc_component::xtsc_router::request_info *xtsc_component::xtsc_router::new_request_info(const xtsc_request& request) {
-  if (m_request_pool.empty()) {
-    request_info *p_request_info = new request_info(request);
-    XTSC_DEBUG(m_text, "Creating a new request_info " << p_request_info << " for " << request);
-    return p_request_info;
-  }
-  else {
-    request_info *p_request_info = m_request_pool.back();
-    XTSC_DEBUG(m_text, "Reusing request_info " << p_request_info << " for " << request);
-    m_request_pool.pop_back();
-    p_request_info->m_request = request;
-    p_request_info->m_time_stamp = sc_time_stamp();
-    return p_request_info;
-  }
+  request_info *p_request_info = m_allocator.create<request_info>(request);
+  XTSC_DEBUG(m_text, "Creating request_info " << p_request_info << " for " << request);
+  return p_request_info;
 }
 
 
 
 xtsc_component::xtsc_router::request_info *xtsc_component::xtsc_router::new_request_info(const request_info& info) {
-  if (m_request_pool.empty()) {
-    request_info *p_request_info = new request_info(info);
-    XTSC_DEBUG(m_text, "Creating a new request_info " << p_request_info << " for " << info.m_request);
-    return p_request_info;
-  }
-  else {
-    request_info *p_request_info = m_request_pool.back();
-    XTSC_DEBUG(m_text, "Reusing request_info " << p_request_info << " for " << info.m_request);
-    m_request_pool.pop_back();
-    *p_request_info = info;
-    return p_request_info;
-  }
+  request_info *p_request_info = m_allocator.create<request_info>(info);
+  XTSC_DEBUG(m_text, "Creating request_info " << p_request_info << " for " << info.m_request);
+  return p_request_info;
 }
 
 
 
 void xtsc_component::xtsc_router::delete_request_info(request_info*& p_request_info) {
   XTSC_DEBUG(m_text, "Recycling request_info " << p_request_info);
-  m_request_pool.push_back(p_request_info);
+  m_allocator.destroy(p_request_info);
   p_request_info = 0;
 }
 
 
 
 xtsc_component::xtsc_router::response_info *xtsc_component::xtsc_router::new_response_info(const xtsc_response& response) {
-  if (m_response_pool.empty()) {
-    response_info *p_response_info = new response_info(response);
-    XTSC_DEBUG(m_text, "Creating a new response_info " << p_response_info << " for " << response);
-    return p_response_info;
-  }
-  else {
-    response_info *p_response_info = m_response_pool.back();
-    XTSC_DEBUG(m_text, "Reusing response_info " << p_response_info << " for " << response);
-    m_response_pool.pop_back();
-    p_response_info->m_response = response;
-    p_response_info->m_response.set_exclusive_ok(response.get_exclusive_ok());
-    p_response_info->m_time_stamp = sc_time_stamp();
-    return p_response_info;
-  }
+  response_info *p_response_info = m_allocator.create<response_info>(response);
+  XTSC_DEBUG(m_text, "Creating response_info " << p_response_info << " for " << response);
+  p_response_info->m_response.set_exclusive_ok(response.get_exclusive_ok());
+  return p_response_info;
 }
 
 
 
 xtsc_component::xtsc_router::response_info *xtsc_component::xtsc_router::new_response_info(const xtsc_request& request) {
-  if (m_response_pool.empty()) {
-    response_info *p_response_info = new response_info(request);
-    XTSC_DEBUG(m_text, "Creating a new response_info " << p_response_info << " for " << request);
-    return p_response_info;
-  }
-  else {
-    response_info *p_response_info = m_response_pool.back();
-    XTSC_DEBUG(m_text, "Reusing response_info " << p_response_info << " for " << request);
-    m_response_pool.pop_back();
-    p_response_info->m_response = request;
-    p_response_info->m_response.set_exclusive_ok(request.get_exclusive());
-    p_response_info->m_time_stamp = sc_time_stamp();
-    return p_response_info;
-  }
+  response_info *p_response_info = m_allocator.create<response_info>(request);
+  XTSC_DEBUG(m_text, "Creating response_info " << p_response_info << " for " << request);
+  p_response_info->m_response.set_exclusive_ok(request.get_exclusive());
+  return p_response_info;
 }
 
 
 
 void xtsc_component::xtsc_router::delete_response_info(response_info*& p_response_info) {
   XTSC_DEBUG(m_text, "Recycling response_info " << p_response_info);
-  m_response_pool.push_back(p_response_info);
+  m_allocator.destroy(p_response_info);
   p_response_info = 0;
 }
 
@@ -2859,16 +2952,8 @@ u64 xtsc_component::xtsc_router::get_u64(u32 index) {
 
 
 xtsc_component::xtsc_router::req_rsp_info *xtsc_component::xtsc_router::new_req_rsp_info(request_info  *p_first_request_info) {
-  req_rsp_info *p_req_rsp_info;
-  if (m_req_rsp_info_pool.empty()) {
-    p_req_rsp_info = new req_rsp_info();
-    XTSC_DEBUG(m_text, "Creating a new req_rsp_info " << p_req_rsp_info);
-  }
-  else {
-    p_req_rsp_info = m_req_rsp_info_pool.back();
-    XTSC_DEBUG(m_text, "Reusing req_rsp_info " << p_req_rsp_info);
-    m_req_rsp_info_pool.pop_back();
-  }
+  req_rsp_info *p_req_rsp_info = m_allocator.create<req_rsp_info>();
+  XTSC_DEBUG(m_text, "Creating req_rsp_info " << p_req_rsp_info);
   p_req_rsp_info->m_p_first_request_info = p_first_request_info;
   return p_req_rsp_info;
 }
@@ -2878,8 +2963,7 @@ xtsc_component::xtsc_router::req_rsp_info *xtsc_component::xtsc_router::new_req_
 void xtsc_component::xtsc_router::delete_req_rsp_info(req_rsp_info*& p_req_rsp_info) {
   XTSC_DEBUG(m_text, "Recycling req_rsp_info " << p_req_rsp_info);
   delete_request_info(p_req_rsp_info->m_p_first_request_info);
-  memset(p_req_rsp_info, 0, sizeof(req_rsp_info));
-  m_req_rsp_info_pool.push_back(p_req_rsp_info);
+  m_allocator.destroy(p_req_rsp_info);
   p_req_rsp_info = 0;
 }
 
@@ -3165,24 +3249,24 @@ bool xtsc_component::xtsc_router::xtsc_request_if_impl::nb_fast_access(xtsc_fast
 
   if (!(*m_router.m_request_ports[port_num])->nb_fast_access(request)) { return false; }
 
+  // Remember who to tell if the route to this block later changes
+  xtsc_fast_access_revocation_if *p_if = request.get_fast_access_revocation_if();
+  if (p_if) {
+    m_router.m_revocation_set.insert(p_if);
+  }
+
   if (m_router.m_address_routing) {
     xtsc_address start_address8 = orig_address8  & m_router.m_address_routing_turbo_mask;
     xtsc_address end_address8   = start_address8 + m_router.m_address_routing_turbo_size - 1;
     xtsc_fast_access_block min_block(orig_address8, start_address8, end_address8);
     if (!request.restrict_to_block(min_block)) { return false; }   // TODO: Why check call to restrict_to_block and return false?
   }
-  else {
-    // Remove anything mapped before this address hits. When the address hits, remove anything outside of its range.
-    for (unsigned i = 0; i < m_router.m_routing_table.size(); ++i) {
-      xtsc_address end_address8   = m_router.m_routing_table[i].m_end_address8;
-      xtsc_address start_address8 = m_router.m_routing_table[i].m_start_address8;
-      if (start_address8 <= orig_address8 && orig_address8 <= end_address8) {
-        xtsc_fast_access_block min_block(orig_address8, start_address8, end_address8);
-        if (!request.restrict_to_block(min_block)) { return false; }
-        break;
-      }
-      if (!request.remove_address_range(orig_address8, start_address8, end_address8)) { return false; }
-    }
+  else if (m_router.m_routing_table.size()) {
+    // The compiled segment holding this address is what remains of the hit entry's range (or of the unmapped
+    // gap) after removing the ranges of all earlier entries, so restricting to it is all that is required.
+    const routing_segment& segment = m_router.m_routing_segments[m_router.find_routing_segment(orig_address8)];
+    xtsc_fast_access_block min_block(orig_address8, segment.m_start_address8, segment.m_end_address8);
+    if (!request.restrict_to_block(min_block)) { return false; }
   }
 
   if (xtsc_is_text_logging_enabled() && m_router.m_text.isEnabledFor(INFO_LOG_LEVEL)) {
@@ -0,0 +1,307 @@
+// Copyright (c) 2005-2018 by Cadence Design Systems, Inc.  ALL RIGHTS RESERVED.
+// These coded instructions, statements, and computer programs are the
+// copyrighted works and confidential proprietary information of Cadence Design Systems, Inc.
+// They may not be modified, copied, reproduced, distributed, or disclosed to
+// third parties in any manner, medium, or form, in whole or in part, without
+// the prior written consent of Cadence Design Systems, Inc.
+
+#include <cmath>
+#include <sstream>
+#include <iomanip>
+#include <xtsc/xtsc_sampling_controller.h>
+#include <xtsc/xtsc_core.h>
+#include <xtsc/xtsc_logging.h>
+
+
+using namespace std;
+#if SYSTEMC_VERSION >= 20050601
+using namespace sc_core;
+#endif
+using namespace xtsc;
+
+
+
+xtsc_component::xtsc_sampling_controller::xtsc_sampling_controller(sc_module_name                           module_name,
+                                                                   const xtsc_sampling_controller_parms&    sampling_parms) :
+  sc_module             (module_name),
+  xtsc_module           (*(sc_module*)this),
+  m_text                (log4xtensa::TextLogger::getInstance(name())),
+  m_functional_cycles   (sampling_parms.get_u32("functional_cycles")),
+  m_warmup_cycles       (sampling_parms.get_u32("warmup_cycles")),
+  m_measure_cycles      (sampling_parms.get_non_zero_u32("measure_cycles")),
+  m_max_samples         (sampling_parms.get_u32("num_samples")),
+  m_confidence          (sampling_parms.get_u32("confidence")),
+  m_z                   (0.0),
+  m_switch_poll_cycles  (sampling_parms.get_non_zero_u32("switch_poll_cycles")),
+  m_switch_settle_cycles(sampling_parms.get_u32("switch_settle_cycles")),
+  m_num_samples         (0),
+  m_num_switches        (0)
+{
+
+  // Two-sided standard normal quantiles
+  switch (m_confidence) {
+    case  80: m_z = 1.2816; break;
+    case  90: m_z = 1.6449; break;
+    case  95: m_z = 1.9600; break;
+    case  98: m_z = 2.3263; break;
+    case  99: m_z = 2.5758; break;
+    case 999: m_z = 3.2905; break;
+    default: {
+      ostringstream oss;
+      oss << kind() << " '" << name() << "': \"confidence\"=" << m_confidence
+          << " is not supported (supported values are 80, 90, 95, 98, 99, and 999).";
+      throw xtsc_exception(oss.str());
+    }
+  }
+
+  // Get clock period
+  u32 clock_period = sampling_parms.get_u32("clock_period");
+  if (clock_period == 0xFFFFFFFF) {
+    m_clock_period = xtsc_get_system_clock_period();
+  }
+  else {
+    m_clock_period = sc_get_time_resolution() * clock_period;
+  }
+
+  SC_THREAD(sampling_thread);
+
+  xtsc_register_command(*this, *this, "get_num_samples", 0, 0,
+      "get_num_samples",
+      "Return xtsc_sampling_controller::get_num_samples()."
+  );
+
+  xtsc_register_command(*this, *this, "report", 0, 0,
+      "report",
+      "Call xtsc_sampling_controller::report()."
+  );
+
+  xtsc_register_command(*this, *this, "reset", 0, 0,
+      "reset",
+      "Call xtsc_sampling_controller::reset()."
+  );
+
+  log4xtensa::LogLevel ll = xtsc_get_constructor_log_level();
+  XTSC_LOG(m_text, ll,        "Constructed " << kind() << " '" << name() << "':");
+  XTSC_LOG(m_text, ll,        " functional_cycles       = "   << m_functional_cycles);
+  XTSC_LOG(m_text, ll,        " warmup_cycles           = "   << m_warmup_cycles);
+  XTSC_LOG(m_text, ll,        " measure_cycles          = "   << m_measure_cycles);
+  XTSC_LOG(m_text, ll,        " num_samples             = "   << m_max_samples);
+  XTSC_LOG(m_text, ll,        " confidence              = "   << m_confidence);
+  XTSC_LOG(m_text, ll,        " switch_poll_cycles      = "   << m_switch_poll_cycles);
+  XTSC_LOG(m_text, ll,        " switch_settle_cycles    = "   << m_switch_settle_cycles);
+  if (clock_period == 0xFFFFFFFF) {
+  XTSC_LOG(m_text, ll,        " clock_period            = 0x" << hex << clock_period << " (" << m_clock_period << ")");
+  } else {
+  XTSC_LOG(m_text, ll,        " clock_period            = "   << clock_period << " (" << m_clock_period << ")");
+  }
+
+  reset();
+}
+
+
+
+xtsc_component::xtsc_sampling_controller::~xtsc_sampling_controller() {
+  for (vector<core_info*>::iterator ic = m_cores.begin(); ic != m_cores.end(); ++ic) {
+    delete *ic;
+  }
+}
+
+
+
+u32 xtsc_component::xtsc_sampling_controller::get_bit_width(const string& port_name, u32 interface_num) const {
+  ostringstream oss;
+  oss << kind() << " \"" << name() << "\" has no port named \"" << port_name << "\"" << endl;
+  throw xtsc_exception(oss.str());
+}
+
+
+
+sc_object *xtsc_component::xtsc_sampling_controller::get_port(const string& port_name) {
+  ostringstream oss;
+  oss << kind() << " \"" << name() << "\" has no port named \"" << port_name << "\"" << endl;
+  throw xtsc_exception(oss.str());
+}
+
+
+
+void xtsc_component::xtsc_sampling_controller::reset(bool /*hard_reset*/) {
+  XTSC_INFO(m_text, kind() << "::reset()");
+  m_num_samples  = 0;
+  m_num_switches = 0;
+  m_switch_time  = SC_ZERO_TIME;
+  for (vector<core_info*>::iterator ic = m_cores.begin(); ic != m_cores.end(); ++ic) {
+    core_info& info = **ic;
+    info.m_num_samples           = 0;
+    info.m_sum_cpi               = 0.0;
+    info.m_sum_cpi_squared       = 0.0;
+    info.m_measured_cycles       = 0;
+    info.m_measured_instructions = 0;
+  }
+}
+
+
+
+void xtsc_component::xtsc_sampling_controller::add_core(xtsc_core& core) {
+  m_cores.push_back(new core_info(core));
+}
+
+
+
+void xtsc_component::xtsc_sampling_controller::report(ostream& os) const {
+  streamsize precision = os.precision();
+  os << name() << ": " << m_num_samples << " measurement windows, " << m_num_switches << " mode switches ("
+     << m_switch_time << " waiting to switch)" << endl;
+  for (vector<core_info*>::const_iterator ic = m_cores.begin(); ic != m_cores.end(); ++ic) {
+    const core_info& info = **ic;
+    u64 instructions = get_instruction_count(*info.m_p_core);
+    u64 cycles       = info.m_p_core->get_cycle_count();
+    os << info.m_p_core->name() << ": " << info.m_num_samples << " samples";
+    if (info.m_num_samples == 0) {
+      os << ", " << instructions << " instructions, " << cycles << " simulated cycles (no estimate)" << endl;
+      continue;
+    }
+    double n    = info.m_num_samples;
+    double mean = info.m_sum_cpi / n;
+    double half = 0.0;
+    if (info.m_num_samples > 1) {
+      double variance = (info.m_sum_cpi_squared - n * mean * mean) / (n - 1);
+      half = m_z * sqrt((variance > 0.0) ? variance : 0.0) / sqrt(n);
+    }
+    u64 estimate = (u64) (instructions * mean + 0.5);
+    u64 margin   = (u64) (instructions * half + 0.5);
+    os << fixed << setprecision(4)
+       << ", CPI " << mean << " +/- " << half
+       << ", " << instructions << " instructions"
+       << ", estimated cycles " << estimate << " +/- " << margin;
+    if (info.m_num_samples > 1) {
+      os << " (" << setprecision(2) << (100.0 * half / mean) << "% at ";
+      if (m_confidence == 999) os << "99.9"; else os << m_confidence;
+      os << "% confidence)";
+    }
+    else {
+      os << " (too few samples for an interval)";
+    }
+    os << ", " << cycles << " simulated cycles" << endl;
+    os.unsetf(ios::floatfield);
+    os.precision(precision);
+  }
+}
+
+
+
+void xtsc_component::xtsc_sampling_controller::execute(const string&           cmd_line,
+                                                       const vector<string>&   words,
+                                                       const vector<string>&   words_lc,
+                                                       ostream&                result)
+{
+  ostringstream res;
+
+  if (false) {
+  }
+  else if (words[0] == "get_num_samples") {
+    res << get_num_samples();
+  }
+  else if (words[0] == "report") {
+    report(res);
+  }
+  else if (words[0] == "reset") {
+    reset();
+  }
+  else {
+    ostringstream oss;
+    oss << __FUNCTION__ << " called for unknown command '" << cmd_line << "'.";
+    throw xtsc_exception(oss.str());
+  }
+
+  result << res.str();
+}
+
+
+
+void xtsc_component::xtsc_sampling_controller::end_of_simulation() {
+  ostringstream oss;
+  report(oss);
+  string line;
+  istringstream iss(oss.str());
+  while (getline(iss, line)) {
+    XTSC_INFO(m_text, line);
+  }
+}
+
+
+
+void xtsc_component::xtsc_sampling_controller::sampling_thread() {
+  while ((m_max_samples == 0) || (m_num_samples < m_max_samples)) {
+    if (m_functional_cycles) {
+      switch_sim_mode(XTSC_FUNCTIONAL);
+      wait(m_clock_period * m_functional_cycles);
+    }
+    // Even without a functional window the system may have been started in functional mode
+    switch_sim_mode(XTSC_CYCLE_ACCURATE);
+    wait(m_clock_period * m_warmup_cycles);
+    for (vector<core_info*>::iterator ic = m_cores.begin(); ic != m_cores.end(); ++ic) {
+      core_info& info = **ic;
+      info.m_start_cycles       = info.m_p_core->get_cycle_count();
+      info.m_start_instructions = get_instruction_count(*info.m_p_core);
+    }
+    wait(m_clock_period * m_measure_cycles);
+    for (vector<core_info*>::iterator ic = m_cores.begin(); ic != m_cores.end(); ++ic) {
+      core_info& info = **ic;
+      u64 cycles       = info.m_p_core->get_cycle_count()   - info.m_start_cycles;
+      u64 instructions = get_instruction_count(*info.m_p_core) - info.m_start_instructions;
+      // A core which is halted or waiting for an interrupt for the whole window gives no CPI sample
+      if (instructions == 0) continue;
+      double cpi = (double) cycles / instructions;
+      info.m_num_samples           += 1;
+      info.m_sum_cpi               += cpi;
+      info.m_sum_cpi_squared       += cpi * cpi;
+      info.m_measured_cycles       += cycles;
+      info.m_measured_instructions += instructions;
+      XTSC_DEBUG(m_text, info.m_p_core->name() << ": sample #" << info.m_num_samples << " cycles=" << cycles <<
+                         " instructions=" << instructions << " CPI=" << cpi);
+    }
+    m_num_samples += 1;
+    XTSC_VERBOSE(m_text, "Completed measurement window #" << m_num_samples);
+  }
+  if (m_functional_cycles) {
+    switch_sim_mode(XTSC_FUNCTIONAL);
+  }
+  XTSC_INFO(m_text, "Sampling done after " << m_num_samples << " measurement windows");
+}
+
+
+
+void xtsc_component::xtsc_sampling_controller::switch_sim_mode(xtsc_sim_mode mode) {
+  vector<xtsc_switch_registration> registrations;
+  xtsc_get_registered_mode_switch_interfaces(registrations);
+  bool switch_needed = false;
+  for (vector<xtsc_switch_registration>::iterator ir = registrations.begin(); ir != registrations.end(); ++ir) {
+    if (ir->m_switch_if->get_sim_mode() != mode) switch_needed = true;
+  }
+  if (!switch_needed) return;
+
+  const char *mode_name = ((mode == XTSC_FUNCTIONAL) ? "functional" : "cycle-accurate");
+  XTSC_DEBUG(m_text, "Preparing to switch to " << mode_name << " mode");
+  sc_time start = sc_time_stamp();
+  while (true) {
+    if (xtsc_prepare_to_switch_sim_mode(mode)) {
+      if (m_switch_settle_cycles == 0) break;
+      // Let transactions in passive modules propagate through the system and then try one more time
+      wait(m_clock_period * m_switch_settle_cycles);
+      if (xtsc_prepare_to_switch_sim_mode(mode)) break;
+    }
+    else {
+      wait(m_clock_period * m_switch_poll_cycles);
+    }
+  }
+  xtsc_switch_sim_mode(mode);
+  m_num_switches += 1;
+  m_switch_time  += sc_time_stamp() - start;
+  XTSC_VERBOSE(m_text, "Switched to " << mode_name << " mode");
+}
+
+
+
+u64 xtsc_component::xtsc_sampling_controller::get_instruction_count(const xtsc_core& core) const {
+  return core.get_summary_count("Instructions");
+}
@@ -0,0 +1,203 @@
+// Copyright (c) 2005-2018 by Cadence Design Systems Inc.  ALL RIGHTS RESERVED.
+// These coded instructions, statements, and computer programs are the
+// copyrighted works and confidential proprietary information of Cadence Design Systems Inc.
+// They may not be modified, copied, reproduced, distributed, or disclosed to
+// third parties in any manner, medium, or form, in whole or in part, without
+// the prior written consent of Cadence Design Systems Inc.
+
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <vector>
+#include <xtsc/xtsc_slab_allocator.h>
+
+using namespace std;
+using namespace sc_core;
+using namespace xtsc;
+
+
+
+namespace xtsc_component {
+
+static const u32 num_size_classes = xtsc_slab_allocator::max_size / xtsc_slab_allocator::granularity;
+
+
+// A free chunk.  The link lives in the chunk itself.
+struct free_chunk {
+  free_chunk   *m_next;
+};
+
+
+// Everything the allocator owns.  Reached through get_state() so that components
+// constructed during static initialization find it ready.
+struct slab_state {
+  slab_state() {
+    for (u32 i=0; i<num_size_classes; ++i) {
+      m_free_lists[i]  = 0;
+      m_num_slabs[i]   = 0;
+      m_num_free[i]    = 0;
+    }
+    m_num_large = 0;
+  }
+  free_chunk                           *m_free_lists[num_size_classes];         // Index is (size class / granularity) - 1
+  u64                                   m_num_slabs[num_size_classes];
+  u64                                   m_num_free[num_size_classes];
+  u64                                   m_num_large;                            // Live allocations larger than max_size
+  vector<xtsc_allocator_client*>        m_clients;
+};
+
+
+static slab_state& get_state() {
+  static slab_state state;
+  return state;
+}
+
+
+static inline u32 get_size_class_index(size_t size8) {
+  return (u32) ((max(size8, (size_t) 1) + xtsc_slab_allocator::granularity - 1) / xtsc_slab_allocator::granularity) - 1;
+}
+
+
+static inline size_t get_rounded_size(size_t size8) {
+  return (size8 > xtsc_slab_allocator::max_size) ? size8
+                                                 : (get_size_class_index(size8) + 1) * (size_t) xtsc_slab_allocator::granularity;
+}
+
+}
+
+
+
+void *xtsc_component::xtsc_slab_allocator::allocate(size_t size8) {
+  slab_state& state = get_state();
+  if (size8 > max_size) {
+    void *p = malloc(size8);
+    if (!p) throw bad_alloc();
+    state.m_num_large += 1;
+    return p;
+  }
+  u32 index = get_size_class_index(size8);
+  free_chunk *p_chunk = state.m_free_lists[index];
+  if (!p_chunk) {
+    // Carve a new slab into chunks of this size class
+    size_t chunk_bytes = (index + 1) * (size_t) granularity;
+    u32    num_chunks  = (u32) (slab_bytes / chunk_bytes);
+    u8    *p_slab      = (u8*) malloc(num_chunks * chunk_bytes);
+    if (!p_slab) throw bad_alloc();
+    for (u32 i=num_chunks; i>0; --i) {
+      free_chunk *p_free = (free_chunk*) (p_slab + (i-1) * chunk_bytes);
+      p_free->m_next = state.m_free_lists[index];
+      state.m_free_lists[index] = p_free;
+    }
+    state.m_num_slabs[index] += 1;
+    state.m_num_free [index] += num_chunks;
+    p_chunk = state.m_free_lists[index];
+  }
+  state.m_free_lists[index] = p_chunk->m_next;
+  state.m_num_free  [index] -= 1;
+  return p_chunk;
+}
+
+
+
+void xtsc_component::xtsc_slab_allocator::deallocate(void *p, size_t size8) {
+  if (!p) return;
+  slab_state& state = get_state();
+  if (size8 > max_size) {
+    free(p);
+    state.m_num_large -= 1;
+    return;
+  }
+  u32 index = get_size_class_index(size8);
+  free_chunk *p_chunk = (free_chunk*) p;
+  p_chunk->m_next = state.m_free_lists[index];
+  state.m_free_lists[index] = p_chunk;
+  state.m_num_free  [index] += 1;
+}
+
+
+
+void xtsc_component::xtsc_slab_allocator::dump_statistics(ostream& os) {
+  slab_state& state = get_state();
+  os << "Size   Slabs    InUse     Free" << endl;
+  for (u32 i=0; i<num_size_classes; ++i) {
+    if (!state.m_num_slabs[i]) continue;
+    size_t chunk_bytes = (i + 1) * (size_t) granularity;
+    u64    num_chunks  = state.m_num_slabs[i] * (slab_bytes / chunk_bytes);
+    os << setw(4) << chunk_bytes << " " << setw(7) << state.m_num_slabs[i] << " " << setw(8) << (num_chunks - state.m_num_free[i])
+       << " " << setw(8) << state.m_num_free[i] << endl;
+  }
+  if (state.m_num_large) {
+    os << "Live allocations larger than " << max_size << " bytes: " << state.m_num_large << endl;
+  }
+}
+
+
+
+xtsc_component::xtsc_allocator_client::xtsc_allocator_client(const string& name) :
+  m_name                (name),
+  m_num_live            (0),
+  m_num_peak            (0),
+  m_bytes_live          (0),
+  m_num_allocations     (0)
+{
+  get_state().m_clients.push_back(this);
+}
+
+
+
+xtsc_component::xtsc_allocator_client::~xtsc_allocator_client() {
+  vector<xtsc_allocator_client*>& clients = get_state().m_clients;
+  clients.erase(remove(clients.begin(), clients.end(), this), clients.end());
+}
+
+
+
+void *xtsc_component::xtsc_allocator_client::allocate(size_t size8) {
+  void *p = xtsc_slab_allocator::allocate(size8);
+  m_num_live            += 1;
+  m_num_allocations     += 1;
+  m_bytes_live          += get_rounded_size(size8);
+  if (m_num_live > m_num_peak) {
+    m_num_peak = m_num_live;
+  }
+  return p;
+}
+
+
+
+void xtsc_component::xtsc_allocator_client::deallocate(void *p, size_t size8) {
+  if (!p) return;
+  xtsc_slab_allocator::deallocate(p, size8);
+  m_num_live            -= 1;
+  m_bytes_live          -= get_rounded_size(size8);
+}
+
+
+
+void xtsc_component::xtsc_allocator_client::dump_statistics(ostream& os) const {
+  double usecs = sc_time_stamp().to_seconds() * 1e6;
+  os << setw(40) << left << m_name << right << " " << setw(8) << m_num_live << " " << setw(8) << m_num_peak << " "
+     << setw(10) << m_bytes_live << " " << setw(12) << m_num_allocations << " ";
+  if (usecs > 0) {
+    os << setw(10) << fixed << setprecision(2) << (m_num_allocations / usecs);
+    os.unsetf(ios::floatfield);
+  }
+  else {
+    os << setw(10) << "-";
+  }
+  os << endl;
+}
+
+
+
+void xtsc_component::xtsc_dump_allocator_stats(ostream& os) {
+  const vector<xtsc_allocator_client*>& clients = get_state().m_clients;
+  os << setw(40) << left << "Component" << right << " " << setw(8) << "Live" << " " << setw(8) << "Peak" << " "
+     << setw(10) << "LiveBytes" << " " << setw(12) << "Allocations" << " " << setw(10) << "Allocs/us" << endl;
+  for (vector<xtsc_allocator_client*>::const_iterator i = clients.begin(); i != clients.end(); ++i) {
+    (*i)->dump_statistics(os);
+  }
+  os << endl;
+  xtsc_slab_allocator::dump_statistics(os);
+}
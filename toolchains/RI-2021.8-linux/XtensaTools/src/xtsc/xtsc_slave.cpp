@@ -35,6 +35,7 @@ xtsc_component::xtsc_slave::xtsc_slave(sc_module_name module_name, const xtsc_sl
   m_format              (slave_parms.get_non_zero_u32("format")),
   m_ignore_count        (0),
   m_transfer_num        (0),
+  m_allocator           (name()),
   m_text                (log4xtensa::TextLogger::getInstance(name()))
 {
 
@@ -433,7 +434,7 @@ xtsc_component::xtsc_slave::response_info *xtsc_component::xtsc_slave::new_respo
   bool cont = (m_words[m_words.size()-1] == "cont");
   bool last = (get_u32(7, "last_transfer") != 0);
 
-  xtsc_response *p_response = new xtsc_response(request, status, last);
+  xtsc_response *p_response = m_allocator.create<xtsc_response>(request, status, last);
 
   // Format 1
   // 0     1      2    3        4  5        6  7    8  9  ... 8+N
@@ -465,14 +466,15 @@ xtsc_component::xtsc_slave::response_info *xtsc_component::xtsc_slave::new_respo
 
   bool respond_now = (m_words[0] == "now");
   sc_time delay = respond_now ? SC_ZERO_TIME : m_clock_period*get_double(0, "delay");
-  return new response_info(p_response, respond_now, cont, delay);
+  return m_allocator.create<response_info>(p_response, respond_now, cont, delay);
 }
 
 
 
 void xtsc_component::xtsc_slave::delete_response_info(response_info*& p_response_info) {
   if (p_response_info) {
-    delete p_response_info;
+    m_allocator.destroy(p_response_info->m_p_response);
+    m_allocator.destroy(p_response_info);
     p_response_info = 0;
   }
 }
@@ -115,7 +115,10 @@
  * get_direct_mem_ptr:
  *
  * When get_direct_mem_ptr of this transactor is called by the upstream OSCI TLM2 subsystem, it calls
- * nb_fast_access of the downstream Xtensa TLM subsystem to see if it can get raw fast access.
+ * nb_fast_access of the downstream Xtensa TLM subsystem to see if it can get raw fast access.  The
+ * request carries this port's xtsc_fast_access_revocation_if so that a downstream revocation (for
+ * example, from xtsc_xttlm2tlm2_transactor or xtsc_router) reaches revoke_fast_access, which calls
+ * invalidate_direct_mem_ptr of the upstream OSCI TLM2 subsystem.
  *
  *
  *
@@ -200,7 +203,7 @@ xtsc_component::xtsc_tlm22xttlm_transactor::xtsc_tlm22xttlm_transactor(
   m_trans_to_info_map           (NULL),
   m_pending_transaction_deque   (NULL),
   m_transaction_info_count      (0),
-  m_request_count               (0),
+  m_allocator                   (name()),
   m_text                        (TextLogger::getInstance(name()))
 {
 
@@ -418,7 +421,7 @@ xtsc_component::xtsc_tlm22xttlm_transactor::xtsc_tlm22xttlm_transactor(
 
 xtsc_component::xtsc_tlm22xttlm_transactor::~xtsc_tlm22xttlm_transactor(void) {
   XTSC_INFO(m_text, "transaction_info: Created=" << m_transaction_info_count << " Available=" << m_transaction_info_pool.size());
-  XTSC_INFO(m_text, "xtsc_request:     Created=" << m_request_count          << " Available=" << m_request_pool.size());
+  XTSC_INFO(m_text, "m_allocator:      Live=" << m_allocator.get_num_live() << " Peak=" << m_allocator.get_num_peak());
 }
 
 
@@ -1028,7 +1031,7 @@ xtsc_component::xtsc_tlm22xttlm_transactor::new_transaction_info(tlm_generic_pay
   if (m_transaction_info_pool.empty()) {
     XTSC_DEBUG(m_text, "Creating a new transaction_info");
     m_transaction_info_count += 1;
-    return new transaction_info(*this, p_gp, blocking, port_num);
+    return m_allocator.create<transaction_info>(*this, p_gp, blocking, port_num);
   }
   else {
     transaction_info *p_transaction_info = m_transaction_info_pool.back();
@@ -1049,22 +1052,13 @@ void xtsc_component::xtsc_tlm22xttlm_transactor::delete_transaction_info(transac
 
 
 xtsc_request *xtsc_component::xtsc_tlm22xttlm_transactor::new_request() {
-  if (m_request_pool.empty()) {
-    XTSC_DEBUG(m_text, "Creating a new xtsc_request");
-    m_request_count += 1;
-    return new xtsc_request();
-  }
-  else {
-    xtsc_request *p_request = m_request_pool.back();
-    m_request_pool.pop_back();
-    return p_request;
-  }
+  return m_allocator.create<xtsc_request>();
 }
 
 
 
 void xtsc_component::xtsc_tlm22xttlm_transactor::delete_request(xtsc_request*& p_request) {
-  m_request_pool.push_back(p_request);
+  m_allocator.destroy(p_request);
   p_request = 0;
 }
 
@@ -2011,6 +2005,7 @@ bool xtsc_component::xtsc_tlm22xttlm_transactor::tlm_fw_transport_if_impl::get_d
 
   if (m_transactor.m_allow_dmi) {
     xtsc_fast_access_request fast_access_request(m_transactor, address8, m_transactor.m_width8, false);
+    fast_access_request.set_fast_access_revocation_if(this);
 
     (*m_transactor.m_request_ports[m_port_num])->nb_fast_access(fast_access_request);
 
@@ -2018,7 +2013,10 @@ bool xtsc_component::xtsc_tlm22xttlm_transactor::tlm_fw_transport_if_impl::get_d
     dmi_data.set_start_address(block.get_block_beg_address());
     dmi_data.set_end_address  (block.get_block_end_address());
 
-    if (fast_access_request.get_access_type() == xtsc_fast_access_request::ACCESS_RAW) {
+    // A swizzled raw block is not in byte order so it cannot be handed out as a DMI pointer
+    if ((fast_access_request.get_access_type() == xtsc_fast_access_request::ACCESS_RAW) &&
+        (fast_access_request.get_swizzle() == 0))
+    {
       if (trans.is_read() && fast_access_request.is_readable()) {
         if (!fast_access_request.is_writable()) {
           dmi_data.allow_read();
@@ -2100,6 +2098,19 @@ u32 xtsc_component::xtsc_tlm22xttlm_transactor::tlm_fw_transport_if_impl::transp
 
 
 
+void xtsc_component::xtsc_tlm22xttlm_transactor::tlm_fw_transport_if_impl::revoke_fast_access() {
+  sc_dt::uint64 start_range = 0;
+  sc_dt::uint64 end_range   = (sc_dt::uint64) -1;
+  XTSC_INFO(m_transactor.m_text, "revoke_fast_access() calling invalidate_direct_mem_ptr() Port #" << m_port_num);
+       if (m_width8 ==  4) { (*m_transactor.m_target_sockets_4 [m_port_num])->invalidate_direct_mem_ptr(start_range, end_range); }
+  else if (m_width8 ==  8) { (*m_transactor.m_target_sockets_8 [m_port_num])->invalidate_direct_mem_ptr(start_range, end_range); }
+  else if (m_width8 == 16) { (*m_transactor.m_target_sockets_16[m_port_num])->invalidate_direct_mem_ptr(start_range, end_range); }
+  else if (m_width8 == 32) { (*m_transactor.m_target_sockets_32[m_port_num])->invalidate_direct_mem_ptr(start_range, end_range); }
+  else if (m_width8 == 64) { (*m_transactor.m_target_sockets_64[m_port_num])->invalidate_direct_mem_ptr(start_range, end_range); }
+}
+
+
+
 void xtsc_component::xtsc_tlm22xttlm_transactor::tlm_fw_transport_if_impl::register_port(sc_port_base& port, const char *if_typename) {
   if (m_p_port) {
     ostringstream oss;
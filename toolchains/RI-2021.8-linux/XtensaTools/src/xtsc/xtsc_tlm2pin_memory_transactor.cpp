@@ -680,6 +680,7 @@ xtsc_component::xtsc_tlm2pin_memory_transactor::xtsc_tlm2pin_memory_transactor(
   m_domain              (2),
   m_data                ((int)m_width8*8),
   m_req_cntl            (0),
+  m_allocator           (name()),
   m_text                (TextLogger::getInstance(name())),
   m_tran_id_rsp_info    (0),
   m_pending_rsp_info_cnt(0)
@@ -745,6 +746,7 @@ xtsc_component::xtsc_tlm2pin_memory_transactor::xtsc_tlm2pin_memory_transactor(
   m_has_busy                  = tlm2pin_parms.get_bool("has_busy");
   m_has_lock                  = tlm2pin_parms.get_bool("has_lock");
   m_has_xfer_en               = tlm2pin_parms.get_bool("has_xfer_en");
+  m_activity_driven           = tlm2pin_parms.get_bool("activity_driven");
   m_bus_addr_bits_mask        = ((m_width8 ==  4) ? 0x03 :
                                  (m_width8 ==  8) ? 0x07 : 
                                  (m_width8 == 16) ? 0x0F :
@@ -2114,6 +2116,7 @@ xtsc_component::xtsc_tlm2pin_memory_transactor::xtsc_tlm2pin_memory_transactor(
   XTSC_LOG(m_text, ll, " start_byte_address        = 0x" << hex        << setfill('0') << setw(8) << m_start_byte_address);
   XTSC_LOG(m_text, ll, " big_endian                = "   << boolalpha  << m_big_endian);
   XTSC_LOG(m_text, ll, " vcd_handle                = "                 << m_p_trace_file);
+  XTSC_LOG(m_text, ll, " activity_driven           = "   << boolalpha  << m_activity_driven);
   XTSC_LOG(m_text, ll, " request_fifo_depth        = "                 << m_request_fifo_depth);
   if (clock_period == 0xFFFFFFFF) {
   XTSC_LOG(m_text, ll, " clock_period              = 0xFFFFFFFF => "   << m_clock_period.value() << " (" << m_clock_period << ")");
@@ -2199,8 +2202,7 @@ xtsc_component::xtsc_tlm2pin_memory_transactor::xtsc_tlm2pin_memory_transactor(
 
 xtsc_component::xtsc_tlm2pin_memory_transactor::~xtsc_tlm2pin_memory_transactor(void) {
   // Do any required clean-up here
-  XTSC_DEBUG(m_text, "m_request_pool.size()=" << m_request_pool.size());
-  XTSC_DEBUG(m_text, "m_response_pool.size()=" << m_response_pool.size());
+  XTSC_DEBUG(m_text, "m_allocator live=" << m_allocator.get_num_live() << " peak=" << m_allocator.get_num_peak());
   if (m_p_memory) {
     delete m_p_memory;
     m_p_memory = 0;
@@ -2870,7 +2872,7 @@ void xtsc_component::xtsc_tlm2pin_memory_transactor::pif_request_thread(void) {
         m_request_fifo[port].pop_front();
 
         // Create response from request
-        xtsc_response *p_response = new xtsc_response(*p_request, xtsc_response::RSP_OK);
+        xtsc_response *p_response = m_allocator.create<xtsc_response>(*p_request, xtsc_response::RSP_OK);
 
         // Pick out some useful information about the request
         type_t            type            = p_request->get_type();
@@ -3248,7 +3250,7 @@ void xtsc_component::xtsc_tlm2pin_memory_transactor::pif_response_thread(void) {
                 m_pending_rsp_info_cnt -= 1;
                 XTSC_DEBUG(m_text, "Removed   m_tran_id_rsp_info[" << port << "] tran_id=" << tran_id << ": because request was last data");
               }
-              delete p_info->m_p_response;
+              m_allocator.destroy(p_info->m_p_response);
               p_info->m_p_response = 0;
               delete_response_info(p_info);
             }
@@ -3412,7 +3414,7 @@ void xtsc_component::xtsc_tlm2pin_memory_transactor::axi_request_thread(void) {
         m_request_fifo[port].pop_front();
 
         // Create response from request
-        xtsc_response *p_response = new xtsc_response(*p_request, xtsc_response::AXI_OK);
+        xtsc_response *p_response = m_allocator.create<xtsc_response>(*p_request, xtsc_response::AXI_OK);
 
         // Pick out some useful information about the request
         type_t            type            = p_request->get_type();
@@ -3567,7 +3569,7 @@ void xtsc_component::xtsc_tlm2pin_memory_transactor::axi_request_thread(void) {
             m_pending_rsp_info_cnt -= 1;
             XTSC_DEBUG(m_text, "Removed   m_tran_id_rsp_info[" << port << "] tran_id=0x" << hex << tid << ": because request was not last data");
             delete_response_info(p_info);
-            delete p_response;
+            m_allocator.destroy(p_response);
             p_response = 0;
           }
 
@@ -3588,7 +3590,7 @@ void xtsc_component::xtsc_tlm2pin_memory_transactor::axi_request_thread(void) {
               while (!m_request_fifo[port].empty()) {
                 xtsc_request *p_req = m_request_fifo[port].front();
                 m_request_fifo[port].pop_front();
-                xtsc_response *p_rsp = new xtsc_response(*p_req, xtsc_response::NOTRDY);
+                xtsc_response *p_rsp = m_allocator.create<xtsc_response>(*p_req, xtsc_response::NOTRDY);
                 send_unchecked_response(p_rsp, port);
                 delete_request(p_req);
               }
@@ -3870,7 +3872,7 @@ void xtsc_component::xtsc_tlm2pin_memory_transactor::axi_response_thread(void) {
               rid.pop_front();
               m_pending_rsp_info_cnt -= 1;
               XTSC_DEBUG(m_text, "Removed   m_tran_id_rsp_info[" << port << "] tran_id=" << tran_id << ": because request was last data");
-              delete p_info->m_p_response;
+              m_allocator.destroy(p_info->m_p_response);
               p_info->m_p_response = 0;
               delete_response_info(p_info);
             }
@@ -4065,11 +4067,18 @@ void xtsc_component::xtsc_tlm2pin_memory_transactor::apb_thread(void) {
 
         // Check for accepted at 1 cycle intervals
         while (!m_p_pready[port]->read()) {
-          wait(m_clock_period);
+          if (m_activity_driven) {
+            // Sleep until PREADY rises then re-check at the next sample phase
+            wait(m_p_pready[port]->posedge_event());
+            sync_to_sample_phase();
+          }
+          else {
+            wait(m_clock_period);
+          }
         }
 
         // Create response from request
-        xtsc_response *p_response = new xtsc_response(*p_request, (m_p_pslverr[port]->read() ? xtsc_response::SLVERR : xtsc_response::APB_OK));
+        xtsc_response *p_response = m_allocator.create<xtsc_response>(*p_request, (m_p_pslverr[port]->read() ? xtsc_response::SLVERR : xtsc_response::APB_OK));
 
         // Extract read data
         if (is_read) {
@@ -4132,6 +4141,25 @@ void xtsc_component::xtsc_tlm2pin_memory_transactor::apb_drive_zeroes(u32 port)
 
 
 
+void xtsc_component::xtsc_tlm2pin_memory_transactor::sync_to_sample_phase(void) {
+  sc_time now = sc_time_stamp();
+  sc_time phase_now = (now.value() % m_clock_period_value) * m_time_resolution;
+  if (m_has_posedge_offset) {
+    if (phase_now < m_posedge_offset) {
+      phase_now += m_clock_period;
+    }
+    phase_now -= m_posedge_offset;
+  }
+  if (phase_now < m_sample_phase) {
+    wait(m_sample_phase - phase_now);
+  }
+  else {
+    wait(m_sample_phase_plus_one - phase_now);
+  }
+}
+
+
+
 void xtsc_component::xtsc_tlm2pin_memory_transactor::lcl_request_thread(void) {
 
   // Get the port number for this "instance" of the thread
@@ -4169,7 +4197,7 @@ void xtsc_component::xtsc_tlm2pin_memory_transactor::lcl_request_thread(void) {
         m_request_fifo[port].pop_front();
 
         // Create response from request
-        xtsc_response *p_response = new xtsc_response(*p_request, xtsc_response::RSP_OK);
+        xtsc_response *p_response = m_allocator.create<xtsc_response>(*p_request, xtsc_response::RSP_OK);
 
         // Pick out some useful information about the request
         xtsc_address      addr8           = p_request->get_byte_address() - m_start_byte_address;
@@ -4689,7 +4717,7 @@ void xtsc_component::xtsc_tlm2pin_memory_transactor::send_unchecked_response(xts
 
   // Delete it?
   if (!is_system_memory(m_interface_type) || (p_response->get_last_transfer())) {
-    delete p_response;
+    m_allocator.destroy(p_response);
     p_response = 0;
   }
 }
@@ -4706,43 +4734,18 @@ response_info *xtsc_component::xtsc_tlm2pin_memory_transactor::new_response_info
                                                                                  u32               num_transfers,
                                                                                  burst_t           burst)
 {
-  if (m_response_pool.empty()) {
-    response_info *p_response_info = new response_info(p_response, bus_addr_bits, size, is_read, id, route_id, num_transfers, burst);
-    XTSC_DEBUG(m_text, "Created new response_info (" << p_response_info << ") from an xtsc_response: " << *p_response);
-    return p_response_info;
-  }
-  else {
-    response_info *p_response_info = m_response_pool.back();
-    XTSC_DEBUG(m_text, "Recycling response_info (" << p_response_info << ") given an xtsc_response: " << *p_response);
-    m_response_pool.pop_back();
-    p_response_info->m_p_response    = p_response;
-    p_response_info->m_bus_addr_bits = bus_addr_bits;
-    p_response_info->m_size          = size;
-    p_response_info->m_is_read       = is_read;
-    p_response_info->m_id            = id;
-    p_response_info->m_route_id      = route_id;
-    p_response_info->m_num_transfers = num_transfers;
-    p_response_info->m_burst         = burst;
-    return p_response_info;
-  }
+  response_info *p_response_info = m_allocator.create<response_info>(p_response, bus_addr_bits, size, is_read, id, route_id, num_transfers, burst);
+  XTSC_DEBUG(m_text, "Created response_info (" << p_response_info << ") from an xtsc_response: " << *p_response);
+  return p_response_info;
 }
 
 
 
 xtsc_component::xtsc_tlm2pin_memory_transactor::
 response_info *xtsc_component::xtsc_tlm2pin_memory_transactor::new_response_info(const response_info& info) {
-  if (m_response_pool.empty()) {
-    response_info *p_response_info = new response_info(info);
-    XTSC_DEBUG(m_text, "Created new response_info (" << p_response_info << ") from another response_info");
-    return p_response_info;
-  }
-  else {
-    response_info *p_response_info = m_response_pool.back();
-    XTSC_DEBUG(m_text, "Recycling response_info (" << p_response_info << ") given a response_info");
-    m_response_pool.pop_back();
-    *p_response_info = info;
-    return p_response_info;
-  }
+  response_info *p_response_info = m_allocator.create<response_info>(info);
+  XTSC_DEBUG(m_text, "Created response_info (" << p_response_info << ") from another response_info");
+  return p_response_info;
 }
 
 
@@ -4750,29 +4753,20 @@ response_info *xtsc_component::xtsc_tlm2pin_memory_transactor::new_response_info
 void xtsc_component::xtsc_tlm2pin_memory_transactor::delete_response_info(response_info*& p_response_info) {
   XTSC_DEBUG(m_text, "Freeing up response_info " << p_response_info);
   assert(p_response_info);
-  m_response_pool.push_back(p_response_info);
+  m_allocator.destroy(p_response_info);
   p_response_info = 0;
 }
 
 
 
 xtsc_request *xtsc_component::xtsc_tlm2pin_memory_transactor::new_request(const xtsc_request& request) {
-  if (m_request_pool.empty()) {
-    XTSC_DEBUG(m_text, "Creating a new xtsc_request");
-    return new xtsc_request(request);
-  }
-  else {
-    xtsc_request *p_request = m_request_pool.back();
-    m_request_pool.pop_back();
-    *p_request = request;
-    return p_request;
-  }
+  return m_allocator.create<xtsc_request>(request);
 }
 
 
 
 void xtsc_component::xtsc_tlm2pin_memory_transactor::delete_request(xtsc_request*& p_request) {
-  m_request_pool.push_back(p_request);
+  m_allocator.destroy(p_request);
   p_request = 0;
 }
 
@@ -75,7 +75,9 @@ xtsc_component::xtsc_wire::xtsc_wire(sc_module_name module_name, const xtsc_wire
   m_shmem_name          (""),
   m_p_buffer            (NULL),
   m_p_shmem             (NULL),
-  m_shmem_total_size    (0)
+  m_p_shmem_sync        (NULL),
+  m_shmem_total_size    (0),
+  m_barrier_sync        (false)
 {
 
   m_p_wire              = new sc_unsigned(m_width1);
@@ -132,6 +134,8 @@ xtsc_component::xtsc_wire::xtsc_wire(sc_module_name module_name, const xtsc_wire
     }
     m_shmem_total_size    = (m_width1 + 7) / 8;
     m_p_buffer            = new u8[m_shmem_total_size];
+    m_p_shmem_sync        = new u8[m_shmem_total_size];
+    memset(m_p_shmem_sync, 0, m_shmem_total_size);
     m_p_shmem             = xtsc_get_shared_memory(m_shmem_name, m_shmem_total_size, name(), kind(), 0x0);
   }
 
@@ -194,6 +198,7 @@ xtsc_component::xtsc_wire::~xtsc_wire() {
   if (m_read_file)  delete m_read_file;
   if (m_p_shmem) {
     delete [] m_p_buffer;
+    delete [] m_p_shmem_sync;
   }
 }
 
@@ -247,11 +252,26 @@ void xtsc_component::xtsc_wire::reset(bool /*hard_reset*/) {
 
   if (m_p_shmem) {
     memset(m_p_shmem, 0, m_shmem_total_size);
+    memset(m_p_shmem_sync, 0, m_shmem_total_size);
   }
 }
 
 
 
+bool xtsc_component::xtsc_wire::sync_host_shared_memory() {
+  if (!m_p_shmem) return false;
+  memcpy(m_p_buffer, m_p_shmem, m_shmem_total_size);
+  if (memcmp(m_p_buffer, m_p_shmem_sync, m_shmem_total_size) == 0) return false;
+  memcpy(m_p_shmem_sync, m_p_buffer, m_shmem_total_size);
+  xtsc_byte_array_to_sc_unsigned(m_p_buffer, m_value);
+  *m_p_wire = m_value;
+  XTSC_DEBUG(m_text, "sync_host_shared_memory(): 0x" << m_value.to_string(SC_HEX).substr(m_width1%4 ? 2 : 3));
+  m_write_event.notify(SC_ZERO_TIME);
+  return true;
+}
+
+
+
 void xtsc_component::xtsc_wire::execute(const string&          cmd_line, 
                                         const vector<string>&  words,
                                         const vector<string>&  words_lc,
@@ -413,6 +433,7 @@ void xtsc_component::xtsc_wire::nb_write(const sc_unsigned& value) {
       // Use intermediate buffer to avoid u32/u64 word tearing (32-bit/64-bit simulator respectively)
       xtsc_sc_unsigned_to_byte_array(m_value, m_p_buffer);
       memcpy(m_p_shmem, m_p_buffer, m_shmem_total_size);
+      memcpy(m_p_shmem_sync, m_p_buffer, m_shmem_total_size);
     }
     *m_p_wire = value;
     // a variable substr is used to get rid of the pesky extra leading bit
@@ -445,7 +466,7 @@ void xtsc_component::xtsc_wire::nb_write(const sc_unsigned& value) {
 
 sc_unsigned xtsc_component::xtsc_wire::nb_read() {
   if (m_use_wire) {
-    if (m_p_shmem) {
+    if (m_p_shmem && !m_barrier_sync) {
       // Use intermediate buffer to avoid u32/u64 word tearing (32-bit/64-bit simulator respectively)
       memcpy(m_p_buffer, m_p_shmem, m_shmem_total_size);
       xtsc_byte_array_to_sc_unsigned(m_p_buffer, m_value);
@@ -63,6 +63,18 @@ using namespace xtsc;
  *    [6] - input_bit_index
  *    [7] - op code other than op_PUSH
  *    ...
+ *
+ * The rpn_assignment objects are not evaluated directly.  After the definition_file has been
+ * read, compile_assignments() merges runs of up to 64 consecutive rpn_assignment objects that
+ * have the same output, the same op codes and the same operand inputs, and whose output and
+ * input bit indices each advance by a constant stride (as produced by an assign line using
+ * an iterator or an implied bit range) into one compiled_assignment.  A compiled_assignment
+ * is evaluated with 64-bit words on the stack; lane (bit) l of each word computes the output
+ * bit of the l-th merged rpn_assignment.  Each input keeps its value packed into 64-bit words
+ * (m_packed) along with, for each word, the compiled assignments and lanes that read it
+ * (m_dependencies).  nb_write() then only evaluates the compiled assignments which read an
+ * input bit that actually changed (or, on the first nb_write() after reset, all compiled
+ * assignments which read the input).
  */
 
 
@@ -74,6 +86,32 @@ static const u32 op_XOR  = 4;   ///< RPN assignment op-code to XOR the top two b
 
 
 
+/// Return bits [64*word+63:64*word] of value (bits at or above bit_width are 0)
+static inline u64 pack_word(const sc_unsigned& value, u32 word, u32 bit_width) {
+  u32 lo = word * 64;
+  u32 hi = (((lo + 63) < bit_width) ? (lo + 63) : (bit_width - 1));
+  return value.range(hi, lo).to_uint64();
+}
+
+
+
+/**
+ * Check whether bit, the bit index of lane number lane, is consistent with base (the bit
+ * index of lane 0) and stride and append the stride to strides.  When lane is 1, the
+ * stride is not yet known so it is taken from bit.
+ */
+static bool check_lane(u32 base, u32 bit, i64 lane, i32 stride, vector<i64>& strides) {
+  i64 delta = (i64) bit - (i64) base;
+  if (lane == 1) {
+    strides.push_back(delta);
+    return ((delta >= -0x7FFFFFFF) && (delta <= 0x7FFFFFFF));
+  }
+  strides.push_back(stride);
+  return (delta == lane * stride);
+}
+
+
+
 
 
 xtsc_component::xtsc_wire_logic::xtsc_wire_logic(sc_module_name module_name, const xtsc_wire_logic_parms& logic_parms) :
@@ -86,6 +124,7 @@ xtsc_component::xtsc_wire_logic::xtsc_wire_logic(sc_module_name module_name, con
 {
 
   m_max_depth           = 0;
+  m_eval_stamp          = 0;
 
   // Get clock period 
   u32 clock_period = logic_parms.get_u32("clock_period");
@@ -155,6 +194,8 @@ xtsc_component::xtsc_wire_logic::xtsc_wire_logic(sc_module_name module_name, con
   // Size stack
   m_stack.resize(m_max_depth);
 
+  compile_assignments();
+
   for (input_definition_vector::const_iterator i = m_inputs.begin(); i != m_inputs.end(); ++i) {
     input_definition& input = **i;
     for (output_set::const_iterator j = input.m_outputs.begin(); j != input.m_outputs.end(); ++j) {
@@ -587,6 +628,84 @@ void xtsc_component::xtsc_wire_logic::handle_assign() {
 
 
 
+void xtsc_component::xtsc_wire_logic::compile_assignments() {
+  compiled_assignment  *p_compiled = 0;
+  rpn_assignment       *p_first    = 0;         // The rpn_assignment of lane 0 of *p_compiled
+  for (assignment_table::const_iterator i = m_assignments.begin(); i != m_assignments.end(); ++i) {
+    const rpn_assignment& assignment = **i;
+    // Try to add assignment as the next lane of *p_compiled
+    bool compatible = (p_compiled                           &&
+                       (p_compiled->m_num_lanes < 64)       &&
+                       (assignment.size() == p_first->size()) &&
+                       (assignment[0] == (*p_first)[0]));
+    vector<i64> strides;                        // Output stride followed by the stride of each operand
+    if (compatible) {
+      const rpn_assignment& first = *p_first;
+      i64 lane = p_compiled->m_num_lanes;
+      compatible = check_lane(first[1], assignment[1], lane, p_compiled->m_output_stride, strides);
+      for (u32 j = 2, k = 0; compatible && (j < assignment.size()); ++j) {
+        if (assignment[j] != first[j]) {
+          compatible = false;
+        }
+        else if (assignment[j] == op_PUSH) {
+          compatible = ((assignment[j+1] == first[j+1]) &&
+                        check_lane(first[j+2], assignment[j+2], lane, p_compiled->m_operands[k].m_stride, strides));
+          j += 2;
+          k += 1;
+        }
+      }
+    }
+    if (compatible) {
+      if (p_compiled->m_num_lanes == 1) {
+        p_compiled->m_output_stride = (i32) strides[0];
+        for (u32 k = 0; k < p_compiled->m_operands.size(); ++k) {
+          p_compiled->m_operands[k].m_stride = (i32) strides[k+1];
+        }
+      }
+      p_compiled->m_num_lanes += 1;
+      continue;
+    }
+    // Start a new compiled_assignment with assignment as lane 0
+    p_compiled = new compiled_assignment(assignment[0], assignment[1]);
+    p_first    = *i;
+    for (u32 j = 2; j < assignment.size(); ++j) {
+      p_compiled->m_program.push_back(assignment[j]);
+      if (assignment[j] == op_PUSH) {
+        p_compiled->m_program.push_back(p_compiled->m_operands.size());
+        p_compiled->m_operands.push_back(compiled_operand(assignment[j+1], assignment[j+2]));
+        j += 2;
+      }
+    }
+    m_compiled_assignments.push_back(p_compiled);
+  }
+
+  // Record which lanes of each compiled_assignment read which input words
+  for (u32 c = 0; c < m_compiled_assignments.size(); ++c) {
+    const compiled_assignment& compiled = *m_compiled_assignments[c];
+    map<pair<u32, u32>, u64> masks;             // (input, word) => bits read
+    for (vector<compiled_operand>::const_iterator i = compiled.m_operands.begin(); i != compiled.m_operands.end(); ++i) {
+      for (u32 lane = 0; lane < compiled.m_num_lanes; ++lane) {
+        u32 bit = (u32) ((i64) i->m_base + (i64) lane * i->m_stride);
+        masks[make_pair(i->m_input, bit >> 6)] |= (1ULL << (bit & 63));
+      }
+    }
+    for (map<pair<u32, u32>, u64>::const_iterator m = masks.begin(); m != masks.end(); ++m) {
+      input_definition& input = *m_inputs[m->first.first];
+      input.m_dependencies[m->first.second].push_back(compiled_dependency(c, m->second));
+      if (input.m_compiled.empty() || (input.m_compiled.back() != c)) {
+        input.m_compiled.push_back(c);
+      }
+    }
+  }
+  m_dirty.reserve(m_compiled_assignments.size());
+
+  log4xtensa::LogLevel ll = xtsc_get_constructor_log_level();
+  XTSC_LOG(m_text, ll, "Compiled " << m_assignments.size() << " RPN assignments into " << m_compiled_assignments.size() <<
+                       " word-parallel assignments");
+}
+
+
+
 bool xtsc_component::xtsc_wire_logic::parse_operand(u32         index,
                                                     string&     io_name,
                                                     bool&       is_iterator,
@@ -1120,6 +1239,96 @@ void xtsc_component::xtsc_wire_logic::output_definition::dump(ostream& os) const
 
 
 
+u64 xtsc_component::xtsc_wire_logic::gather(const compiled_operand& operand) const {
+  const vector<u64>& packed = m_inputs[operand.m_input]->m_packed;
+  u32 base = operand.m_base;
+  if (operand.m_stride == 1) {
+    // Lanes are consecutive input bits: shift them out of (at most) two packed words
+    u32 word  = base >> 6;
+    u32 shift = base & 63;
+    u64 lanes = packed[word] >> shift;
+    if (shift && ((word + 1) < packed.size())) {
+      lanes |= packed[word + 1] << (64 - shift);
+    }
+    return lanes;
+  }
+  if (operand.m_stride == 0) {
+    // Every lane is the same input bit
+    return (((packed[base >> 6] >> (base & 63)) & 1) ? ~0ULL : 0ULL);
+  }
+  u64 lanes = 0;
+  for (u32 lane = 0; lane < 64; ++lane) {
+    i64 bit = (i64) base + (i64) lane * operand.m_stride;
+    if ((bit < 0) || ((u64) bit >= 64 * packed.size())) break;
+    lanes |= ((packed[bit >> 6] >> (bit & 63)) & 1) << lane;
+  }
+  return lanes;
+}
+
+
+
+void xtsc_component::xtsc_wire_logic::evaluate(const compiled_assignment& compiled) {
+  u64 *stack = &m_stack[0];
+  u32  sp    = 0;
+  const vector<u32>& program = compiled.m_program;
+  for (u32 j = 0; j < program.size(); ++j) {
+    switch (program[j]) {
+      case op_PUSH: {
+        j += 1;
+        stack[sp] = gather(compiled.m_operands[program[j]]);
+        sp += 1;
+        break;
+      }
+      case op_NOT: {
+        stack[sp-1] = ~stack[sp-1];
+        break;
+      }
+      case op_AND: {
+        sp -= 1;
+        stack[sp-1] &= stack[sp];
+        break;
+      }
+      case op_OR:  {
+        sp -= 1;
+        stack[sp-1] |= stack[sp];
+        break;
+      }
+      case op_XOR: {
+        sp -= 1;
+        stack[sp-1] ^= stack[sp];
+        break;
+      }
+      default: {
+        ostringstream oss;
+        oss << "Program Bug:  Unrecognized op-code in compiled assignment in xtsc_wire_logic '" << name() << "'";
+        throw xtsc_exception(oss.str());
+      }
+    }
+  }
+  if (sp != 1) {
+    ostringstream oss;
+    oss << "Program Bug:  Stack pointer not 1 after RPN evalutaion in xtsc_wire_logic '" << name() << "'";
+    throw xtsc_exception(oss.str());
+  }
+  u32 num_lanes = compiled.m_num_lanes;
+  u64 result    = stack[0] & ((num_lanes == 64) ? ~0ULL : ((1ULL << num_lanes) - 1));
+  output_definition& output = *m_outputs[compiled.m_output];
+  u32 base = compiled.m_output_base;
+  if ((num_lanes == 1) || (compiled.m_output_stride == 1)) {
+    output.m_value.range(base + num_lanes - 1, base) = result;
+    XTSC_DEBUG(m_text, output.m_name << "[" << (base + num_lanes - 1) << ":" << base << "] <= 0x" << hex << result);
+  }
+  else {
+    for (u32 lane = 0; lane < num_lanes; ++lane) {
+      u32 bit = (u32) ((i64) base + (i64) lane * compiled.m_output_stride);
+      output.m_value[bit] = (((result >> lane) & 1) != 0);
+      XTSC_DEBUG(m_text, output.m_name << "[" << bit << "] <= " << ((result >> lane) & 1));
+    }
+  }
+}
+
+
+
 xtsc_component::xtsc_wire_logic::input_definition::input_definition(xtsc_wire_logic&   logic,
                                                                     const std::string& name,
                                                                     xtsc::u32          index,
@@ -1131,7 +1340,10 @@ xtsc_component::xtsc_wire_logic::input_definition::input_definition(xtsc_wire_lo
   m_bit_width               (bit_width),
   m_value                   (bit_width),
   m_initial_value           (initial_value),
-  m_detect_value_change     (false)
+  m_detect_value_change     (false),
+  m_packed                  ((bit_width + 63) / 64, 0),
+  m_dependencies            ((bit_width + 63) / 64),
+  m_stale                   (true)
 {
   reset();
 }
@@ -1149,6 +1361,10 @@ void xtsc_component::xtsc_wire_logic::input_definition::reset() {
     oss << m_logic.m_p_definition_file->info_for_exception();
     throw xtsc_exception(oss.str());
   }
+  for (u32 w = 0; w < m_packed.size(); ++w) {
+    m_packed[w] = pack_word(m_value, w, m_bit_width);
+  }
+  m_stale = true;
 }
 
 
@@ -1209,63 +1425,32 @@ void xtsc_component::xtsc_wire_logic::input_definition::xtsc_wire_write_if_impl:
     }
   }
 
-  // Crunch all RPN assignments dependent on this input
-  for (assignment_table::iterator i = m_input_definition.m_assignments.begin(); i != m_input_definition.m_assignments.end(); ++i) {
-    rpn_assignment& assignment = **i;
-    output_definition& output = *m_input_definition.m_logic.m_outputs[assignment[0]];
-    u32 output_bit_index = assignment[1];
-    u32 sp = 0;
-    vector<bool>& stack = m_input_definition.m_logic.m_stack;
-    for (u32 j = 2; j < assignment.size(); ++j) {
-      switch (assignment[j]) {
-        case op_PUSH: {
-          input_definition& input = *m_input_definition.m_logic.m_inputs[assignment[j+1]];
-          u32 bit_index = assignment[j+2];
-          bool value = input.m_value[bit_index].to_bool();
-          stack[sp] = value;
-          XTSC_DEBUG(m_text, "stack[" << sp << "] <= " << input.m_name << "[" << bit_index << "] = " << value);
-          sp += 1;
-          j += 2;
-          break;
-        }
-        case op_NOT: {
-          XTSC_DEBUG(m_text, "stack[" << (sp-1) << "] <= ! " << stack[sp-1]);
-          stack[sp-1] = !stack[sp-1];
-          break;
-        }
-        case op_AND: {
-          XTSC_DEBUG(m_text, "stack[" << (sp-2) << "] <= " << stack[sp-2] << " & " << stack[sp-1]);
-          stack[sp-2] = stack[sp-2] && stack[sp-1];
-          sp -= 1;
-          break;
-        }
-        case op_OR:  {
-          XTSC_DEBUG(m_text, "stack[" << (sp-2) << "] <= " << stack[sp-2] << " | " << stack[sp-1]);
-          stack[sp-2] = stack[sp-2] || stack[sp-1];
-          sp -= 1;
-          break;
-        }
-        case op_XOR: {
-          XTSC_DEBUG(m_text, "stack[" << (sp-2) << "] <= " << stack[sp-2] << " ^ " << stack[sp-1]);
-          stack[sp-2] = (stack[sp-2] != stack[sp-1]);
-          sp -= 1;
-          break;
-        }
-        default: {
-          ostringstream oss;
-          oss << "Program Bug:  Unrecognized op-code in RPN assignment in xtsc_wire_logic '" << m_input_definition.m_logic.name()
-              << "'";
-          throw xtsc_exception(oss.str());
+  // Re-pack the input and evaluate the compiled assignments which read a bit that changed.  On the
+  // first write after reset, evaluate all compiled assignments which read this input.
+  xtsc_wire_logic& logic = m_input_definition.m_logic;
+  logic.m_eval_stamp += 1;
+  logic.m_dirty.clear();
+  for (u32 w = 0; w < m_input_definition.m_packed.size(); ++w) {
+    u64 word    = pack_word(value, w, m_bit_width);
+    u64 changed = word ^ m_input_definition.m_packed[w];
+    m_input_definition.m_packed[w] = word;
+    if (changed && !m_input_definition.m_stale) {
+      vector<compiled_dependency>& dependencies = m_input_definition.m_dependencies[w];
+      for (vector<compiled_dependency>::const_iterator i = dependencies.begin(); i != dependencies.end(); ++i) {
+        compiled_assignment& compiled = *logic.m_compiled_assignments[i->m_compiled];
+        if ((changed & i->m_mask) && (compiled.m_stamp != logic.m_eval_stamp)) {
+          compiled.m_stamp = logic.m_eval_stamp;
+          logic.m_dirty.push_back(i->m_compiled);
         }
       }
     }
-    if (sp != 1) {
-      ostringstream oss;
-      oss << "Program Bug:  Stack pointer not 1 after RPN evalutaion in xtsc_wire_logic '" << m_input_definition.m_logic.name() << "'";
-      throw xtsc_exception(oss.str());
-    }
-    XTSC_DEBUG(m_text, output.m_name << "[" << output_bit_index << "] <= " << stack[0]);
-    output.m_value[output_bit_index] = stack[0];
+  }
+  if (m_input_definition.m_stale) {
+    logic.m_dirty = m_input_definition.m_compiled;
+    m_input_definition.m_stale = false;
+  }
+  for (vector<u32>::const_iterator i = logic.m_dirty.begin(); i != logic.m_dirty.end(); ++i) {
+    logic.evaluate(*logic.m_compiled_assignments[*i]);
   }
 
   // Call the Lua function of each output dependent on this input
@@ -332,6 +332,7 @@ xtsc_component::xtsc_xttlm2tlm2_transactor::xtsc_xttlm2tlm2_transactor(
   m_burst_index                 (NULL),
   m_burst_start_time            (NULL),
   m_prev_response_time          (NULL),
+  m_allocator                   (name()),
   m_transaction_count           (0),
   m_transaction_info_count      (0),
   m_request_count               (0),
@@ -1165,7 +1166,7 @@ transaction_info *xtsc_component::xtsc_xttlm2tlm2_transactor::new_transaction_in
   if (m_transaction_info_pool.empty()) {
     m_transaction_info_count += 1;
     XTSC_DEBUG(m_text, "Creating new transaction_info #" << m_transaction_info_count);
-    p_info = new transaction_info;
+    p_info = m_allocator.create<transaction_info>();
     tlm_generic_payload *p_trans = new tlm_generic_payload(&m_nb_mm);
     p_trans->set_data_ptr       (new_buffer());
     p_trans->set_byte_enable_ptr(new_buffer());
@@ -1182,7 +1183,7 @@ transaction_info *xtsc_component::xtsc_xttlm2tlm2_transactor::new_transaction_in
   p_info->m_p_request                        = p_request;
   // enum tlm_phase_enum { UNINITIALIZED_PHASE=0, BEGIN_REQ=1, END_REQ, BEGIN_RESP, END_RESP };
   p_info->m_phase = BEGIN_REQ;
-  p_info->m_p_response = new xtsc_response(*p_request, xtsc_response::RSP_OK, true);
+  p_info->m_p_response = m_allocator.create<xtsc_response>(*p_request, xtsc_response::RSP_OK, true);
   m_transaction_info_map[p_info->m_p_trans]  = p_info;
   return p_info;
 }
@@ -1219,7 +1220,7 @@ xtsc_request *xtsc_component::xtsc_xttlm2tlm2_transactor::new_request(const xtsc
   if (m_request_pool.empty()) {
     m_request_count += 1;
     XTSC_DEBUG(m_text, "Creating new xtsc_request #" << m_request_count);
-    p_request = new xtsc_request();
+    p_request = m_allocator.create<xtsc_request>();
   }
   else {
     p_request = m_request_pool.back();
@@ -3417,7 +3418,7 @@ void xtsc_component::xtsc_xttlm2tlm2_transactor::nb_mm::free(tlm::tlm_generic_pa
     throw xtsc_exception(oss.str());
   }
   transaction_info *p_info = i->second;
-  delete p_info->m_p_response;
+  m_transactor.m_allocator.destroy(p_info->m_p_response);
   p_info->m_p_response = NULL;
   p_trans->reset();
   m_transactor.m_transaction_info_pool.push_back(p_info);